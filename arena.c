@@ -0,0 +1,379 @@
+/*******************************************************************************************
+*
+*   arena - Block allocator for data that lives as long as the loaded model
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "arena.h"
+#include "memtrack.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT     16
+#define ARENA_ALIGN(size)   (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+#define FRAME_ARENA_MAGIC   0x4652414Du
+#define FRAME_ARENA_POISON  0xDD
+
+struct ArenaBlock
+{
+    struct ArenaBlock* next;
+    size_t size;                // Usable bytes after the header
+    size_t used;
+};
+
+// Headers rounded up so the data that follows them stays aligned
+#define ARENA_HEADER_SIZE   ARENA_ALIGN(sizeof(struct ArenaBlock))
+
+struct FrameOverflow
+{
+    struct FrameOverflow* next;
+    size_t size;                // Bytes after the header
+};
+
+#define FRAME_OVERFLOW_HEADER_SIZE  ARENA_ALIGN(sizeof(struct FrameOverflow))
+
+#if defined(FRAME_ARENA_CHECKS)
+typedef struct
+{
+    unsigned int magic;
+    unsigned int frame;         // Frame the allocation was made in
+} FrameStamp;
+
+#define FRAME_STAMP_SIZE    ARENA_ALIGN(sizeof(FrameStamp))
+#else
+#define FRAME_STAMP_SIZE    0
+#endif
+
+//----------------------------------------------------------------
+
+// Arena blocks hold the load-lifetime data of the model and count as scene memory. Frame
+// buffers hold the text and lists built for one frame and count as UI memory
+static struct ArenaBlock* AllocArenaBlock(Arena* arena, size_t size)
+{
+    struct ArenaBlock* block = (struct ArenaBlock*)MemTrackCalloc(MEMORY_SCENE, 1, ARENA_HEADER_SIZE + size);
+    if (block == NULL) return NULL;
+
+    block->size = size;
+
+    arena->reservedBytes += ARENA_HEADER_SIZE + size;
+    arena->blockCount++;
+
+    return block;
+}
+
+//----------------------------------------------------------------
+
+Arena InitArena(size_t blockSize)
+{
+    Arena arena = { 0 };
+    arena.blockSize = (blockSize > 0) ? blockSize : ARENA_DEFAULT_BLOCK_SIZE;
+
+    return arena;
+}
+
+void UnloadArena(Arena arena)
+{
+    struct ArenaBlock* block = arena.blocks;
+
+    while (block != NULL)
+    {
+        struct ArenaBlock* next = block->next;
+        MemTrackFree(MEMORY_SCENE, block);
+        block = next;
+    }
+}
+
+void* ArenaAlloc(Arena* arena, size_t size)
+{
+    if (arena->blockSize == 0) arena->blockSize = ARENA_DEFAULT_BLOCK_SIZE;
+
+    const size_t alignedSize = ARENA_ALIGN(size);
+    struct ArenaBlock* block = arena->blocks;
+
+    if ((block == NULL) || (block->size - block->used < alignedSize))
+    {
+        if (alignedSize > arena->blockSize/4)
+        {
+            // Large requests get their own block behind the current one, which keeps filling
+            struct ArenaBlock* own = AllocArenaBlock(arena, alignedSize);
+            if (own == NULL) return NULL;
+
+            own->used = alignedSize;
+
+            if (block != NULL)
+            {
+                own->next = block->next;
+                block->next = own;
+            }
+            else arena->blocks = own;
+
+            arena->allocationCount++;
+            arena->allocatedBytes += size;
+
+            return (unsigned char*)own + ARENA_HEADER_SIZE;
+        }
+
+        block = AllocArenaBlock(arena, arena->blockSize);
+        if (block == NULL) return NULL;
+
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+
+    void* result = (unsigned char*)block + ARENA_HEADER_SIZE + block->used;
+    block->used += alignedSize;
+
+    arena->allocationCount++;
+    arena->allocatedBytes += size;
+
+    return result;
+}
+
+void* ArenaRealloc(Arena* arena, void* ptr, size_t oldSize, size_t newSize)
+{
+    if (ptr == NULL) return ArenaAlloc(arena, newSize);
+    if (newSize <= oldSize) return ptr;
+
+    struct ArenaBlock* block = arena->blocks;
+    unsigned char* top = (block != NULL) ? (unsigned char*)block + ARENA_HEADER_SIZE + block->used : NULL;
+
+    // The newest allocation of the current block grows in place while the block has room
+    if ((top != NULL) && ((unsigned char*)ptr + ARENA_ALIGN(oldSize) == top) && (block->size - block->used >= ARENA_ALIGN(newSize) - ARENA_ALIGN(oldSize)))
+    {
+        block->used += ARENA_ALIGN(newSize) - ARENA_ALIGN(oldSize);
+        arena->allocatedBytes += newSize - oldSize;
+
+        return ptr;
+    }
+
+    void* memory = ArenaAlloc(arena, newSize);
+    if (memory != NULL) memcpy(memory, ptr, oldSize);
+
+    return memory;
+}
+
+char* ArenaStrdup(Arena* arena, const char* text)
+{
+    const size_t length = strlen(text);
+    char* copy = (char*)ArenaAlloc(arena, length + 1);
+
+    if (copy != NULL) memcpy(copy, text, length + 1);
+
+    return copy;
+}
+
+//----------------------------------------------------------------
+
+static void FreeFrameOverflows(struct FrameOverflow* overflow)
+{
+    while (overflow != NULL)
+    {
+        struct FrameOverflow* next = overflow->next;
+        MemTrackFree(MEMORY_UI, overflow);
+        overflow = next;
+    }
+}
+
+#if defined(FRAME_ARENA_CHECKS)
+static bool IsFramePointer(const FrameArena* arena, const void* ptr)
+{
+    const unsigned char* address = (const unsigned char*)ptr;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if ((arena->buffers[i] != NULL) && (address >= arena->buffers[i]) && (address < arena->buffers[i] + arena->used[i])) return true;
+
+        for (const struct FrameOverflow* overflow = arena->overflows[i]; overflow != NULL; overflow = overflow->next)
+        {
+            const unsigned char* memory = (const unsigned char*)overflow + FRAME_OVERFLOW_HEADER_SIZE;
+            if ((address >= memory) && (address < memory + overflow->size)) return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+//----------------------------------------------------------------
+
+FrameArena InitFrameArena(size_t size)
+{
+    FrameArena arena = { 0 };
+
+    if (size == 0) size = FRAME_ARENA_DEFAULT_SIZE;
+
+    for (int i = 0; i < 2; i++)
+    {
+        arena.buffers[i] = (unsigned char*)MemTrackAlloc(MEMORY_UI, size);
+        arena.capacities[i] = (arena.buffers[i] != NULL) ? size : 0;
+    }
+
+    return arena;
+}
+
+void UnloadFrameArena(FrameArena arena)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        MemTrackFree(MEMORY_UI, arena.buffers[i]);
+        FreeFrameOverflows(arena.overflows[i]);
+    }
+}
+
+void ResetFrameArena(FrameArena* arena)
+{
+    const size_t frameBytes = arena->used[arena->current] + arena->overflowBytes[arena->current];
+
+    arena->lastFrameBytes = frameBytes;
+    if (frameBytes > arena->highWaterBytes) arena->highWaterBytes = frameBytes;
+
+    // The buffer of two frames ago is recycled, the one of the finished frame stays valid
+    arena->current ^= 1;
+    arena->frame++;
+
+    const int index = arena->current;
+
+    if (arena->overflowBytes[index] > 0)
+    {
+        // Grow so the next frame of the same size fits without the heap
+        size_t capacity = (arena->capacities[index] > 0) ? arena->capacities[index]*2 : FRAME_ARENA_DEFAULT_SIZE;
+        const size_t needed = arena->used[index] + arena->overflowBytes[index];
+        while (capacity < needed) capacity *= 2;
+
+        unsigned char* buffer = (unsigned char*)MemTrackAlloc(MEMORY_UI, capacity);
+
+        if (buffer != NULL)
+        {
+            MemTrackFree(MEMORY_UI, arena->buffers[index]);
+            arena->buffers[index] = buffer;
+            arena->capacities[index] = capacity;
+
+            TraceLog(LOG_INFO, "ARENA: Frame buffer %d grown to %.1f KB", index, capacity/1024.0f);
+        }
+
+        FreeFrameOverflows(arena->overflows[index]);
+        arena->overflows[index] = NULL;
+        arena->overflowBytes[index] = 0;
+    }
+#if defined(FRAME_ARENA_CHECKS)
+    else if (arena->buffers[index] != NULL)
+    {
+        memset(arena->buffers[index], FRAME_ARENA_POISON, arena->used[index]);
+    }
+#endif
+
+    arena->used[index] = 0;
+}
+
+void* FrameAlloc(FrameArena* arena, size_t size)
+{
+    const int index = arena->current;
+    const size_t alignedSize = FRAME_STAMP_SIZE + ARENA_ALIGN(size);
+    unsigned char* memory = NULL;
+
+    if (arena->capacities[index] - arena->used[index] >= alignedSize)
+    {
+        memory = arena->buffers[index] + arena->used[index];
+        arena->used[index] += alignedSize;
+    }
+    else
+    {
+        struct FrameOverflow* overflow = (struct FrameOverflow*)MemTrackAlloc(MEMORY_UI, FRAME_OVERFLOW_HEADER_SIZE + alignedSize);
+        if (overflow == NULL) return NULL;
+
+        overflow->next = arena->overflows[index];
+        overflow->size = alignedSize;
+        arena->overflows[index] = overflow;
+        arena->overflowBytes[index] += alignedSize;
+        arena->overflowCount++;
+
+        memory = (unsigned char*)overflow + FRAME_OVERFLOW_HEADER_SIZE;
+    }
+
+#if defined(FRAME_ARENA_CHECKS)
+    FrameStamp* stamp = (FrameStamp*)memory;
+    stamp->magic = FRAME_ARENA_MAGIC;
+    stamp->frame = arena->frame;
+#endif
+
+    return memory + FRAME_STAMP_SIZE;
+}
+
+const char* FrameTextFormat(FrameArena* arena, const char* text, ...)
+{
+    const int index = arena->current;
+    const size_t offset = arena->used[index] + FRAME_STAMP_SIZE;
+    const size_t available = (arena->capacities[index] > offset) ? arena->capacities[index] - offset : 0;
+
+    va_list args;
+
+    // Format straight into the free space, most texts fit and are formatted once
+    va_start(args, text);
+    const int length = vsnprintf((available > 0) ? (char*)arena->buffers[index] + offset : NULL, available, text, args);
+    va_end(args);
+
+    if (length < 0) return "";
+
+    if ((size_t)length < available)
+    {
+        char* result = (char*)FrameAlloc(arena, length + 1);
+        assert(result == (char*)arena->buffers[index] + offset);
+
+        return result;
+    }
+
+    char* result = (char*)FrameAlloc(arena, length + 1);
+    if (result == NULL) return "";
+
+    va_start(args, text);
+    vsnprintf(result, length + 1, text, args);
+    va_end(args);
+
+    return result;
+}
+
+void CheckFramePointer(const FrameArena* arena, const void* ptr)
+{
+#if defined(FRAME_ARENA_CHECKS)
+    assert(IsFramePointer(arena, ptr) && "Frame memory used after its buffer was recycled");
+
+    const FrameStamp* stamp = (const FrameStamp*)((const unsigned char*)ptr - FRAME_STAMP_SIZE);
+    assert((stamp->magic == FRAME_ARENA_MAGIC) && "Frame pointer does not point at the start of an allocation");
+    assert((arena->frame - stamp->frame <= 1) && "Frame memory used after its buffer was recycled");
+#else
+    (void)arena;
+    (void)ptr;
+#endif
+}
+
+void CheckNotFramePointer(const FrameArena* arena, const void* ptr)
+{
+#if defined(FRAME_ARENA_CHECKS)
+    assert(!IsFramePointer(arena, ptr) && "Frame memory stored past its frames");
+#else
+    (void)arena;
+    (void)ptr;
+#endif
+}
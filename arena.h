@@ -0,0 +1,103 @@
+/*******************************************************************************************
+*
+*   arena - Block allocator for data that lives as long as the loaded model, and a frame
+*   scratch allocator for data that lives one or two frames
+*
+*   Allocations are bumped out of large blocks and never freed on their own, UnloadArena()
+*   releases every block at once. Memory is zeroed and 16 byte aligned. A request larger
+*   than the block size gets a block of its own.
+*
+*   The frame arena has two buffers and ResetFrameArena() swaps them once per frame, so an
+*   allocation stays valid through the frame after the one it was made in. A frame that does
+*   not fit falls back to the heap and its buffer grows at the next reset. Frame memory is not
+*   zeroed. With FRAME_ARENA_CHECKS defined every allocation is stamped with its frame and
+*   recycled memory is poisoned, CheckFramePointer() asserts on a pointer that outlived its
+*   frames and CheckNotFramePointer() asserts when one is stored in longer lived state. A
+*   stale pointer is missed only when a newer allocation starts at the same address.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "raylib.h"
+
+#include <stddef.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE    (64*1024)
+#define FRAME_ARENA_DEFAULT_SIZE    (256*1024)      // Per buffer
+
+typedef struct
+{
+    size_t blockSize;
+    struct ArenaBlock* blocks;  // Newest first, allocations come from the first one
+
+    int allocationCount;
+    size_t allocatedBytes;      // Requested bytes, before alignment
+    size_t reservedBytes;       // Bytes of every block
+    int blockCount;
+} Arena;
+
+typedef struct
+{
+    unsigned char* buffers[2];
+    size_t capacities[2];
+    size_t used[2];
+    struct FrameOverflow* overflows[2];     // Heap fallbacks of each buffer, freed when it is reset
+    size_t overflowBytes[2];
+    int current;                            // Buffer of the frame being built
+    unsigned int frame;
+
+    size_t lastFrameBytes;                  // Bytes the last finished frame used
+    size_t highWaterBytes;                  // Most bytes any frame used
+    int overflowCount;                      // Heap fallbacks since start
+} FrameArena;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// No memory is reserved until the first allocation
+Arena InitArena(size_t blockSize);
+void UnloadArena(Arena arena);
+
+void* ArenaAlloc(Arena* arena, size_t size);
+// Grows in place when ptr is the newest allocation and the block has room, copies otherwise
+void* ArenaRealloc(Arena* arena, void* ptr, size_t oldSize, size_t newSize);
+char* ArenaStrdup(Arena* arena, const char* text);
+
+FrameArena InitFrameArena(size_t size);
+void UnloadFrameArena(FrameArena arena);
+
+// Call once per frame before BeginDrawing(), memory of the frame before stays valid
+void ResetFrameArena(FrameArena* arena);
+
+void* FrameAlloc(FrameArena* arena, size_t size);
+const char* FrameTextFormat(FrameArena* arena, const char* text, ...);
+
+// Both do nothing without FRAME_ARENA_CHECKS
+void CheckFramePointer(const FrameArena* arena, const void* ptr);
+void CheckNotFramePointer(const FrameArena* arena, const void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_H
@@ -0,0 +1,280 @@
+/*******************************************************************************************
+*
+*   bench_math - Batch math kernels against the scalar functions they replace
+*
+*   Runs without a window, only vmath.c is linked. Every batch kernel level the CPU supports
+*   is timed against a loop over the scalar function as it was in main.c, for a bone sized
+*   and a large array. Results are checked against the scalar loop before timing.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "vmath.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#define BENCH_MAX_COUNT     4096
+#define BENCH_MIN_TIME      0.2         // Seconds per measurement
+
+typedef enum
+{
+    BENCH_MULTIPLY = 0,
+    BENCH_TRANSFORM,
+    BENCH_QUATERNION
+} BenchKind;
+
+typedef struct
+{
+    Matrix a[BENCH_MAX_COUNT];
+    Matrix b[BENCH_MAX_COUNT];
+    Matrix matrices[BENCH_MAX_COUNT];
+    Vector3 points[BENCH_MAX_COUNT];
+    Vector3 transformed[BENCH_MAX_COUNT];
+    Quaternion quaternions[BENCH_MAX_COUNT];
+} BenchData;
+
+static BenchData data = { 0 };
+static volatile float sink = 0.0f;
+
+//----------------------------------------------------------------
+// The scalar functions as main.c had them, defined here so the compiler can inline them
+static Matrix MatrixMultiplyReference(Matrix a, Matrix b)
+{
+    Matrix result = { 0 };
+
+    result.m0 = a.m0*b.m0 + a.m4*b.m1 + a.m8*b.m2 + a.m12*b.m3;
+    result.m1 = a.m1*b.m0 + a.m5*b.m1 + a.m9*b.m2 + a.m13*b.m3;
+    result.m2 = a.m2*b.m0 + a.m6*b.m1 + a.m10*b.m2 + a.m14*b.m3;
+    result.m3 = a.m3*b.m0 + a.m7*b.m1 + a.m11*b.m2 + a.m15*b.m3;
+
+    result.m4 = a.m0*b.m4 + a.m4*b.m5 + a.m8*b.m6 + a.m12*b.m7;
+    result.m5 = a.m1*b.m4 + a.m5*b.m5 + a.m9*b.m6 + a.m13*b.m7;
+    result.m6 = a.m2*b.m4 + a.m6*b.m5 + a.m10*b.m6 + a.m14*b.m7;
+    result.m7 = a.m3*b.m4 + a.m7*b.m5 + a.m11*b.m6 + a.m15*b.m7;
+
+    result.m8 = a.m0*b.m8 + a.m4*b.m9 + a.m8*b.m10 + a.m12*b.m11;
+    result.m9 = a.m1*b.m8 + a.m5*b.m9 + a.m9*b.m10 + a.m13*b.m11;
+    result.m10 = a.m2*b.m8 + a.m6*b.m9 + a.m10*b.m10 + a.m14*b.m11;
+    result.m11 = a.m3*b.m8 + a.m7*b.m9 + a.m11*b.m10 + a.m15*b.m11;
+
+    result.m12 = a.m0*b.m12 + a.m4*b.m13 + a.m8*b.m14 + a.m12*b.m15;
+    result.m13 = a.m1*b.m12 + a.m5*b.m13 + a.m9*b.m14 + a.m13*b.m15;
+    result.m14 = a.m2*b.m12 + a.m6*b.m13 + a.m10*b.m14 + a.m14*b.m15;
+    result.m15 = a.m3*b.m12 + a.m7*b.m13 + a.m11*b.m14 + a.m15*b.m15;
+
+    return result;
+}
+
+static Vector3 Vector3TransformReference(Vector3 v, Matrix mat)
+{
+    return (Vector3)
+    {
+        v.x*mat.m0 + v.y*mat.m4 + v.z*mat.m8 + mat.m12,
+        v.x*mat.m1 + v.y*mat.m5 + v.z*mat.m9 + mat.m13,
+        v.x*mat.m2 + v.y*mat.m6 + v.z*mat.m10 + mat.m14
+    };
+}
+
+static Matrix QuaternionToMatrixReference(Quaternion q)
+{
+    Matrix result = { 0 };
+
+    float norm = sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+    if (norm > 0.0f)
+    {
+        q.x /= norm;
+        q.y /= norm;
+        q.z /= norm;
+        q.w /= norm;
+    }
+
+    float xx = q.x*q.x;
+    float yy = q.y*q.y;
+    float zz = q.z*q.z;
+    float xy = q.x*q.y;
+    float xz = q.x*q.z;
+    float yz = q.y*q.z;
+    float wx = q.w*q.x;
+    float wy = q.w*q.y;
+    float wz = q.w*q.z;
+
+    result.m0 = 1.0f - 2.0f*(yy + zz);
+    result.m1 = 2.0f*(xy + wz);
+    result.m2 = 2.0f*(xz - wy);
+
+    result.m4 = 2.0f*(xy - wz);
+    result.m5 = 1.0f - 2.0f*(xx + zz);
+    result.m6 = 2.0f*(yz + wx);
+
+    result.m8  = 2.0f*(xz + wy);
+    result.m9  = 2.0f*(yz - wx);
+    result.m10 = 1.0f - 2.0f*(xx + yy);
+
+    result.m15 = 1.0f;
+
+    return result;
+}
+
+//----------------------------------------------------------------
+static double GetSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+static float GetRandom(void)
+{
+    return (float)rand()/(float)RAND_MAX*2.0f - 1.0f;
+}
+
+static void RunOnce(BenchKind kind, bool isReference, int count)
+{
+    switch (kind)
+    {
+        case BENCH_MULTIPLY:
+        {
+            if (isReference) for (int i = 0; i < count; i++) data.matrices[i] = MatrixMultiplyReference(data.a[i], data.b[i]);
+            else MatrixMultiplyBatch(data.matrices, data.a, data.b, count);
+
+            sink += data.matrices[count - 1].m0;
+        } break;
+        case BENCH_TRANSFORM:
+        {
+            if (isReference) for (int i = 0; i < count; i++) data.transformed[i] = Vector3TransformReference(data.points[i], data.a[0]);
+            else Vector3TransformBatch(data.transformed, data.points, count, &data.a[0]);
+
+            sink += data.transformed[count - 1].x;
+        } break;
+        case BENCH_QUATERNION:
+        {
+            if (isReference) for (int i = 0; i < count; i++) data.matrices[i] = QuaternionToMatrixReference(data.quaternions[i]);
+            else QuaternionToMatrixBatch(data.matrices, data.quaternions, count);
+
+            sink += data.matrices[count - 1].m5;
+        } break;
+        default: break;
+    }
+}
+
+// Nanoseconds per element, repeats until BENCH_MIN_TIME has passed
+static double Measure(BenchKind kind, bool isReference, int count)
+{
+    RunOnce(kind, isReference, count);
+
+    long long elements = 0;
+    const double start = GetSeconds();
+    double elapsed = 0.0;
+
+    while (elapsed < BENCH_MIN_TIME)
+    {
+        for (int k = 0; k < 64; k++) RunOnce(kind, isReference, count);
+
+        elements += 64LL*count;
+        elapsed = GetSeconds() - start;
+    }
+
+    return elapsed*1e9/(double)elements;
+}
+
+// Largest difference between the batch result and the reference loop
+static float Validate(BenchKind kind, int count)
+{
+    static float expected[BENCH_MAX_COUNT*16];
+
+    const int floatCount = (kind == BENCH_TRANSFORM) ? 3*count : 16*count;
+    const float* result = (kind == BENCH_TRANSFORM) ? (const float*)data.transformed : (const float*)data.matrices;
+
+    RunOnce(kind, true, count);
+    memcpy(expected, result, floatCount*sizeof(float));
+    RunOnce(kind, false, count);
+
+    float maxError = 0.0f;
+    for (int i = 0; i < floatCount; i++) maxError = fmaxf(maxError, fabsf(result[i] - expected[i]));
+
+    return maxError;
+}
+
+//----------------------------------------------------------------
+int main(void)
+{
+    const char* kindNames[] = { "MatrixMultiply", "Vector3Transform", "QuaternionToMatrix" };
+    const int counts[] = { 64, BENCH_MAX_COUNT };
+
+    srand(1);
+
+    for (int i = 0; i < BENCH_MAX_COUNT; i++)
+    {
+        float* a = (float*)&data.a[i];
+        float* b = (float*)&data.b[i];
+        for (int k = 0; k < 16; k++) { a[k] = GetRandom(); b[k] = GetRandom(); }
+
+        data.points[i] = (Vector3){ GetRandom(), GetRandom(), GetRandom() };
+        data.quaternions[i] = (Quaternion){ GetRandom(), GetRandom(), GetRandom(), GetRandom() };
+    }
+
+    const MathSimdLevel best = GetMathSimdLevel();
+    printf("Best supported level: %s\n\n", GetMathSimdName(best));
+    printf("%-20s %6s %-8s %10s %10s %8s %10s\n", "function", "count", "level", "scalar ns", "batch ns", "speedup", "max error");
+
+    int failures = 0;
+
+    for (int kind = BENCH_MULTIPLY; kind <= BENCH_QUATERNION; kind++)
+    {
+        for (int c = 0; c < (int)(sizeof(counts)/sizeof(counts[0])); c++)
+        {
+            const double reference = Measure((BenchKind)kind, true, counts[c]);
+
+            for (int level = MATH_SIMD_SCALAR; level <= MATH_SIMD_NEON; level++)
+            {
+                if (!SetMathSimdLevel((MathSimdLevel)level)) continue;
+
+                const float maxError = Validate((BenchKind)kind, counts[c]);
+                const double batch = Measure((BenchKind)kind, false, counts[c]);
+
+                if (maxError > 1e-4f) failures++;
+
+                printf("%-20s %6d %-8s %10.2f %10.2f %7.2fx %10.2e\n", kindNames[kind], counts[c], GetMathSimdName((MathSimdLevel)level),
+                    reference, batch, reference/batch, maxError);
+            }
+        }
+    }
+
+    SetMathSimdLevel(best);
+
+    if (failures > 0) printf("\n%d results differ from the scalar functions\n", failures);
+
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,1482 @@
+/*******************************************************************************************
+*
+*   bench_viewer - Headless benchmarks of the viewer hot paths with a regression check
+*
+*   Runs without a window, so only the CPU side of each path is measured: math helpers,
+*   vec.c operations against the typed containers, heap against arena clip names, name
+*   lookups through the interned table against a string scan, clip search keystrokes over
+*   100k names, list view frames from 1k to 1M rows, directory sorting, scanning and cache
+*   returns over 50k entries, bone drawing preparation, animation pose sampling, scene graph updates
+*   and loading (JSON parse, node graph, LoadModelAnimations). Every kernel runs on a
+*   synthetic input (generated .glb node tree and skeleton) and on each --glb file given.
+*
+*   Each kernel is sampled several times after a warm up, ns/op is reported as median, mean,
+*   standard deviation and minimum. Results go to a JSON file, one result per line, and are
+*   compared by median against a baseline written by an earlier run (make bench_baseline).
+*   A kernel slower than the baseline by more than the threshold fails the run.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "vmath.h"
+#include "vec.h"
+#include "arena.h"
+#include "containers.h"
+#include "names.h"
+#include "search.h"
+#include "listview.h"
+#include "dirscan.h"
+#include "dircache.h"
+#include "scene.h"
+#include "glb.h"
+#include "glbindex.h"
+#include "memtrack.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <direct.h>
+    #define MakeBenchDirectory(path)    _mkdir(path)
+    #define RemoveBenchDirectory(path)  _rmdir(path)
+#else
+    #include <time.h>
+    #include <unistd.h>
+    #define MakeBenchDirectory(path)    mkdir(path, 0755)
+    #define RemoveBenchDirectory(path)  rmdir(path)
+#endif
+
+#define BENCH_MAX_INPUTS        32          // The glbgen suite is swept in one run
+#define BENCH_MAX_RESULTS       512
+#define BENCH_DEFAULT_SAMPLES   15
+#define BENCH_SAMPLE_TIME       0.005       // Minimum seconds per sample, calibrated in the warm up
+#define BENCH_SYNTHETIC_NODES   1365        // Complete 4-ary tree of depth 6
+#define BENCH_SYNTHETIC_BONES   64
+#define BENCH_SYNTHETIC_FRAMES  120
+#define BENCH_CLIP_NAMES        64
+#define BENCH_NAMES             50000       // Node names of a large scene, one in five is unique
+#define BENCH_NAME_PARTS        1000        // Distinct names the others repeat
+#define BENCH_NAME_QUERIES      1024
+#define BENCH_SCAN_QUERIES      16
+#define BENCH_SEARCH_NAMES      100000      // Mocap sized clip list
+#define BENCH_LIST_VIEW_HEIGHT  400.0f      // Pixels of the view, about 13 rows
+#define BENCH_DIR_ENTRIES       50000
+#define BENCH_DIR_STAT_ENTRIES  1000        // The stat() per compare sort takes seconds on more
+#define BENCH_INDEX_FILES       10000
+#define BENCH_INDEX_NODES       21          // Complete 4-ary tree of depth 3, about 2 KB of JSON
+#define BENCH_INDEX_BIN_SIZE    4096        // Never read by the index, it only has to be there
+
+typedef void (*BenchFunc)(void);
+
+typedef struct
+{
+    char name[48];
+    char input[64];
+    int samples;
+    long long iterations;       // Calls per sample
+    double medianNs;            // Per op, an op is one call unless the kernel says otherwise
+    double meanNs;
+    double stddevNs;
+    double minNs;
+} BenchResult;
+
+typedef struct
+{
+    char name[48];
+    char input[64];
+    double medianNs;
+} BaselineEntry;
+
+// State of the input being measured, kernels read it through globals to stay plain calls
+typedef struct
+{
+    const char* fileName;
+    bool isGlb;
+    bool hasFileAnimations;     // Animations came from the file, not generated
+
+    Arena graphArena;
+    NameTable graphNames;
+    SceneGraph graph;
+    int leafNode;               // Last node in depth-first order, a leaf, editing it recomputes one world
+    int topNode;                // First node under the root, editing it recomputes its whole subtree
+
+    ModelAnimation* anims;
+    int animCount;
+    int frame;
+
+    Vector3* positions;
+    Matrix* poses;
+    Quaternion* rotations;
+    int boneCapacity;
+} BenchInput;
+
+static BenchInput input = { 0 };
+static volatile float sink = 0.0f;
+
+static Matrix mathA, mathB;
+static Vector3 mathPoint, mathAngles;
+static Quaternion mathQuaternion;
+static unsigned tick = 0;
+
+//----------------------------------------------------------------
+static double GetSeconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec*1e-9;
+#endif
+}
+
+static void WaitMilliseconds(double ms)
+{
+#if defined(_WIN32)
+    Sleep((DWORD)ms);
+#else
+    const struct timespec wait = { 0, (long)(ms*1e6) };
+    nanosleep(&wait, NULL);
+#endif
+}
+
+static float GetRandom(void)
+{
+    return (float)rand()/(float)RAND_MAX*2.0f - 1.0f;
+}
+
+static int CompareDouble(const void* a, const void* b)
+{
+    const double da = *(const double*)a;
+    const double db = *(const double*)b;
+
+    return (da > db) - (da < db);
+}
+
+//----------------------------------------------------------------
+// Math helpers, one call per op
+
+static void BenchMatrixMultiply(void)
+{
+    mathA = MatrixMultiply(mathA, mathB);
+    sink += mathA.m0;
+}
+
+// What DrawModelPro() built every frame before the scene graph cached it
+static void BenchModelTransform(void)
+{
+    mathAngles.y += 0.5f;
+    const Matrix m = MatrixMultiply(MatrixTranslateV(mathPoint), MatrixMultiply(MatrixRotateV(mathAngles), MatrixScaleV(Vector3One())));
+    sink += m.m12;
+}
+
+static void BenchVector3Transform(void)
+{
+    mathPoint = Vector3Transform(mathPoint, mathB);
+    sink += mathPoint.x;
+}
+
+static void BenchQuaternionToMatrix(void)
+{
+    mathQuaternion.x += 0.001f;
+    const Matrix m = QuaternionToMatrix(mathQuaternion);
+    sink += m.m5;
+}
+
+static void BenchQuaternionFromEuler(void)
+{
+    mathAngles.x += 0.001f;
+    mathQuaternion = QuaternionFromEuler(mathAngles);
+    sink += mathQuaternion.w;
+}
+
+//----------------------------------------------------------------
+// vec.c, the way main.c fills and joins the clip name list
+
+#define BENCH_VEC_PUSHES    1024
+
+static void BenchVectorAdd(void)
+{
+    int* values = (int*)vector_create();
+    for (int i = 0; i < BENCH_VEC_PUSHES; i++) vector_add(&values, i);
+
+    sink += (float)vector_size(values);
+    vector_free(values);
+}
+
+// containers.h, the same pushes through the typed array and one bulk append
+
+DEFINE_ARRAY(BenchIntArray, int, 16)
+
+static int benchValues[BENCH_VEC_PUSHES];
+
+static void BenchArrayPush(void)
+{
+    BenchIntArray values = BenchIntArrayInit(GetHeapAllocator());
+    for (int i = 0; i < BENCH_VEC_PUSHES; i++) BenchIntArrayPush(&values, i);
+
+    sink += (float)BenchIntArrayCount(&values);
+    BenchIntArrayFree(&values);
+}
+
+static void BenchArrayAppend(void)
+{
+    BenchIntArray values = BenchIntArrayInit(GetHeapAllocator());
+    BenchIntArrayAppend(&values, benchValues, BENCH_VEC_PUSHES);
+
+    sink += (float)BenchIntArrayCount(&values);
+    BenchIntArrayFree(&values);
+}
+
+static void BenchArrayArenaPush(void)
+{
+    static Arena arena = { 0 };
+
+    BenchIntArray values = BenchIntArrayInit(GetArenaAllocator(&arena));
+    for (int i = 0; i < BENCH_VEC_PUSHES; i++) BenchIntArrayPush(&values, i);
+
+    sink += (float)BenchIntArrayCount(&values);
+
+    // One arena per call would time its block allocation, reuse it until it grew a little
+    if (arena.reservedBytes > 4*ARENA_DEFAULT_BLOCK_SIZE)
+    {
+        UnloadArena(arena);
+        arena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+    }
+}
+
+//----------------------------------------------------------------
+// memtrack.c, the cost the accounting adds to every allocation
+
+#define BENCH_ALLOCATIONS   256
+
+static void* benchBlocks[BENCH_ALLOCATIONS];
+
+static void BenchMallocFree(void)
+{
+    for (int i = 0; i < BENCH_ALLOCATIONS; i++) benchBlocks[i] = malloc(16 + (i%32)*24);
+    for (int i = 0; i < BENCH_ALLOCATIONS; i++) free(benchBlocks[i]);
+}
+
+static void BenchTrackedAllocFree(void)
+{
+    for (int i = 0; i < BENCH_ALLOCATIONS; i++) benchBlocks[i] = MemTrackAlloc(MEMORY_OTHER, 16 + (i%32)*24);
+    for (int i = 0; i < BENCH_ALLOCATIONS; i++) MemTrackFree(MEMORY_OTHER, benchBlocks[i]);
+}
+
+static void BenchClipNames(void)
+{
+    char** names = (char**)vector_create();
+
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++)
+    {
+        char* name = strdup(TextFormat("Armature|Clip_%03d", i));
+        vector_add(&names, name);
+    }
+
+    size_t totalLength = 1;
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++) totalLength += strlen(names[i]) + 1;
+
+    char* options = (char*)MemAlloc((unsigned int)totalLength);
+    strcpy(options, names[0]);
+
+    for (int i = 1; i < BENCH_CLIP_NAMES; i++)
+    {
+        strcat(options, ";");
+        strcat(options, names[i]);
+    }
+
+    sink += (float)strlen(options);
+
+    MemFree(options);
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++) free(names[i]);
+    vector_free(names);
+}
+
+// The same list as main.c builds it now, names and options from one arena released at once
+static void BenchArenaClipNames(void)
+{
+    Arena arena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+    char** names = (char**)vector_create();
+
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++)
+    {
+        char* name = ArenaStrdup(&arena, TextFormat("Armature|Clip_%03d", i));
+        vector_add(&names, name);
+    }
+
+    size_t totalLength = 0;
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++) totalLength += strlen(names[i]) + 1;
+
+    char* options = (char*)ArenaAlloc(&arena, totalLength);
+    size_t length = 0;
+
+    for (int i = 0; i < BENCH_CLIP_NAMES; i++)
+    {
+        const size_t nameLength = strlen(names[i]);
+        memcpy(options + length, names[i], nameLength);
+        length += nameLength;
+        options[length++] = (i < BENCH_CLIP_NAMES - 1) ? ';' : '\0';
+    }
+
+    sink += (float)strlen(options);
+
+    vector_free(names);
+    UnloadArena(arena);
+}
+
+//----------------------------------------------------------------
+// names.c, one op is one name
+
+static char benchNames[BENCH_NAMES][24];
+static const char* benchQueries[BENCH_NAME_QUERIES];
+static NameTable benchNameTable = { 0 };
+static NameIndex benchNameIndex = { 0 };
+
+static void BenchInternNames(void)
+{
+    Arena arena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+    NameTable table = InitNameTable(&arena, BENCH_NAMES);
+
+    for (int i = 0; i < BENCH_NAMES; i++) InternName(&table, benchNames[i]);
+
+    sink += (float)table.count;
+    UnloadArena(arena);
+}
+
+static void BenchFindName(void)
+{
+    int found = 0;
+    for (int i = 0; i < BENCH_NAME_QUERIES; i++) found += FindNameIndex(&benchNameTable, benchNameIndex, benchQueries[i]);
+
+    sink += (float)found;
+}
+
+// What finding a node by name costs without the table, first match wins as in BuildNameIndex()
+static void BenchScanName(void)
+{
+    int found = 0;
+
+    for (int q = 0; q < BENCH_SCAN_QUERIES; q++)
+    {
+        const char* query = benchQueries[q*(BENCH_NAME_QUERIES/BENCH_SCAN_QUERIES)];
+
+        for (int i = 0; i < BENCH_NAMES; i++)
+        {
+            if (strcmp(benchNames[i], query) == 0) { found += i; break; }
+        }
+    }
+
+    sink += (float)found;
+}
+
+static void GenerateNames(Arena* arena)
+{
+    for (int i = 0; i < BENCH_NAMES; i++)
+    {
+        if (i%5 == 0) snprintf(benchNames[i], sizeof(benchNames[i]), "Node_%d", i);
+        else snprintf(benchNames[i], sizeof(benchNames[i]), "Part_%04d", i%BENCH_NAME_PARTS);
+    }
+
+    // Queries spread over the whole list so they hit unique and repeated names
+    for (int i = 0; i < BENCH_NAME_QUERIES; i++) benchQueries[i] = benchNames[(int)(((long long)i*7919)%BENCH_NAMES)];
+
+    static int nameIds[BENCH_NAMES];
+
+    benchNameTable = InitNameTable(arena, 0);
+    for (int i = 0; i < BENCH_NAMES; i++) nameIds[i] = InternName(&benchNameTable, benchNames[i]);
+    benchNameIndex = BuildNameIndex(&benchNameTable, arena, nameIds, BENCH_NAMES);
+}
+
+// One copy per node as the scene graph kept them, against the table and the ids
+static void PrintNameMemory(void)
+{
+    size_t copyBytes = BENCH_NAMES*sizeof(char*);
+    for (int i = 0; i < BENCH_NAMES; i++) copyBytes += strlen(benchNames[i]) + 1;
+
+    const size_t tableBytes = benchNameTable.stringBytes + benchNameTable.capacity*(sizeof(char*) + sizeof(unsigned int)) +
+        benchNameTable.slotCount*sizeof(int) + BENCH_NAMES*sizeof(int);
+
+    printf("\nNames: %d, %d distinct, copies %.1f KB, interned %.1f KB (%.1f KB strings, %.1f KB table and ids)\n",
+        BENCH_NAMES, benchNameTable.count, copyBytes/1024.0, tableBytes/1024.0, benchNameTable.stringBytes/1024.0,
+        (tableBytes - benchNameTable.stringBytes)/1024.0);
+}
+
+//----------------------------------------------------------------
+// search.c over a generated clip list, one op is one keystroke unless said otherwise
+
+static const char* searchActions[] = { "Walk", "Run", "Jump", "Idle", "Turn", "Crouch", "Kick", "Punch", "Dance", "Climb" };
+static const char* searchDirections[] = { "Forward", "Back", "Left", "Right" };
+
+static char (*searchNames)[40] = NULL;
+static const char** searchNamePointers = NULL;
+static SearchIndex benchSearch = { 0 };
+
+static void GenerateSearchNames(void)
+{
+    searchNames = (char (*)[40])RL_MALLOC(BENCH_SEARCH_NAMES*sizeof(searchNames[0]));
+    searchNamePointers = (const char**)RL_MALLOC(BENCH_SEARCH_NAMES*sizeof(char*));
+
+    for (int i = 0; i < BENCH_SEARCH_NAMES; i++)
+    {
+        snprintf(searchNames[i], sizeof(searchNames[i]), "Subject%03d_%s_%s_%02d", (i/400)%1000, searchActions[i%10], searchDirections[(i/10)%4], (i/40)%10);
+        searchNamePointers[i] = searchNames[i];
+    }
+
+    benchSearch = LoadSearchIndex(searchNamePointers, BENCH_SEARCH_NAMES);
+}
+
+static void UnloadSearchNames(void)
+{
+    UnloadSearchIndex(benchSearch);
+    RL_FREE(searchNamePointers);
+    RL_FREE(searchNames);
+}
+
+// One op is one name
+static void BenchSearchBuild(void)
+{
+    SearchIndex index = LoadSearchIndex(searchNamePointers, BENCH_SEARCH_NAMES);
+    sink += (float)index.resultCount;
+    UnloadSearchIndex(index);
+}
+
+// Typing "kickleft" and clearing it, 9 updates
+static void BenchSearchTyping(void)
+{
+    static const char query[] = "kickleft";
+    char typed[sizeof(query)] = { 0 };
+
+    for (int i = 0; i < (int)sizeof(query) - 1; i++)
+    {
+        typed[i] = query[i];
+        UpdateSearch(&benchSearch, typed);
+        sink += (float)benchSearch.resultCount;
+    }
+
+    UpdateSearch(&benchSearch, "");
+}
+
+// The slowest keystroke, the first one filters every name
+static void BenchSearchFirstKey(void)
+{
+    UpdateSearch(&benchSearch, "");
+    UpdateSearch(&benchSearch, "k");
+    sink += (float)benchSearch.resultCount;
+}
+
+// Changing the first character refilters from the empty query
+static void BenchSearchEdit(void)
+{
+    static bool isAlternate = false;
+    isAlternate = !isAlternate;
+
+    UpdateSearch(&benchSearch, isAlternate ? "jump_back" : "dump_back");
+    sink += (float)benchSearch.resultCount;
+}
+
+//----------------------------------------------------------------
+// listview.c with file dialog row heights, one op is one frame unless said otherwise
+
+static int benchListRows = 0;
+static ListView benchListView = { 0 };
+static float* benchListHeights = NULL;
+
+// Every fifth row is a .glb with a thumbnail
+static void LoadBenchListView(int count)
+{
+    benchListRows = count;
+    benchListHeights = (float*)RL_MALLOC(count*sizeof(float));
+
+    for (int i = 0; i < count; i++) benchListHeights[i] = (i%5 == 0) ? 40.0f : 24.0f;
+
+    benchListView = LoadListViewHeights(benchListHeights, count);
+}
+
+static void UnloadBenchListView(void)
+{
+    UnloadListView(benchListView);
+    RL_FREE(benchListHeights);
+}
+
+// One op is one row
+static void BenchListViewBuild(void)
+{
+    ListView view = LoadListViewHeights(benchListHeights, benchListRows);
+    sink += (float)view.bandCount;
+    UnloadListView(view);
+}
+
+// Jumps to a new scroll offset and visits the visible rows, what a frame does before drawing
+static void BenchListViewFrame(void)
+{
+    static unsigned int seed = 1;
+    seed = seed*1664525u + 1013904223u;
+
+    const float contentHeight = GetListViewContentHeight(&benchListView);
+    ScrollListView(&benchListView, (seed >> 8)/16777216.0f*contentHeight, BENCH_LIST_VIEW_HEIGHT);
+
+    ListViewInput input = { 0 };
+    input.move = (seed & 256) ? LIST_VIEW_MOVE_PAGE_DOWN : LIST_VIEW_MOVE_DOWN;
+    UpdateListView(&benchListView, BENCH_LIST_VIEW_HEIGHT, input);
+
+    float y = benchListView.firstTop;
+    for (int row = benchListView.first; row < benchListView.last; row++)
+    {
+        y += GetListViewRowHeight(&benchListView, row);
+    }
+
+    sink += y;
+}
+
+//----------------------------------------------------------------
+// dirscan.c, one op is one sort or one scan of the whole directory
+
+static const char* dirPrefixes[] = { "character", "prop", "scene", "walk", "run", "texture", "level", "ui" };
+static const char* dirExtensions[] = { ".glb", ".gltf", ".png", ".txt", ".bin", ".json", "" };
+
+static DirectoryScan benchDir = { 0 };
+static DirectoryEntry* benchDirUnsorted = NULL;     // Scan order, restored before each sort
+static DirectorySortMode benchSortMode = DIRECTORY_SORT_NAME;
+
+static const char* benchDirPath = NULL;
+static bool benchReadInfo = false;
+
+static DirectoryCache benchCache = { 0 };
+
+static char** benchStatPaths = NULL;
+static int benchStatCount = 0;
+static long long benchStatCalls = 0;
+
+// A listing filled in place of a scan: shuffled names sharing long prefixes, one in fifty a directory
+static void GenerateDirectory(void)
+{
+    benchDir = (DirectoryScan){ 0 };
+    benchDir.count = benchDir.capacity = BENCH_DIR_ENTRIES;
+    benchDir.entries = (DirectoryEntry*)RL_MALLOC(BENCH_DIR_ENTRIES*sizeof(DirectoryEntry));
+    benchDir.poolCapacity = BENCH_DIR_ENTRIES*48;
+    benchDir.pool = (char*)RL_MALLOC(benchDir.poolCapacity);
+    benchDir.hasInfo = true;
+
+    for (int i = 0; i < BENCH_DIR_ENTRIES; i++)
+    {
+        DirectoryEntry* entry = &benchDir.entries[i];
+        const int id = rand()%1000000;
+        const bool isDirectory = (rand()%50 == 0);
+        const char* extension = isDirectory ? "" : dirExtensions[rand()%7];
+
+        const int length = snprintf(benchDir.pool + benchDir.poolSize, 48, "/bench/%s_%06d%s", dirPrefixes[rand()%8], id, extension);
+
+        entry->pathOffset = (int)benchDir.poolSize;
+        entry->nameOffset = entry->pathOffset + 7;
+        entry->extensionOffset = entry->pathOffset + length - (int)strlen(extension);
+        entry->isDirectory = isDirectory;
+        entry->size = isDirectory ? 0 : (long long)rand()*rand()%100000000;
+        entry->modTime = 1700000000 + rand()%10000000;
+
+        benchDir.poolSize += length + 1;
+    }
+
+    benchDirUnsorted = (DirectoryEntry*)RL_MALLOC(BENCH_DIR_ENTRIES*sizeof(DirectoryEntry));
+    memcpy(benchDirUnsorted, benchDir.entries, BENCH_DIR_ENTRIES*sizeof(DirectoryEntry));
+}
+
+static void UnloadGeneratedDirectory(void)
+{
+    UnloadDirectoryScan(benchDir);
+    RL_FREE(benchDirUnsorted);
+}
+
+// The copy back is 1.6 MB, a few percent of the sort
+static void BenchDirectorySort(void)
+{
+    memcpy(benchDir.entries, benchDirUnsorted, benchDir.count*sizeof(DirectoryEntry));
+    benchDir.isSorted = false;
+    SortDirectoryScan(&benchDir, benchSortMode);
+    sink += (float)benchDir.entries[0].nameOffset;
+}
+
+static DirectoryScan ScanDirectory(const char* path, bool readInfo)
+{
+    DirectoryScan scan = LoadDirectoryScan(path, NULL, readInfo);
+    while (scan.isScanning) UpdateDirectoryScan(&scan);
+
+    return scan;
+}
+
+static void BenchDirectoryScan(void)
+{
+    DirectoryScan scan = ScanDirectory(benchDirPath, benchReadInfo);
+    sink += (float)scan.count;
+    UnloadDirectoryScan(scan);
+}
+
+// Coming back to a directory the file dialog left, taken from the cache and stored again on leaving
+static void BenchDirectoryCacheReturn(void)
+{
+    DirectoryScan scan = { 0 };
+    if (!TakeCachedDirectory(&benchCache, benchDirPath, NULL, false, &scan)) scan = ScanDirectory(benchDirPath, false);
+
+    sink += (float)scan.count;
+    StoreCachedDirectory(&benchCache, &scan);
+}
+
+static bool IsStatDirectory(const char* path)
+{
+    struct stat info;
+    benchStatCalls++;
+    return (stat(path, &info) == 0) && S_ISDIR(info.st_mode);
+}
+
+static bool IsStatFile(const char* path)
+{
+    struct stat info;
+    benchStatCalls++;
+    return (stat(path, &info) == 0);
+}
+
+// How the file dialog compared paths before, DirectoryExists() and FileExists() on both sides of every compare
+static int CompareStatPaths(const void* a, const void* b)
+{
+    const char* pathA = *(const char* const*)a;
+    const char* pathB = *(const char* const*)b;
+
+    const bool isDirectoryA = IsStatDirectory(pathA);
+    const bool isDirectoryB = IsStatDirectory(pathB);
+
+    if (isDirectoryA && !isDirectoryB) return -1;
+    if (!isDirectoryA && isDirectoryB) return 1;
+
+    if (!IsStatFile(pathA)) return 1;
+    if (!IsStatFile(pathB)) return -1;
+
+    return strcmp(pathA, pathB);
+}
+
+static void BenchDirectoryStatSort(void)
+{
+    qsort(benchStatPaths, benchStatCount, sizeof(char*), CompareStatPaths);
+    sink += (float)benchStatPaths[0][0];
+
+    // Back to an order qsort has to work on
+    for (int i = benchStatCount - 1; i > 0; i--)
+    {
+        const int j = rand()%(i + 1);
+        char* path = benchStatPaths[i];
+        benchStatPaths[i] = benchStatPaths[j];
+        benchStatPaths[j] = path;
+    }
+}
+
+// Empty files named like the generated listing, the directory must not exist yet
+static bool WriteBenchDirectory(const char* path, int count)
+{
+    if (MakeBenchDirectory(path) != 0) return false;
+
+    for (int i = 0; i < count; i++)
+    {
+        FILE* file = fopen(TextFormat("%s/%s_%06d%s", path, dirPrefixes[i%8], i, dirExtensions[i%7]), "wb");
+        if (file == NULL) return false;
+        fclose(file);
+    }
+
+    return true;
+}
+
+static void RemoveBenchDirectoryFiles(const char* path, int count)
+{
+    for (int i = 0; i < count; i++) remove(TextFormat("%s/%s_%06d%s", path, dirPrefixes[i%8], i, dirExtensions[i%7]));
+    RemoveBenchDirectory(path);
+}
+
+//----------------------------------------------------------------
+// Animation, one op is one frame of the first clip
+
+static ModelAnimation* NextAnimationFrame(void)
+{
+    ModelAnimation* anim = &input.anims[0];
+    input.frame = (input.frame + 1) % anim->frameCount;
+
+    return anim;
+}
+
+// DrawModelBones() without the draw calls
+static void BenchBonePositions(void)
+{
+    const ModelAnimation* anim = NextAnimationFrame();
+    const Transform* pose = anim->framePoses[input.frame];
+
+    for (int i = 0; i < anim->boneCount; i++) input.positions[i] = pose[i].translation;
+
+    Vector3TransformBatch(input.positions, input.positions, anim->boneCount, &mathB);
+
+    for (int i = 0; i < anim->boneCount - 1; i++)
+    {
+        const int parent = anim->bones[i].parent;
+        if (parent >= 0) sink += input.positions[parent].x - input.positions[i].x;
+    }
+}
+
+// Pose matrices of one frame, the CPU part of UpdateModelAnimation() before skinning
+static void BenchPoseSampling(void)
+{
+    const ModelAnimation* anim = NextAnimationFrame();
+    const Transform* pose = anim->framePoses[input.frame];
+
+    for (int i = 0; i < anim->boneCount; i++) input.rotations[i] = pose[i].rotation;
+
+    QuaternionToMatrixBatch(input.poses, input.rotations, anim->boneCount);
+
+    for (int i = 0; i < anim->boneCount; i++)
+    {
+        Matrix* m = &input.poses[i];
+        const Vector3 s = pose[i].scale;
+        const Vector3 t = pose[i].translation;
+
+        m->m0 *= s.x; m->m1 *= s.x; m->m2  *= s.x;
+        m->m4 *= s.y; m->m5 *= s.y; m->m6  *= s.y;
+        m->m8 *= s.z; m->m9 *= s.z; m->m10 *= s.z;
+        m->m12 = t.x; m->m13 = t.y; m->m14 = t.z;
+    }
+
+    sink += input.poses[anim->boneCount - 1].m12;
+}
+
+//----------------------------------------------------------------
+// Scene graph updates
+
+static void BenchSceneRoot(void)
+{
+    tick++;
+    SetSceneRootTransform(&input.graph, Vector3Zero(), (Vector3){ 0.0f, (float)(tick & 255), 0.0f }, Vector3One());
+    UpdateSceneGraph(&input.graph);
+    sink += input.graph.worlds[SCENE_ROOT].m0;
+}
+
+static void BenchSceneLeaf(void)
+{
+    tick++;
+    const int node = input.leafNode;
+    SetSceneNodeTransform(&input.graph, node, (Vector3){ (float)(tick & 15), 0.0f, 0.0f }, input.graph.rotations[node], input.graph.scales[node]);
+    UpdateSceneGraph(&input.graph);
+    sink += input.graph.worlds[node].m12;
+}
+
+static void BenchSceneSubtree(void)
+{
+    tick++;
+    const int node = input.topNode;
+    SetSceneNodeTransform(&input.graph, node, (Vector3){ (float)(tick & 15), 0.0f, 0.0f }, input.graph.rotations[node], input.graph.scales[node]);
+    UpdateSceneGraph(&input.graph);
+    sink += (float)input.graph.changedCount;
+}
+
+//----------------------------------------------------------------
+// Loading, one op is one load and unload
+
+static void BenchParseJson(void)
+{
+    GlbFile glb = OpenGlbFile(input.fileName);
+    cgltf_data* data = ParseGlbJson(&glb);
+
+    if (data != NULL) sink += (float)data->nodes_count;
+
+    UnloadGlbData(data);
+    CloseGlbFile(&glb);
+}
+
+static void BenchLoadSceneGraph(void)
+{
+    Arena arena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+    NameTable names = InitNameTable(&arena, 0);
+    SceneGraph graph = LoadSceneGraph(input.fileName, &arena, &names);
+
+    sink += (float)graph.nodeCount;
+    UnloadArena(arena);
+}
+
+static void BenchLoadAnimations(void)
+{
+    int count = 0;
+    ModelAnimation* anims = LoadModelAnimations(input.fileName, &count);
+    sink += (float)count;
+    UnloadModelAnimations(anims, count);
+}
+
+//----------------------------------------------------------------
+// Directory indexing, one op is one file
+
+static FilePathList benchIndexFiles = { 0 };
+static size_t benchIndexBytes = 0;              // Header and JSON bytes read by the last pass
+
+// What the file dialog would do on one thread
+static void BenchIndexSerial(void)
+{
+    benchIndexBytes = 0;
+
+    for (unsigned int i = 0; i < benchIndexFiles.count; i++)
+    {
+        GlbStats stats = { 0 };
+        if (ReadGlbStats(benchIndexFiles.paths[i], &stats)) sink += (float)stats.meshCount;
+        benchIndexBytes += stats.bytesRead;
+    }
+}
+
+static void BenchIndexParallel(void)
+{
+    GlbIndex index = LoadGlbIndex(benchIndexFiles);
+
+    // Polled like a frame loop would, a spinning main thread takes a core from the workers
+    while (IsGlbIndexBusy(index))
+    {
+        WaitMilliseconds(0.1);
+        UpdateGlbIndex(&index);
+    }
+
+    benchIndexBytes = index.bytesRead;
+    sink += (float)index.completedCount;
+    UnloadGlbIndex(index);
+}
+
+//----------------------------------------------------------------
+// Synthetic inputs
+
+static void WriteUint32(FILE* file, unsigned int value)
+{
+    const unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+    fwrite(bytes, 1, 4, file);
+}
+
+// .glb holding a complete 4-ary node tree with TRS values, and a BIN chunk of zeros when binLength > 0
+static bool WriteSyntheticGlb(const char* fileName, int nodeCount, int binLength)
+{
+    size_t capacity = (size_t)nodeCount*160 + 256;
+    char* json = (char*)malloc(capacity);
+    size_t length = 0;
+
+    length += sprintf(json + length, "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[");
+
+    for (int i = 0; i < nodeCount; i++)
+    {
+        length += sprintf(json + length, "%s{\"name\":\"node_%d\",\"translation\":[%.3f,%.3f,%.3f],\"rotation\":[0,%.4f,0,%.4f]",
+            (i > 0) ? "," : "", i, GetRandom(), GetRandom(), GetRandom(), sinf(0.1f*i), cosf(0.1f*i));
+
+        if (4*i + 1 < nodeCount)
+        {
+            length += sprintf(json + length, ",\"children\":[");
+            for (int c = 4*i + 1; (c <= 4*i + 4) && (c < nodeCount); c++) length += sprintf(json + length, "%s%d", (c > 4*i + 1) ? "," : "", c);
+            length += sprintf(json + length, "]");
+        }
+
+        length += sprintf(json + length, "}");
+    }
+
+    length += sprintf(json + length, "]}");
+
+    while (length % 4 != 0) json[length++] = ' ';
+
+    FILE* file = fopen(fileName, "wb");
+
+    if (file == NULL)
+    {
+        free(json);
+        return false;
+    }
+
+    WriteUint32(file, 0x46546C67);
+    WriteUint32(file, 2);
+    WriteUint32(file, (unsigned int)(12 + 8 + length + ((binLength > 0) ? 8 + binLength : 0)));
+    WriteUint32(file, (unsigned int)length);
+    WriteUint32(file, 0x4E4F534A);
+    fwrite(json, 1, length, file);
+
+    if (binLength > 0)
+    {
+        static const unsigned char zeros[1024] = { 0 };
+
+        WriteUint32(file, (unsigned int)binLength);
+        WriteUint32(file, 0x004E4942);
+        for (int written = 0; written < binLength; written += (int)sizeof(zeros)) fwrite(zeros, 1, ((binLength - written) < (int)sizeof(zeros)) ? (binLength - written) : sizeof(zeros), file);
+    }
+
+    const bool isWritten = (fclose(file) == 0);
+    free(json);
+
+    return isWritten;
+}
+
+// A chain of bones with random poses, allocated like LoadModelAnimations() does
+static ModelAnimation* GenerateAnimation(int boneCount, int frameCount)
+{
+    ModelAnimation* anim = (ModelAnimation*)RL_CALLOC(1, sizeof(ModelAnimation));
+    anim->boneCount = boneCount;
+    anim->frameCount = frameCount;
+    anim->bones = (BoneInfo*)RL_CALLOC(boneCount, sizeof(BoneInfo));
+    anim->framePoses = (Transform**)RL_CALLOC(frameCount, sizeof(Transform*));
+    strcpy(anim->name, "synthetic");
+
+    for (int i = 0; i < boneCount; i++)
+    {
+        snprintf(anim->bones[i].name, sizeof(anim->bones[i].name), "bone_%d", i);
+        anim->bones[i].parent = (i == 0) ? -1 : (i - 1)/2;
+    }
+
+    for (int f = 0; f < frameCount; f++)
+    {
+        anim->framePoses[f] = (Transform*)RL_MALLOC(boneCount*sizeof(Transform));
+
+        for (int i = 0; i < boneCount; i++)
+        {
+            anim->framePoses[f][i].translation = (Vector3){ GetRandom(), GetRandom(), GetRandom() };
+            anim->framePoses[f][i].rotation = (Quaternion){ GetRandom(), GetRandom(), GetRandom(), GetRandom() };
+            anim->framePoses[f][i].scale = Vector3One();
+        }
+    }
+
+    return anim;
+}
+
+//----------------------------------------------------------------
+// Measurement
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int resultCount = 0;
+static int sampleCount = BENCH_DEFAULT_SAMPLES;
+static const char* filter = NULL;
+
+static bool IsMeasured(const char* name)
+{
+    return (filter == NULL) || (strstr(name, filter) != NULL);
+}
+
+static void Measure(const char* name, const char* inputName, BenchFunc func, int opsPerCall)
+{
+    if (!IsMeasured(name)) return;
+    if (resultCount == BENCH_MAX_RESULTS) return;
+
+    // Warm up and find how many calls fill a sample
+    long long iterations = 1;
+    while (true)
+    {
+        const double start = GetSeconds();
+        for (long long i = 0; i < iterations; i++) func();
+        const double elapsed = GetSeconds() - start;
+
+        if (elapsed >= BENCH_SAMPLE_TIME) break;
+        iterations = (elapsed > 0.0) ? (long long)(iterations*fmin(BENCH_SAMPLE_TIME*1.2/elapsed, 16.0)) + 1 : iterations*16;
+    }
+
+    double* samples = (double*)malloc(sampleCount*sizeof(double));
+    double sum = 0.0;
+
+    for (int s = 0; s < sampleCount; s++)
+    {
+        const double start = GetSeconds();
+        for (long long i = 0; i < iterations; i++) func();
+        samples[s] = (GetSeconds() - start)*1e9/((double)iterations*opsPerCall);
+        sum += samples[s];
+    }
+
+    const double mean = sum/sampleCount;
+    double variance = 0.0;
+    for (int s = 0; s < sampleCount; s++) variance += (samples[s] - mean)*(samples[s] - mean);
+    variance /= (sampleCount > 1) ? (sampleCount - 1) : 1;
+
+    qsort(samples, sampleCount, sizeof(double), CompareDouble);
+
+    BenchResult* result = &results[resultCount++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    snprintf(result->input, sizeof(result->input), "%s", inputName);
+    result->samples = sampleCount;
+    result->iterations = iterations;
+    result->medianNs = (sampleCount % 2 == 1) ? samples[sampleCount/2] : 0.5*(samples[sampleCount/2 - 1] + samples[sampleCount/2]);
+    result->meanNs = mean;
+    result->stddevNs = sqrt(variance);
+    result->minNs = samples[0];
+
+    free(samples);
+
+    printf("%-24s %-20s %12.1f %12.1f %10.1f %6.1f%% %12.1f\n", result->name, result->input, result->medianNs, result->meanNs,
+        result->stddevNs, (mean > 0.0) ? 100.0*result->stddevNs/mean : 0.0, result->minNs);
+}
+
+static void RunInputKernels(const char* inputName)
+{
+    if (input.animCount > 0)
+    {
+        int boneCount = 0;
+        for (int i = 0; i < input.animCount; i++) if (input.anims[i].boneCount > boneCount) boneCount = input.anims[i].boneCount;
+
+        if (boneCount > input.boneCapacity)
+        {
+            input.boneCapacity = boneCount;
+            input.positions = (Vector3*)RL_REALLOC(input.positions, boneCount*sizeof(Vector3));
+            input.poses = (Matrix*)RL_REALLOC(input.poses, boneCount*sizeof(Matrix));
+            input.rotations = (Quaternion*)RL_REALLOC(input.rotations, boneCount*sizeof(Quaternion));
+        }
+
+        if ((input.anims[0].boneCount > 0) && (input.anims[0].frameCount > 0))
+        {
+            input.frame = 0;
+            Measure("bones/positions", inputName, BenchBonePositions, 1);
+            Measure("anim/pose_sampling", inputName, BenchPoseSampling, 1);
+        }
+    }
+
+    if (input.isGlb)
+    {
+        input.graphArena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+        input.graphNames = InitNameTable(&input.graphArena, 0);
+        input.graph = LoadSceneGraph(input.fileName, &input.graphArena, &input.graphNames);
+
+        if (input.graph.nodeCount > 1)
+        {
+            // The last node in depth-first order has no children
+            input.topNode = 1;
+            input.leafNode = input.graph.nodeCount - 1;
+
+            Measure("scene/update_root", inputName, BenchSceneRoot, 1);
+            Measure("scene/update_leaf", inputName, BenchSceneLeaf, 1);
+            Measure("scene/update_subtree", inputName, BenchSceneSubtree, 1);
+        }
+
+        UnloadArena(input.graphArena);
+        input.graphArena = (Arena){ 0 };
+        input.graph = (SceneGraph){ 0 };
+
+        Measure("load/parse_json", inputName, BenchParseJson, 1);
+        Measure("load/scene_graph", inputName, BenchLoadSceneGraph, 1);
+        if (input.hasFileAnimations) Measure("load/animations", inputName, BenchLoadAnimations, 1);
+    }
+}
+
+// Scans with and without the entry info, then the old and the keyed sort of the same entries
+static void RunDirectoryKernels(const char* inputName)
+{
+    benchReadInfo = false;
+    Measure("dir/scan", inputName, BenchDirectoryScan, 1);
+    benchReadInfo = true;
+    Measure("dir/scan_info", inputName, BenchDirectoryScan, 1);
+
+    if (IsMeasured("dir/cache_return"))
+    {
+        benchCache = LoadDirectoryCache(DIRECTORY_CACHE_MAX_ENTRIES, DIRECTORY_CACHE_MAX_BYTES);
+
+        DirectoryScan scan = ScanDirectory(benchDirPath, false);
+        StoreCachedDirectory(&benchCache, &scan);
+
+        Measure("dir/cache_return", inputName, BenchDirectoryCacheReturn, 1);
+
+        UnloadDirectoryCache(benchCache);
+        benchCache = (DirectoryCache){ 0 };
+    }
+
+    if (!IsMeasured("dir/sort_stat")) return;
+
+    DirectoryScan scan = ScanDirectory(benchDirPath, false);
+    const int scanStatCount = scan.statCount;
+    UnloadDirectoryScan(scan);
+
+    scan = ScanDirectory(benchDirPath, true);
+
+    benchStatCount = (scan.count < BENCH_DIR_STAT_ENTRIES) ? scan.count : BENCH_DIR_STAT_ENTRIES;
+    benchStatPaths = (char**)RL_MALLOC((benchStatCount + 1)*sizeof(char*));
+    for (int i = 0; i < benchStatCount; i++) benchStatPaths[i] = (char*)GetDirectoryEntryPath(&scan, i);
+
+    if (benchStatCount > 1)
+    {
+        benchStatCalls = 0;
+        qsort(benchStatPaths, benchStatCount, sizeof(char*), CompareStatPaths);
+        const long long sortStatCalls = benchStatCalls;
+
+        char statInput[64];
+        snprintf(statInput, sizeof(statInput), "%s, %d", inputName, benchStatCount);
+
+        Measure("dir/sort_stat", statInput, BenchDirectoryStatSort, 1);
+
+        // The keyed sort of the same entries, sharing the pool of the scan
+        benchDir = (DirectoryScan){ 0 };
+        benchDir.count = benchDir.capacity = benchStatCount;
+        benchDir.entries = (DirectoryEntry*)RL_MALLOC(benchStatCount*sizeof(DirectoryEntry));
+        benchDir.pool = scan.pool;
+        benchDirUnsorted = (DirectoryEntry*)RL_MALLOC(benchStatCount*sizeof(DirectoryEntry));
+        memcpy(benchDirUnsorted, scan.entries, benchStatCount*sizeof(DirectoryEntry));
+        benchSortMode = DIRECTORY_SORT_NAME;
+
+        Measure("dir/sort_name", statInput, BenchDirectorySort, 1);
+
+        RL_FREE(benchDir.entries);
+        RL_FREE(benchDirUnsorted);
+        benchDir = (DirectoryScan){ 0 };
+        benchDirUnsorted = NULL;
+
+        printf("%-24s %-20s %d entries, stat() calls: scan %d, scan with info %d, stat sort of %d %lld, keyed sort 0\n",
+            "dir/stat_calls", inputName, scan.count, scanStatCount, scan.statCount, benchStatCount, sortStatCalls);
+    }
+
+    RL_FREE(benchStatPaths);
+    benchStatPaths = NULL;
+    UnloadDirectoryScan(scan);
+}
+
+//----------------------------------------------------------------
+// JSON results and baseline
+
+static bool WriteResults(const char* fileName)
+{
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    // One result per line, LoadBaseline() reads it back line by line
+    fprintf(file, "{\n  \"simd\": \"%s\",\n  \"samples\": %d,\n  \"results\": [\n", GetMathSimdName(GetMathSimdLevel()), sampleCount);
+
+    for (int i = 0; i < resultCount; i++)
+    {
+        const BenchResult* r = &results[i];
+        fprintf(file, "    { \"name\": \"%s\", \"input\": \"%s\", \"median_ns\": %.3f, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f, \"iterations\": %lld }%s\n",
+            r->name, r->input, r->medianNs, r->meanNs, r->stddevNs, r->minNs, r->iterations, (i < resultCount - 1) ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+
+    return true;
+}
+
+static bool ReadJsonString(const char* line, const char* key, char* out, int size)
+{
+    const char* p = strstr(line, key);
+    if (p == NULL) return false;
+
+    p = strchr(p + strlen(key), '"');
+    if (p == NULL) return false;
+    p++;
+
+    int n = 0;
+    while ((*p != '"') && (*p != '\0') && (n < size - 1)) out[n++] = *p++;
+    out[n] = '\0';
+
+    return true;
+}
+
+static int LoadBaseline(const char* fileName, BaselineEntry* entries, int capacity)
+{
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL) return -1;
+
+    int count = 0;
+    char line[1024];
+
+    while ((fgets(line, sizeof(line), file) != NULL) && (count < capacity))
+    {
+        BaselineEntry entry = { 0 };
+        const char* median = strstr(line, "\"median_ns\":");
+
+        if ((median == NULL) || !ReadJsonString(line, "\"name\":", entry.name, sizeof(entry.name)) ||
+            !ReadJsonString(line, "\"input\":", entry.input, sizeof(entry.input))) continue;
+
+        entry.medianNs = atof(median + strlen("\"median_ns\":"));
+        entries[count++] = entry;
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+// Returns the number of kernels over the threshold
+static int CompareBaseline(const BaselineEntry* entries, int count, double threshold)
+{
+    int regressions = 0;
+
+    printf("\n%-24s %-20s %12s %12s %9s\n", "kernel", "input", "baseline ns", "median ns", "change");
+
+    for (int i = 0; i < resultCount; i++)
+    {
+        const BenchResult* r = &results[i];
+        const BaselineEntry* base = NULL;
+
+        for (int k = 0; k < count; k++)
+        {
+            if ((strcmp(entries[k].name, r->name) == 0) && (strcmp(entries[k].input, r->input) == 0)) base = &entries[k];
+        }
+
+        if ((base == NULL) || (base->medianNs <= 0.0))
+        {
+            printf("%-24s %-20s %12s %12.1f %9s\n", r->name, r->input, "-", r->medianNs, "new");
+            continue;
+        }
+
+        const double change = 100.0*(r->medianNs - base->medianNs)/base->medianNs;
+        const bool isRegression = change > threshold;
+
+        if (isRegression) regressions++;
+
+        printf("%-24s %-20s %12.1f %12.1f %+8.1f%%%s\n", r->name, r->input, base->medianNs, r->medianNs, change, isRegression ? "  REGRESSION" : "");
+    }
+
+    return regressions;
+}
+
+//----------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char* inputs[BENCH_MAX_INPUTS] = { 0 };
+    int inputCount = 0;
+    const char* jsonFileName = NULL;
+    const char* baselineFileName = NULL;
+    const char* directory = NULL;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if ((strcmp(argv[i], "--glb") == 0) && hasValue) { if (inputCount < BENCH_MAX_INPUTS) inputs[inputCount++] = argv[++i]; }
+        else if ((strcmp(argv[i], "--json") == 0) && hasValue) jsonFileName = argv[++i];
+        else if ((strcmp(argv[i], "--baseline") == 0) && hasValue) baselineFileName = argv[++i];
+        else if ((strcmp(argv[i], "--threshold") == 0) && hasValue) threshold = atof(argv[++i]);
+        else if ((strcmp(argv[i], "--samples") == 0) && hasValue) sampleCount = (atoi(argv[++i]) > 1) ? atoi(argv[i]) : 2;
+        else if ((strcmp(argv[i], "--filter") == 0) && hasValue) filter = argv[++i];
+        else if ((strcmp(argv[i], "--dir") == 0) && hasValue) directory = argv[++i];
+        else
+        {
+            printf("usage: %s [--glb file.glb]... [--dir directory] [--json out.json] [--baseline base.json] [--threshold percent] [--samples n] [--filter text]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    srand(1);
+
+    mathA = MatrixRotateV((Vector3){ 10.0f, 20.0f, 30.0f });
+    mathB = MatrixMultiply(MatrixTranslateV((Vector3){ 1.0f, 2.0f, 3.0f }), MatrixRotateV((Vector3){ 0.0f, 45.0f, 0.0f }));
+    mathPoint = (Vector3){ 1.0f, 2.0f, 3.0f };
+    mathAngles = (Vector3){ 0.1f, 0.2f, 0.3f };
+    mathQuaternion = (Quaternion){ 0.1f, 0.2f, 0.3f, 0.9f };
+
+    for (int i = 0; i < BENCH_VEC_PUSHES; i++) benchValues[i] = i;
+
+    // Spin first so the clock has ramped up before the first kernel
+    const double warmUpStart = GetSeconds();
+    while (GetSeconds() - warmUpStart < 0.2) BenchMatrixMultiply();
+
+    printf("Math batch kernels: %s, %d samples per kernel\n\n", GetMathSimdName(GetMathSimdLevel()), sampleCount);
+    printf("%-24s %-20s %12s %12s %10s %7s %12s\n", "kernel", "input", "median ns", "mean ns", "stddev", "cv", "min ns");
+
+    Measure("math/MatrixMultiply", "-", BenchMatrixMultiply, 1);
+    Measure("math/ModelTransform", "-", BenchModelTransform, 1);
+    Measure("math/Vector3Transform", "-", BenchVector3Transform, 1);
+    Measure("math/QuaternionToMatrix", "-", BenchQuaternionToMatrix, 1);
+    Measure("math/QuaternionFromEuler", "-", BenchQuaternionFromEuler, 1);
+    Measure("vec/vector_add", "-", BenchVectorAdd, BENCH_VEC_PUSHES);
+    Measure("array/push", "-", BenchArrayPush, BENCH_VEC_PUSHES);
+    Measure("array/append", "-", BenchArrayAppend, BENCH_VEC_PUSHES);
+    Measure("array/arena_push", "-", BenchArrayArenaPush, BENCH_VEC_PUSHES);
+    Measure("memory/malloc", "-", BenchMallocFree, BENCH_ALLOCATIONS);
+    Measure("memory/tracked", "-", BenchTrackedAllocFree, BENCH_ALLOCATIONS);
+    Measure("vec/clip_names", "-", BenchClipNames, 1);
+    Measure("arena/clip_names", "-", BenchArenaClipNames, 1);
+
+    Arena nameArena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+    GenerateNames(&nameArena);
+
+    Measure("names/intern", "-", BenchInternNames, BENCH_NAMES);
+    Measure("names/find", "-", BenchFindName, BENCH_NAME_QUERIES);
+    Measure("names/scan", "-", BenchScanName, BENCH_SCAN_QUERIES);
+
+    UnloadArena(nameArena);
+
+    GenerateSearchNames();
+
+    Measure("search/build", "-", BenchSearchBuild, BENCH_SEARCH_NAMES);
+    Measure("search/typing", "-", BenchSearchTyping, 9);
+    Measure("search/first_key", "-", BenchSearchFirstKey, 1);
+    Measure("search/edit", "-", BenchSearchEdit, 1);
+
+    UnloadSearchNames();
+
+    // Per frame cost should not change with the row count
+    const int listRows[] = { 1000, 100000, 1000000 };
+    const char* listRowNames[] = { "1k rows", "100k rows", "1M rows" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        LoadBenchListView(listRows[i]);
+
+        if (i == 2) Measure("listview/build", listRowNames[i], BenchListViewBuild, listRows[i]);
+        Measure("listview/frame", listRowNames[i], BenchListViewFrame, 1);
+
+        UnloadBenchListView();
+    }
+
+    // Sorting never stats, size and time use the info the scan read
+    GenerateDirectory();
+
+    const DirectorySortMode sortModes[] = { DIRECTORY_SORT_NAME, DIRECTORY_SORT_EXTENSION, DIRECTORY_SORT_SIZE };
+    const char* sortModeNames[] = { "dir/sort_name", "dir/sort_ext", "dir/sort_size" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        benchSortMode = sortModes[i];
+        Measure(sortModeNames[i], "50k entries", BenchDirectorySort, 1);
+    }
+
+    UnloadGeneratedDirectory();
+
+    // A generated local directory, --dir adds a real one such as a network mount
+    if (IsMeasured("dir/scan") || IsMeasured("dir/cache_return") || IsMeasured("dir/sort_stat"))
+    {
+        const char* benchDirectory = "bench_directory";
+
+        if (WriteBenchDirectory(benchDirectory, BENCH_DIR_ENTRIES))
+        {
+            benchDirPath = benchDirectory;
+            RunDirectoryKernels("50k local");
+        }
+        else printf("%s: could not be written, directory scans skipped\n", benchDirectory);
+
+        RemoveBenchDirectoryFiles(benchDirectory, BENCH_DIR_ENTRIES);
+
+        if (directory != NULL)
+        {
+            benchDirPath = directory;
+            RunDirectoryKernels(directory);
+        }
+    }
+
+    // Stats of a directory of small .glb files, the files are in the page cache after the first pass
+    if (IsMeasured("glb/index"))
+    {
+        const char* indexDirectory = "bench_index";
+
+        benchIndexFiles.paths = (char**)RL_CALLOC(BENCH_INDEX_FILES, sizeof(char*));
+        benchIndexFiles.capacity = BENCH_INDEX_FILES;
+
+        if (MakeBenchDirectory(indexDirectory) == 0)
+        {
+            for (int i = 0; i < BENCH_INDEX_FILES; i++)
+            {
+                const char* fileName = TextFormat("%s/model_%05d.glb", indexDirectory, i);
+                if (!WriteSyntheticGlb(fileName, BENCH_INDEX_NODES, BENCH_INDEX_BIN_SIZE)) break;
+
+                benchIndexFiles.paths[i] = (char*)RL_MALLOC(strlen(fileName) + 1);
+                strcpy(benchIndexFiles.paths[i], fileName);
+                benchIndexFiles.count++;
+            }
+        }
+
+        if (benchIndexFiles.count == BENCH_INDEX_FILES)
+        {
+            struct stat info = { 0 };
+            stat(benchIndexFiles.paths[0], &info);
+
+            const int resultStart = resultCount;
+
+            Measure("glb/index_serial", "10k files", BenchIndexSerial, BENCH_INDEX_FILES);
+            Measure("glb/index", "10k files", BenchIndexParallel, BENCH_INDEX_FILES);
+
+            for (int i = resultStart; i < resultCount; i++) printf("%-24s %-20s %.0f files/s\n", "glb/files_per_s", results[i].name, 1e9/results[i].medianNs);
+
+            printf("%-24s %-20s %.1f MB of %.1f MB read\n", "glb/index_bytes", "10k files", benchIndexBytes/1048576.0, (double)info.st_size*BENCH_INDEX_FILES/1048576.0);
+        }
+        else printf("%s: could not be written, indexing skipped\n", indexDirectory);
+
+        for (unsigned int i = 0; i < benchIndexFiles.count; i++)
+        {
+            remove(benchIndexFiles.paths[i]);
+            RL_FREE(benchIndexFiles.paths[i]);
+        }
+
+        RL_FREE(benchIndexFiles.paths);
+        benchIndexFiles = (FilePathList){ 0 };
+        RemoveBenchDirectory(indexDirectory);
+    }
+
+    // Synthetic skeleton and node tree
+    const char* syntheticFileName = "bench_synthetic.glb";
+
+    input = (BenchInput){ 0 };
+    input.anims = GenerateAnimation(BENCH_SYNTHETIC_BONES, BENCH_SYNTHETIC_FRAMES);
+    input.animCount = 1;
+    input.isGlb = WriteSyntheticGlb(syntheticFileName, BENCH_SYNTHETIC_NODES, 0);
+    input.fileName = syntheticFileName;
+
+    RunInputKernels("synthetic");
+
+    UnloadModelAnimations(input.anims, input.animCount);
+    remove(syntheticFileName);
+
+    // Real files
+    for (int i = 0; i < inputCount; i++)
+    {
+        if (!FileExists(inputs[i]))
+        {
+            printf("%s: file not found, skipped\n", inputs[i]);
+            continue;
+        }
+
+        input.fileName = inputs[i];
+        input.isGlb = true;
+        input.anims = LoadModelAnimations(inputs[i], &input.animCount);
+        input.hasFileAnimations = (input.animCount > 0);
+
+        RunInputKernels(GetFileName(inputs[i]));
+
+        UnloadModelAnimations(input.anims, input.animCount);
+        input.anims = NULL;
+        input.animCount = 0;
+    }
+
+    RL_FREE(input.positions);
+    RL_FREE(input.poses);
+    RL_FREE(input.rotations);
+
+    PrintNameMemory();
+
+    if ((jsonFileName != NULL) && !WriteResults(jsonFileName)) printf("\nFailed to write %s\n", jsonFileName);
+
+    int regressions = 0;
+
+    if (baselineFileName != NULL)
+    {
+        static BaselineEntry entries[BENCH_MAX_RESULTS];
+        const int count = LoadBaseline(baselineFileName, entries, BENCH_MAX_RESULTS);
+
+        if (count < 0) printf("\nNo baseline at %s, run make bench_baseline to record one\n", baselineFileName);
+        else
+        {
+            regressions = CompareBaseline(entries, count, threshold);
+
+            if (regressions > 0) printf("\n%d kernels slower than the baseline by more than %.1f%%\n", regressions, threshold);
+            else printf("\nNo kernel slower than the baseline by more than %.1f%%\n", threshold);
+        }
+    }
+
+    return (regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,853 @@
+/*******************************************************************************************
+*
+*   glbgen - Synthetic .glb files of a given size for stress and scaling tests
+*
+*   Runs without a window and links nothing but the C library. Every file is a skinned cylinder
+*   per mesh with its own vertices, a bone hierarchy of chains hanging off one root, clips that
+*   rotate every bone, embedded PNG textures and any number of nodes instancing each mesh. The
+*   same parameters and seed always give the same bytes. --suite writes the presets, each one
+*   moving a single parameter away from the base file, which the bench targets sweep.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLBGEN_COLUMNS          32          // Vertices around a cylinder
+#define GLBGEN_MAX_ROWS         2048        // 65536 vertices, all raylib's 16 bit indices address
+#define GLBGEN_HEIGHT           2.0f
+#define GLBGEN_FPS              30.0f
+#define GLBGEN_SPACING          1.5f        // Between instances
+
+#define GLTF_FLOAT              5126
+#define GLTF_UNSIGNED_SHORT     5123
+#define GLTF_ARRAY_BUFFER       34962
+#define GLTF_ELEMENT_BUFFER     34963
+
+typedef struct
+{
+    int vertices;               // Per mesh, split in primitives of at most GLBGEN_COLUMNS*GLBGEN_MAX_ROWS
+    int meshes;
+    int bones;                  // 0 writes unskinned meshes and no clips
+    int depth;                  // Bones from the root to the end of a chain, root included
+    int clips;
+    int frames;                 // Keyframes per clip at GLBGEN_FPS
+    int textures;
+    int textureSize;
+    int instances;              // Nodes per mesh
+    unsigned int seed;
+} GlbGenParams;
+
+typedef struct
+{
+    const char* name;
+    GlbGenParams params;
+} GlbGenPreset;
+
+typedef struct
+{
+    char* data;
+    size_t length;
+    size_t capacity;
+} ByteBuffer;
+
+// BIN chunk and the JSON arrays indexing into it
+typedef struct
+{
+    ByteBuffer bin;
+    ByteBuffer views;
+    ByteBuffer accessors;
+    int viewCount;
+    int accessorCount;
+    unsigned long long random;
+} GlbWriter;
+
+static const GlbGenParams baseParams = { 4096, 4, 32, 8, 2, 60, 2, 256, 1, 1 };
+
+// Each preset changes one parameter of baseParams, the name says which and to what
+static const GlbGenPreset presets[] = {
+    { "base",           { 4096, 4, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "vertices_1k",    { 1024, 4, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "vertices_16k",   { 16384, 4, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "vertices_64k",   { 65536, 4, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "meshes_1",       { 4096, 1, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "meshes_16",      { 4096, 16, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "meshes_64",      { 4096, 64, 32, 8, 2, 60, 2, 256, 1, 1 } },
+    { "bones_8",        { 4096, 4, 8, 8, 2, 60, 2, 256, 1, 1 } },
+    { "bones_128",      { 4096, 4, 128, 8, 2, 60, 2, 256, 1, 1 } },
+    { "bones_512",      { 4096, 4, 512, 8, 2, 60, 2, 256, 1, 1 } },
+    { "depth_2",        { 4096, 4, 128, 2, 2, 60, 2, 256, 1, 1 } },
+    { "depth_16",       { 4096, 4, 128, 16, 2, 60, 2, 256, 1, 1 } },
+    { "depth_128",      { 4096, 4, 128, 128, 2, 60, 2, 256, 1, 1 } },
+    { "clips_1",        { 4096, 4, 32, 8, 1, 60, 2, 256, 1, 1 } },
+    { "clips_16",       { 4096, 4, 32, 8, 16, 60, 2, 256, 1, 1 } },
+    { "clips_128",      { 4096, 4, 32, 8, 128, 60, 2, 256, 1, 1 } },
+    { "frames_15",      { 4096, 4, 32, 8, 2, 15, 2, 256, 1, 1 } },
+    { "frames_480",     { 4096, 4, 32, 8, 2, 480, 2, 256, 1, 1 } },
+    { "frames_3840",    { 4096, 4, 32, 8, 2, 3840, 2, 256, 1, 1 } },
+    { "textures_0",     { 4096, 4, 32, 8, 2, 60, 0, 256, 1, 1 } },
+    { "textures_8",     { 4096, 4, 32, 8, 2, 60, 8, 256, 1, 1 } },
+    { "textures_32",    { 4096, 4, 32, 8, 2, 60, 32, 256, 1, 1 } },
+    { "instances_16",   { 4096, 4, 32, 8, 2, 60, 2, 256, 16, 1 } },
+    { "instances_256",  { 4096, 4, 32, 8, 2, 60, 2, 256, 256, 1 } },
+    { "instances_4096", { 4096, 4, 32, 8, 2, 60, 2, 256, 4096, 1 } },
+};
+
+#define PRESET_COUNT    ((int)(sizeof(presets)/sizeof(presets[0])))
+
+//----------------------------------------------------------------
+// Buffers
+
+static void Reserve(ByteBuffer* buffer, size_t size)
+{
+    if (buffer->length + size <= buffer->capacity) return;
+
+    size_t capacity = (buffer->capacity > 0) ? buffer->capacity : 4096;
+    while (capacity < buffer->length + size) capacity *= 2;
+
+    buffer->data = (char*)realloc(buffer->data, capacity);
+    buffer->capacity = capacity;
+
+    if (buffer->data == NULL)
+    {
+        fprintf(stderr, "GLBGEN: Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void AppendBytes(ByteBuffer* buffer, const void* data, size_t size)
+{
+    Reserve(buffer, size);
+    memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+}
+
+static void AppendText(ByteBuffer* buffer, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int size = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    Reserve(buffer, (size_t)size + 1);
+
+    va_start(args, format);
+    vsnprintf(buffer->data + buffer->length, (size_t)size + 1, format, args);
+    va_end(args);
+
+    buffer->length += (size_t)size;
+}
+
+// Comma before every element but the first of a JSON array
+static void AppendSeparator(ByteBuffer* buffer)
+{
+    if ((buffer->length > 0) && (buffer->data[buffer->length - 1] != '[')) AppendText(buffer, ",");
+}
+
+static void AppendUint32(ByteBuffer* buffer, unsigned int value)
+{
+    const unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+    AppendBytes(buffer, bytes, 4);
+}
+
+static void AppendUint32BigEndian(ByteBuffer* buffer, unsigned int value)
+{
+    const unsigned char bytes[4] = { (unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value };
+    AppendBytes(buffer, bytes, 4);
+}
+
+static void UnloadByteBuffer(ByteBuffer buffer)
+{
+    free(buffer.data);
+}
+
+//----------------------------------------------------------------
+// Random, splitmix64 so a seed gives the same file on every platform
+
+static unsigned int GetRandomBits(GlbWriter* writer)
+{
+    unsigned long long z = (writer->random += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+
+    return (unsigned int)((z ^ (z >> 31)) >> 32);
+}
+
+// [0, 1)
+static float GetRandomFloat(GlbWriter* writer)
+{
+    return (float)(GetRandomBits(writer) >> 8)/16777216.0f;
+}
+
+//----------------------------------------------------------------
+// Buffer views and accessors
+
+static int AddView(GlbWriter* writer, const void* data, size_t size, int target)
+{
+    while (writer->bin.length % 4 != 0) AppendBytes(&writer->bin, "", 1);
+
+    AppendSeparator(&writer->views);
+    AppendText(&writer->views, "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu", writer->bin.length, size);
+    if (target != 0) AppendText(&writer->views, ",\"target\":%d", target);
+    AppendText(&writer->views, "}");
+
+    AppendBytes(&writer->bin, data, size);
+
+    return writer->viewCount++;
+}
+
+// Bounds are written for the POSITION and animation input accessors, which require them
+static int AddAccessor(GlbWriter* writer, const void* data, int count, int componentType, int components, int target, bool hasBounds)
+{
+    static const char* types[] = { "", "SCALAR", "VEC2", "VEC3", "VEC4", "", "", "", "", "", "", "", "", "", "", "", "MAT4" };
+    const size_t componentSize = (componentType == GLTF_FLOAT) ? 4 : 2;
+
+    const int view = AddView(writer, data, (size_t)count*components*componentSize, target);
+
+    AppendSeparator(&writer->accessors);
+    AppendText(&writer->accessors, "{\"bufferView\":%d,\"componentType\":%d,\"count\":%d,\"type\":\"%s\"", view, componentType, count, types[components]);
+
+    if (hasBounds)
+    {
+        const float* values = (const float*)data;
+        float min[4] = { 0 };
+        float max[4] = { 0 };
+
+        for (int c = 0; c < components; c++) min[c] = max[c] = values[c];
+
+        for (int i = 1; i < count; i++)
+        {
+            for (int c = 0; c < components; c++)
+            {
+                const float value = values[i*components + c];
+                if (value < min[c]) min[c] = value;
+                if (value > max[c]) max[c] = value;
+            }
+        }
+
+        AppendText(&writer->accessors, ",\"min\":[");
+        for (int c = 0; c < components; c++) AppendText(&writer->accessors, "%s%.9g", (c > 0) ? "," : "", min[c]);
+        AppendText(&writer->accessors, "],\"max\":[");
+        for (int c = 0; c < components; c++) AppendText(&writer->accessors, "%s%.9g", (c > 0) ? "," : "", max[c]);
+        AppendText(&writer->accessors, "]");
+    }
+
+    AppendText(&writer->accessors, "}");
+
+    return writer->accessorCount++;
+}
+
+//----------------------------------------------------------------
+// PNG, stored deflate blocks, the generator has nothing to gain from compressing
+
+static unsigned int UpdateCrc32(unsigned int crc, const unsigned char* data, size_t size)
+{
+    static unsigned int table[256] = { 0 };
+
+    if (table[1] == 0)
+    {
+        for (unsigned int n = 0; n < 256; n++)
+        {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            table[n] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static void AppendPngChunk(ByteBuffer* png, const char* type, const unsigned char* data, size_t size)
+{
+    AppendUint32BigEndian(png, (unsigned int)size);
+    AppendBytes(png, type, 4);
+    if (size > 0) AppendBytes(png, data, size);
+
+    unsigned int crc = UpdateCrc32(0, (const unsigned char*)type, 4);
+    crc = UpdateCrc32(crc, data, size);
+    AppendUint32BigEndian(png, crc);
+}
+
+// RGBA checkerboard, two colors from the seed
+static ByteBuffer GeneratePng(GlbWriter* writer, int size)
+{
+    const int tile = (size >= 8) ? size/8 : 1;
+    const unsigned char colors[2][4] = {
+        { (unsigned char)(GetRandomBits(writer) & 0xFF), (unsigned char)(GetRandomBits(writer) & 0xFF), (unsigned char)(GetRandomBits(writer) & 0xFF), 255 },
+        { (unsigned char)(GetRandomBits(writer) & 0xFF), (unsigned char)(GetRandomBits(writer) & 0xFF), (unsigned char)(GetRandomBits(writer) & 0xFF), 255 }
+    };
+
+    // Scanlines, each led by filter type 0
+    ByteBuffer raw = { 0 };
+
+    for (int y = 0; y < size; y++)
+    {
+        AppendBytes(&raw, "", 1);
+        for (int x = 0; x < size; x++) AppendBytes(&raw, colors[((x/tile) + (y/tile)) & 1], 4);
+    }
+
+    ByteBuffer zlib = { 0 };
+    AppendBytes(&zlib, "\x78\x01", 2);
+
+    unsigned int a = 1, b = 0;
+
+    for (size_t offset = 0; offset < raw.length; offset += 65535)
+    {
+        const size_t length = ((raw.length - offset) < 65535) ? (raw.length - offset) : 65535;
+        const unsigned char header[5] = { (unsigned char)((offset + length == raw.length) ? 1 : 0),
+            (unsigned char)length, (unsigned char)(length >> 8), (unsigned char)~length, (unsigned char)(~length >> 8) };
+
+        AppendBytes(&zlib, header, 5);
+        AppendBytes(&zlib, raw.data + offset, length);
+
+        for (size_t i = offset; i < offset + length; i++)
+        {
+            a = (a + (unsigned char)raw.data[i])%65521;
+            b = (b + a)%65521;
+        }
+    }
+
+    AppendUint32BigEndian(&zlib, (b << 16) | a);
+
+    unsigned char ihdr[13] = { 0 };
+    ihdr[0] = (unsigned char)(size >> 24); ihdr[1] = (unsigned char)(size >> 16); ihdr[2] = (unsigned char)(size >> 8); ihdr[3] = (unsigned char)size;
+    memcpy(ihdr + 4, ihdr, 4);
+    ihdr[8] = 8;        // Bit depth
+    ihdr[9] = 6;        // RGBA
+
+    ByteBuffer png = { 0 };
+    AppendBytes(&png, "\x89PNG\r\n\x1A\n", 8);
+    AppendPngChunk(&png, "IHDR", ihdr, sizeof(ihdr));
+    AppendPngChunk(&png, "IDAT", (const unsigned char*)zlib.data, zlib.length);
+    AppendPngChunk(&png, "IEND", NULL, 0);
+
+    UnloadByteBuffer(zlib);
+    UnloadByteBuffer(raw);
+
+    return png;
+}
+
+//----------------------------------------------------------------
+// Skeleton, bone 0 is the root and the rest are chains of depth - 1 bones under it
+
+static int GetChainLength(GlbGenParams params)
+{
+    return (params.depth > 1) ? params.depth - 1 : 1;
+}
+
+static int GetChainCount(GlbGenParams params)
+{
+    return (params.bones > 1) ? (params.bones - 1 + GetChainLength(params) - 1)/GetChainLength(params) : 0;
+}
+
+static int GetBoneParent(GlbGenParams params, int bone)
+{
+    if (bone == 0) return -1;
+
+    return ((bone - 1)%GetChainLength(params) == 0) ? 0 : bone - 1;
+}
+
+// Chain starts fan out around the root, the rest go up
+static void GetBoneTranslation(GlbGenParams params, int bone, float* translation)
+{
+    const float segment = GLBGEN_HEIGHT/(GetChainLength(params) + 1);
+
+    translation[0] = translation[1] = translation[2] = 0.0f;
+
+    if (bone == 0) return;
+
+    translation[1] = segment;
+
+    if (GetBoneParent(params, bone) == 0)
+    {
+        const float angle = 6.2831853f*((bone - 1)/GetChainLength(params))/GetChainCount(params);
+        translation[0] = 0.25f*cosf(angle);
+        translation[2] = 0.25f*sinf(angle);
+    }
+}
+
+// The two bones of the vertex's chain around its height
+static void GetVertexJoints(GlbGenParams params, int column, float height, unsigned short* joints, float* weights)
+{
+    memset(joints, 0, 4*sizeof(unsigned short));
+    memset(weights, 0, 4*sizeof(float));
+
+    const int chainCount = GetChainCount(params);
+
+    if (chainCount == 0)
+    {
+        weights[0] = 1.0f;
+        return;
+    }
+
+    const int chain = column%chainCount;
+    const int first = 1 + chain*GetChainLength(params);
+    const int last = ((first + GetChainLength(params)) < params.bones) ? first + GetChainLength(params) - 1 : params.bones - 1;
+    const int jointCount = 1 + last - first + 1;       // The root, then the chain
+
+    const float t = height*(jointCount - 1);
+    int j = (int)t;
+    if (j > jointCount - 2) j = jointCount - 2;
+
+    joints[0] = (unsigned short)((j == 0) ? 0 : first + j - 1);
+    joints[1] = (unsigned short)(first + j);
+    weights[1] = t - j;
+    weights[0] = 1.0f - weights[1];
+}
+
+//----------------------------------------------------------------
+// Sections of the JSON
+
+// One primitive per GLBGEN_MAX_ROWS rows, a cylinder each
+static void WriteMesh(GlbWriter* writer, GlbGenParams params, int mesh, ByteBuffer* json)
+{
+    const int totalRows = (params.vertices + GLBGEN_COLUMNS - 1)/GLBGEN_COLUMNS;
+    const int primitiveCount = (totalRows + GLBGEN_MAX_ROWS - 1)/GLBGEN_MAX_ROWS;
+
+    AppendSeparator(json);
+    AppendText(json, "{\"name\":\"mesh_%d\",\"primitives\":[", mesh);
+
+    for (int p = 0; p < primitiveCount; p++)
+    {
+        int rows = (p < primitiveCount - 1) ? GLBGEN_MAX_ROWS : totalRows - p*GLBGEN_MAX_ROWS;
+        if (rows < 2) rows = 2;
+
+        const int count = rows*GLBGEN_COLUMNS;
+        const int indexCount = (rows - 1)*GLBGEN_COLUMNS*6;
+        const float radius = 0.2f + 0.3f*(p + 1)/primitiveCount;
+
+        float* positions = (float*)malloc(count*3*sizeof(float));
+        float* normals = (float*)malloc(count*3*sizeof(float));
+        float* texcoords = (float*)malloc(count*2*sizeof(float));
+        unsigned short* joints = (unsigned short*)malloc(count*4*sizeof(unsigned short));
+        float* weights = (float*)malloc(count*4*sizeof(float));
+        unsigned short* indices = (unsigned short*)malloc(indexCount*sizeof(unsigned short));
+
+        for (int r = 0; r < rows; r++)
+        {
+            const float height = (float)r/(rows - 1);
+
+            for (int c = 0; c < GLBGEN_COLUMNS; c++)
+            {
+                const int v = r*GLBGEN_COLUMNS + c;
+                const float angle = 6.2831853f*c/GLBGEN_COLUMNS;
+                const float jitter = radius*(1.0f + 0.02f*(GetRandomFloat(writer) - 0.5f));
+
+                positions[v*3 + 0] = jitter*cosf(angle);
+                positions[v*3 + 1] = height*GLBGEN_HEIGHT;
+                positions[v*3 + 2] = jitter*sinf(angle);
+                normals[v*3 + 0] = cosf(angle);
+                normals[v*3 + 1] = 0.0f;
+                normals[v*3 + 2] = sinf(angle);
+                texcoords[v*2 + 0] = (float)c/GLBGEN_COLUMNS;
+                texcoords[v*2 + 1] = height;
+
+                GetVertexJoints(params, c, height, &joints[v*4], &weights[v*4]);
+            }
+        }
+
+        int i = 0;
+
+        for (int r = 0; r < rows - 1; r++)
+        {
+            for (int c = 0; c < GLBGEN_COLUMNS; c++)
+            {
+                const unsigned short a = (unsigned short)(r*GLBGEN_COLUMNS + c);
+                const unsigned short b = (unsigned short)(r*GLBGEN_COLUMNS + (c + 1)%GLBGEN_COLUMNS);
+
+                indices[i++] = a; indices[i++] = (unsigned short)(a + GLBGEN_COLUMNS); indices[i++] = b;
+                indices[i++] = b; indices[i++] = (unsigned short)(a + GLBGEN_COLUMNS); indices[i++] = (unsigned short)(b + GLBGEN_COLUMNS);
+            }
+        }
+
+        const int positionAccessor = AddAccessor(writer, positions, count, GLTF_FLOAT, 3, GLTF_ARRAY_BUFFER, true);
+        const int normalAccessor = AddAccessor(writer, normals, count, GLTF_FLOAT, 3, GLTF_ARRAY_BUFFER, false);
+        const int texcoordAccessor = AddAccessor(writer, texcoords, count, GLTF_FLOAT, 2, GLTF_ARRAY_BUFFER, false);
+        const int indexAccessor = AddAccessor(writer, indices, indexCount, GLTF_UNSIGNED_SHORT, 1, GLTF_ELEMENT_BUFFER, false);
+
+        AppendText(json, "%s{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d,\"TEXCOORD_0\":%d", (p > 0) ? "," : "", positionAccessor, normalAccessor, texcoordAccessor);
+
+        if (params.bones > 0)
+        {
+            const int jointAccessor = AddAccessor(writer, joints, count, GLTF_UNSIGNED_SHORT, 4, GLTF_ARRAY_BUFFER, false);
+            const int weightAccessor = AddAccessor(writer, weights, count, GLTF_FLOAT, 4, GLTF_ARRAY_BUFFER, false);
+            AppendText(json, ",\"JOINTS_0\":%d,\"WEIGHTS_0\":%d", jointAccessor, weightAccessor);
+        }
+
+        AppendText(json, "},\"indices\":%d", indexAccessor);
+        if (params.textures > 0) AppendText(json, ",\"material\":%d", mesh%params.textures);
+        AppendText(json, "}");
+
+        free(indices);
+        free(weights);
+        free(joints);
+        free(texcoords);
+        free(normals);
+        free(positions);
+    }
+
+    AppendText(json, "]}");
+}
+
+// Bones first, so node i is bone i, then the instances in a square grid
+static void WriteNodes(GlbGenParams params, ByteBuffer* json)
+{
+    for (int bone = 0; bone < params.bones; bone++)
+    {
+        float t[3] = { 0 };
+        GetBoneTranslation(params, bone, t);
+
+        AppendSeparator(json);
+        AppendText(json, "{\"name\":\"bone_%d\",\"translation\":[%.9g,%.9g,%.9g]", bone, t[0], t[1], t[2]);
+
+        bool hasChildren = false;
+
+        for (int child = bone + 1; child < params.bones; child++)
+        {
+            if (GetBoneParent(params, child) != bone) continue;
+
+            AppendText(json, "%s%d", hasChildren ? "," : ",\"children\":[", child);
+            hasChildren = true;
+
+            if (bone > 0) break;        // A chain bone has one child
+        }
+
+        AppendText(json, "%s}", hasChildren ? "]" : "");
+    }
+
+    const int instanceCount = params.meshes*params.instances;
+    int side = (int)ceil(sqrt((double)instanceCount));
+    if (side < 1) side = 1;
+
+    for (int i = 0; i < instanceCount; i++)
+    {
+        AppendSeparator(json);
+        AppendText(json, "{\"name\":\"instance_%d\",\"mesh\":%d,\"translation\":[%.9g,0,%.9g]", i, i%params.meshes,
+            GLBGEN_SPACING*(i%side - 0.5f*(side - 1)), GLBGEN_SPACING*(i/side - 0.5f*(side - 1)));
+        if (params.bones > 0) AppendText(json, ",\"skin\":0");
+        AppendText(json, "}");
+    }
+}
+
+static void WriteSkin(GlbWriter* writer, GlbGenParams params, ByteBuffer* json)
+{
+    float* inverseBinds = (float*)calloc(params.bones*16, sizeof(float));
+    float* worlds = (float*)calloc(params.bones*3, sizeof(float));
+
+    // Parents come before children, translations only so the inverse negates the bind position
+    for (int bone = 0; bone < params.bones; bone++)
+    {
+        float* m = &inverseBinds[bone*16];
+        float* world = &worlds[bone*3];
+        const int parent = GetBoneParent(params, bone);
+
+        GetBoneTranslation(params, bone, world);
+
+        if (parent >= 0)
+        {
+            for (int c = 0; c < 3; c++) world[c] += worlds[parent*3 + c];
+        }
+
+        m[0] = m[5] = m[10] = m[15] = 1.0f;
+        m[12] = -world[0];
+        m[13] = -world[1];
+        m[14] = -world[2];
+    }
+
+    const int accessor = AddAccessor(writer, inverseBinds, params.bones, GLTF_FLOAT, 16, 0, false);
+
+    AppendText(json, "{\"inverseBindMatrices\":%d,\"skeleton\":0,\"joints\":[", accessor);
+    for (int bone = 0; bone < params.bones; bone++) AppendText(json, "%s%d", (bone > 0) ? "," : "", bone);
+    AppendText(json, "]}");
+
+    free(worlds);
+    free(inverseBinds);
+}
+
+// Every bone swings around a random horizontal axis, one sampler per bone
+static void WriteAnimation(GlbWriter* writer, GlbGenParams params, int clip, ByteBuffer* json)
+{
+    float* times = (float*)malloc(params.frames*sizeof(float));
+    float* rotations = (float*)malloc(params.frames*4*sizeof(float));
+
+    for (int f = 0; f < params.frames; f++) times[f] = f/GLBGEN_FPS;
+
+    const int input = AddAccessor(writer, times, params.frames, GLTF_FLOAT, 1, 0, true);
+
+    ByteBuffer samplers = { 0 };
+    ByteBuffer channels = { 0 };
+    AppendText(&samplers, "[");
+    AppendText(&channels, "[");
+
+    for (int bone = 0; bone < params.bones; bone++)
+    {
+        const float amplitude = 0.1f + 0.4f*GetRandomFloat(writer);
+        const float phase = 6.2831853f*GetRandomFloat(writer);
+        const float heading = 6.2831853f*GetRandomFloat(writer);
+        const float cycles = (float)(1 + GetRandomBits(writer)%3);
+
+        for (int f = 0; f < params.frames; f++)
+        {
+            const float angle = amplitude*sinf(6.2831853f*cycles*f/params.frames + phase);
+
+            rotations[f*4 + 0] = sinf(0.5f*angle)*cosf(heading);
+            rotations[f*4 + 1] = 0.0f;
+            rotations[f*4 + 2] = sinf(0.5f*angle)*sinf(heading);
+            rotations[f*4 + 3] = cosf(0.5f*angle);
+        }
+
+        const int output = AddAccessor(writer, rotations, params.frames, GLTF_FLOAT, 4, 0, false);
+
+        AppendSeparator(&samplers);
+        AppendText(&samplers, "{\"input\":%d,\"output\":%d,\"interpolation\":\"LINEAR\"}", input, output);
+        AppendSeparator(&channels);
+        AppendText(&channels, "{\"sampler\":%d,\"target\":{\"node\":%d,\"path\":\"rotation\"}}", bone, bone);
+    }
+
+    AppendBytes(&samplers, "]", 2);
+    AppendBytes(&channels, "]", 2);
+
+    AppendSeparator(json);
+    AppendText(json, "{\"name\":\"clip_%d\",\"samplers\":%s,\"channels\":%s}", clip, samplers.data, channels.data);
+
+    UnloadByteBuffer(channels);
+    UnloadByteBuffer(samplers);
+    free(rotations);
+    free(times);
+}
+
+//----------------------------------------------------------------
+
+static bool WriteGlb(const char* fileName, GlbGenParams params)
+{
+    GlbWriter writer = { 0 };
+    writer.random = params.seed;
+
+    ByteBuffer meshes = { 0 };
+    ByteBuffer nodes = { 0 };
+    ByteBuffer skin = { 0 };
+    ByteBuffer animations = { 0 };
+    ByteBuffer images = { 0 };
+
+    AppendText(&writer.views, "[");
+    AppendText(&writer.accessors, "[");
+    AppendText(&meshes, "[");
+    AppendText(&nodes, "[");
+    AppendText(&animations, "[");
+    AppendText(&images, "[");
+
+    for (int i = 0; i < params.meshes; i++) WriteMesh(&writer, params, i, &meshes);
+
+    WriteNodes(params, &nodes);
+
+    if (params.bones > 0)
+    {
+        WriteSkin(&writer, params, &skin);
+        for (int i = 0; i < params.clips; i++) WriteAnimation(&writer, params, i, &animations);
+    }
+
+    for (int i = 0; i < params.textures; i++)
+    {
+        ByteBuffer png = GeneratePng(&writer, params.textureSize);
+        const int view = AddView(&writer, png.data, png.length, 0);
+
+        AppendSeparator(&images);
+        AppendText(&images, "{\"name\":\"texture_%d\",\"mimeType\":\"image/png\",\"bufferView\":%d}", i, view);
+        UnloadByteBuffer(png);
+    }
+
+    AppendText(&writer.views, "]");
+    AppendText(&writer.accessors, "]");
+    AppendText(&meshes, "]");
+    AppendText(&nodes, "]");
+    AppendText(&animations, "]");
+    AppendText(&images, "]");
+
+    ByteBuffer json = { 0 };
+
+    AppendText(&json, "{\"asset\":{\"version\":\"2.0\",\"generator\":\"glbgen\"},\"scene\":0,\"scenes\":[{\"nodes\":[");
+    if (params.bones > 0) AppendText(&json, "0,");
+    for (int i = 0; i < params.meshes*params.instances; i++) AppendText(&json, "%s%d", (i > 0) ? "," : "", params.bones + i);
+    AppendText(&json, "]}],\"nodes\":%.*s,\"meshes\":%.*s", (int)nodes.length, nodes.data, (int)meshes.length, meshes.data);
+
+    if (params.bones > 0) AppendText(&json, ",\"skins\":[%.*s]", (int)skin.length, skin.data);
+    if ((params.bones > 0) && (params.clips > 0)) AppendText(&json, ",\"animations\":%.*s", (int)animations.length, animations.data);
+
+    if (params.textures > 0)
+    {
+        AppendText(&json, ",\"images\":%.*s,\"samplers\":[{}],\"textures\":[", (int)images.length, images.data);
+        for (int i = 0; i < params.textures; i++) AppendText(&json, "%s{\"sampler\":0,\"source\":%d}", (i > 0) ? "," : "", i);
+        AppendText(&json, "],\"materials\":[");
+        for (int i = 0; i < params.textures; i++) AppendText(&json, "%s{\"name\":\"material_%d\",\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":%d}}}", (i > 0) ? "," : "", i, i);
+        AppendText(&json, "]");
+    }
+
+    AppendText(&json, ",\"bufferViews\":%.*s,\"accessors\":%.*s,\"buffers\":[{\"byteLength\":%zu}]}",
+        (int)writer.views.length, writer.views.data, (int)writer.accessors.length, writer.accessors.data, writer.bin.length);
+
+    while (json.length%4 != 0) AppendBytes(&json, " ", 1);
+    while (writer.bin.length%4 != 0) AppendBytes(&writer.bin, "", 1);
+
+    ByteBuffer glb = { 0 };
+    AppendUint32(&glb, 0x46546C67);
+    AppendUint32(&glb, 2);
+    AppendUint32(&glb, (unsigned int)(12 + 8 + json.length + 8 + writer.bin.length));
+    AppendUint32(&glb, (unsigned int)json.length);
+    AppendUint32(&glb, 0x4E4F534A);
+    AppendBytes(&glb, json.data, json.length);
+    AppendUint32(&glb, (unsigned int)writer.bin.length);
+    AppendUint32(&glb, 0x004E4942);
+    AppendBytes(&glb, writer.bin.data, writer.bin.length);
+
+    FILE* file = fopen(fileName, "wb");
+    bool isWritten = (file != NULL);
+
+    if (file != NULL)
+    {
+        isWritten = (fwrite(glb.data, 1, glb.length, file) == glb.length);
+        isWritten = (fclose(file) == 0) && isWritten;
+    }
+
+    if (isWritten) printf("GLBGEN: [%s] %zu bytes, %d meshes of %d vertices, %d bones, %d clips of %d frames, %d textures, %d instances\n",
+        fileName, glb.length, params.meshes, params.vertices, params.bones, (params.bones > 0) ? params.clips : 0, params.frames, params.textures, params.instances);
+    else fprintf(stderr, "GLBGEN: [%s] Failed to write\n", fileName);
+
+    UnloadByteBuffer(glb);
+    UnloadByteBuffer(json);
+    UnloadByteBuffer(images);
+    UnloadByteBuffer(animations);
+    UnloadByteBuffer(skin);
+    UnloadByteBuffer(nodes);
+    UnloadByteBuffer(meshes);
+    UnloadByteBuffer(writer.accessors);
+    UnloadByteBuffer(writer.views);
+    UnloadByteBuffer(writer.bin);
+
+    return isWritten;
+}
+
+//----------------------------------------------------------------
+
+static const GlbGenPreset* FindPreset(const char* name)
+{
+    for (int i = 0; i < PRESET_COUNT; i++)
+    {
+        if (strcmp(presets[i].name, name) == 0) return &presets[i];
+    }
+
+    return NULL;
+}
+
+// Out of range values are pulled back to what still makes a valid file
+static GlbGenParams ClampParams(GlbGenParams params)
+{
+    if (params.vertices < 2*GLBGEN_COLUMNS) params.vertices = 2*GLBGEN_COLUMNS;
+    if (params.meshes < 1) params.meshes = 1;
+    if (params.bones < 0) params.bones = 0;
+    if (params.bones > 65536) params.bones = 65536;
+    if (params.depth < 1) params.depth = 1;
+    if (params.clips < 0) params.clips = 0;
+    if (params.frames < 1) params.frames = 1;
+    if (params.textures < 0) params.textures = 0;
+    if (params.textureSize < 1) params.textureSize = 1;
+    if (params.textureSize > 4096) params.textureSize = 4096;
+    if (params.instances < 1) params.instances = 1;
+
+    return params;
+}
+
+int main(int argc, char** argv)
+{
+    const char* outFileName = "synthetic.glb";
+    const char* suiteDirectory = NULL;
+    GlbGenParams params = baseParams;
+
+    // The preset goes first so the other options can change it wherever they are
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--preset") != 0) continue;
+
+        const GlbGenPreset* preset = FindPreset(argv[i + 1]);
+
+        if (preset == NULL)
+        {
+            fprintf(stderr, "GLBGEN: Unknown preset %s, --list shows them\n", argv[i + 1]);
+            return 1;
+        }
+
+        params = preset->params;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if ((strcmp(argv[i], "--preset") == 0) && hasValue) i++;
+        else if ((strcmp(argv[i], "--out") == 0) && hasValue) outFileName = argv[++i];
+        else if ((strcmp(argv[i], "--suite") == 0) && hasValue) suiteDirectory = argv[++i];
+        else if ((strcmp(argv[i], "--vertices") == 0) && hasValue) params.vertices = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--meshes") == 0) && hasValue) params.meshes = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--bones") == 0) && hasValue) params.bones = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--depth") == 0) && hasValue) params.depth = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--clips") == 0) && hasValue) params.clips = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--frames") == 0) && hasValue) params.frames = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--textures") == 0) && hasValue) params.textures = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--texture-size") == 0) && hasValue) params.textureSize = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--instances") == 0) && hasValue) params.instances = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--seed") == 0) && hasValue) params.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            for (int p = 0; p < PRESET_COUNT; p++) printf("%s\n", presets[p].name);
+            return 0;
+        }
+        else
+        {
+            printf("usage: %s [--preset name] [--out file.glb] [--suite directory] [--list] [--vertices n] [--meshes n] [--bones n] [--depth n]"
+                " [--clips n] [--frames n] [--textures n] [--texture-size n] [--instances n] [--seed n]\n", argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    // Every preset as it is, only the seed can be changed
+    if (suiteDirectory != NULL)
+    {
+        for (int p = 0; p < PRESET_COUNT; p++)
+        {
+            char fileName[1024] = { 0 };
+            snprintf(fileName, sizeof(fileName), "%s/%s.glb", suiteDirectory, presets[p].name);
+
+            GlbGenParams presetParams = presets[p].params;
+            presetParams.seed = params.seed;
+
+            if (!WriteGlb(fileName, ClampParams(presetParams))) return 1;
+        }
+
+        return 0;
+    }
+
+    return WriteGlb(outFileName, ClampParams(params)) ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/*******************************************************************************************
+*
+*   containers - Typed growable arrays with inline storage and allocator hooks
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "containers.h"
+
+#include <stdint.h>
+
+#define ARRAY_MIN_CAPACITY  4       // First allocation past the inline storage
+
+//----------------------------------------------------------------
+
+// The context is the memory category, MEMORY_OTHER for GetHeapAllocator()
+static void* HeapResize(void* context, void* ptr, size_t oldSize, size_t newSize)
+{
+    (void)oldSize;
+
+    const MemoryCategory category = (MemoryCategory)(intptr_t)context;
+
+    if (newSize == 0)
+    {
+        MemTrackFree(category, ptr);
+        return NULL;
+    }
+
+    return MemTrackRealloc(category, ptr, newSize);
+}
+
+// Arena memory is never given back, the newest allocation grows in place
+static void* ArenaResize(void* context, void* ptr, size_t oldSize, size_t newSize)
+{
+    if (newSize == 0) return NULL;
+
+    return ArenaRealloc((Arena*)context, ptr, oldSize, newSize);
+}
+
+static void* FrameResize(void* context, void* ptr, size_t oldSize, size_t newSize)
+{
+    if ((newSize == 0) || (newSize <= oldSize)) return (newSize == 0) ? NULL : ptr;
+
+    void* memory = FrameAlloc((FrameArena*)context, newSize);
+    if ((memory != NULL) && (ptr != NULL)) memcpy(memory, ptr, oldSize);
+
+    return memory;
+}
+
+static ContainerAllocator ResolveAllocator(ContainerAllocator allocator)
+{
+    return (allocator.resize != NULL) ? allocator : GetHeapAllocator();
+}
+
+//----------------------------------------------------------------
+
+ContainerAllocator GetHeapAllocator(void)
+{
+    ContainerAllocator allocator = { HeapResize, NULL };
+    return allocator;
+}
+
+ContainerAllocator GetTaggedAllocator(MemoryCategory category)
+{
+    ContainerAllocator allocator = { HeapResize, (void*)(intptr_t)category };
+    return allocator;
+}
+
+ContainerAllocator GetArenaAllocator(Arena* arena)
+{
+    ContainerAllocator allocator = { ArenaResize, arena };
+    return allocator;
+}
+
+ContainerAllocator GetFrameAllocator(FrameArena* arena)
+{
+    ContainerAllocator allocator = { FrameResize, arena };
+    return allocator;
+}
+
+bool ReserveArray(ArrayHeader* header, void* inlineItems, int inlineCount, size_t elementSize, int capacity, bool isExact)
+{
+    const int currentCapacity = (header->heap != NULL) ? header->capacity : inlineCount;
+    if (capacity <= currentCapacity) return true;
+
+    int newCapacity = capacity;
+
+    if (!isExact)
+    {
+        int grown = currentCapacity*ARRAY_GROWTH_NUMERATOR/ARRAY_GROWTH_DENOMINATOR;
+        if (grown < ARRAY_MIN_CAPACITY) grown = ARRAY_MIN_CAPACITY;
+        if (grown > newCapacity) newCapacity = grown;
+    }
+
+    const ContainerAllocator allocator = ResolveAllocator(header->allocator);
+    const size_t oldSize = (header->heap != NULL) ? (size_t)header->capacity*elementSize : 0;
+    void* memory = allocator.resize(allocator.context, header->heap, oldSize, (size_t)newCapacity*elementSize);
+
+    if (memory == NULL)
+    {
+        TraceLog(LOG_WARNING, "CONTAINERS: Failed to grow array to %d elements", newCapacity);
+        return false;
+    }
+
+    // Leaving the inline storage, the elements move once
+    if (header->heap == NULL) memcpy(memory, inlineItems, (size_t)header->count*elementSize);
+
+    header->heap = memory;
+    header->capacity = newCapacity;
+
+    return true;
+}
+
+void ShrinkArray(ArrayHeader* header, void* inlineItems, int inlineCount, size_t elementSize)
+{
+    if ((header->heap == NULL) || (header->count == header->capacity)) return;
+
+    const ContainerAllocator allocator = ResolveAllocator(header->allocator);
+    const size_t oldSize = (size_t)header->capacity*elementSize;
+
+    if (header->count <= inlineCount)
+    {
+        memcpy(inlineItems, header->heap, (size_t)header->count*elementSize);
+        allocator.resize(allocator.context, header->heap, oldSize, 0);
+
+        header->heap = NULL;
+        header->capacity = 0;
+    }
+    else if (allocator.resize == HeapResize)
+    {
+        // Arenas cannot take memory back, only the heap shrinks in place
+        void* memory = allocator.resize(allocator.context, header->heap, oldSize, (size_t)header->count*elementSize);
+
+        if (memory != NULL)
+        {
+            header->heap = memory;
+            header->capacity = header->count;
+        }
+    }
+}
+
+void FreeArray(ArrayHeader* header, size_t elementSize)
+{
+    if (header->heap != NULL)
+    {
+        const ContainerAllocator allocator = ResolveAllocator(header->allocator);
+        allocator.resize(allocator.context, header->heap, (size_t)header->capacity*elementSize, 0);
+    }
+
+    header->heap = NULL;
+    header->count = 0;
+    header->capacity = 0;
+}
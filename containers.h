@@ -0,0 +1,204 @@
+/*******************************************************************************************
+*
+*   containers - Typed growable arrays with inline storage and allocator hooks
+*
+*   DEFINE_ARRAY(Name, Type, InlineCount) declares Name and its functions (Name##Push,
+*   Name##Append, Name##At...). The first InlineCount elements live inside the struct, the
+*   array moves to allocated memory once it outgrows them and back on Name##Shrink(). Memory
+*   comes from the allocator the array was initialized with: the heap, a model Arena or a
+*   FrameArena. Arena memory is only released with its arena, Name##Free() then just resets
+*   the array. A zeroed array is valid and uses the heap.
+*
+*   Growth multiplies the capacity by ARRAY_GROWTH_NUMERATOR/ARRAY_GROWTH_DENOMINATOR,
+*   Name##Reserve() and Name##Resize() allocate exactly what they are asked for. With
+*   CONTAINER_CHECKS defined every indexed access is bounds checked.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef CONTAINERS_H
+#define CONTAINERS_H
+
+#include "raylib.h"
+#include "arena.h"
+#include "memtrack.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef ARRAY_GROWTH_NUMERATOR
+    #define ARRAY_GROWTH_NUMERATOR      3
+    #define ARRAY_GROWTH_DENOMINATOR    2
+#endif
+
+#if defined(CONTAINER_CHECKS)
+    #define ARRAY_CHECK_INDEX(index, count) assert(((index) >= 0) && ((index) < (count)) && "Array index out of bounds")
+#else
+    #define ARRAY_CHECK_INDEX(index, count) ((void)0)
+#endif
+
+typedef struct
+{
+    // Allocates, grows or frees (newSize 0) a block, oldSize is 0 for a new one
+    void* (*resize)(void* context, void* ptr, size_t oldSize, size_t newSize);
+    void* context;
+} ContainerAllocator;
+
+// Shared by every array type, the inline elements follow it
+typedef struct
+{
+    void* heap;                 // Elements once they outgrow the inline storage, NULL while inline
+    int count;
+    int capacity;               // Allocated elements, unused while inline
+    ContainerAllocator allocator;
+} ArrayHeader;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ContainerAllocator GetHeapAllocator(void);
+ContainerAllocator GetTaggedAllocator(MemoryCategory category);    // Heap memory counted in a category
+ContainerAllocator GetArenaAllocator(Arena* arena);
+ContainerAllocator GetFrameAllocator(FrameArena* arena);
+
+// Untyped parts of the array functions, called through the DEFINE_ARRAY wrappers
+bool ReserveArray(ArrayHeader* header, void* inlineItems, int inlineCount, size_t elementSize, int capacity, bool isExact);
+void ShrinkArray(ArrayHeader* header, void* inlineItems, int inlineCount, size_t elementSize);
+void FreeArray(ArrayHeader* header, size_t elementSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define DEFINE_ARRAY(Name, Type, InlineCount)                                                           \
+typedef struct                                                                                          \
+{                                                                                                       \
+    ArrayHeader header;                                                                                 \
+    Type inlineItems[InlineCount];                                                                      \
+} Name;                                                                                                 \
+                                                                                                        \
+static inline Name Name##Init(ContainerAllocator allocator)                                             \
+{                                                                                                       \
+    Name array;                                                                                         \
+    memset(&array, 0, sizeof(Name));                                                                    \
+    array.header.allocator = allocator;                                                                 \
+    return array;                                                                                       \
+}                                                                                                       \
+                                                                                                        \
+static inline void Name##Free(Name* array)                                                              \
+{                                                                                                       \
+    FreeArray(&array->header, sizeof(Type));                                                            \
+}                                                                                                       \
+                                                                                                        \
+static inline int Name##Count(const Name* array)                                                        \
+{                                                                                                       \
+    return array->header.count;                                                                         \
+}                                                                                                       \
+                                                                                                        \
+static inline int Name##Capacity(const Name* array)                                                     \
+{                                                                                                       \
+    return (array->header.heap != NULL) ? array->header.capacity : (InlineCount);                       \
+}                                                                                                       \
+                                                                                                        \
+static inline Type* Name##Data(Name* array)                                                             \
+{                                                                                                       \
+    return (array->header.heap != NULL) ? (Type*)array->header.heap : array->inlineItems;               \
+}                                                                                                       \
+                                                                                                        \
+static inline Type* Name##At(Name* array, int index)                                                    \
+{                                                                                                       \
+    ARRAY_CHECK_INDEX(index, array->header.count);                                                      \
+    return &Name##Data(array)[index];                                                                   \
+}                                                                                                       \
+                                                                                                        \
+static inline bool Name##Reserve(Name* array, int capacity)                                             \
+{                                                                                                       \
+    if (capacity <= Name##Capacity(array)) return true;                                                 \
+    return ReserveArray(&array->header, array->inlineItems, (InlineCount), sizeof(Type), capacity, true); \
+}                                                                                                       \
+                                                                                                        \
+/* Zeroed slot at the end, NULL when the allocator fails */                                             \
+static inline Type* Name##Add(Name* array)                                                              \
+{                                                                                                       \
+    const int count = array->header.count;                                                              \
+    if ((count >= Name##Capacity(array)) &&                                                             \
+        !ReserveArray(&array->header, array->inlineItems, (InlineCount), sizeof(Type), count + 1, false)) return NULL; \
+                                                                                                        \
+    Type* item = &Name##Data(array)[count];                                                             \
+    memset(item, 0, sizeof(Type));                                                                      \
+    array->header.count++;                                                                              \
+    return item;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+static inline bool Name##Push(Name* array, Type value)                                                  \
+{                                                                                                       \
+    const int count = array->header.count;                                                              \
+    if ((count >= Name##Capacity(array)) &&                                                             \
+        !ReserveArray(&array->header, array->inlineItems, (InlineCount), sizeof(Type), count + 1, false)) return false; \
+                                                                                                        \
+    Name##Data(array)[count] = value;                                                                   \
+    array->header.count++;                                                                              \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/* Grows once for the whole run of values */                                                           \
+static inline bool Name##Append(Name* array, Type const* values, int count)                              \
+{                                                                                                       \
+    const int total = array->header.count + count;                                                      \
+    if ((total > Name##Capacity(array)) &&                                                              \
+        !ReserveArray(&array->header, array->inlineItems, (InlineCount), sizeof(Type), total, false)) return false; \
+                                                                                                        \
+    if (count > 0) memcpy(Name##Data(array) + array->header.count, values, count*sizeof(Type));         \
+    array->header.count = total;                                                                        \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+/* New elements are zeroed, the capacity grows to exactly count */                                     \
+static inline bool Name##Resize(Name* array, int count)                                                 \
+{                                                                                                       \
+    if (!Name##Reserve(array, count)) return false;                                                     \
+                                                                                                        \
+    if (count > array->header.count)                                                                    \
+    {                                                                                                   \
+        memset(Name##Data(array) + array->header.count, 0, (count - array->header.count)*sizeof(Type)); \
+    }                                                                                                   \
+    array->header.count = count;                                                                        \
+    return true;                                                                                        \
+}                                                                                                       \
+                                                                                                        \
+static inline Type Name##Pop(Name* array)                                                               \
+{                                                                                                       \
+    ARRAY_CHECK_INDEX(array->header.count - 1, array->header.count);                                    \
+    return Name##Data(array)[--array->header.count];                                                    \
+}                                                                                                       \
+                                                                                                        \
+static inline void Name##Clear(Name* array)                                                             \
+{                                                                                                       \
+    array->header.count = 0;                                                                            \
+}                                                                                                       \
+                                                                                                        \
+/* Capacity down to the count, back to inline storage when it fits */                                  \
+static inline void Name##Shrink(Name* array)                                                            \
+{                                                                                                       \
+    ShrinkArray(&array->header, array->inlineItems, (InlineCount), sizeof(Type));                       \
+}
+
+#endif // CONTAINERS_H
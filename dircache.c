@@ -0,0 +1,329 @@
+/*******************************************************************************************
+*
+*   dircache - Recent directory listings kept for returning to a directory without a rescan
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "dircache.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <string.h>
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+
+    // Anything that changes the listing or the size and time of an entry
+    #define DIRECTORY_CACHE_WATCH_MASK  (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+#if defined(DIRECTORY_CACHE_STATS)
+    #define COUNT_DIRECTORY_CACHE(counter) ((counter)++)
+#else
+    #define COUNT_DIRECTORY_CACHE(counter) ((void)0)
+#endif
+
+//----------------------------------------------------------------
+
+static char* CopyText(const char* text)
+{
+    if (text == NULL) return NULL;
+
+    const size_t length = strlen(text);
+    char* copy = (char*)RL_MALLOC(length + 1);
+
+    if (copy != NULL) memcpy(copy, text, length + 1);
+
+    return copy;
+}
+
+// NULL and empty are the same filter
+static bool IsSameText(const char* a, const char* b)
+{
+    if (a == NULL) a = "";
+    if (b == NULL) b = "";
+
+    return (strcmp(a, b) == 0);
+}
+
+static size_t GetScanBytes(const DirectoryScan* scan)
+{
+    size_t bytes = scan->capacity*sizeof(DirectoryEntry) + scan->poolCapacity;
+    if (scan->paths != NULL) bytes += (scan->count + 1)*sizeof(char*);
+
+    return bytes;
+}
+
+static int FindCachedDirectory(const DirectoryCache* cache, const char* directory, const char* filterExt)
+{
+    for (int i = 0; i < cache->count; i++)
+    {
+        const DirectoryCacheEntry* entry = &cache->entries[i];
+        if ((strcmp(entry->directory, directory) == 0) && IsSameText(entry->filterExt, filterExt)) return i;
+    }
+
+    return -1;
+}
+
+// The last entry moves into the hole
+static void RemoveCachedDirectory(DirectoryCache* cache, int index)
+{
+    DirectoryCacheEntry* entry = &cache->entries[index];
+
+#if defined(__linux__)
+    // One watch per directory, listings with another filter share it
+    if (entry->watch >= 0)
+    {
+        bool isShared = false;
+        for (int i = 0; i < cache->count; i++) isShared = isShared || ((i != index) && (cache->entries[i].watch == entry->watch));
+
+        if (!isShared) inotify_rm_watch(cache->inotify, entry->watch);
+    }
+#endif
+
+    UnloadDirectoryScan(entry->scan);
+    RL_FREE(entry->directory);
+    RL_FREE(entry->filterExt);
+
+    cache->bytes -= entry->bytes;
+    cache->entries[index] = cache->entries[cache->count - 1];
+    cache->count--;
+}
+
+// Drops every listing whose directory sent an event since the last call, the read does not block
+static void ReadDirectoryCacheEvents(DirectoryCache* cache)
+{
+#if defined(__linux__)
+    if (cache->inotify < 0) return;
+
+    unsigned long long buffer[512];     // Aligned for inotify_event
+
+    while (true)
+    {
+        const ssize_t length = read(cache->inotify, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (const char* event = (const char*)buffer; event < (const char*)buffer + length; )
+        {
+            const struct inotify_event* info = (const struct inotify_event*)event;
+            const bool isOverflow = ((info->mask & IN_Q_OVERFLOW) != 0);
+
+            // Events were lost on overflow, nothing cached can be trusted
+            for (int i = cache->count - 1; i >= 0; i--)
+            {
+                DirectoryCacheEntry* entry = &cache->entries[i];
+                if (!isOverflow && (entry->watch != info->wd)) continue;
+
+                // A watch the kernel removed with its directory must not be removed again
+                if ((info->mask & IN_IGNORED) != 0) entry->watch = -1;
+
+                if (entry->isTaken) entry->isStale = true;
+                else
+                {
+                    RemoveCachedDirectory(cache, i);
+                    COUNT_DIRECTORY_CACHE(cache->staleCount);
+                }
+            }
+
+            event += sizeof(struct inotify_event) + info->len;
+        }
+    }
+#else
+    (void)cache;
+#endif
+}
+
+//----------------------------------------------------------------
+
+DirectoryCache LoadDirectoryCache(int maxEntries, size_t maxBytes)
+{
+    DirectoryCache cache = { 0 };
+
+    cache.maxEntries = maxEntries;
+    cache.maxBytes = maxBytes;
+    cache.inotify = -1;
+    cache.entries = (DirectoryCacheEntry*)RL_CALLOC((maxEntries > 0) ? maxEntries : 1, sizeof(DirectoryCacheEntry));
+
+    if (cache.entries == NULL) cache.maxEntries = 0;
+
+#if defined(__linux__)
+    cache.inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (cache.inotify < 0) TraceLog(LOG_WARNING, "DIRCACHE: inotify not available, cached listings are checked by modification time");
+#endif
+
+    return cache;
+}
+
+void UnloadDirectoryCache(DirectoryCache cache)
+{
+    for (int i = 0; i < cache.count; i++)
+    {
+        UnloadDirectoryScan(cache.entries[i].scan);
+        RL_FREE(cache.entries[i].directory);
+        RL_FREE(cache.entries[i].filterExt);
+    }
+
+#if defined(__linux__)
+    // Closing the descriptor removes every watch
+    if (cache.inotify >= 0) close(cache.inotify);
+#endif
+
+#if defined(DIRECTORY_CACHE_STATS)
+    TraceLog(LOG_INFO, "DIRCACHE: %d hits, %d misses, %d stale, %d evicted", cache.hitCount, cache.missCount, cache.staleCount, cache.evictionCount);
+#endif
+
+    RL_FREE(cache.entries);
+}
+
+void StoreCachedDirectory(DirectoryCache* cache, DirectoryScan* scan)
+{
+    const size_t bytes = GetScanBytes(scan);
+
+    if (scan->isScanning || scan->isFailed || (scan->directory == NULL) || (bytes > cache->maxBytes) || (cache->maxEntries == 0))
+    {
+        UnloadDirectoryScan(*scan);
+        *scan = (DirectoryScan){ 0 };
+        return;
+    }
+
+    ReadDirectoryCacheEvents(cache);
+
+    int index = FindCachedDirectory(cache, scan->directory, scan->filterExt);
+    bool isStale = false;
+
+    if ((index >= 0) && cache->entries[index].isTaken)
+    {
+        // Coming back from a take, the watch has been on the whole time
+        isStale = cache->entries[index].isStale;
+    }
+    else
+    {
+        if (index >= 0) RemoveCachedDirectory(cache, index);
+
+        // Least recently used first until there is room for one more
+        while ((cache->count > 0) && (cache->count >= cache->maxEntries))
+        {
+            int oldest = 0;
+            for (int i = 1; i < cache->count; i++) if (cache->entries[i].lastUse < cache->entries[oldest].lastUse) oldest = i;
+
+            RemoveCachedDirectory(cache, oldest);
+            COUNT_DIRECTORY_CACHE(cache->evictionCount);
+        }
+
+        index = cache->count++;
+
+        DirectoryCacheEntry* entry = &cache->entries[index];
+        *entry = (DirectoryCacheEntry){ 0 };
+        entry->directory = CopyText(scan->directory);
+        entry->filterExt = CopyText(scan->filterExt);
+        entry->isTaken = true;
+        entry->watch = -1;
+
+#if defined(__linux__)
+        // Watched before the check below, a change after the check is never missed
+        if (cache->inotify >= 0) entry->watch = inotify_add_watch(cache->inotify, scan->directory, DIRECTORY_CACHE_WATCH_MASK);
+#endif
+        // The listing was shown while the directory was not watched
+        const long long modTime = GetDirectoryModTime(scan->directory);
+        isStale = (entry->directory == NULL) || (modTime < 0) || (modTime != scan->directoryModTime);
+    }
+
+    // Without a watch only the modification time tells
+    if (!isStale && (cache->entries[index].watch < 0)) isStale = (GetDirectoryModTime(scan->directory) != scan->directoryModTime);
+
+    if (isStale)
+    {
+        RemoveCachedDirectory(cache, index);
+        COUNT_DIRECTORY_CACHE(cache->staleCount);
+
+        UnloadDirectoryScan(*scan);
+        *scan = (DirectoryScan){ 0 };
+        return;
+    }
+
+    DirectoryCacheEntry* entry = &cache->entries[index];
+    entry->scan = *scan;
+    entry->bytes = bytes;
+    entry->isTaken = false;
+    entry->lastUse = ++cache->useCounter;
+
+    cache->bytes += bytes;
+    *scan = (DirectoryScan){ 0 };
+
+    // Other listings make room by bytes, taken ones hold none
+    while (cache->bytes > cache->maxBytes)
+    {
+        int oldest = -1;
+        for (int i = 0; i < cache->count; i++)
+        {
+            if ((i != index) && !cache->entries[i].isTaken && ((oldest < 0) || (cache->entries[i].lastUse < cache->entries[oldest].lastUse))) oldest = i;
+        }
+
+        if (oldest < 0) break;
+
+        // The stored entry may be the last one, which moves into the hole
+        if (index == cache->count - 1) index = oldest;
+
+        RemoveCachedDirectory(cache, oldest);
+        COUNT_DIRECTORY_CACHE(cache->evictionCount);
+    }
+}
+
+bool TakeCachedDirectory(DirectoryCache* cache, const char* directory, const char* filterExt, bool readInfo, DirectoryScan* scan)
+{
+    ReadDirectoryCacheEvents(cache);
+
+    int index = FindCachedDirectory(cache, directory, filterExt);
+    if ((index >= 0) && cache->entries[index].isTaken) index = -1;
+
+    // Without a watch the modification time tells whether entries were added, removed or renamed
+    if ((index >= 0) && (cache->entries[index].watch < 0) && (GetDirectoryModTime(directory) != cache->entries[index].scan.directoryModTime))
+    {
+        RemoveCachedDirectory(cache, index);
+        COUNT_DIRECTORY_CACHE(cache->staleCount);
+        index = -1;
+    }
+
+    if ((index < 0) || (readInfo && !cache->entries[index].scan.hasInfo))
+    {
+        COUNT_DIRECTORY_CACHE(cache->missCount);
+        return false;
+    }
+
+    DirectoryCacheEntry* entry = &cache->entries[index];
+
+    *scan = entry->scan;
+    entry->scan = (DirectoryScan){ 0 };
+    entry->isTaken = true;
+    entry->isStale = false;
+    entry->lastUse = ++cache->useCounter;
+
+    cache->bytes -= entry->bytes;
+    entry->bytes = 0;
+
+    COUNT_DIRECTORY_CACHE(cache->hitCount);
+#if defined(DIRECTORY_CACHE_STATS)
+    TraceLog(LOG_INFO, "DIRCACHE: [%s] from the cache, %d hits, %d misses", directory, cache->hitCount, cache->missCount);
+#endif
+
+    return true;
+}
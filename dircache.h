@@ -0,0 +1,98 @@
+/*******************************************************************************************
+*
+*   dircache - Recent directory listings kept for returning to a directory without a rescan
+*
+*   A complete DirectoryScan is handed to the cache when the file dialog leaves a directory
+*   and taken back out when it returns, the listing moves without a copy and keeps its sort
+*   order. On Linux every cached directory has an inotify watch, an entry created, deleted,
+*   renamed or modified in it drops the listing the next time the cache is used. The watch
+*   stays while a listing is taken out, a change meanwhile keeps it from being stored again.
+*   Elsewhere, or once the watch limit is reached, the modification time of the directory is
+*   compared instead, which only sees entries added, removed or renamed.
+*
+*   The least recently used listings are unloaded to stay under the entry and byte limits.
+*   With DIRECTORY_CACHE_STATS defined, as debug builds do, hits, misses and evictions are
+*   counted.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef DIRCACHE_H
+#define DIRCACHE_H
+
+#include "raylib.h"
+#include "dirscan.h"
+
+#include <stddef.h>
+
+#define DIRECTORY_CACHE_MAX_ENTRIES     32
+#define DIRECTORY_CACHE_MAX_BYTES       (64*1024*1024)
+
+typedef struct
+{
+    char* directory;
+    char* filterExt;            // NULL for every file
+
+    DirectoryScan scan;         // Complete, empty while taken
+    size_t bytes;
+    bool isTaken;               // The scan was moved out, the watch is kept for its return
+    bool isStale;               // The directory changed while the scan was taken
+
+    int watch;                  // inotify watch descriptor, -1 when the modification time is compared
+    unsigned int lastUse;
+} DirectoryCacheEntry;
+
+typedef struct
+{
+    DirectoryCacheEntry* entries;
+    int count;
+    int maxEntries;
+    size_t bytes;
+    size_t maxBytes;
+
+    int inotify;                // -1 without inotify
+    unsigned int useCounter;
+
+    // Only counted with DIRECTORY_CACHE_STATS
+    int hitCount;
+    int missCount;
+    int staleCount;             // Listings dropped because their directory changed
+    int evictionCount;
+} DirectoryCache;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+DirectoryCache LoadDirectoryCache(int maxEntries, size_t maxBytes);
+void UnloadDirectoryCache(DirectoryCache cache);
+
+// The cache owns the scan from then on and clears *scan. A scan still reading, failed, over the
+// byte limit or older than its directory is unloaded instead, a listing with the same key is replaced
+void StoreCachedDirectory(DirectoryCache* cache, DirectoryScan* scan);
+
+// Moves an up to date listing out of the cache into *scan, false when there is none. With readInfo
+// only a listing read with the entry info is taken
+bool TakeCachedDirectory(DirectoryCache* cache, const char* directory, const char* filterExt, bool readInfo, DirectoryScan* scan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DIRCACHE_H
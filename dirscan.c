@@ -0,0 +1,568 @@
+/*******************************************************************************************
+*
+*   dirscan - Directory listing read on a background thread
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "dirscan.h"
+#include "trace.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+struct DirectoryScanJob
+{
+    pthread_t thread;
+    bool hasThread;
+    pthread_mutex_t mutex;
+
+    bool isCancelled;
+    bool isDone;
+    bool isFailed;
+
+    bool readInfo;
+    int statCount;              // Written by the thread, read once it is done
+    long long directoryModTime;
+
+    char* directory;
+    char* filterExt;            // NULL lists every file
+
+    // Entries handed over and not taken yet, offsets point into this pool
+    DirectoryEntry* entries;
+    int count;
+    int capacity;
+    char* pool;
+    size_t poolSize;
+    size_t poolCapacity;
+};
+
+#define DIRECTORY_SORT_MAX_KEY  ((1ULL << 62) - 1)     // Mode keys leave the top bit to the directory flag
+
+typedef struct
+{
+    unsigned long long key;     // Directory flag and the key of the sort mode
+    unsigned long long prefix;  // First bytes of the name
+    const char* name;
+    int index;                  // Entry in scan order
+} DirectorySortKey;
+
+//----------------------------------------------------------------
+
+static char* CopyText(const char* text)
+{
+    const size_t length = strlen(text);
+    char* copy = (char*)RL_MALLOC(length + 1);
+
+    if (copy != NULL) memcpy(copy, text, length + 1);
+
+    return copy;
+}
+
+// Grows both arrays to hold count more entries and size more pool bytes
+static bool ReserveEntries(DirectoryEntry** entries, int* capacity, int count, char** pool, size_t* poolCapacity, size_t size)
+{
+    if (count > *capacity)
+    {
+        int newCapacity = (*capacity > 0) ? *capacity : 64;
+        while (newCapacity < count) newCapacity *= 2;
+
+        DirectoryEntry* newEntries = (DirectoryEntry*)RL_REALLOC(*entries, newCapacity*sizeof(DirectoryEntry));
+        if (newEntries == NULL) return false;
+
+        *entries = newEntries;
+        *capacity = newCapacity;
+    }
+
+    if (size > *poolCapacity)
+    {
+        size_t newCapacity = (*poolCapacity > 0) ? *poolCapacity : 4096;
+        while (newCapacity < size) newCapacity *= 2;
+
+        char* newPool = (char*)RL_REALLOC(*pool, newCapacity);
+        if (newPool == NULL) return false;
+
+        *pool = newPool;
+        *poolCapacity = newCapacity;
+    }
+
+    return true;
+}
+
+// Appends entries and their pool, the offsets are moved to the end of the destination pool
+static bool AppendEntries(DirectoryEntry** entries, int* count, int* capacity, char** pool, size_t* poolSize, size_t* poolCapacity,
+                          const DirectoryEntry* source, int sourceCount, const char* sourcePool, size_t sourcePoolSize)
+{
+    if (!ReserveEntries(entries, capacity, *count + sourceCount, pool, poolCapacity, *poolSize + sourcePoolSize)) return false;
+
+    for (int i = 0; i < sourceCount; i++)
+    {
+        DirectoryEntry entry = source[i];
+        entry.pathOffset += (int)*poolSize;
+        entry.nameOffset += (int)*poolSize;
+        entry.extensionOffset += (int)*poolSize;
+
+        (*entries)[*count + i] = entry;
+    }
+
+    if (sourcePoolSize > 0) memcpy(*pool + *poolSize, sourcePool, sourcePoolSize);
+
+    *count += sourceCount;
+    *poolSize += sourcePoolSize;
+
+    return true;
+}
+
+// Same rule as IsFileExtension(), which is not thread safe
+static bool IsFilteredName(const char* name, const char* filterExt)
+{
+    const char* extension = strrchr(name, '.');
+    if ((extension == NULL) || (extension == name)) return false;
+
+    const size_t length = strlen(extension);
+
+    for (const char* filter = filterExt; *filter != '\0';)
+    {
+        const char* end = strchr(filter, ';');
+        const size_t filterLength = (end != NULL) ? (size_t)(end - filter) : strlen(filter);
+
+        if (filterLength == length)
+        {
+            size_t i = 0;
+            while ((i < length) && (tolower((unsigned char)extension[i]) == tolower((unsigned char)filter[i]))) i++;
+
+            if (i == length) return true;
+        }
+
+        if (end == NULL) break;
+        filter = end + 1;
+    }
+
+    return false;
+}
+
+// One lock per entry is nothing next to the stat() of the entry
+static bool IsDirectoryScanCancelled(struct DirectoryScanJob* job)
+{
+    pthread_mutex_lock(&job->mutex);
+    const bool isCancelled = job->isCancelled;
+    pthread_mutex_unlock(&job->mutex);
+
+    return isCancelled;
+}
+
+//----------------------------------------------------------------
+
+static void* DirectoryScanMain(void* arg)
+{
+    struct DirectoryScanJob* job = (struct DirectoryScanJob*)arg;
+
+    SetTraceThreadName("directory scan");
+    TraceBegin("scan directory");
+
+    // Taken before reading, a change during the scan leaves the listing older than the directory
+    job->directoryModTime = GetDirectoryModTime(job->directory);
+
+    DIR* dir = opendir(job->directory);
+
+    DirectoryEntry* batch = NULL;
+    int batchCount = 0;
+    int batchCapacity = 0;
+    char* batchPool = NULL;
+    size_t batchPoolSize = 0;
+    size_t batchPoolCapacity = 0;
+
+    const size_t directoryLength = strlen(job->directory);
+    const bool hasSeparator = (directoryLength > 0) && ((job->directory[directoryLength - 1] == '/') || (job->directory[directoryLength - 1] == '\\'));
+
+    bool isFailed = (dir == NULL);
+
+    while (!isFailed && !IsDirectoryScanCancelled(job))
+    {
+        const struct dirent* entry = readdir(dir);
+        const bool isEnd = (entry == NULL);
+
+        if (!isEnd && (strcmp(entry->d_name, ".") != 0) && (strcmp(entry->d_name, "..") != 0))
+        {
+            const size_t nameLength = strlen(entry->d_name);
+            const size_t pathLength = directoryLength + (hasSeparator ? 0 : 1) + nameLength;
+
+            if (!ReserveEntries(&batch, &batchCapacity, batchCount + 1, &batchPool, &batchPoolCapacity, batchPoolSize + pathLength + 1))
+            {
+                isFailed = true;
+                break;
+            }
+
+            char* path = batchPool + batchPoolSize;
+            memcpy(path, job->directory, directoryLength);
+            if (!hasSeparator) path[directoryLength] = '/';
+            memcpy(path + pathLength - nameLength, entry->d_name, nameLength + 1);
+
+            // Links and file systems without d_type need a stat() to tell directories apart
+            bool isDirectory = false;
+            bool isTypeKnown = false;
+#if defined(DT_DIR)
+            isDirectory = (entry->d_type == DT_DIR);
+            isTypeKnown = isDirectory || (entry->d_type == DT_REG);
+#endif
+            struct stat info;
+            bool hasInfo = false;
+
+            if (!isTypeKnown || job->readInfo)
+            {
+                hasInfo = (stat(path, &info) == 0);
+                isDirectory = hasInfo && S_ISDIR(info.st_mode);
+                job->statCount++;
+            }
+
+            if (isDirectory || (job->filterExt == NULL) || IsFilteredName(entry->d_name, job->filterExt))
+            {
+                const char* extension = strrchr(entry->d_name, '.');
+
+                DirectoryEntry* added = &batch[batchCount++];
+                added->pathOffset = (int)batchPoolSize;
+                added->nameOffset = (int)(batchPoolSize + pathLength - nameLength);
+                added->extensionOffset = added->nameOffset + (int)(((extension != NULL) && (extension != entry->d_name)) ? (size_t)(extension - entry->d_name) : nameLength);
+                added->isDirectory = isDirectory;
+                added->size = (hasInfo && !isDirectory) ? (long long)info.st_size : 0;
+                added->modTime = hasInfo ? (long long)info.st_mtime : 0;
+
+                batchPoolSize += pathLength + 1;
+            }
+        }
+
+        // Full batches are handed over, the last one when the directory ends
+        if ((batchCount == DIRECTORY_SCAN_BATCH) || (isEnd && (batchCount > 0)))
+        {
+            pthread_mutex_lock(&job->mutex);
+            const bool isAppended = AppendEntries(&job->entries, &job->count, &job->capacity, &job->pool, &job->poolSize, &job->poolCapacity, batch, batchCount, batchPool, batchPoolSize);
+            pthread_mutex_unlock(&job->mutex);
+
+            if (!isAppended) isFailed = true;
+
+            batchCount = 0;
+            batchPoolSize = 0;
+        }
+
+        if (isEnd) break;
+    }
+
+    if (dir != NULL) closedir(dir);
+
+    RL_FREE(batch);
+    RL_FREE(batchPool);
+
+    TraceEnd();
+
+    pthread_mutex_lock(&job->mutex);
+    job->isFailed = isFailed;
+    job->isDone = true;
+    pthread_mutex_unlock(&job->mutex);
+
+    return NULL;
+}
+
+static void UnloadDirectoryScanJob(struct DirectoryScanJob* job)
+{
+    if (job->hasThread) pthread_join(job->thread, NULL);
+
+    pthread_mutex_destroy(&job->mutex);
+
+    RL_FREE(job->entries);
+    RL_FREE(job->pool);
+    RL_FREE(job->directory);
+    RL_FREE(job->filterExt);
+    RL_FREE(job);
+}
+
+//----------------------------------------------------------------
+
+// First 8 bytes in big endian order, comparing keys orders like strcmp() up to the eighth byte
+static unsigned long long GetTextKey(const char* text, bool isFolded)
+{
+    unsigned long long key = 0;
+    int i = 0;
+
+    for (; (i < 8) && (text[i] != '\0'); i++)
+    {
+        const unsigned char c = (unsigned char)(isFolded ? tolower((unsigned char)text[i]) : text[i]);
+        key = (key << 8) | c;
+    }
+
+    return (i > 0) ? key << (8*(8 - i)) : 0;
+}
+
+static unsigned long long GetClampedKey(long long value)
+{
+    if (value < 0) return 0;
+    if ((unsigned long long)value > DIRECTORY_SORT_MAX_KEY) return DIRECTORY_SORT_MAX_KEY;
+
+    return (unsigned long long)value;
+}
+
+static inline bool IsSortKeyLess(const DirectorySortKey* a, const DirectorySortKey* b)
+{
+    if (a->key != b->key) return (a->key < b->key);
+    if (a->prefix != b->prefix) return (a->prefix < b->prefix);
+
+    // Only names sharing their first 8 bytes are compared as text
+    return (strcmp(a->name, b->name) < 0);
+}
+
+// Bottom up merge sort, the compare inlines where qsort() calls through a pointer for every one.
+// Returns the buffer holding the result, keys or temp
+static DirectorySortKey* SortKeys(DirectorySortKey* keys, DirectorySortKey* temp, int count)
+{
+    for (int width = 1; width < count; width *= 2)
+    {
+        for (int low = 0; low < count; low += 2*width)
+        {
+            const int middle = (low + width < count) ? low + width : count;
+            const int high = (low + 2*width < count) ? low + 2*width : count;
+
+            int a = low;
+            int b = middle;
+            int out = low;
+
+            // Equal keys take the left one first, the sort is stable
+            while ((a < middle) && (b < high)) temp[out++] = IsSortKeyLess(&keys[b], &keys[a]) ? keys[b++] : keys[a++];
+            while (a < middle) temp[out++] = keys[a++];
+            while (b < high) temp[out++] = keys[b++];
+        }
+
+        DirectorySortKey* swap = keys;
+        keys = temp;
+        temp = swap;
+    }
+
+    return keys;
+}
+
+//----------------------------------------------------------------
+
+DirectoryScan LoadDirectoryScan(const char* directory, const char* filterExt, bool readInfo)
+{
+    DirectoryScan scan = { 0 };
+
+    scan.startTime = GetTime();
+    scan.hasInfo = readInfo;
+    scan.directory = CopyText(directory);
+    scan.filterExt = ((filterExt != NULL) && (filterExt[0] != '\0')) ? CopyText(filterExt) : NULL;
+
+    struct DirectoryScanJob* job = (struct DirectoryScanJob*)RL_CALLOC(1, sizeof(struct DirectoryScanJob));
+
+    if ((job == NULL) || (scan.directory == NULL))
+    {
+        RL_FREE(job);
+        scan.isFailed = true;
+        return scan;
+    }
+
+    job->directory = CopyText(directory);
+    job->filterExt = ((filterExt != NULL) && (filterExt[0] != '\0')) ? CopyText(filterExt) : NULL;
+    job->readInfo = readInfo;
+    pthread_mutex_init(&job->mutex, NULL);
+
+    scan.job = job;
+    scan.isScanning = true;
+
+    if (job->directory == NULL)
+    {
+        job->isDone = job->isFailed = true;
+    }
+    else if (pthread_create(&job->thread, NULL, DirectoryScanMain, job) == 0) job->hasThread = true;
+    else
+    {
+        // Without a thread the directory is read here, the first update takes it all
+        TraceLog(LOG_WARNING, "DIRSCAN: Failed to start the scan thread, reading [%s] on the main thread", directory);
+        DirectoryScanMain(job);
+    }
+
+    return scan;
+}
+
+void UnloadDirectoryScan(DirectoryScan scan)
+{
+    if (scan.job != NULL)
+    {
+        pthread_mutex_lock(&scan.job->mutex);
+        scan.job->isCancelled = true;
+        pthread_mutex_unlock(&scan.job->mutex);
+
+        UnloadDirectoryScanJob(scan.job);
+    }
+
+    RL_FREE(scan.directory);
+    RL_FREE(scan.filterExt);
+    RL_FREE(scan.entries);
+    RL_FREE(scan.pool);
+    RL_FREE(scan.paths);
+}
+
+int UpdateDirectoryScan(DirectoryScan* scan)
+{
+    struct DirectoryScanJob* job = scan->job;
+    if (job == NULL) return 0;
+
+    // The handed over entries are taken as they are, the thread starts a new buffer
+    pthread_mutex_lock(&job->mutex);
+
+    DirectoryEntry* entries = job->entries;
+    const int count = job->count;
+    char* pool = job->pool;
+    const size_t poolSize = job->poolSize;
+    const bool isDone = job->isDone;
+    const bool isFailed = job->isFailed;
+
+    job->entries = NULL;
+    job->count = job->capacity = 0;
+    job->pool = NULL;
+    job->poolSize = job->poolCapacity = 0;
+
+    pthread_mutex_unlock(&job->mutex);
+
+    const int previousCount = scan->count;
+
+    if (!AppendEntries(&scan->entries, &scan->count, &scan->capacity, &scan->pool, &scan->poolSize, &scan->poolCapacity, entries, count, pool, poolSize))
+    {
+        TraceLog(LOG_WARNING, "DIRSCAN: Failed to grow the listing, %d entries dropped", count);
+        scan->isFailed = true;
+    }
+
+    RL_FREE(entries);
+    RL_FREE(pool);
+
+    if (isDone)
+    {
+        scan->statCount = job->statCount;
+        scan->directoryModTime = job->directoryModTime;
+        UnloadDirectoryScanJob(job);
+
+        scan->job = NULL;
+        scan->isScanning = false;
+        scan->isFailed = scan->isFailed || isFailed;
+        scan->scanTime = GetTime() - scan->startTime;
+
+        TraceLog(LOG_INFO, "DIRSCAN: %d entries in %.2f ms, %d stat() calls%s", scan->count, scan->scanTime*1000.0, scan->statCount, isFailed ? ", failed" : "");
+    }
+
+    return scan->count - previousCount;
+}
+
+long long GetDirectoryModTime(const char* directory)
+{
+    struct stat info;
+    if (stat(directory, &info) != 0) return -1;
+
+#if defined(__linux__)
+    return (long long)info.st_mtim.tv_sec*1000000000LL + info.st_mtim.tv_nsec;
+#else
+    return (long long)info.st_mtime*1000000000LL;
+#endif
+}
+
+const char* GetDirectoryEntryPath(const DirectoryScan* scan, int index)
+{
+    return scan->pool + scan->entries[index].pathOffset;
+}
+
+const char* GetDirectoryEntryName(const DirectoryScan* scan, int index)
+{
+    return scan->pool + scan->entries[index].nameOffset;
+}
+
+void SortDirectoryScan(DirectoryScan* scan, DirectorySortMode mode)
+{
+    if (!scan->hasInfo && ((mode == DIRECTORY_SORT_SIZE) || (mode == DIRECTORY_SORT_TIME))) mode = DIRECTORY_SORT_NAME;
+    if (scan->isSorted && (scan->sortMode == mode)) return;
+
+    if (scan->count < 2)
+    {
+        scan->isSorted = true;
+        scan->sortMode = mode;
+        return;
+    }
+
+    DirectorySortKey* keys = (DirectorySortKey*)RL_MALLOC(2*scan->count*sizeof(DirectorySortKey));
+    DirectoryEntry* sorted = (DirectoryEntry*)RL_MALLOC(scan->capacity*sizeof(DirectoryEntry));
+
+    if ((keys == NULL) || (sorted == NULL))
+    {
+        TraceLog(LOG_WARNING, "DIRSCAN: Failed to sort %d entries", scan->count);
+        RL_FREE(keys);
+        RL_FREE(sorted);
+        return;
+    }
+
+    for (int i = 0; i < scan->count; i++)
+    {
+        const DirectoryEntry* entry = &scan->entries[i];
+        unsigned long long key = 0;
+
+        switch (mode)
+        {
+            // The first 7 bytes of the extension, longer ones that share them sort by name
+            case DIRECTORY_SORT_EXTENSION: key = GetTextKey(scan->pool + entry->extensionOffset, true) >> 8; break;
+            case DIRECTORY_SORT_SIZE: key = DIRECTORY_SORT_MAX_KEY - GetClampedKey(entry->size); break;
+            case DIRECTORY_SORT_TIME: key = DIRECTORY_SORT_MAX_KEY - GetClampedKey(entry->modTime); break;
+            default: break;
+        }
+
+        // Directories come first, the top bit is free in every key
+        keys[i].key = (entry->isDirectory ? 0 : (1ULL << 63)) | key;
+        keys[i].prefix = GetTextKey(scan->pool + entry->nameOffset, false);
+        keys[i].name = scan->pool + entry->nameOffset;
+        keys[i].index = i;
+    }
+
+    const DirectorySortKey* order = SortKeys(keys, keys + scan->count, scan->count);
+
+    for (int i = 0; i < scan->count; i++) sorted[i] = scan->entries[order[i].index];
+
+    RL_FREE(scan->entries);
+    scan->entries = sorted;
+    scan->isSorted = true;
+    scan->sortMode = mode;
+
+    RL_FREE(keys);
+}
+
+FilePathList GetDirectoryScanPaths(DirectoryScan* scan)
+{
+    FilePathList list = { 0 };
+
+    RL_FREE(scan->paths);
+    scan->paths = (char**)RL_MALLOC((scan->count + 1)*sizeof(char*));
+    if (scan->paths == NULL) return list;
+
+    for (int i = 0; i < scan->count; i++) scan->paths[i] = scan->pool + scan->entries[i].pathOffset;
+
+    list.capacity = (unsigned int)scan->count;
+    list.count = (unsigned int)scan->count;
+    list.paths = scan->paths;
+
+    return list;
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************************
+*
+*   dirscan - Directory listing read on a background thread
+*
+*   LoadDirectoryScan() returns at once and a thread reads the directory. Entries are handed
+*   over in batches, UpdateDirectoryScan() moves the ones found since the last call into the
+*   listing, so a directory of any size on a slow mount fills in while the UI keeps drawing.
+*   Entries are only ever appended while reading, an index stays valid until the scan is sorted.
+*
+*   Paths live in one growable string pool and entries hold offsets into it. There is no limit
+*   on the number of entries. Like LoadDirectoryFilesEx() the filter only applies to files,
+*   directories are always listed, and '.' and '..' are skipped.
+*
+*   The entry type comes from the d_type of readdir(), stat() is only called when the file
+*   system does not fill it in, or for every entry when size and modification time are asked
+*   for. SortDirectoryScan() builds one key per entry up front and sorts the keys, a compare
+*   never touches the file system.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef DIRSCAN_H
+#define DIRSCAN_H
+
+#include "raylib.h"
+
+#include <stddef.h>
+
+#define DIRECTORY_SCAN_BATCH    256     // Entries the thread collects before handing them over
+
+typedef enum
+{
+    DIRECTORY_SORT_NAME = 0,
+    DIRECTORY_SORT_EXTENSION,
+    DIRECTORY_SORT_SIZE,        // Largest first, needs the entry info
+    DIRECTORY_SORT_TIME         // Newest first, needs the entry info
+} DirectorySortMode;
+
+typedef struct
+{
+    int pathOffset;             // Full path in the pool
+    int nameOffset;             // File name in the pool, the tail of the path
+    int extensionOffset;        // Last '.' of the name, the terminating null without one
+    bool isDirectory;
+    long long size;             // Bytes, with the entry info only
+    long long modTime;          // Seconds since the epoch, with the entry info only
+} DirectoryEntry;
+
+typedef struct
+{
+    char* directory;            // Copies of what the scan was loaded with
+    char* filterExt;            // NULL lists every file
+
+    int count;
+    int capacity;
+    DirectoryEntry* entries;
+
+    char* pool;                 // Null terminated paths one after another
+    size_t poolSize;
+    size_t poolCapacity;
+
+    char** paths;               // Path of every entry, built by GetDirectoryScanPaths()
+
+    bool hasInfo;               // Entries carry their size and modification time
+    int statCount;              // stat() calls the scan made, once it is done
+    long long directoryModTime; // GetDirectoryModTime() of the directory before it was read, once it is done
+
+    bool isSorted;              // Entries are in sortMode order
+    DirectorySortMode sortMode;
+
+    bool isScanning;
+    bool isFailed;              // The directory could not be opened
+    double startTime;
+    double scanTime;            // Seconds the whole scan took, once it is done
+
+    struct DirectoryScanJob* job;
+} DirectoryScan;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// filterExt is a ';' separated extension list like ".glb;.gltf", NULL or empty lists every file.
+// With readInfo every entry is stat()ed for its size and modification time
+DirectoryScan LoadDirectoryScan(const char* directory, const char* filterExt, bool readInfo);
+// Stops the thread if it is still reading
+void UnloadDirectoryScan(DirectoryScan scan);
+
+// Takes over the entries found since the last call, returns how many were added
+int UpdateDirectoryScan(DirectoryScan* scan);
+
+const char* GetDirectoryEntryPath(const DirectoryScan* scan, int index);
+const char* GetDirectoryEntryName(const DirectoryScan* scan, int index);
+
+// Directories first, then by mode and by name (byte order), call once the scan is done. Size and
+// time fall back to the name without the entry info. Indices change, GetDirectoryScanPaths() again.
+// Does nothing when the scan is already in that order
+void SortDirectoryScan(DirectoryScan* scan, DirectorySortMode mode);
+
+// Modification time of a directory in nanoseconds where the platform has them, -1 when it cannot be read
+long long GetDirectoryModTime(const char* directory);
+
+// Paths of every entry for functions taking a FilePathList, owned by the scan, call once it is done
+FilePathList GetDirectoryScanPaths(DirectoryScan* scan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DIRSCAN_H
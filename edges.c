@@ -0,0 +1,388 @@
+/*******************************************************************************************
+*
+*   edges - Deduplicated edge index buffers for wireframe drawing
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "edges.h"
+#include "vmath.h"
+#include "rlgl.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_INDICES
+#include "memtrack.h"
+
+#if defined(__APPLE__)
+    #define GL_SILENCE_DEPRECATION
+    #include <OpenGL/gl3.h>         // Required for: glDrawElements()
+#else
+    #include "external/glad.h"      // Required for: glDrawElements(), loaded by raylib
+#endif
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Vertex attribute type of compact positions (see quant.c)
+#define EDGES_GL_SHORT    0x1402
+
+typedef struct
+{
+    float angle;
+    unsigned int a;
+    unsigned int b;
+} EdgeRecord;
+
+//----------------------------------------------------------------
+
+static unsigned int NextPowerOfTwo(unsigned int value)
+{
+    unsigned int result = 16;
+    while (result < value) result <<= 1;
+
+    return result;
+}
+
+static Vector3 GetEdgeVertex(Mesh mesh, const QuantMesh* quant, int index)
+{
+    if (mesh.vertices != NULL) return (Vector3){ mesh.vertices[index*3], mesh.vertices[index*3 + 1], mesh.vertices[index*3 + 2] };
+
+    return GetQuantMeshVertex(*quant, index);
+}
+
+static unsigned int HashPosition(Vector3 p)
+{
+    // Adding zero turns -0.0f into 0.0f so both weld together
+    float values[3] = { p.x + 0.0f, p.y + 0.0f, p.z + 0.0f };
+    unsigned int bits[3] = { 0 };
+    memcpy(bits, values, sizeof(bits));
+
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < 3; i++)
+    {
+        hash = (hash ^ bits[i])*16777619u;
+        hash ^= hash >> 15;
+    }
+
+    return hash;
+}
+
+static unsigned int HashEdge(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+
+    return (unsigned int)key;
+}
+
+static int CompareEdgeRecord(const void* a, const void* b)
+{
+    const float angleA = ((const EdgeRecord*)a)->angle;
+    const float angleB = ((const EdgeRecord*)b)->angle;
+
+    return (angleA < angleB) - (angleA > angleB);
+}
+
+// Build the unique edges of one mesh, sorted by dihedral angle
+static void BuildEdgeMesh(EdgeMesh* edgeMesh, Mesh mesh, const QuantMesh* quant)
+{
+    const int vertexCount = mesh.vertexCount;
+    const int triangleCount = (mesh.indices != NULL) ? mesh.triangleCount : vertexCount/3;
+
+    // Weld vertices sharing a position, glTF splits them at UV and normal seams
+    unsigned int* welded = (unsigned int*)RL_MALLOC(vertexCount*sizeof(unsigned int));
+
+    const unsigned int weldCapacity = NextPowerOfTwo(vertexCount*2);
+    int* weldTable = (int*)RL_MALLOC(weldCapacity*sizeof(int));
+    memset(weldTable, 0xff, weldCapacity*sizeof(int));
+
+    for (int v = 0; v < vertexCount; v++)
+    {
+        Vector3 p = GetEdgeVertex(mesh, quant, v);
+        unsigned int slot = HashPosition(p) & (weldCapacity - 1);
+
+        while (weldTable[slot] >= 0)
+        {
+            Vector3 q = GetEdgeVertex(mesh, quant, weldTable[slot]);
+            if ((p.x == q.x) && (p.y == q.y) && (p.z == q.z)) break;
+
+            slot = (slot + 1) & (weldCapacity - 1);
+        }
+
+        if (weldTable[slot] < 0) weldTable[slot] = v;
+        welded[v] = (unsigned int)weldTable[slot];
+    }
+
+    RL_FREE(weldTable);
+
+    // Edge hash table: key is the welded vertex pair, value the edge slot
+    const unsigned int edgeCapacity = NextPowerOfTwo(triangleCount*3*2);
+    uint64_t* keys = (uint64_t*)RL_MALLOC(edgeCapacity*sizeof(uint64_t));
+    int* values = (int*)RL_MALLOC(edgeCapacity*sizeof(int));
+    memset(values, 0xff, edgeCapacity*sizeof(int));
+
+    EdgeRecord* records = (EdgeRecord*)RL_MALLOC(triangleCount*3*sizeof(EdgeRecord));
+    Vector3* firstNormals = (Vector3*)RL_MALLOC(triangleCount*3*sizeof(Vector3));
+    int* faceCounts = (int*)RL_MALLOC(triangleCount*3*sizeof(int));
+    int edgeCount = 0;
+
+    for (int t = 0; t < triangleCount; t++)
+    {
+        unsigned int tri[3] = { 0 };
+
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int index = (mesh.indices != NULL) ? mesh.indices[t*3 + k] : (unsigned int)(t*3 + k);
+            tri[k] = welded[index];
+        }
+
+        // Collapsed triangles contribute no edges
+        if ((tri[0] == tri[1]) || (tri[1] == tri[2]) || (tri[0] == tri[2])) continue;
+
+        Vector3 p0 = GetEdgeVertex(mesh, quant, tri[0]);
+        Vector3 p1 = GetEdgeVertex(mesh, quant, tri[1]);
+        Vector3 p2 = GetEdgeVertex(mesh, quant, tri[2]);
+
+        Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+        Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+        Vector3 normal = { e1.y*e2.z - e1.z*e2.y, e1.z*e2.x - e1.x*e2.z, e1.x*e2.y - e1.y*e2.x };
+
+        float length = sqrtf(normal.x*normal.x + normal.y*normal.y + normal.z*normal.z);
+        if (length > 0.0f) normal = (Vector3){ normal.x/length, normal.y/length, normal.z/length };
+
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int a = tri[k];
+            unsigned int b = tri[(k + 1)%3];
+            if (a > b) { unsigned int tmp = a; a = b; b = tmp; }
+
+            const uint64_t key = ((uint64_t)a << 32) | b;
+            unsigned int slot = HashEdge(key) & (edgeCapacity - 1);
+
+            while ((values[slot] >= 0) && (keys[slot] != key)) slot = (slot + 1) & (edgeCapacity - 1);
+
+            if (values[slot] < 0)
+            {
+                keys[slot] = key;
+                values[slot] = edgeCount;
+
+                records[edgeCount] = (EdgeRecord){ 0.0f, a, b };
+                firstNormals[edgeCount] = normal;
+                faceCounts[edgeCount] = 1;
+                edgeCount++;
+            }
+            else
+            {
+                // Shared edge, keep the sharpest angle for non-manifold fans
+                const int e = values[slot];
+                const Vector3 n = firstNormals[e];
+                float cosine = n.x*normal.x + n.y*normal.y + n.z*normal.z;
+                cosine = fmaxf(-1.0f, fminf(1.0f, cosine));
+
+                records[e].angle = fmaxf(records[e].angle, acosf(cosine)*RAD2DEG);
+                faceCounts[e]++;
+            }
+        }
+    }
+
+    for (int e = 0; e < edgeCount; e++)
+    {
+        if (faceCounts[e] == 1) records[e].angle = 180.0f;      // Boundary edge, always drawn
+    }
+
+    qsort(records, edgeCount, sizeof(EdgeRecord), CompareEdgeRecord);
+
+    edgeMesh->edgeCount = edgeCount;
+    edgeMesh->indices = (unsigned int*)RL_MALLOC(edgeCount*2*sizeof(unsigned int));
+    edgeMesh->angles = (float*)RL_MALLOC(edgeCount*sizeof(float));
+
+    for (int e = 0; e < edgeCount; e++)
+    {
+        edgeMesh->indices[e*2] = records[e].a;
+        edgeMesh->indices[e*2 + 1] = records[e].b;
+        edgeMesh->angles[e] = records[e].angle;
+    }
+
+    RL_FREE(faceCounts);
+    RL_FREE(firstNormals);
+    RL_FREE(records);
+    RL_FREE(values);
+    RL_FREE(keys);
+    RL_FREE(welded);
+}
+
+// Line index buffer in a VAO reading the mesh position buffer
+static void UploadEdgeMesh(EdgeMesh* edgeMesh, Mesh mesh, const QuantMesh* quant)
+{
+    edgeMesh->vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(edgeMesh->vaoId);
+
+    rlEnableVertexBuffer(mesh.vboId[0]);
+
+    if ((quant != NULL) && quant->isGpuCompact)
+    {
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, EDGES_GL_SHORT, true, 4*sizeof(short), 0);
+    }
+    else
+    {
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, 0, 0);
+    }
+
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+
+    edgeMesh->eboId = rlLoadVertexBufferElement(edgeMesh->indices, edgeMesh->edgeCount*2*sizeof(unsigned int), false);
+
+    rlDisableVertexArray();
+}
+
+//----------------------------------------------------------------
+
+EdgeModel LoadEdgeModel(Model model, QuantModel quant)
+{
+    EdgeModel edges = { 0 };
+
+    const double startTime = GetTime();
+
+    edges.meshCount = model.meshCount;
+    edges.meshes = (EdgeMesh*)RL_CALLOC(model.meshCount, sizeof(EdgeMesh));
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        const Mesh mesh = model.meshes[i];
+        const QuantMesh* quantMesh = ((i < quant.meshCount) && quant.meshes[i].isQuantized) ? &quant.meshes[i] : NULL;
+
+        if ((mesh.vertices == NULL) && (quantMesh == NULL)) continue;
+
+        BuildEdgeMesh(&edges.meshes[i], mesh, quantMesh);
+
+        // Drawing needs a VAO, without one the caller falls back to DrawModelWires()
+        if ((mesh.vaoId > 0) && (edges.meshes[i].edgeCount > 0)) UploadEdgeMesh(&edges.meshes[i], mesh, quantMesh);
+
+        edges.edgeCount += edges.meshes[i].edgeCount;
+        edges.triangleEdgeCount += 3*((mesh.indices != NULL) ? mesh.triangleCount : mesh.vertexCount/3);
+    }
+
+    edges.buildTime = GetTime() - startTime;
+
+    TraceLog(LOG_INFO, "EDGES: %d unique edges from %d triangle edges in %.2f ms", edges.edgeCount, edges.triangleEdgeCount, edges.buildTime*1000.0);
+
+    return edges;
+}
+
+void UnloadEdgeModel(EdgeModel edges)
+{
+    for (int i = 0; i < edges.meshCount; i++)
+    {
+        if (edges.meshes[i].vaoId > 0)
+        {
+            rlUnloadVertexArray(edges.meshes[i].vaoId);
+            rlUnloadVertexBuffer(edges.meshes[i].eboId);
+        }
+
+        RL_FREE(edges.meshes[i].indices);
+        RL_FREE(edges.meshes[i].angles);
+    }
+
+    RL_FREE(edges.meshes);
+}
+
+// Number of edges at or above the crease angle, they form a prefix of the sorted buffer
+int GetEdgeMeshCreaseCount(EdgeMesh mesh, float creaseAngle)
+{
+    int low = 0;
+    int high = mesh.edgeCount;
+
+    while (low < high)
+    {
+        int mid = (low + high)/2;
+
+        if (mesh.angles[mid] >= creaseAngle) low = mid + 1;
+        else high = mid;
+    }
+
+    return low;
+}
+
+static void DrawEdgeMesh(EdgeModel* edges, int meshIndex, QuantModel quant, Matrix viewProjection, Matrix world, float creaseAngle, int mvpLoc)
+{
+    const EdgeMesh* edgeMesh = &edges->meshes[meshIndex];
+
+    if (edgeMesh->vaoId == 0) return;
+
+    const int count = GetEdgeMeshCreaseCount(*edgeMesh, creaseAngle);
+    if (count == 0) return;
+
+    if (meshIndex < quant.meshCount) world = GetQuantMeshMatrix(quant.meshes[meshIndex], world);
+
+    rlSetUniformMatrix(mvpLoc, MatrixMultiply(viewProjection, world));
+
+    rlEnableVertexArray(edgeMesh->vaoId);
+    glDrawElements(GL_LINES, count*2, GL_UNSIGNED_INT, 0);
+    rlDisableVertexArray();
+
+    edges->drawnEdges += count;
+}
+
+void DrawEdgeModel(EdgeModel* edges, Model model, QuantModel quant, const InstanceScene* instances, Matrix transform, float creaseAngle, Color color)
+{
+    edges->drawnEdges = 0;
+
+    // Flush pending immediate mode geometry (grid, gizmo) before binding our own state
+    rlDrawRenderBatchActive();
+
+    rlEnableShader(rlGetShaderIdDefault());
+    int* locs = rlGetShaderLocsDefault();
+
+    const float colorDiffuse[4] = { color.r/255.0f, color.g/255.0f, color.b/255.0f, color.a/255.0f };
+    const float vertexColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], colorDiffuse, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetVertexAttributeDefault(locs[SHADER_LOC_VERTEX_COLOR], vertexColor, RL_SHADER_ATTRIB_VEC4, 4);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(rlGetTextureIdDefault());
+
+    const Matrix viewProjection = MatrixMultiply(rlGetMatrixProjection(), MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixTransform()));
+    const int mvpLoc = locs[SHADER_LOC_MATRIX_MVP];
+
+    if ((instances != NULL) && (instances->batchCount > 0))
+    {
+        for (int i = 0; i < instances->batchCount; i++)
+        {
+            const InstanceBatch* batch = &instances->batches[i];
+
+            for (int k = 0; k < batch->instanceCount; k++)
+            {
+                DrawEdgeMesh(edges, batch->meshIndex, quant, viewProjection, MatrixMultiply(transform, batch->transforms[k]), creaseAngle, mvpLoc);
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; (i < model.meshCount) && (i < edges->meshCount); i++)
+        {
+            DrawEdgeMesh(edges, i, quant, viewProjection, transform, creaseAngle, mvpLoc);
+        }
+    }
+
+    rlDisableTexture();
+    rlDisableShader();
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************************
+*
+*   edges - Deduplicated edge index buffers for wireframe drawing
+*
+*   DrawModelWires() rasterizes every triangle in line mode, so edges shared by two triangles
+*   are drawn twice. At load time every mesh gets a GL_LINES index buffer with each edge once:
+*   vertices are welded by position (glTF splits them at UV/normal seams), edges are keyed by
+*   their welded vertex pair in an open addressing hash table and sorted by dihedral angle,
+*   sharpest first. A crease angle filter then only has to draw a prefix of the buffer.
+*
+*   The edge VAO shares the mesh position buffer, CPU skinned animation shows up in the wires.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef EDGES_H
+#define EDGES_H
+
+#include "raylib.h"
+#include "quant.h"
+#include "instancing.h"
+
+typedef struct
+{
+    int edgeCount;
+    unsigned int* indices;      // Two vertex indices per edge, sorted by angle (descending)
+    float* angles;              // Dihedral angle in degrees, 180 for boundary edges
+
+    unsigned int vaoId;         // Shares the mesh position buffer
+    unsigned int eboId;
+} EdgeMesh;
+
+typedef struct
+{
+    int meshCount;
+    EdgeMesh* meshes;
+
+    int edgeCount;              // Unique edges over all meshes
+    int triangleEdgeCount;      // Edges DrawModelWires() draws (3 per triangle)
+    double buildTime;           // Seconds spent in LoadEdgeModel()
+
+    int drawnEdges;             // Edges submitted by the last DrawEdgeModel()
+} EdgeModel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+EdgeModel LoadEdgeModel(Model model, QuantModel quant);
+void UnloadEdgeModel(EdgeModel edges);
+
+int GetEdgeMeshCreaseCount(EdgeMesh mesh, float creaseAngle);
+void DrawEdgeModel(EdgeModel* edges, Model model, QuantModel quant, const InstanceScene* instances, Matrix transform, float creaseAngle, Color color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGES_H
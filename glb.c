@@ -0,0 +1,289 @@
+/*******************************************************************************************
+*
+*   glb - Partial reads of binary glTF (.glb) containers
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "glb.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_OTHER
+#include "memtrack.h"
+
+#include <string.h>
+#include <fcntl.h>              // Required for: open()
+
+#if defined(_WIN32)
+    #include <io.h>             // Required for: _read(), _lseeki64(), _close()
+    #define GLB_OPEN_FLAGS      (O_RDONLY | O_BINARY)
+#else
+    #include <unistd.h>         // Required for: pread(), lseek(), close()
+    #define GLB_OPEN_FLAGS      O_RDONLY
+#endif
+
+#define GLB_MAGIC           0x46546C67      // "glTF"
+#define GLB_CHUNK_JSON      0x4E4F534A      // "JSON"
+#define GLB_CHUNK_BIN       0x004E4942      // "BIN\0"
+#define GLB_HEADER_SIZE     20              // File header and the JSON chunk header
+
+// glTF stores everything little endian
+static unsigned int ReadUint32(const unsigned char* bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) | ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+}
+
+static bool ReadBytes(GlbFile* glb, size_t offset, size_t size, void* data)
+{
+    if (fseek(glb->file, (long)offset, SEEK_SET) != 0) return false;
+    if (fread(data, 1, size, glb->file) != size) return false;
+
+    glb->bytesRead += size;
+
+    return true;
+}
+
+// Reads at offset without a shared file position, short only at the end of the file
+static size_t PeekFile(int fd, size_t offset, size_t size, void* data)
+{
+    size_t total = 0;
+
+    while (total < size)
+    {
+#if defined(_WIN32)
+        // Windows has no pread(), every caller has its own descriptor so seeking is safe
+        const int count = (_lseeki64(fd, (long long)(offset + total), SEEK_SET) >= 0) ? _read(fd, (char*)data + total, (unsigned int)(size - total)) : -1;
+#else
+        const ssize_t count = pread(fd, (char*)data + total, size - total, (off_t)(offset + total));
+#endif
+        if (count <= 0) break;
+
+        total += (size_t)count;
+    }
+
+    return total;
+}
+
+// Header fields of a .glb, the JSON chunk must fit in the declared length and in the file itself.
+// Lengths are compared in 64 bits, a crafted length near 4 GB must not wrap
+static bool ReadGlbHeader(const unsigned char* header, long long fileSize, GlbFile* glb)
+{
+    if ((ReadUint32(header) != GLB_MAGIC) || (ReadUint32(header + 16) != GLB_CHUNK_JSON)) return false;
+
+    glb->version = ReadUint32(header + 4);
+    glb->length = ReadUint32(header + 8);
+    glb->jsonLength = ReadUint32(header + 12);
+
+    const long long jsonEnd = GLB_HEADER_SIZE + (long long)glb->jsonLength;
+
+    return (glb->version == 2) && (jsonEnd <= (long long)glb->length) && (jsonEnd <= fileSize);
+}
+
+static void CountGlbPrimitive(const cgltf_primitive* primitive, GlbStats* stats)
+{
+    const cgltf_accessor* positions = NULL;
+
+    for (cgltf_size i = 0; i < primitive->attributes_count; i++)
+    {
+        if (primitive->attributes[i].type == cgltf_attribute_type_position) positions = primitive->attributes[i].data;
+    }
+
+    if (positions == NULL) return;
+
+    stats->vertexCount += (long long)positions->count;
+
+    const long long indexCount = (long long)((primitive->indices != NULL) ? primitive->indices->count : positions->count);
+
+    if (primitive->type == cgltf_primitive_type_triangles) stats->triangleCount += indexCount/3;
+    else if ((primitive->type == cgltf_primitive_type_triangle_strip) || (primitive->type == cgltf_primitive_type_triangle_fan))
+    {
+        if (indexCount >= 3) stats->triangleCount += indexCount - 2;
+    }
+}
+
+//----------------------------------------------------------------
+
+GlbFile OpenGlbFile(const char* fileName)
+{
+    GlbFile glb = { 0 };
+
+    glb.file = fopen(fileName, "rb");
+    if (glb.file == NULL) return glb;
+
+    unsigned char header[GLB_HEADER_SIZE] = { 0 };
+    const long long fileSize = (fseek(glb.file, 0, SEEK_END) == 0) ? (long long)ftell(glb.file) : -1;
+
+    // Header (magic, version, length) followed by the JSON chunk header
+    if (!ReadBytes(&glb, 0, sizeof(header), header) || !ReadGlbHeader(header, fileSize, &glb))
+    {
+        CloseGlbFile(&glb);
+        return glb;
+    }
+
+    glb.json = (char*)RL_MALLOC((size_t)glb.jsonLength + 1);
+
+    if ((glb.json == NULL) || !ReadBytes(&glb, sizeof(header), glb.jsonLength, glb.json))
+    {
+        CloseGlbFile(&glb);
+        return glb;
+    }
+
+    glb.json[glb.jsonLength] = '\0';
+
+    // Optional BIN chunk, chunks are 4 byte aligned. jsonLength is bounded above, the sum can't wrap
+    const long long binHeaderOffset = sizeof(header) + (((long long)glb.jsonLength + 3) & ~3ll);
+    unsigned char binHeader[8] = { 0 };
+
+    if ((binHeaderOffset + (long long)sizeof(binHeader) <= (long long)glb.length) && ReadBytes(&glb, (size_t)binHeaderOffset, sizeof(binHeader), binHeader) && (ReadUint32(binHeader + 4) == GLB_CHUNK_BIN))
+    {
+        glb.binOffset = (unsigned int)(binHeaderOffset + sizeof(binHeader));
+        glb.binLength = ReadUint32(binHeader);
+
+        // Views are bounded by binLength, a chunk past the end of the file is not read at all
+        if ((long long)glb.binOffset + glb.binLength > fileSize) glb.binOffset = glb.binLength = 0;
+    }
+
+    return glb;
+}
+
+void CloseGlbFile(GlbFile* glb)
+{
+    if (glb->file != NULL) fclose(glb->file);
+    RL_FREE(glb->json);
+
+    glb->file = NULL;
+    glb->json = NULL;
+}
+
+cgltf_data* ParseGlbJson(const GlbFile* glb)
+{
+    if (glb->json == NULL) return NULL;
+
+    cgltf_options options = { cgltf_file_type_invalid };
+    options.type = cgltf_file_type_gltf;
+
+    cgltf_data* data = NULL;
+    if (cgltf_parse(&options, glb->json, glb->jsonLength, &data) != cgltf_result_success) return NULL;
+
+    return data;
+}
+
+bool LoadGlbBufferView(GlbFile* glb, cgltf_buffer_view* view)
+{
+    if (view->data != NULL) return true;
+
+    // Only the embedded buffer (no uri) lives in the BIN chunk
+    if ((view->buffer == NULL) || (view->buffer->uri != NULL) || (glb->binOffset == 0)) return false;
+    if (view->offset + view->size > glb->binLength) return false;
+
+    void* data = RL_MALLOC(view->size);
+
+    if ((data == NULL) || !ReadBytes(glb, glb->binOffset + view->offset, view->size, data))
+    {
+        RL_FREE(data);
+        return false;
+    }
+
+    view->data = data;
+
+    return true;
+}
+
+void UnloadGlbData(cgltf_data* data)
+{
+    if (data == NULL) return;
+
+    // Freed here with our allocator, cgltf_free() must not see them
+    for (cgltf_size i = 0; i < data->buffer_views_count; i++)
+    {
+        RL_FREE(data->buffer_views[i].data);
+        data->buffer_views[i].data = NULL;
+    }
+
+    cgltf_free(data);
+}
+
+bool ReadGlbStats(const char* fileName, GlbStats* stats)
+{
+    *stats = (GlbStats){ 0 };
+
+#if defined(_WIN32)
+    const int fd = _open(fileName, GLB_OPEN_FLAGS);
+#else
+    const int fd = open(fileName, GLB_OPEN_FLAGS);
+#endif
+    if (fd < 0) return false;
+
+    GlbFile glb = { 0 };
+    unsigned char header[GLB_HEADER_SIZE] = { 0 };
+#if defined(_WIN32)
+    const long long fileSize = _lseeki64(fd, 0, SEEK_END);
+#else
+    const long long fileSize = (long long)lseek(fd, 0, SEEK_END);
+#endif
+
+    // Same checks as OpenGlbFile(), the JSON is read to its last byte and no further
+    bool isValid = (PeekFile(fd, 0, sizeof(header), header) == sizeof(header)) && ReadGlbHeader(header, fileSize, &glb);
+
+    if (isValid)
+    {
+        glb.json = (char*)RL_MALLOC((size_t)glb.jsonLength + 1);
+        isValid = (glb.json != NULL) && (PeekFile(fd, sizeof(header), glb.jsonLength, glb.json) == glb.jsonLength);
+    }
+
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+
+    cgltf_data* data = NULL;
+
+    if (isValid)
+    {
+        glb.json[glb.jsonLength] = '\0';
+        data = ParseGlbJson(&glb);
+    }
+
+    RL_FREE(glb.json);
+
+    if (data == NULL) return false;
+
+    stats->version = glb.version;
+    stats->bytesRead = sizeof(header) + glb.jsonLength;
+    if (data->asset.version != NULL) snprintf(stats->assetVersion, sizeof(stats->assetVersion), "%s", data->asset.version);
+    if (data->asset.generator != NULL) snprintf(stats->generator, sizeof(stats->generator), "%s", data->asset.generator);
+
+    stats->meshCount = (int)data->meshes_count;
+    stats->clipCount = (int)data->animations_count;
+    stats->textureCount = (int)data->textures_count;
+
+    for (cgltf_size i = 0; i < data->meshes_count; i++)
+    {
+        for (cgltf_size p = 0; p < data->meshes[i].primitives_count; p++) CountGlbPrimitive(&data->meshes[i].primitives[p], stats);
+    }
+
+    for (cgltf_size i = 0; i < data->skins_count; i++)
+    {
+        if ((int)data->skins[i].joints_count > stats->boneCount) stats->boneCount = (int)data->skins[i].joints_count;
+    }
+
+    UnloadGlbData(data);
+
+    return true;
+}
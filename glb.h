@@ -0,0 +1,96 @@
+/*******************************************************************************************
+*
+*   glb - Partial reads of binary glTF (.glb) containers
+*
+*   Reads the 12 byte header and the JSON chunk, and remembers where the BIN chunk starts.
+*   Buffer views are read one by one on request, so a caller only pays for the bytes it
+*   uses (no textures, no animation data unless asked for).
+*
+*   ReadGlbStats() goes further for listings of many files: two pread() calls, the header and
+*   the JSON chunk, and the counts a file picker shows are taken from the parsed JSON.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef GLB_H
+#define GLB_H
+
+#include "raylib.h"
+#include "external/cgltf.h"     // Implementation is compiled into raylib (models.c)
+
+#include <stdio.h>
+
+typedef struct
+{
+    FILE* file;                 // NULL when the file is missing or not a valid .glb
+
+    unsigned int version;
+    unsigned int length;        // Total length from the header
+
+    char* json;                 // JSON chunk, null terminated
+    unsigned int jsonLength;
+
+    unsigned int binOffset;     // File offset of the BIN chunk data, 0 without one
+    unsigned int binLength;
+
+    size_t bytesRead;           // Header, JSON and buffer view bytes read so far
+} GlbFile;
+
+// Counts of the mesh definitions, an instanced mesh counts once
+typedef struct
+{
+    unsigned int version;       // Container version from the header
+    char assetVersion[8];       // asset.version from the JSON, "2.0"
+    char generator[48];         // asset.generator, the exporter and its version
+
+    int meshCount;
+    long long vertexCount;      // POSITION accessor counts of every primitive
+    long long triangleCount;    // Triangle, strip and fan primitives
+    int boneCount;              // Joints of the largest skin
+    int clipCount;
+    int textureCount;
+
+    size_t bytesRead;           // Header and JSON chunk
+} GlbStats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+GlbFile OpenGlbFile(const char* fileName);
+void CloseGlbFile(GlbFile* glb);
+
+// Parses the JSON chunk only, buffers are left unloaded
+cgltf_data* ParseGlbJson(const GlbFile* glb);
+
+// Reads one buffer view of the BIN chunk into view->data (once), cgltf_accessor_read_*() then work on it
+bool LoadGlbBufferView(GlbFile* glb, cgltf_buffer_view* view);
+
+// Frees the view data loaded above and the cgltf data
+void UnloadGlbData(cgltf_data* data);
+
+// Reads the header and the JSON chunk, never the BIN chunk. Opens its own descriptor, safe to
+// call from several threads
+bool ReadGlbStats(const char* fileName, GlbStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLB_H
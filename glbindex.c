@@ -0,0 +1,237 @@
+/*******************************************************************************************
+*
+*   glbindex - .glb statistics of a directory listing, read on worker threads
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "glbindex.h"
+#include "trace.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+    #include <unistd.h>         // Required for: sysconf()
+#endif
+
+struct GlbIndexJobs
+{
+    pthread_t threads[GLB_INDEX_MAX_THREADS];
+    int threadCount;
+    pthread_mutex_t mutex;
+
+    bool isCancelled;
+
+    int count;
+    char** paths;               // Owned copies, NULL for entries that are not indexed
+    int nextJob;
+
+    GlbStats* stats;            // Written by the worker that claimed the entry
+    bool* isRead;
+    int* finished;              // Indices in completion order
+    int finishedCount;
+    int publishedCount;
+};
+
+//----------------------------------------------------------------
+// Workers
+
+// Claims batches until the queue is empty or cancelled
+static void ReadGlbIndexJobs(struct GlbIndexJobs* jobs)
+{
+    int batch[GLB_INDEX_BATCH_SIZE] = { 0 };
+
+    while (true)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+
+        int batchCount = 0;
+
+        while (!jobs->isCancelled && (jobs->nextJob < jobs->count) && (batchCount < GLB_INDEX_BATCH_SIZE))
+        {
+            if (jobs->paths[jobs->nextJob] != NULL) batch[batchCount++] = jobs->nextJob;
+            jobs->nextJob++;
+        }
+
+        pthread_mutex_unlock(&jobs->mutex);
+
+        if (batchCount == 0) break;
+
+        TraceBegin("glb stats");
+        for (int i = 0; i < batchCount; i++) jobs->isRead[batch[i]] = ReadGlbStats(jobs->paths[batch[i]], &jobs->stats[batch[i]]);
+        TraceEnd();
+
+        pthread_mutex_lock(&jobs->mutex);
+
+        for (int i = 0; i < batchCount; i++) jobs->finished[jobs->finishedCount++] = batch[i];
+
+        pthread_mutex_unlock(&jobs->mutex);
+    }
+}
+
+static void* GlbIndexWorkerMain(void* arg)
+{
+    SetTraceThreadName("glb index");
+    ReadGlbIndexJobs((struct GlbIndexJobs*)arg);
+
+    return NULL;
+}
+
+static int GetGlbIndexThreadCount(void)
+{
+#if defined(_WIN32)
+    int count = 4;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);   // Threads mostly wait on reads, use every core
+#endif
+
+    if (count < 2) count = 2;
+    if (count > GLB_INDEX_MAX_THREADS) count = GLB_INDEX_MAX_THREADS;
+
+    return count;
+}
+
+//----------------------------------------------------------------
+
+GlbIndex LoadGlbIndex(FilePathList files)
+{
+    GlbIndex index = { 0 };
+
+    index.count = files.count;
+    index.states = (GlbIndexState*)RL_CALLOC((files.count > 0) ? files.count : 1, sizeof(GlbIndexState));
+    index.stats = (GlbStats*)RL_CALLOC((files.count > 0) ? files.count : 1, sizeof(GlbStats));
+    index.startTime = GetTime();
+
+    struct GlbIndexJobs* jobs = (struct GlbIndexJobs*)RL_CALLOC(1, sizeof(struct GlbIndexJobs));
+    index.jobs = jobs;
+
+    jobs->count = files.count;
+    jobs->paths = (char**)RL_CALLOC(index.count + 1, sizeof(char*));
+    jobs->stats = (GlbStats*)RL_CALLOC(index.count + 1, sizeof(GlbStats));
+    jobs->isRead = (bool*)RL_CALLOC(index.count + 1, sizeof(bool));
+    jobs->finished = (int*)RL_CALLOC(index.count + 1, sizeof(int));
+
+    // Extensions are checked here, IsFileExtension() is not thread safe. A directory named
+    // *.glb can't be read and ends up GLB_INDEX_FAILED, no stat() needed
+    for (int i = 0; i < index.count; i++)
+    {
+        if (!IsFileExtension(files.paths[i], ".glb")) continue;
+
+        const size_t length = strlen(files.paths[i]);
+        jobs->paths[i] = (char*)RL_MALLOC(length + 1);
+        memcpy(jobs->paths[i], files.paths[i], length + 1);
+
+        index.states[i] = GLB_INDEX_PENDING;
+        index.requestedCount++;
+    }
+
+    pthread_mutex_init(&jobs->mutex, NULL);
+
+    if (index.requestedCount > 0)
+    {
+        const int threadCount = (index.requestedCount < GetGlbIndexThreadCount()) ? index.requestedCount : GetGlbIndexThreadCount();
+
+        for (int i = 0; i < threadCount; i++)
+        {
+            if (pthread_create(&jobs->threads[jobs->threadCount], NULL, GlbIndexWorkerMain, jobs) == 0) jobs->threadCount++;
+        }
+
+        // Headers take microseconds each, without workers they are read here and published by the next update
+        if (jobs->threadCount == 0)
+        {
+            TraceLog(LOG_WARNING, "GLBINDEX: Failed to start worker threads, reading on the calling thread");
+            ReadGlbIndexJobs(jobs);
+        }
+    }
+
+    return index;
+}
+
+void UnloadGlbIndex(GlbIndex index)
+{
+    struct GlbIndexJobs* jobs = index.jobs;
+
+    if (jobs != NULL)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+        jobs->isCancelled = true;
+        pthread_mutex_unlock(&jobs->mutex);
+
+        for (int i = 0; i < jobs->threadCount; i++) pthread_join(jobs->threads[i], NULL);
+
+        pthread_mutex_destroy(&jobs->mutex);
+
+        for (int i = 0; i < jobs->count; i++) RL_FREE(jobs->paths[i]);
+
+        RL_FREE(jobs->finished);
+        RL_FREE(jobs->isRead);
+        RL_FREE(jobs->stats);
+        RL_FREE(jobs->paths);
+        RL_FREE(jobs);
+    }
+
+    RL_FREE(index.stats);
+    RL_FREE(index.states);
+}
+
+void UpdateGlbIndex(GlbIndex* index)
+{
+    struct GlbIndexJobs* jobs = index->jobs;
+
+    if ((jobs == NULL) || (index->completedCount == index->requestedCount)) return;
+
+    pthread_mutex_lock(&jobs->mutex);
+    const int finishedCount = jobs->finishedCount;
+    pthread_mutex_unlock(&jobs->mutex);
+
+    // Entries before finishedCount are final, no lock needed to read them. Nothing is uploaded,
+    // so everything finished is published at once
+    while (jobs->publishedCount < finishedCount)
+    {
+        const int i = jobs->finished[jobs->publishedCount++];
+
+        if (jobs->isRead[i])
+        {
+            index->stats[i] = jobs->stats[i];
+            index->states[i] = GLB_INDEX_READY;
+            index->bytesRead += jobs->stats[i].bytesRead;
+        }
+        else index->states[i] = GLB_INDEX_FAILED;
+
+        index->completedCount++;
+    }
+
+    const double elapsed = GetTime() - index->startTime;
+    if (elapsed > 0.0) index->filesPerSecond = (float)(index->completedCount/elapsed);
+
+    if (index->completedCount == index->requestedCount)
+    {
+        TraceLog(LOG_INFO, "GLBINDEX: %d files in %.2f s (%.0f/s, %.1f KB read)", index->completedCount, elapsed, index->filesPerSecond, index->bytesRead/1024.0);
+    }
+}
+
+bool IsGlbIndexBusy(GlbIndex index)
+{
+    return (index.jobs != NULL) && (index.completedCount < index.requestedCount);
+}
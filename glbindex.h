@@ -0,0 +1,78 @@
+/*******************************************************************************************
+*
+*   glbindex - .glb statistics of a directory listing, read on worker threads
+*
+*   Every .glb of a listing is queued to a small thread pool that calls ReadGlbStats(), the
+*   header and the JSON chunk of each file and nothing of the BIN chunk. Finished entries are
+*   published to the main thread in UpdateGlbIndex(), the file dialog shows them as columns.
+*
+*   The work is mostly waiting on the disk, so the pool is not limited to the spare cores.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef GLBINDEX_H
+#define GLBINDEX_H
+
+#include "raylib.h"
+#include "glb.h"
+
+#define GLB_INDEX_MAX_THREADS   8
+#define GLB_INDEX_BATCH_SIZE    16      // Files claimed and published per lock, a file takes a few microseconds
+
+typedef enum
+{
+    GLB_INDEX_NONE = 0,         // Not a .glb file
+    GLB_INDEX_PENDING,
+    GLB_INDEX_READY,
+    GLB_INDEX_FAILED
+} GlbIndexState;
+
+typedef struct
+{
+    int count;
+    GlbIndexState* states;      // One per listed path
+    GlbStats* stats;            // Valid for GLB_INDEX_READY entries
+
+    int requestedCount;         // .glb files queued
+    int completedCount;         // Read or failed
+    size_t bytesRead;           // Header and JSON bytes of the read files
+
+    double startTime;
+    float filesPerSecond;       // Completed files over the time since the listing was loaded
+
+    struct GlbIndexJobs* jobs;
+} GlbIndex;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+GlbIndex LoadGlbIndex(FilePathList files);
+void UnloadGlbIndex(GlbIndex index);
+
+// Publishes finished entries, call once per frame from the main thread
+void UpdateGlbIndex(GlbIndex* index);
+bool IsGlbIndexBusy(GlbIndex index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLBINDEX_H
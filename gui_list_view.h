@@ -0,0 +1,218 @@
+/*******************************************************************************************
+*
+*   Gui List View - Virtualized list view control drawn with raygui
+*
+*   MODULE USAGE:
+*       #define GUI_LIST_VIEW_IMPLEMENTATION
+*       #include "gui_list_view.h"
+*
+*       INIT: ListView view = LoadListView(count, rowHeight);
+*       DRAW: int clicked = GuiListViewVirtual(bounds, &view, active, hasKeyboard, DrawRow, userData);
+*
+*   Rows are drawn by a callback and only the visible ones are visited, see listview.h. The
+*   control handles the wheel, dragging the scrollbar thumb, clicks and, while it has the
+*   keyboard, up/down, page up/down, home/end and enter.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "raylib.h"
+#include "listview.h"
+
+#ifndef GUI_LIST_VIEW_H
+#define GUI_LIST_VIEW_H
+
+// Draws one row, state is a raygui GuiState (STATE_PRESSED for the active row)
+typedef void (*GuiListViewRowFunc)(Rectangle bounds, int row, int state, void *userData);
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+// Returns the row clicked or activated with enter, -1 otherwise
+int GuiListViewVirtual(Rectangle bounds, ListView *view, int active, bool hasKeyboard, GuiListViewRowFunc drawRow, void *userData);
+
+// Row drawn like a GuiListViewEx() item, the text can start with an icon (#12#name)
+void GuiListViewText(Rectangle bounds, const char *text, int state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GUI_LIST_VIEW_H
+
+/***********************************************************************************
+*
+*   GUI_LIST_VIEW IMPLEMENTATION
+*
+************************************************************************************/
+#if defined(GUI_LIST_VIEW_IMPLEMENTATION)
+
+#include "raygui-4.0/src/raygui.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define LIST_VIEW_MIN_THUMB_SIZE    16
+
+//----------------------------------------------------------------------------------
+// Internal Module Functions Definition
+//----------------------------------------------------------------------------------
+static bool IsListViewKeyPressed(int key)
+{
+    return IsKeyPressed(key) || IsKeyPressedRepeat(key);
+}
+
+static ListViewInput GetListViewInput(bool isHovered, bool hasKeyboard)
+{
+    ListViewInput input = { 0 };
+
+    if (isHovered) input.wheel = GetMouseWheelMove();
+
+    if (hasKeyboard)
+    {
+        if (IsListViewKeyPressed(KEY_UP)) input.move = LIST_VIEW_MOVE_UP;
+        else if (IsListViewKeyPressed(KEY_DOWN)) input.move = LIST_VIEW_MOVE_DOWN;
+        else if (IsListViewKeyPressed(KEY_PAGE_UP)) input.move = LIST_VIEW_MOVE_PAGE_UP;
+        else if (IsListViewKeyPressed(KEY_PAGE_DOWN)) input.move = LIST_VIEW_MOVE_PAGE_DOWN;
+        else if (IsKeyPressed(KEY_HOME)) input.move = LIST_VIEW_MOVE_HOME;
+        else if (IsKeyPressed(KEY_END)) input.move = LIST_VIEW_MOVE_END;
+
+        input.activate = IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_KP_ENTER);
+    }
+
+    return input;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// List view control, the scroll maps linearly to the thumb so dragging it costs the same at any count
+int GuiListViewVirtual(Rectangle bounds, ListView *view, int active, bool hasKeyboard, GuiListViewRowFunc drawRow, void *userData)
+{
+    const bool isLocked = GuiIsLocked();
+    const int borderWidth = GuiGetStyle(DEFAULT, BORDER_WIDTH);
+    const Vector2 mousePosition = GetMousePosition();
+    const bool isHovered = !isLocked && CheckCollisionPointRec(mousePosition, bounds);
+
+    Rectangle rowsBounds = { bounds.x + borderWidth, bounds.y + borderWidth, bounds.width - 2*borderWidth, bounds.height - 2*borderWidth };
+
+    const float contentHeight = GetListViewContentHeight(view);
+    const float maxScroll = contentHeight - rowsBounds.height;
+    const bool useScrollBar = (maxScroll > 0.0f);
+
+    Rectangle scrollBarBounds = { 0 };
+    Rectangle thumbBounds = { 0 };
+
+    if (useScrollBar)
+    {
+        rowsBounds.width -= GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH);
+        scrollBarBounds = (Rectangle){ rowsBounds.x + rowsBounds.width, rowsBounds.y, (float)GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH), rowsBounds.height };
+    }
+
+    // Update control
+    //--------------------------------------------------------------------
+    int result = UpdateListView(view, rowsBounds.height, GetListViewInput(isHovered, hasKeyboard && !isLocked));
+
+    if (useScrollBar)
+    {
+        float thumbHeight = scrollBarBounds.height*rowsBounds.height/contentHeight;
+        if (thumbHeight < LIST_VIEW_MIN_THUMB_SIZE) thumbHeight = LIST_VIEW_MIN_THUMB_SIZE;
+
+        const float track = scrollBarBounds.height - thumbHeight;
+
+        if (!isLocked && IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && CheckCollisionPointRec(mousePosition, scrollBarBounds))
+        {
+            const float thumbY = scrollBarBounds.y + view->scroll/maxScroll*track;
+
+            // Pressing the track outside the thumb centers the thumb on the mouse
+            view->thumbGrab = ((mousePosition.y >= thumbY) && (mousePosition.y < thumbY + thumbHeight)) ? mousePosition.y - thumbY : thumbHeight/2;
+            view->isDraggingThumb = true;
+        }
+
+        if (view->isDraggingThumb)
+        {
+            if (track > 0.0f) ScrollListView(view, (mousePosition.y - view->thumbGrab - scrollBarBounds.y)/track*maxScroll, rowsBounds.height);
+            if (!IsMouseButtonDown(MOUSE_BUTTON_LEFT)) view->isDraggingThumb = false;
+
+            UpdateListView(view, rowsBounds.height, (ListViewInput){ 0 });
+        }
+
+        thumbBounds = (Rectangle){ scrollBarBounds.x, scrollBarBounds.y + view->scroll/maxScroll*track, scrollBarBounds.width, thumbHeight };
+    }
+    else view->isDraggingThumb = false;
+    //--------------------------------------------------------------------
+
+    // Draw control
+    //--------------------------------------------------------------------
+    GuiDrawRectangle(bounds, borderWidth, GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_NORMAL)), GetColor(GuiGetStyle(DEFAULT, BACKGROUND_COLOR)));
+
+    BeginScissorMode((int)rowsBounds.x, (int)rowsBounds.y, (int)rowsBounds.width, (int)rowsBounds.height);
+
+    float y = rowsBounds.y + view->firstTop;
+
+    for (int row = view->first; row < view->last; row++)
+    {
+        const Rectangle rowBounds = { rowsBounds.x, y, rowsBounds.width, GetListViewRowHeight(view, row) };
+        const bool isRowHovered = isHovered && !view->isDraggingThumb && CheckCollisionPointRec(mousePosition, rowsBounds) && CheckCollisionPointRec(mousePosition, rowBounds);
+
+        int state = STATE_NORMAL;
+        if (row == active) state = STATE_PRESSED;
+        else if (isRowHovered || (row == view->focused)) state = STATE_FOCUSED;
+
+        drawRow(rowBounds, row, state, userData);
+
+        if (isRowHovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+        {
+            view->focused = row;
+            result = row;
+        }
+
+        y += rowBounds.height;
+    }
+
+    EndScissorMode();
+
+    if (useScrollBar)
+    {
+        const int thumbState = view->isDraggingThumb ? STATE_PRESSED : ((isHovered && CheckCollisionPointRec(mousePosition, thumbBounds)) ? STATE_FOCUSED : STATE_NORMAL);
+
+        GuiDrawRectangle(scrollBarBounds, 0, BLANK, GetColor(GuiGetStyle(SCROLLBAR, BASE_COLOR_NORMAL)));
+        GuiDrawRectangle(thumbBounds, 0, BLANK, GetColor(GuiGetStyle(SCROLLBAR, BORDER_COLOR_NORMAL + thumbState*3)));
+    }
+    //--------------------------------------------------------------------
+
+    return result;
+}
+
+void GuiListViewText(Rectangle bounds, const char *text, int state)
+{
+    if (state != STATE_NORMAL)
+    {
+        GuiDrawRectangle(bounds, GuiGetStyle(LISTVIEW, BORDER_WIDTH), GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_NORMAL + state*3)), GetColor(GuiGetStyle(LISTVIEW, BASE_COLOR_NORMAL + state*3)));
+    }
+
+    GuiDrawText(text, GetTextBounds(DEFAULT, bounds), GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT), GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_NORMAL + state*3)));
+}
+
+#endif // GUI_LIST_VIEW_IMPLEMENTATION
@@ -8,6 +8,7 @@
 *
 *       INIT: GuiWindowFileDialogState state = GuiInitWindowFileDialog();
 *       DRAW: GuiWindowFileDialog(&state);
+*       UNLOAD: UnloadGuiWindowFileDialog(&state);
 *
 *   NOTE: This module depends on some raylib file system functions:
 *       - LoadDirectoryFiles()
@@ -38,6 +39,11 @@
 **********************************************************************************************/
 
 #include "raylib.h"
+#include "thumbnails.h"
+#include "glbindex.h"
+#include "dirscan.h"
+#include "dircache.h"
+#include "gui_list_view.h"
 
 #ifndef GUI_WINDOW_FILE_DIALOG_H
 #define GUI_WINDOW_FILE_DIALOG_H
@@ -56,7 +62,7 @@ typedef struct {
     bool dirPathEditMode;
     char dirPathText[1024];
 
-    int filesListScrollIndex;
+    ListView filesList;             // .glb rows are taller to fit their thumbnail
     bool filesListEditMode;
     int filesListActive;
 
@@ -65,10 +71,12 @@ typedef struct {
     bool SelectFilePressed;
     bool CancelFilePressed;
     int fileTypeActive;
-    int itemFocused;
+    int sortModeActive;             // DirectorySortMode of the listing
 
     // Custom state variables
-    FilePathList dirFiles;
+    DirectoryScan dirScan;          // Filled in over several frames by a background thread
+    DirectoryCache dirCache;        // Listings left behind, kept while the dialog is closed
+    int *dirFileIcons;              // raygui icon of each entry
     char filterExt[256];
     char dirPathTextCopy[1024];
     char fileNameTextCopy[1024];
@@ -77,6 +85,12 @@ typedef struct {
 
     bool saveFileMode;
 
+    // Shaded thumbnails of the listed .glb files
+    ThumbnailSet thumbnails;
+
+    // Counts read from the JSON chunk of the listed .glb files, shown under their name
+    GlbIndex glbIndex;
+
 } GuiWindowFileDialogState;
 
 #ifdef __cplusplus
@@ -103,6 +117,7 @@ extern "C" {            // Prevents name mangling of functions
 //----------------------------------------------------------------------------------
 GuiWindowFileDialogState InitGuiWindowFileDialog(const char *initPath);
 void GuiWindowFileDialog(GuiWindowFileDialogState *state);
+void UnloadGuiWindowFileDialog(GuiWindowFileDialogState *state);
 
 #ifdef __cplusplus
 }
@@ -118,52 +133,31 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state);
 #if defined(GUI_WINDOW_FILE_DIALOG_IMPLEMENTATION)
 
 #include "raygui-4.0/src/raygui.h"
+#include "memtrack.h"
 
 #include <string.h>     // Required for: strcpy()
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-#define MAX_DIRECTORY_FILES    2048
-#define MAX_ICON_PATH_LENGTH    512
+#define FILE_LIST_ROW_HEIGHT            24
+#define FILE_LIST_THUMBNAIL_ROW_HEIGHT  40
+#define FILE_LIST_STATS_COLUMN_WIDTH    52
 #ifdef _WIN32
 #define PATH_SEPERATOR "\\"
 #else
 #define PATH_SEPERATOR "/"
 #endif
 
-//----------------------------------------------------------------------------------
-// Types and Structures Definition
-//----------------------------------------------------------------------------------
-#if defined(USE_CUSTOM_LISTVIEW_FILEINFO)
-// Detailed file info type
-typedef struct FileInfo {
-    const char *name;
-    int size;
-    int modTime;
-    int type;
-    int icon;
-} FileInfo;
-#else
-// Filename only
-typedef char *FileInfo;             // Files are just a path string
-#endif
-
-//----------------------------------------------------------------------------------
-// Global Variables Definition
-//----------------------------------------------------------------------------------
-FileInfo *dirFilesIcon = NULL;      // Path string + icon (for fancy drawing)
-
 //----------------------------------------------------------------------------------
 // Internal Module Functions Definition
 //----------------------------------------------------------------------------------
 // Read files in new path
 static void ReloadDirectoryFiles(GuiWindowFileDialogState *state);
-
-#if defined(USE_CUSTOM_LISTVIEW_FILEINFO)
-// List View control for files info with extended parameters
-static int GuiListViewFiles(Rectangle bounds, FileInfo *files, int count, int *focus, int *scrollIndex, int active);
-#endif
+static void UpdateDirectoryFiles(GuiWindowFileDialogState *state);
+static void SortDirectoryFiles(GuiWindowFileDialogState *state);
+static void AddDirectoryRows(GuiWindowFileDialogState *state, int first);
+static void DrawFileRow(Rectangle bounds, int row, int state, void *userData);
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
@@ -183,7 +177,7 @@ GuiWindowFileDialogState InitGuiWindowFileDialog(const char *initPath)
     state.dirPathEditMode = false;
     state.filesListActive = -1;
     state.prevFilesListActive = state.filesListActive;
-    state.filesListScrollIndex = 0;
+    state.filesList = LoadListView(0, FILE_LIST_ROW_HEIGHT);
 
     state.fileNameEditMode = false;
 
@@ -213,7 +207,7 @@ GuiWindowFileDialogState InitGuiWindowFileDialog(const char *initPath)
     state.filterExt[0] = '\0';
     //strcpy(state.filterExt, "all");
 
-    state.dirFiles.count = 0;
+    state.dirCache = LoadDirectoryCache(DIRECTORY_CACHE_MAX_ENTRIES, DIRECTORY_CACHE_MAX_BYTES);
 
     return state;
 }
@@ -257,22 +251,36 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state)
         }
         //----------------------------------------------------------------------------------------
 
-        // Load dirFilesIcon and state->dirFiles lazily on windows open
+        // Start reading the directory lazily on windows open, the list view exists once it has started
         // NOTE: They are automatically unloaded at fileDialog closing
         //----------------------------------------------------------------------------------------
-        if (dirFilesIcon == NULL)
-        {
-            dirFilesIcon = (FileInfo *)RL_CALLOC(MAX_DIRECTORY_FILES, sizeof(FileInfo));    // Max files to read
-            for (int i = 0; i < MAX_DIRECTORY_FILES; i++) dirFilesIcon[i] = (char *)RL_CALLOC(MAX_ICON_PATH_LENGTH, 1);    // Max file name length
-        }
+        if (state->filesList.offsets == NULL) ReloadDirectoryFiles(state);
 
-        // Load current directory files
-        if (state->dirFiles.paths == NULL) ReloadDirectoryFiles(state);
+        // Add the entries read since the last frame
+        if (state->dirScan.isScanning) UpdateDirectoryFiles(state);
         //----------------------------------------------------------------------------------------
 
         // Draw window and controls
         //----------------------------------------------------------------------------------------
-        state->windowActive = !GuiWindowBox(state->windowBounds, "#198# Select File Dialog");
+        UpdateThumbnailSet(&state->thumbnails);
+        UpdateGlbIndex(&state->glbIndex);
+
+        if (state->dirScan.isScanning)
+        {
+            state->windowActive = !GuiWindowBox(state->windowBounds, TextFormat("#198# Select File Dialog - reading, %d entries", state->dirScan.count));
+        }
+        else if (state->thumbnails.requestedCount > 0)
+        {
+            state->windowActive = !GuiWindowBox(state->windowBounds, TextFormat("#198# Select File Dialog - thumbnails %d/%d, %.1f/s - stats %d/%d, %.0f/s",
+                state->thumbnails.completedCount, state->thumbnails.requestedCount, state->thumbnails.thumbnailsPerSecond,
+                state->glbIndex.completedCount, state->glbIndex.requestedCount, state->glbIndex.filesPerSecond));
+        }
+#if defined(DIRECTORY_CACHE_STATS)
+        else state->windowActive = !GuiWindowBox(state->windowBounds, TextFormat("#198# Select File Dialog - cache %d hits, %d misses, %d stale",
+            state->dirCache.hitCount, state->dirCache.missCount, state->dirCache.staleCount));
+#else
+        else state->windowActive = !GuiWindowBox(state->windowBounds, "#198# Select File Dialog");
+#endif
 
         // Draw previous directory button + logic
         if (GuiButton((Rectangle){ state->windowBounds.x + state->windowBounds.width - 48, state->windowBounds.y + 24 + 12, 40, 24 }, "< .."))
@@ -309,25 +317,23 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state)
 
         // List view elements are aligned left
         int prevTextAlignment = GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT);
-        int prevElementsHeight = GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT);
         GuiSetStyle(LISTVIEW, TEXT_ALIGNMENT, TEXT_ALIGN_LEFT);
-        GuiSetStyle(LISTVIEW, LIST_ITEMS_HEIGHT, 24);
-# if defined(USE_CUSTOM_LISTVIEW_FILEINFO)
-        state->filesListActive = GuiListViewFiles((Rectangle){ state->position.x + 8, state->position.y + 48 + 20, state->windowBounds.width - 16, state->windowBounds.height - 60 - 16 - 68 }, fileInfo, state->dirFiles.count, &state->itemFocused, &state->filesListScrollIndex, state->filesListActive);
-# else
-        GuiListViewEx((Rectangle){ state->windowBounds.x + 8, state->windowBounds.y + 48 + 20, state->windowBounds.width - 16, state->windowBounds.height - 60 - 16 - 68 }, 
-                      (const char**)dirFilesIcon, state->dirFiles.count, &state->filesListScrollIndex, &state->filesListActive, &state->itemFocused);
-# endif
+
+        Rectangle filesListBounds = { state->windowBounds.x + 8, state->windowBounds.y + 48 + 20, state->windowBounds.width - 16, state->windowBounds.height - 60 - 16 - 68 };
+
+        // Only the visible rows are drawn, clicking or entering a row selects it
+        int filesListClicked = GuiListViewVirtual(filesListBounds, &state->filesList, state->filesListActive, !state->dirPathEditMode && !state->fileNameEditMode, DrawFileRow, state);
+        if (filesListClicked >= 0) state->filesListActive = filesListClicked;
+
         GuiSetStyle(LISTVIEW, TEXT_ALIGNMENT, prevTextAlignment);
-        GuiSetStyle(LISTVIEW, LIST_ITEMS_HEIGHT, prevElementsHeight);
 
         // Check if a path has been selected, if it is a directory, move to that directory (and reload paths)
         if ((state->filesListActive >= 0) && (state->filesListActive != state->prevFilesListActive))
             //&& (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_DPAD_A)))
         {
-            strcpy(state->fileNameText, GetFileName(state->dirFiles.paths[state->filesListActive]));
+            strcpy(state->fileNameText, GetDirectoryEntryName(&state->dirScan, state->filesListActive));
 
-            if (DirectoryExists(TextFormat("%s/%s", state->dirPathText, state->fileNameText)))
+            if (state->dirScan.entries[state->filesListActive].isDirectory)
             {
                 if (TextIsEqual(state->fileNameText, "..")) strcpy(state->dirPathText, GetPrevDirectoryPath(state->dirPathText));
                 else strcpy(state->dirPathText, TextFormat("%s/%s", (strcmp(state->dirPathText, "/") == 0)? "" : state->dirPathText, state->fileNameText));
@@ -358,11 +364,12 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state)
                 if (FileExists(TextFormat("%s/%s", state->dirPathText, state->fileNameText)))
                 {
                     // Select filename from list view
-                    for (int i = 0; i < state->dirFiles.count; i++)
+                    for (int i = 0; i < state->dirScan.count; i++)
                     {
-                        if (TextIsEqual(state->fileNameText, state->dirFiles.paths[i]))
+                        if (TextIsEqual(state->fileNameText, GetDirectoryEntryName(&state->dirScan, i)))
                         {
                             state->filesListActive = i;
+                            state->filesList.focused = i;
                             strcpy(state->fileNameTextCopy, state->fileNameText);
                             break;
                         }
@@ -378,7 +385,20 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state)
         }
 
         GuiLabel((Rectangle){ state->windowBounds.x + 8, state->windowBounds.y + state->windowBounds.height - 24 - 12, 68, 24 }, "File filter:");
-        GuiComboBox((Rectangle){ state->windowBounds.x + 72, state->windowBounds.y + state->windowBounds.height - 24 - 12, state->windowBounds.width - 184, 24 }, "All files", &state->fileTypeActive);
+        GuiComboBox((Rectangle){ state->windowBounds.x + 72, state->windowBounds.y + state->windowBounds.height - 24 - 12, state->windowBounds.width - 184 - 88, 24 }, "All files", &state->fileTypeActive);
+
+        // Size and date need the entry info, a listing read without it is read again
+        int prevSortModeActive = state->sortModeActive;
+        GuiComboBox((Rectangle){ state->windowBounds.x + state->windowBounds.width - 192, state->windowBounds.y + state->windowBounds.height - 24 - 12, 80, 24 }, "Name;Type;Size;Date", &state->sortModeActive);
+
+        if ((state->sortModeActive != prevSortModeActive) && !state->dirScan.isScanning)
+        {
+            if (!state->dirScan.hasInfo && ((state->sortModeActive == DIRECTORY_SORT_SIZE) || (state->sortModeActive == DIRECTORY_SORT_TIME))) ReloadDirectoryFiles(state);
+            else SortDirectoryFiles(state);
+
+            state->filesListActive = -1;
+            state->prevFilesListActive = -1;
+        }
 
         state->SelectFilePressed = GuiButton((Rectangle){ state->windowBounds.x + state->windowBounds.width - 96 - 8, state->windowBounds.y + state->windowBounds.height - 68, 96, 24 }, "Select");
 
@@ -391,235 +411,234 @@ void GuiWindowFileDialog(GuiWindowFileDialogState *state)
         // File dialog has been closed, free all memory before exit
         if (!state->windowActive)
         {
-            // Free dirFilesIcon memory
-            for (int i = 0; i < MAX_DIRECTORY_FILES; i++) RL_FREE(dirFilesIcon[i]);
+            // The listing is cached for the next time the dialog opens, a scan still reading is stopped
+            StoreCachedDirectory(&state->dirCache, &state->dirScan);
+
+            MemTrackFree(MEMORY_UI, state->dirFileIcons);
+            state->dirFileIcons = NULL;
 
-            RL_FREE(dirFilesIcon);
-            dirFilesIcon = NULL;
+            UnloadListView(state->filesList);
+            state->filesList = (ListView){ 0 };
 
-            // Unload directory file paths
-            UnloadDirectoryFiles(state->dirFiles);
+            UnloadThumbnailSet(state->thumbnails);
+            state->thumbnails = (ThumbnailSet){ 0 };
 
-            // Reset state variables
-            state->dirFiles.count = 0;
-            state->dirFiles.capacity = 0;
-            state->dirFiles.paths = NULL;
+            UnloadGlbIndex(state->glbIndex);
+            state->glbIndex = (GlbIndex){ 0 };
         }
     }
 }
 
-// Compare two files from a directory
-static inline int FileCompare(const char *d1, const char *d2, const char *dir)
+// Unload the listing and its cache, the dialog is not used again
+void UnloadGuiWindowFileDialog(GuiWindowFileDialogState *state)
 {
-    const bool b1 = DirectoryExists(TextFormat("%s/%s", dir, d1));
-    const bool b2 = DirectoryExists(TextFormat("%s/%s", dir, d2));
+    UnloadDirectoryScan(state->dirScan);
+    state->dirScan = (DirectoryScan){ 0 };
 
-    if (b1 && !b2) return -1;
-    if (!b1 && b2) return 1;
+    UnloadDirectoryCache(state->dirCache);
+    state->dirCache = (DirectoryCache){ 0 };
 
-    if (!FileExists(TextFormat("%s/%s", dir, d1))) return 1;
-    if (!FileExists(TextFormat("%s/%s", dir, d2))) return -1;
+    MemTrackFree(MEMORY_UI, state->dirFileIcons);
+    state->dirFileIcons = NULL;
 
-    return strcmp(d1, d2);
+    UnloadListView(state->filesList);
+    state->filesList = (ListView){ 0 };
+
+    UnloadThumbnailSet(state->thumbnails);
+    state->thumbnails = (ThumbnailSet){ 0 };
+
+    UnloadGlbIndex(state->glbIndex);
+    state->glbIndex = (GlbIndex){ 0 };
 }
 
-// Read files in new path
-static void ReloadDirectoryFiles(GuiWindowFileDialogState *state)
+// Icon of an entry, file icons for some recognized extensions
+static int GetFileIcon(const char *path, bool isDirectory)
 {
-    UnloadDirectoryFiles(state->dirFiles);
+    if (isDirectory) return 1;
 
-    state->dirFiles = LoadDirectoryFilesEx(state->dirPathText, (state->filterExt[0] == '\0')? NULL : state->filterExt, false);
-    state->itemFocused = 0;
+    if (IsFileExtension(path, ".png;.bmp;.tga;.gif;.jpg;.jpeg;.psd;.hdr;.qoi;.dds;.pkm;.ktx;.pvr;.astc")) return 12;
+    if (IsFileExtension(path, ".wav;.mp3;.ogg;.flac;.xm;.mod;.it;.wma;.aiff")) return 11;
+    if (IsFileExtension(path, ".txt;.info;.md;.nfo;.xml;.json;.c;.cpp;.cs;.lua;.py;.glsl;.vs;.fs")) return 10;
+    if (IsFileExtension(path, ".exe;.bin;.raw;.msi")) return 200;
 
-    // Reset dirFilesIcon memory
-    for (int i = 0; i < MAX_DIRECTORY_FILES; i++) memset(dirFilesIcon[i], 0, MAX_ICON_PATH_LENGTH);
+    return 218;
+}
 
-    // Copy paths as icon + fileNames into dirFilesIcon
-    for (int i = 0; i < state->dirFiles.count; i++)
+// Start reading a new path, the entries come in over the next frames unless the path is cached
+static void ReloadDirectoryFiles(GuiWindowFileDialogState *state)
+{
+    const bool readInfo = (state->sortModeActive == DIRECTORY_SORT_SIZE) || (state->sortModeActive == DIRECTORY_SORT_TIME);
+
+    // The listing being left is cached for coming back
+    StoreCachedDirectory(&state->dirCache, &state->dirScan);
+
+    if (!TakeCachedDirectory(&state->dirCache, state->dirPathText, state->filterExt, readInfo, &state->dirScan))
     {
-        if (IsPathFile(state->dirFiles.paths[i]))
-        {
-            // Path is a file, a file icon for convenience (for some recognized extensions)
-            if (IsFileExtension(state->dirFiles.paths[i], ".png;.bmp;.tga;.gif;.jpg;.jpeg;.psd;.hdr;.qoi;.dds;.pkm;.ktx;.pvr;.astc"))
-            {
-                strcpy(dirFilesIcon[i], TextFormat("#12#%s", GetFileName(state->dirFiles.paths[i])));
-            }
-            else if (IsFileExtension(state->dirFiles.paths[i], ".wav;.mp3;.ogg;.flac;.xm;.mod;.it;.wma;.aiff"))
-            {
-                strcpy(dirFilesIcon[i], TextFormat("#11#%s", GetFileName(state->dirFiles.paths[i])));
-            }
-            else if (IsFileExtension(state->dirFiles.paths[i], ".txt;.info;.md;.nfo;.xml;.json;.c;.cpp;.cs;.lua;.py;.glsl;.vs;.fs"))
-            {
-                strcpy(dirFilesIcon[i], TextFormat("#10#%s", GetFileName(state->dirFiles.paths[i])));
-            }
-            else if (IsFileExtension(state->dirFiles.paths[i], ".exe;.bin;.raw;.msi"))
-            {
-                strcpy(dirFilesIcon[i], TextFormat("#200#%s", GetFileName(state->dirFiles.paths[i])));
-            }
-            else strcpy(dirFilesIcon[i], TextFormat("#218#%s", GetFileName(state->dirFiles.paths[i])));
-        }
-        else
-        {
-            // Path is a directory, add a directory icon
-            strcpy(dirFilesIcon[i], TextFormat("#1#%s", GetFileName(state->dirFiles.paths[i])));
-        }
+        state->dirScan = LoadDirectoryScan(state->dirPathText, state->filterExt, readInfo);
     }
+
+    // Thumbnails and stats start once the listing is complete
+    UnloadThumbnailSet(state->thumbnails);
+    state->thumbnails = (ThumbnailSet){ 0 };
+
+    UnloadGlbIndex(state->glbIndex);
+    state->glbIndex = (GlbIndex){ 0 };
+
+    MemTrackFree(MEMORY_UI, state->dirFileIcons);
+    state->dirFileIcons = NULL;
+
+    UnloadListView(state->filesList);
+    state->filesList = LoadListViewHeights(NULL, 0);
+
+    // A cached listing is complete, its rows are built at once
+    if (!state->dirScan.isScanning) SortDirectoryFiles(state);
 }
 
-#if defined(USE_CUSTOM_LISTVIEW_FILEINFO)
-// List View control for files info with extended parameters
-static int GuiListViewFiles(Rectangle bounds, FileInfo *files, int count, int *focus, int *scrollIndex, int *active)
+// Add the rows of the entries read since the last call, the listing is sorted once it is complete
+static void UpdateDirectoryFiles(GuiWindowFileDialogState *state)
 {
-    int result = 0;
-    GuiState state = guiState;
-    int itemFocused = (focus == NULL)? -1 : *focus;
-    int itemSelected = *active;
-
-    // Check if we need a scroll bar
-    bool useScrollBar = false;
-    if ((GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT) + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING))*count > bounds.height) useScrollBar = true;
-
-    // Define base item rectangle [0]
-    Rectangle itemBounds = { 0 };
-    itemBounds.x = bounds.x + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING);
-    itemBounds.y = bounds.y + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING) + GuiGetStyle(DEFAULT, BORDER_WIDTH);
-    itemBounds.width = bounds.width - 2*GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING) - GuiGetStyle(DEFAULT, BORDER_WIDTH);
-    itemBounds.height = GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT);
-    if (useScrollBar) itemBounds.width -= GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH);
-
-    // Get items on the list
-    int visibleItems = bounds.height/(GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT) + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING));
-    if (visibleItems > count) visibleItems = count;
-
-    int startIndex = (scrollIndex == NULL)? 0 : *scrollIndex;
-    if ((startIndex < 0) || (startIndex > (count - visibleItems))) startIndex = 0;
-    int endIndex = startIndex + visibleItems;
-
-    // Update control
-    //--------------------------------------------------------------------
-    if ((state != GUI_STATE_DISABLED) && !guiLocked)
-    {
-        Vector2 mousePoint = GetMousePosition();
+    const int first = state->dirScan.count;
 
-        // Check mouse inside list view
-        if (CheckCollisionPointRec(mousePoint, bounds))
-        {
-            state = GUI_STATE_FOCUSED;
+    if (UpdateDirectoryScan(&state->dirScan) > 0) AddDirectoryRows(state, first);
 
-            // Check focused and selected item
-            for (int i = 0; i < visibleItems; i++)
-            {
-                if (CheckCollisionPointRec(mousePoint, itemBounds))
-                {
-                    itemFocused = startIndex + i;
-                    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) itemSelected = startIndex + i;
-                    break;
-                }
+    if (!state->dirScan.isScanning) SortDirectoryFiles(state);
+}
 
-                // Update item rectangle y position for next item
-                itemBounds.y += (GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT) + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING));
-            }
+// Sort the listing and rebuild its rows, thumbnails and stats are listed by entry so they start over
+static void SortDirectoryFiles(GuiWindowFileDialogState *state)
+{
+    SortDirectoryScan(&state->dirScan, (DirectorySortMode)state->sortModeActive);
 
-            if (useScrollBar)
-            {
-                int wheelMove = GetMouseWheelMove();
-                startIndex -= wheelMove;
+    MemTrackFree(MEMORY_UI, state->dirFileIcons);
+    state->dirFileIcons = NULL;
 
-                if (startIndex < 0) startIndex = 0;
-                else if (startIndex > (count - visibleItems)) startIndex = count - visibleItems;
+    // The order changed under the rows, the view starts again from the top
+    UnloadListView(state->filesList);
+    state->filesList = LoadListViewHeights(NULL, 0);
+    if (state->dirScan.count > 0) AddDirectoryRows(state, 0);
 
-                endIndex = startIndex + visibleItems;
-                if (endIndex > count) endIndex = count;
-            }
-        }
-        else itemFocused = -1;
+    UnloadThumbnailSet(state->thumbnails);
+    state->thumbnails = LoadThumbnailSet(GetDirectoryScanPaths(&state->dirScan), state->dirScan.entries);
 
-        // Reset item rectangle y to [0]
-        itemBounds.y = bounds.y + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING) + GuiGetStyle(DEFAULT, BORDER_WIDTH);
-    }
-    //--------------------------------------------------------------------
+    UnloadGlbIndex(state->glbIndex);
+    state->glbIndex = LoadGlbIndex(GetDirectoryScanPaths(&state->dirScan));
+}
+
+// Icons and rows of the entries from first on, names are read from the pool when their row is drawn
+static void AddDirectoryRows(GuiWindowFileDialogState *state, int first)
+{
+    const int count = state->dirScan.count;
 
-    // Draw control
-    //--------------------------------------------------------------------
-    DrawRectangleRec(bounds, GetColor(GuiGetStyle(DEFAULT, BACKGROUND_COLOR)));     // Draw background
-    DrawRectangleLinesEx(bounds, GuiGetStyle(DEFAULT, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER + state*3)), guiAlpha));
+    // Icons stay off once they failed to grow, the earlier entries would have none
+    int *icons = ((state->dirFileIcons != NULL) || (first == 0))? (int *)MemTrackRealloc(MEMORY_UI, state->dirFileIcons, state->dirScan.capacity*sizeof(int)) : NULL;
+    float *heights = (float *)MemTrackAlloc(MEMORY_UI, (count - first)*sizeof(float));
 
-    // TODO: Draw list view header with file sections: icon+name | size | type | modTime
+    if (icons != NULL) state->dirFileIcons = icons;
 
-    // Draw visible items
-    for (int i = 0; i < visibleItems; i++)
+    for (int i = first; i < count; i++)
     {
-        if (state == GUI_STATE_DISABLED)
-        {
-            if ((startIndex + i) == itemSelected)
-            {
-                DrawRectangleRec(itemBounds, Fade(GetColor(GuiGetStyle(LISTVIEW, BASE_COLOR_DISABLED)), guiAlpha));
-                DrawRectangleLinesEx(itemBounds, GuiGetStyle(LISTVIEW, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_DISABLED)), guiAlpha));
-            }
+        const char *path = GetDirectoryEntryPath(&state->dirScan, i);
+        const bool isDirectory = state->dirScan.entries[i].isDirectory;
 
-            // TODO: Draw full file info line: icon+name | size | type | modTime
+        if (icons != NULL) state->dirFileIcons[i] = GetFileIcon(path, isDirectory);
 
-            GuiDrawText(files[startIndex + i].name, GetTextBounds(DEFAULT, itemBounds), GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT), Fade(GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_DISABLED)), guiAlpha));
-        }
-        else
-        {
-            if ((startIndex + i) == itemSelected)
-            {
-                // Draw item selected
-                DrawRectangleRec(itemBounds, Fade(GetColor(GuiGetStyle(LISTVIEW, BASE_COLOR_PRESSED)), guiAlpha));
-                DrawRectangleLinesEx(itemBounds, GuiGetStyle(LISTVIEW, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_PRESSED)), guiAlpha));
+        // Same rule as LoadThumbnailSet(), .glb rows get room for their thumbnail
+        if (heights != NULL) heights[i - first] = (!isDirectory && IsFileExtension(path, ".glb"))? FILE_LIST_THUMBNAIL_ROW_HEIGHT : FILE_LIST_ROW_HEIGHT;
+    }
 
-                GuiDrawText(files[startIndex + i].name, GetTextBounds(DEFAULT, itemBounds), GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT), Fade(GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_PRESSED)), guiAlpha));
-            }
-            else if ((startIndex + i) == itemFocused)
-            {
-                // Draw item focused
-                DrawRectangleRec(itemBounds, Fade(GetColor(GuiGetStyle(LISTVIEW, BASE_COLOR_FOCUSED)), guiAlpha));
-                DrawRectangleLinesEx(itemBounds, GuiGetStyle(LISTVIEW, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_FOCUSED)), guiAlpha));
+    if (icons == NULL)
+    {
+        MemTrackFree(MEMORY_UI, state->dirFileIcons);
+        state->dirFileIcons = NULL;
+    }
 
-                GuiDrawText(files[startIndex + i].name, GetTextBounds(DEFAULT, itemBounds), GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT), Fade(GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_FOCUSED)), guiAlpha));
-            }
-            else
-            {
-                // Draw item normal
-                GuiDrawText(files[startIndex + i].name, GetTextBounds(DEFAULT, itemBounds), GuiGetStyle(LISTVIEW, TEXT_ALIGNMENT), Fade(GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_NORMAL)), guiAlpha));
-            }
+    if ((heights == NULL) || !AppendListViewRows(&state->filesList, heights, count - first))
+    {
+        TraceLog(LOG_WARNING, "FILEIO: Failed to list %d entries of [%s]", count - first, state->dirPathText);
+    }
+
+    MemTrackFree(MEMORY_UI, heights);
+}
+
+// Short count for the stats columns: 950, 12.3k, 1.2M
+static const char *FormatStatCount(long long count, const char *unit)
+{
+    if (count >= 1000000) return TextFormat("%.1fM %s", count/1000000.0, unit);
+    if (count >= 10000) return TextFormat("%.0fk %s", count/1000.0, unit);
+    if (count >= 1000) return TextFormat("%.1fk %s", count/1000.0, unit);
+
+    return TextFormat("%lld %s", count, unit);
+}
+
+// Stats of an indexed .glb in fixed columns, the ones past the row width are left out
+static void DrawFileStats(const GlbStats *stats, Rectangle bounds, Color color)
+{
+    for (int i = 0; i < 7; i++)
+    {
+        Rectangle column = { bounds.x + i*FILE_LIST_STATS_COLUMN_WIDTH, bounds.y, FILE_LIST_STATS_COLUMN_WIDTH, bounds.height };
+        if (column.x + column.width > bounds.x + bounds.width) break;
+
+        // Formatted as drawn, TextFormat() only keeps a few results alive
+        const char *text = NULL;
+
+        switch (i)
+        {
+            case 0: text = FormatStatCount(stats->vertexCount, "vtx"); break;
+            case 1: text = FormatStatCount(stats->triangleCount, "tri"); break;
+            case 2: text = TextFormat("%i mesh", stats->meshCount); break;
+            case 3: text = TextFormat("%i bone", stats->boneCount); break;
+            case 4: text = TextFormat("%i clip", stats->clipCount); break;
+            case 5: text = TextFormat("%i tex", stats->textureCount); break;
+            default: text = TextFormat("v%s", (stats->assetVersion[0] != '\0')? stats->assetVersion : "?"); break;
         }
 
-        // Update item rectangle y position for next item
-        itemBounds.y += (GuiGetStyle(LISTVIEW, LIST_ITEMS_HEIGHT) + GuiGetStyle(LISTVIEW, LIST_ITEMS_PADDING));
+        GuiDrawText(text, column, TEXT_ALIGN_LEFT, color);
     }
+}
 
-    if (useScrollBar)
-    {
-        Rectangle scrollBarBounds = {
-            bounds.x + bounds.width - GuiGetStyle(LISTVIEW, BORDER_WIDTH) - GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH),
-            bounds.y + GuiGetStyle(LISTVIEW, BORDER_WIDTH), (float)GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH),
-            bounds.height - 2*GuiGetStyle(DEFAULT, BORDER_WIDTH)
-        };
+// Draw one row of the file list, .glb files show their thumbnail in place of the icon and their stats under the name
+static void DrawFileRow(Rectangle bounds, int row, int state, void *userData)
+{
+    GuiWindowFileDialogState *dialog = (GuiWindowFileDialogState *)userData;
+    const char *name = GetDirectoryEntryName(&dialog->dirScan, row);
+    const Thumbnail *thumbnail = (row < dialog->thumbnails.count)? &dialog->thumbnails.thumbnails[row] : NULL;
 
-        // Calculate percentage of visible items and apply same percentage to scrollbar
-        float percentVisible = (float)(endIndex - startIndex)/count;
-        float sliderSize = bounds.height*percentVisible;
+    if ((thumbnail == NULL) || (thumbnail->state == THUMBNAIL_NONE))
+    {
+        GuiListViewText(bounds, TextFormat("#%i#%s", (dialog->dirFileIcons != NULL)? dialog->dirFileIcons[row] : 218, name), state);
+        return;
+    }
 
-        int prevSliderSize = GuiGetStyle(SCROLLBAR, SLIDER_WIDTH);  // Save default slider size
-        int prevScrollSpeed = GuiGetStyle(SCROLLBAR, SCROLL_SPEED); // Save default scroll speed
-        GuiSetStyle(SCROLLBAR, SLIDER_WIDTH, sliderSize);           // Change slider size
-        GuiSetStyle(SCROLLBAR, SCROLL_SPEED, count - visibleItems); // Change scroll speed
+    // Background only, the name goes right of the thumbnail
+    GuiListViewText(bounds, "", state);
 
-        startIndex = GuiScrollBar(scrollBarBounds, startIndex, 0, count - visibleItems);
+    const float size = bounds.height - 4;
+    const float x = bounds.x + GuiGetStyle(DEFAULT, BORDER_WIDTH) + GuiGetStyle(DEFAULT, TEXT_PADDING);
+    const float y = bounds.y + 2;
 
-        GuiSetStyle(SCROLLBAR, SCROLL_SPEED, prevScrollSpeed); // Reset scroll speed to default
-        GuiSetStyle(SCROLLBAR, SLIDER_WIDTH, prevSliderSize);  // Reset slider size to default
+    if (thumbnail->state == THUMBNAIL_READY)
+    {
+        DrawTexturePro(thumbnail->texture, (Rectangle){ 0, 0, THUMBNAIL_SIZE, THUMBNAIL_SIZE }, (Rectangle){ x, y, size, size }, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    }
+    else
+    {
+        // Generic file icon while pending, or when the file has nothing to draw
+        float alpha = (thumbnail->state == THUMBNAIL_PENDING)? 0.4f : 1.0f;
+        GuiDrawIcon(218, (int)(x + (size - 16)/2), (int)(y + (size - 16)/2), 1, Fade(GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_NORMAL)), alpha));
     }
-    //--------------------------------------------------------------------
 
-    if (focus != NULL) *focus = itemFocused;
-    if (scrollIndex != NULL) *scrollIndex = startIndex;
+    Rectangle textBounds = { x + size + 4, bounds.y, bounds.width - (x - bounds.x) - size - 4, bounds.height };
+    const Color textColor = GetColor(GuiGetStyle(LISTVIEW, TEXT_COLOR_NORMAL + state*3));
 
-    *active = itemSelected;
-    return result;
+    if ((row < dialog->glbIndex.count) && (dialog->glbIndex.states[row] == GLB_INDEX_READY))
+    {
+        // Name on the upper half, stats on the lower one
+        textBounds.height = bounds.height/2;
+        GuiDrawText(name, (Rectangle){ textBounds.x, textBounds.y + 2, textBounds.width, textBounds.height }, TEXT_ALIGN_LEFT, textColor);
+
+        DrawFileStats(&dialog->glbIndex.stats[row], (Rectangle){ textBounds.x, textBounds.y + textBounds.height - 2, textBounds.width, textBounds.height }, Fade(textColor, 0.7f));
+    }
+    else GuiDrawText(name, textBounds, TEXT_ALIGN_LEFT, textColor);
 }
-#endif // USE_CUSTOM_LISTVIEW_FILEINFO
 
 #endif // GUI_FILE_DIALOG_IMPLEMENTATION
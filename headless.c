@@ -0,0 +1,450 @@
+/*******************************************************************************************
+*
+*   headless - Window-less benchmark of a model's load and animation stages
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "headless.h"
+#include "vmath.h"
+#include "trace.h"
+
+#include "external/cgltf.h"     // Implementation is compiled into raylib (models.c)
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADLESS_MAX_WEIGHTS    4   // JOINTS_0/WEIGHTS_0, as raylib reads them
+
+typedef struct
+{
+    int vertexCount;
+    Vector3* positions;
+    Vector3* normals;               // NULL when the primitive has none
+    unsigned short* joints;         // HEADLESS_MAX_WEIGHTS per vertex
+    float* weights;
+    Vector3* skinnedPositions;
+    Vector3* skinnedNormals;
+} HeadlessMesh;
+
+typedef struct
+{
+    HeadlessMesh* meshes;           // Skinned triangle primitives only
+    int meshCount;
+    long long vertexCount;          // Every triangle primitive, skinned or not
+    long long skinnedVertexCount;
+
+    Matrix* inverseBinds;           // Joints of the first skin, the one LoadModel() uses
+    int jointCount;
+
+    ModelAnimation* anims;
+    int animCount;
+} HeadlessModel;
+
+typedef struct
+{
+    const char* name;
+    double* samples;                // Seconds
+    int count;
+    double units;                   // Work of one sample for the throughput
+    const char* unitName;
+} HeadlessStage;
+
+//----------------------------------------------------------------
+
+static double GetHeadlessTime(void)
+{
+    return GetTraceTime()*1e-9;
+}
+
+// stdout carries the JSON only
+static void HeadlessLog(int logLevel, const char* text, va_list args)
+{
+    if (logLevel < LOG_WARNING) return;
+
+    fprintf(stderr, (logLevel == LOG_WARNING) ? "WARNING: " : "ERROR: ");
+    vfprintf(stderr, text, args);
+    fprintf(stderr, "\n");
+
+    if (logLevel == LOG_FATAL) exit(EXIT_FAILURE);
+}
+
+static const cgltf_accessor* FindAttribute(const cgltf_primitive* primitive, cgltf_attribute_type type)
+{
+    for (cgltf_size i = 0; i < primitive->attributes_count; i++)
+    {
+        if ((primitive->attributes[i].type == type) && (primitive->attributes[i].index == 0)) return primitive->attributes[i].data;
+    }
+
+    return NULL;
+}
+
+static bool LoadHeadlessMesh(const cgltf_primitive* primitive, int jointCount, HeadlessMesh* mesh)
+{
+    const cgltf_accessor* positions = FindAttribute(primitive, cgltf_attribute_type_position);
+    const cgltf_accessor* normals = FindAttribute(primitive, cgltf_attribute_type_normal);
+    const cgltf_accessor* joints = FindAttribute(primitive, cgltf_attribute_type_joints);
+    const cgltf_accessor* weights = FindAttribute(primitive, cgltf_attribute_type_weights);
+
+    if ((positions == NULL) || (joints == NULL) || (weights == NULL)) return false;
+
+    const int count = (int)positions->count;
+
+    mesh->vertexCount = count;
+    mesh->positions = (Vector3*)RL_MALLOC(count*sizeof(Vector3));
+    mesh->skinnedPositions = (Vector3*)RL_MALLOC(count*sizeof(Vector3));
+    mesh->joints = (unsigned short*)RL_MALLOC(count*HEADLESS_MAX_WEIGHTS*sizeof(unsigned short));
+    mesh->weights = (float*)RL_MALLOC(count*HEADLESS_MAX_WEIGHTS*sizeof(float));
+
+    if ((normals != NULL) && (normals->count == positions->count))
+    {
+        mesh->normals = (Vector3*)RL_MALLOC(count*sizeof(Vector3));
+        mesh->skinnedNormals = (Vector3*)RL_MALLOC(count*sizeof(Vector3));
+    }
+
+    for (int v = 0; v < count; v++)
+    {
+        cgltf_accessor_read_float(positions, v, &mesh->positions[v].x, 3);
+        if (mesh->normals != NULL) cgltf_accessor_read_float(normals, v, &mesh->normals[v].x, 3);
+
+        cgltf_uint ids[HEADLESS_MAX_WEIGHTS] = { 0 };
+        float* w = &mesh->weights[v*HEADLESS_MAX_WEIGHTS];
+
+        cgltf_accessor_read_uint(joints, v, ids, HEADLESS_MAX_WEIGHTS);
+        cgltf_accessor_read_float(weights, v, w, HEADLESS_MAX_WEIGHTS);
+
+        // Joints past the skin are dropped here, the skinning loop does no range checks
+        for (int k = 0; k < HEADLESS_MAX_WEIGHTS; k++)
+        {
+            const bool isValid = ((int)ids[k] < jointCount);
+            mesh->joints[v*HEADLESS_MAX_WEIGHTS + k] = isValid ? (unsigned short)ids[k] : 0;
+            if (!isValid) w[k] = 0.0f;
+        }
+    }
+
+    return true;
+}
+
+static void UnloadHeadlessModel(HeadlessModel model)
+{
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        RL_FREE(model.meshes[i].positions);
+        RL_FREE(model.meshes[i].normals);
+        RL_FREE(model.meshes[i].joints);
+        RL_FREE(model.meshes[i].weights);
+        RL_FREE(model.meshes[i].skinnedPositions);
+        RL_FREE(model.meshes[i].skinnedNormals);
+    }
+
+    RL_FREE(model.meshes);
+    RL_FREE(model.inverseBinds);
+
+    if (model.animCount > 0) UnloadModelAnimations(model.anims, model.animCount);
+}
+
+// What LoadModel() and LoadModelAnimations() read, less the GPU upload and the unskinned data
+static bool LoadHeadlessModel(const char* fileName, HeadlessModel* model)
+{
+    *model = (HeadlessModel){ 0 };
+
+    cgltf_options options = { cgltf_file_type_invalid };
+    cgltf_data* data = NULL;
+
+    if (cgltf_parse_file(&options, fileName, &data) != cgltf_result_success) return false;
+
+    if (cgltf_load_buffers(&options, data, fileName) != cgltf_result_success)
+    {
+        cgltf_free(data);
+        return false;
+    }
+
+    if (data->skins_count > 0)
+    {
+        const cgltf_skin* skin = &data->skins[0];
+
+        model->jointCount = (int)skin->joints_count;
+        model->inverseBinds = (Matrix*)RL_MALLOC((model->jointCount + 1)*sizeof(Matrix));
+
+        for (int j = 0; j < model->jointCount; j++)
+        {
+            float f[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+            if (skin->inverse_bind_matrices != NULL) cgltf_accessor_read_float(skin->inverse_bind_matrices, j, f, 16);
+            model->inverseBinds[j] = MatrixFromColumns(f);
+        }
+    }
+
+    int primitiveCount = 0;
+    for (cgltf_size i = 0; i < data->meshes_count; i++) primitiveCount += (int)data->meshes[i].primitives_count;
+
+    model->meshes = (HeadlessMesh*)RL_CALLOC(primitiveCount + 1, sizeof(HeadlessMesh));
+
+    for (cgltf_size i = 0; i < data->meshes_count; i++)
+    {
+        for (cgltf_size p = 0; p < data->meshes[i].primitives_count; p++)
+        {
+            const cgltf_primitive* primitive = &data->meshes[i].primitives[p];
+            if (primitive->type != cgltf_primitive_type_triangles) continue;
+
+            const cgltf_accessor* positions = FindAttribute(primitive, cgltf_attribute_type_position);
+            if (positions != NULL) model->vertexCount += (long long)positions->count;
+
+            HeadlessMesh* mesh = &model->meshes[model->meshCount];
+
+            if ((model->jointCount > 0) && LoadHeadlessMesh(primitive, model->jointCount, mesh))
+            {
+                model->skinnedVertexCount += mesh->vertexCount;
+                model->meshCount++;
+            }
+        }
+    }
+
+    cgltf_free(data);
+
+    model->anims = LoadModelAnimations(fileName, &model->animCount);
+
+    return true;
+}
+
+//----------------------------------------------------------------
+
+// Pose matrices of one frame, the same steps as the viewer's pose sampling bench kernel
+static void UpdateBoneMatrices(const Transform* pose, int boneCount, const Matrix* inverseBinds, Quaternion* rotations, Matrix* worlds, Matrix* skins)
+{
+    for (int i = 0; i < boneCount; i++) rotations[i] = pose[i].rotation;
+
+    QuaternionToMatrixBatch(worlds, rotations, boneCount);
+
+    for (int i = 0; i < boneCount; i++)
+    {
+        Matrix* m = &worlds[i];
+        const Vector3 s = pose[i].scale;
+        const Vector3 t = pose[i].translation;
+
+        m->m0 *= s.x; m->m1 *= s.x; m->m2  *= s.x;
+        m->m4 *= s.y; m->m5 *= s.y; m->m6  *= s.y;
+        m->m8 *= s.z; m->m9 *= s.z; m->m10 *= s.z;
+        m->m12 = t.x; m->m13 = t.y; m->m14 = t.z;
+    }
+
+    // Frame poses are in model space already, skin = world*inverseBind so the inverse bind applies to the vertex first
+    MatrixMultiplyBatch(skins, worlds, inverseBinds, boneCount);
+}
+
+static void SkinHeadlessMesh(HeadlessMesh* mesh, const Matrix* skins)
+{
+    for (int v = 0; v < mesh->vertexCount; v++)
+    {
+        const unsigned short* ids = &mesh->joints[v*HEADLESS_MAX_WEIGHTS];
+        const float* w = &mesh->weights[v*HEADLESS_MAX_WEIGHTS];
+        const Vector3 p = mesh->positions[v];
+
+        Vector3 position = { 0.0f, 0.0f, 0.0f };
+        Vector3 normal = { 0.0f, 0.0f, 0.0f };
+
+        for (int k = 0; k < HEADLESS_MAX_WEIGHTS; k++)
+        {
+            if (w[k] == 0.0f) continue;
+
+            const Matrix* m = &skins[ids[k]];
+
+            position.x += w[k]*(m->m0*p.x + m->m4*p.y + m->m8*p.z + m->m12);
+            position.y += w[k]*(m->m1*p.x + m->m5*p.y + m->m9*p.z + m->m13);
+            position.z += w[k]*(m->m2*p.x + m->m6*p.y + m->m10*p.z + m->m14);
+
+            if (mesh->normals != NULL)
+            {
+                const Vector3 n = mesh->normals[v];
+
+                normal.x += w[k]*(m->m0*n.x + m->m4*n.y + m->m8*n.z);
+                normal.y += w[k]*(m->m1*n.x + m->m5*n.y + m->m9*n.z);
+                normal.z += w[k]*(m->m2*n.x + m->m6*n.y + m->m10*n.z);
+            }
+        }
+
+        mesh->skinnedPositions[v] = position;
+        if (mesh->normals != NULL) mesh->skinnedNormals[v] = normal;
+    }
+}
+
+//----------------------------------------------------------------
+
+static int CompareSeconds(const void* a, const void* b)
+{
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+static void WriteJsonString(const char* text)
+{
+    putchar('"');
+
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\')) putchar('\\');
+        if ((unsigned char)*c >= 0x20) putchar(*c);
+    }
+
+    putchar('"');
+}
+
+// Sorts the samples, latencies in microseconds and throughput in units per second
+static void WriteStage(HeadlessStage stage, bool isLast)
+{
+    if (stage.count == 0) return;
+
+    qsort(stage.samples, stage.count, sizeof(double), CompareSeconds);
+
+    double total = 0.0;
+    for (int i = 0; i < stage.count; i++) total += stage.samples[i];
+
+    const double mean = total/stage.count;
+    const double p50 = stage.samples[(int)(0.50*(stage.count - 1) + 0.5)];
+    const double p90 = stage.samples[(int)(0.90*(stage.count - 1) + 0.5)];
+    const double p99 = stage.samples[(int)(0.99*(stage.count - 1) + 0.5)];
+
+    printf("    \"%s\": { \"count\": %d, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"%s_per_second\": %.1f }%s\n",
+        stage.name, stage.count, mean*1e6, p50*1e6, p90*1e6, p99*1e6, stage.samples[stage.count - 1]*1e6,
+        stage.unitName, (total > 0.0) ? stage.units*stage.count/total : 0.0, isLast ? "" : ",");
+}
+
+//----------------------------------------------------------------
+
+int RunHeadlessBench(HeadlessBench bench)
+{
+    SetTraceLogCallback(HeadlessLog);
+
+    if (bench.loads < 1) bench.loads = 1;
+    if (bench.frames < 1) bench.frames = 1;
+
+    const long long fileBytes = GetFileLength(bench.fileName);
+
+    // Load stage, each run loads and unloads, the last model is kept for the frame stages
+    double* loadSamples = (double*)RL_MALLOC(bench.loads*sizeof(double));
+    HeadlessModel model = { 0 };
+
+    for (int i = 0; i < bench.loads; i++)
+    {
+        if (i > 0) UnloadHeadlessModel(model);
+
+        TraceBegin("headless load");
+        const double start = GetHeadlessTime();
+        const bool isLoaded = LoadHeadlessModel(bench.fileName, &model);
+        loadSamples[i] = GetHeadlessTime() - start;
+        TraceEnd();
+
+        if (!isLoaded)
+        {
+            TraceLog(LOG_ERROR, "HEADLESS: [%s] Failed to load", bench.fileName);
+            RL_FREE(loadSamples);
+            UnloadHeadlessModel(model);
+            return 1;
+        }
+    }
+
+    const bool hasClip = (bench.clip >= 0) && (bench.clip < model.animCount) && (model.anims[bench.clip].frameCount > 0);
+    const ModelAnimation* anim = hasClip ? &model.anims[bench.clip] : NULL;
+
+    // The clip and the skin agree on the joint order, a mismatch uses the bones both have
+    int boneCount = hasClip ? anim->boneCount : 0;
+    if (boneCount > model.jointCount) boneCount = model.jointCount;
+
+    if (!hasClip) TraceLog(LOG_WARNING, "HEADLESS: [%s] No clip %d among %d, only the load is measured", bench.fileName, bench.clip, model.animCount);
+
+    const int frames = hasClip ? bench.frames : 0;
+    double* samplingSamples = (double*)RL_MALLOC((frames + 1)*sizeof(double));
+    double* boneSamples = (double*)RL_MALLOC((frames + 1)*sizeof(double));
+    double* skinningSamples = (double*)RL_MALLOC((frames + 1)*sizeof(double));
+    double* frameSamples = (double*)RL_MALLOC((frames + 1)*sizeof(double));
+
+    Transform* pose = (Transform*)RL_MALLOC((boneCount + 1)*sizeof(Transform));
+    Quaternion* rotations = (Quaternion*)RL_MALLOC((boneCount + 1)*sizeof(Quaternion));
+    Matrix* worlds = (Matrix*)RL_MALLOC((boneCount + 1)*sizeof(Matrix));
+    Matrix* skins = (Matrix*)RL_MALLOC((boneCount + 1)*sizeof(Matrix));
+
+    for (int f = 0; f < frames; f++)
+    {
+        const int frame = f%anim->frameCount;
+
+        const double t0 = GetHeadlessTime();
+
+        // Sampling, the pose of the frame as UpdateModelAnimation() reads it
+        memcpy(pose, anim->framePoses[frame], boneCount*sizeof(Transform));
+
+        const double t1 = GetHeadlessTime();
+
+        UpdateBoneMatrices(pose, boneCount, model.inverseBinds, rotations, worlds, skins);
+
+        const double t2 = GetHeadlessTime();
+
+        if (boneCount > 0)
+        {
+            for (int i = 0; i < model.meshCount; i++) SkinHeadlessMesh(&model.meshes[i], skins);
+        }
+
+        const double t3 = GetHeadlessTime();
+
+        samplingSamples[f] = t1 - t0;
+        boneSamples[f] = t2 - t1;
+        skinningSamples[f] = t3 - t2;
+        frameSamples[f] = t3 - t0;
+    }
+
+    printf("{\n  \"file\": ");
+    WriteJsonString(bench.fileName);
+    printf(",\n  \"raylib\": \"%s\",\n  \"simd\": \"%s\",\n  \"file_bytes\": %lld,\n", RAYLIB_VERSION, GetMathSimdName(GetMathSimdLevel()), fileBytes);
+    printf("  \"clip\": %d,\n  \"clip_name\": ", bench.clip);
+    WriteJsonString(hasClip ? anim->name : "");
+    printf(",\n  \"clip_frames\": %d,\n  \"frames\": %d,\n  \"bones\": %d,\n", hasClip ? anim->frameCount : 0, frames, boneCount);
+    printf("  \"vertices\": %lld,\n  \"skinned_vertices\": %lld,\n  \"skinned_meshes\": %d,\n", model.vertexCount, model.skinnedVertexCount, model.meshCount);
+    printf("  \"stages\": {\n");
+
+    const HeadlessStage loadStage = { "load", loadSamples, bench.loads, fileBytes/(1024.0*1024.0), "mb" };
+    const HeadlessStage samplingStage = { "sampling", samplingSamples, frames, (double)boneCount, "bones" };
+    const HeadlessStage boneStage = { "bone_matrices", boneSamples, frames, (double)boneCount, "bones" };
+    const HeadlessStage skinningStage = { "skinning", skinningSamples, frames, (double)model.skinnedVertexCount, "vertices" };
+    const HeadlessStage frameStage = { "frame", frameSamples, frames, 1.0, "frames" };
+
+    WriteStage(loadStage, frames == 0);
+    WriteStage(samplingStage, false);
+    WriteStage(boneStage, false);
+    WriteStage(skinningStage, false);
+    WriteStage(frameStage, true);
+
+    printf("  }\n}\n");
+    fflush(stdout);
+
+    RL_FREE(skins);
+    RL_FREE(worlds);
+    RL_FREE(rotations);
+    RL_FREE(pose);
+    RL_FREE(frameSamples);
+    RL_FREE(skinningSamples);
+    RL_FREE(boneSamples);
+    RL_FREE(samplingSamples);
+    RL_FREE(loadSamples);
+
+    UnloadHeadlessModel(model);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************************
+*
+*   headless - Window-less benchmark of a model's load and animation stages
+*
+*   Runs what the viewer does per model and per frame without a window or a GPU, for build
+*   servers: the load, pose sampling of one clip, bone matrices and skinning. Latency percentiles
+*   and throughput of each stage are printed to stdout as one JSON object, the log goes to stderr.
+*
+*   LoadModel() uploads to the GPU, so the skinned primitives are read with cgltf instead. Skinning
+*   is linear blend skinning with bone matrices, the work UpdateModelAnimation() does on the CPU
+*   less the vertex buffer upload.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "raylib.h"
+
+typedef struct
+{
+    const char* fileName;
+    int clip;                   // Clip index
+    int frames;                 // Animation frames to run, the clip loops
+    int loads;                  // Load and unload repetitions
+} HeadlessBench;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns the process exit code, InitWindow() must not have been called
+int RunHeadlessBench(HeadlessBench bench);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HEADLESS_H
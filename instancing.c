@@ -0,0 +1,451 @@
+/*******************************************************************************************
+*
+*   instancing - Mesh-node references grouped into hardware instance batches
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "instancing.h"
+#include "vmath.h"
+#include "rlgl.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_SCENE
+#include "memtrack.h"
+
+#include "external/cgltf.h"     // Implementation is compiled into raylib (models.c)
+
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------
+
+static const char* instancingVs =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec2 vertexTexCoord;\n"
+    "in vec4 vertexColor;\n"
+    "in mat4 instanceTransform;\n"
+    "uniform mat4 mvp;\n"
+    "uniform vec3 dequantScale;\n"
+    "uniform vec3 dequantOffset;\n"
+    "out vec2 fragTexCoord;\n"
+    "out vec4 fragColor;\n"
+    "void main()\n"
+    "{\n"
+    "    fragTexCoord = vertexTexCoord;\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp*instanceTransform*vec4(dequantOffset + dequantScale*vertexPosition, 1.0);\n"
+    "}\n";
+
+static const char* instancingFs =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    finalColor = texture(texture0, fragTexCoord)*colDiffuse*fragColor;\n"
+    "}\n";
+
+static const Matrix matrixIdentity = { 1.0f, 0.0f, 0.0f, 0.0f,
+                                       0.0f, 1.0f, 0.0f, 0.0f,
+                                       0.0f, 0.0f, 1.0f, 0.0f,
+                                       0.0f, 0.0f, 0.0f, 1.0f };
+
+typedef struct
+{
+    int meshIndex;
+    int materialIndex;
+    int node;                   // -1 for skinned meshes, their transform never changes
+    Matrix transform;
+    Matrix local;               // EXT_mesh_gpu_instancing transform under the node, identity otherwise
+} MeshReference;
+
+typedef struct
+{
+    MeshReference* refs;
+    int count;
+    int capacity;
+} MeshReferenceList;
+
+//----------------------------------------------------------------
+
+// Translation*rotation*scale from glTF TRS values
+static Matrix MatrixFromTRS(const float* t, const float* q, const float* s)
+{
+    float x = q[0], y = q[1], z = q[2], w = q[3];
+
+    return (Matrix)
+    {
+        (1.0f - 2.0f*(y*y + z*z))*s[0], 2.0f*(x*y - w*z)*s[1],          2.0f*(x*z + w*y)*s[2],          t[0],
+        2.0f*(x*y + w*z)*s[0],          (1.0f - 2.0f*(x*x + z*z))*s[1], 2.0f*(y*z - w*x)*s[2],          t[1],
+        2.0f*(x*z - w*y)*s[0],          2.0f*(y*z + w*x)*s[1],          (1.0f - 2.0f*(x*x + y*y))*s[2], t[2],
+        0.0f,                           0.0f,                           0.0f,                           1.0f
+    };
+}
+
+static void AddMeshReference(MeshReferenceList* list, MeshReference ref)
+{
+    if (list->count == list->capacity)
+    {
+        list->capacity = (list->capacity == 0) ? 64 : list->capacity*2;
+        list->refs = (MeshReference*)RL_REALLOC(list->refs, list->capacity*sizeof(MeshReference));
+    }
+
+    list->refs[list->count++] = ref;
+}
+
+static int CompareMeshReference(const void* a, const void* b)
+{
+    const MeshReference* ra = (const MeshReference*)a;
+    const MeshReference* rb = (const MeshReference*)b;
+
+    if (ra->meshIndex != rb->meshIndex) return (ra->meshIndex < rb->meshIndex) ? -1 : 1;
+    if (ra->materialIndex != rb->materialIndex) return (ra->materialIndex < rb->materialIndex) ? -1 : 1;
+
+    return (ra->node < rb->node) ? -1 : (ra->node > rb->node);
+}
+
+static const cgltf_accessor* FindInstancingAttribute(const cgltf_node* node, const char* name)
+{
+    for (cgltf_size i = 0; i < node->mesh_gpu_instancing.attributes_count; i++)
+    {
+        if (strcmp(node->mesh_gpu_instancing.attributes[i].name, name) == 0) return node->mesh_gpu_instancing.attributes[i].data;
+    }
+
+    return NULL;
+}
+
+// Record the mesh references of a node and its children
+static void CollectNodeReferences(const cgltf_data* data, const cgltf_node* node, const int* firstMesh, Model model, MeshReferenceList* list)
+{
+    if (node->mesh != NULL)
+    {
+        const int meshId = (int)(node->mesh - data->meshes);
+        const int nodeId = (int)(node - data->nodes);
+
+        float world[16] = { 0 };
+        cgltf_node_transform_world(node, world);
+
+        // Skinned vertices are already in model space, the node transform is ignored (glTF 2.0 spec)
+        Matrix nodeTransform = (node->skin != NULL) ? matrixIdentity : MatrixFromColumns(world);
+
+        // EXT_mesh_gpu_instancing, every attribute accessor has one element per instance
+        const cgltf_accessor* translations = NULL;
+        const cgltf_accessor* rotations = NULL;
+        const cgltf_accessor* scales = NULL;
+        cgltf_size gpuInstances = 0;
+
+        if (node->has_mesh_gpu_instancing)
+        {
+            translations = FindInstancingAttribute(node, "TRANSLATION");
+            rotations = FindInstancingAttribute(node, "ROTATION");
+            scales = FindInstancingAttribute(node, "SCALE");
+
+            if (translations != NULL) gpuInstances = translations->count;
+            else if (rotations != NULL) gpuInstances = rotations->count;
+            else if (scales != NULL) gpuInstances = scales->count;
+        }
+
+        const cgltf_size instances = (gpuInstances > 0) ? gpuInstances : 1;
+
+        for (cgltf_size k = 0; k < instances; k++)
+        {
+            Matrix transform = nodeTransform;
+            Matrix local = matrixIdentity;
+
+            if (gpuInstances > 0)
+            {
+                float t[3] = { 0.0f, 0.0f, 0.0f };
+                float q[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                float s[3] = { 1.0f, 1.0f, 1.0f };
+
+                if (translations != NULL) cgltf_accessor_read_float(translations, k, t, 3);
+                if (rotations != NULL) cgltf_accessor_read_float(rotations, k, q, 4);
+                if (scales != NULL) cgltf_accessor_read_float(scales, k, s, 3);
+
+                local = MatrixFromTRS(t, q, s);
+                transform = MatrixMultiply(nodeTransform, local);
+            }
+
+            // One raylib mesh per triangle primitive, in primitive order
+            for (int m = firstMesh[meshId]; m < firstMesh[meshId + 1]; m++)
+            {
+                MeshReference ref = { 0 };
+                ref.meshIndex = m;
+                ref.materialIndex = (model.meshMaterial != NULL) ? model.meshMaterial[m] : 0;
+                ref.node = (node->skin != NULL) ? -1 : nodeId;
+                ref.transform = transform;
+                ref.local = local;
+
+                AddMeshReference(list, ref);
+            }
+        }
+    }
+
+    for (cgltf_size i = 0; i < node->children_count; i++)
+    {
+        CollectNodeReferences(data, node->children[i], firstMesh, model, list);
+    }
+}
+
+//----------------------------------------------------------------
+
+InstanceScene LoadInstanceScene(const char* fileName, Model model, Arena* arena)
+{
+    InstanceScene scene = { 0 };
+
+#if (RAYLIB_VERSION_MAJOR > 5) || ((RAYLIB_VERSION_MAJOR == 5) && (RAYLIB_VERSION_MINOR >= 5))
+    // raylib 5.5+ already bakes node transforms into per-node mesh copies
+    TraceLog(LOG_INFO, "INSTANCING: [%s] Node transforms baked by LoadModel(), instancing disabled", fileName);
+    return scene;
+#endif
+
+    cgltf_options options = { cgltf_file_type_invalid };
+    cgltf_data* data = NULL;
+
+    if (cgltf_parse_file(&options, fileName, &data) != cgltf_result_success)
+    {
+        TraceLog(LOG_WARNING, "INSTANCING: [%s] Failed to parse node graph", fileName);
+        return scene;
+    }
+
+    bool hasGpuInstancing = false;
+    for (cgltf_size i = 0; i < data->nodes_count; i++)
+    {
+        if (data->nodes[i].has_mesh_gpu_instancing) hasGpuInstancing = true;
+    }
+
+    // Instance attributes live in buffers, plain node references only need the JSON
+    if (hasGpuInstancing && (cgltf_load_buffers(&options, data, fileName) != cgltf_result_success))
+    {
+        TraceLog(LOG_WARNING, "INSTANCING: [%s] Failed to load buffers for EXT_mesh_gpu_instancing", fileName);
+        cgltf_free(data);
+        return scene;
+    }
+
+    // Map glTF meshes to the raylib meshes created from their triangle primitives
+    int* firstMesh = (int*)RL_CALLOC(data->meshes_count + 1, sizeof(int));
+    for (cgltf_size i = 0; i < data->meshes_count; i++)
+    {
+        int triangleCount = 0;
+        for (cgltf_size p = 0; p < data->meshes[i].primitives_count; p++)
+        {
+            if (data->meshes[i].primitives[p].type == cgltf_primitive_type_triangles) triangleCount++;
+        }
+
+        firstMesh[i + 1] = firstMesh[i] + triangleCount;
+    }
+
+    if (firstMesh[data->meshes_count] != model.meshCount)
+    {
+        TraceLog(LOG_WARNING, "INSTANCING: [%s] Mesh layout does not match the loaded model (%d vs %d)", fileName, firstMesh[data->meshes_count], model.meshCount);
+        RL_FREE(firstMesh);
+        cgltf_free(data);
+        return scene;
+    }
+
+    MeshReferenceList list = { 0 };
+
+    if (data->scene != NULL)
+    {
+        for (cgltf_size i = 0; i < data->scene->nodes_count; i++) CollectNodeReferences(data, data->scene->nodes[i], firstMesh, model, &list);
+    }
+    else
+    {
+        for (cgltf_size i = 0; i < data->nodes_count; i++)
+        {
+            if (data->nodes[i].parent == NULL) CollectNodeReferences(data, &data->nodes[i], firstMesh, model, &list);
+        }
+    }
+
+    RL_FREE(firstMesh);
+    cgltf_free(data);
+
+    if (list.count == 0)
+    {
+        RL_FREE(list.refs);
+        return scene;
+    }
+
+    // Group references sharing a mesh/material pair
+    qsort(list.refs, list.count, sizeof(MeshReference), CompareMeshReference);
+
+    scene.batches = (InstanceBatch*)ArenaAlloc(arena, list.count*sizeof(InstanceBatch));
+    scene.instanceCount = list.count;
+    scene.visibleTransforms = (Matrix*)ArenaAlloc(arena, list.count*sizeof(Matrix));
+
+    for (int i = 0; i < list.count;)
+    {
+        int end = i + 1;
+        while ((end < list.count) && (list.refs[end].meshIndex == list.refs[i].meshIndex) && (list.refs[end].materialIndex == list.refs[i].materialIndex)) end++;
+
+        InstanceBatch* batch = &scene.batches[scene.batchCount++];
+        batch->meshIndex = list.refs[i].meshIndex;
+        batch->materialIndex = list.refs[i].materialIndex;
+        batch->instanceCount = end - i;
+        batch->transforms = (Matrix*)ArenaAlloc(arena, batch->instanceCount*sizeof(Matrix));
+        batch->nodes = (int*)ArenaAlloc(arena, batch->instanceCount*sizeof(int));
+        batch->locals = (Matrix*)ArenaAlloc(arena, batch->instanceCount*sizeof(Matrix));
+
+        for (int k = 0; k < batch->instanceCount; k++)
+        {
+            batch->transforms[k] = list.refs[i + k].transform;
+            batch->nodes[k] = list.refs[i + k].node;
+            batch->locals[k] = list.refs[i + k].local;
+        }
+
+        i = end;
+    }
+
+    RL_FREE(list.refs);
+
+    scene.shader = LoadShaderFromMemory(instancingVs, instancingFs);
+
+    if (scene.shader.id == rlGetShaderIdDefault())
+    {
+        // Shader failed to compile (no GLSL 330), draw instances one by one
+        scene.shader = (Shader){ 0 };
+    }
+    else
+    {
+        scene.shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(scene.shader, "instanceTransform");
+    }
+
+    TraceLog(LOG_INFO, "INSTANCING: [%s] %d mesh references grouped into %d batches", fileName, scene.instanceCount, scene.batchCount);
+
+    return scene;
+}
+
+void UnloadInstanceScene(InstanceScene scene)
+{
+    if (scene.shader.id > 0) UnloadShader(scene.shader);
+}
+
+int UpdateInstanceTransforms(InstanceScene* scene, const SceneGraph* graph)
+{
+    if (graph->changedCount == 0) return 0;
+
+    int updated = 0;
+
+    for (int i = 0; i < scene->batchCount; i++)
+    {
+        InstanceBatch* batch = &scene->batches[i];
+
+        for (int k = 0; k < batch->instanceCount; k++)
+        {
+            const int gltfNode = batch->nodes[k];
+            if ((gltfNode < 0) || (gltfNode >= graph->gltfNodeCount)) continue;
+
+            const int node = graph->gltfToNode[gltfNode];
+            if ((node < 0) || !graph->isChanged[node]) continue;
+
+            batch->transforms[k] = MatrixMultiply(graph->worlds[node], batch->locals[k]);
+            updated++;
+        }
+    }
+
+    return updated;
+}
+
+//----------------------------------------------------------------
+
+void DrawInstanceScene(InstanceScene* scene, Model model, QuantModel quant, Matrix transform, bool isInstanced, const bool* visible)
+{
+    scene->drawCalls = 0;
+
+    const int dequantScaleLoc = (scene->shader.id > 0) ? GetShaderLocation(scene->shader, "dequantScale") : -1;
+    const int dequantOffsetLoc = (scene->shader.id > 0) ? GetShaderLocation(scene->shader, "dequantOffset") : -1;
+
+    // Viewer transform goes on the rlgl stack, DrawMesh*() applies it after the instance transform
+    const float transformColumns[16] = {
+        transform.m0, transform.m1, transform.m2, transform.m3,
+        transform.m4, transform.m5, transform.m6, transform.m7,
+        transform.m8, transform.m9, transform.m10, transform.m11,
+        transform.m12, transform.m13, transform.m14, transform.m15
+    };
+
+    rlPushMatrix();
+    rlMultMatrixf(transformColumns);
+
+    int firstInstance = 0;
+
+    for (int i = 0; i < scene->batchCount; i++)
+    {
+        const InstanceBatch* batch = &scene->batches[i];
+        const Mesh mesh = model.meshes[batch->meshIndex];
+        const QuantMesh* quantMesh = (batch->meshIndex < quant.meshCount) ? &quant.meshes[batch->meshIndex] : NULL;
+        const bool* batchVisible = (visible != NULL) ? &visible[firstInstance] : NULL;
+
+        firstInstance += batch->instanceCount;
+
+        Material material = model.materials[batch->materialIndex];
+
+        // Gather the instances that survived culling
+        const Matrix* transforms = batch->transforms;
+        int instanceCount = batch->instanceCount;
+
+        if (batchVisible != NULL)
+        {
+            instanceCount = 0;
+
+            for (int k = 0; k < batch->instanceCount; k++)
+            {
+                if (batchVisible[k]) scene->visibleTransforms[instanceCount++] = batch->transforms[k];
+            }
+
+            transforms = scene->visibleTransforms;
+        }
+
+        if (instanceCount == 0) continue;
+
+        if (isInstanced && (instanceCount > 1) && (scene->shader.id > 0))
+        {
+            Vector3 dequantScale = { 1.0f, 1.0f, 1.0f };
+            Vector3 dequantOffset = { 0.0f, 0.0f, 0.0f };
+
+            if ((quantMesh != NULL) && quantMesh->isGpuCompact)
+            {
+                dequantScale = quantMesh->scale;
+                dequantOffset = quantMesh->offset;
+            }
+
+            SetShaderValue(scene->shader, dequantScaleLoc, &dequantScale, SHADER_UNIFORM_VEC3);
+            SetShaderValue(scene->shader, dequantOffsetLoc, &dequantOffset, SHADER_UNIFORM_VEC3);
+
+            material.shader = scene->shader;
+            DrawMeshInstanced(mesh, material, transforms, instanceCount);
+            scene->drawCalls++;
+        }
+        else
+        {
+            for (int k = 0; k < instanceCount; k++)
+            {
+                Matrix meshTransform = (quantMesh != NULL) ? GetQuantMeshMatrix(*quantMesh, transforms[k]) : transforms[k];
+
+                DrawMesh(mesh, material, meshTransform);
+                scene->drawCalls++;
+            }
+        }
+    }
+
+    rlPopMatrix();
+}
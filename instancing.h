@@ -0,0 +1,79 @@
+/*******************************************************************************************
+*
+*   instancing - Mesh-node references grouped into hardware instance batches
+*
+*   raylib's LoadModel() keeps one Mesh per glTF triangle primitive and drops the node graph.
+*   This module re-reads the node graph (cgltf, bundled with raylib) and records every node
+*   that references a mesh, plus the copies declared through EXT_mesh_gpu_instancing. References
+*   that share the same mesh and material are grouped into a batch drawn with one
+*   DrawMeshInstanced() call.
+*
+*   NOTE: Requires GLSL 330 (desktop OpenGL 3.3), otherwise instances are drawn one by one.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include "raylib.h"
+#include "quant.h"
+#include "scene.h"
+
+typedef struct
+{
+    int meshIndex;              // Index into model.meshes
+    int materialIndex;          // Index into model.materials
+    int instanceCount;
+    Matrix* transforms;         // Node world transform of each instance
+    int* nodes;                 // glTF node index of each instance, -1 for skinned meshes
+    Matrix* locals;             // Instance transform under its node (EXT_mesh_gpu_instancing)
+} InstanceBatch;
+
+typedef struct
+{
+    int batchCount;
+    InstanceBatch* batches;
+
+    int instanceCount;          // Total mesh references (node references and GPU instances)
+    Matrix* visibleTransforms;  // Scratch for batches with culled instances
+    Shader shader;              // Instancing shader, id 0 when unavailable
+
+    int drawCalls;              // Draw calls submitted by the last DrawInstanceScene()
+} InstanceScene;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Batches are allocated from the arena, UnloadInstanceScene() only releases the shader
+InstanceScene LoadInstanceScene(const char* fileName, Model model, Arena* arena);
+void UnloadInstanceScene(InstanceScene scene);
+
+// Rebuilds the transforms of instances whose node world changed in the last UpdateSceneGraph(), returns their count
+int UpdateInstanceTransforms(InstanceScene* scene, const SceneGraph* graph);
+
+// visible holds one flag per instance in batch order, NULL draws every instance
+void DrawInstanceScene(InstanceScene* scene, Model model, QuantModel quant, Matrix transform, bool isInstanced, const bool* visible);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INSTANCING_H
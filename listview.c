@@ -0,0 +1,272 @@
+/*******************************************************************************************
+*
+*   listview - Virtualized list of rows with variable heights
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "listview.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <stdlib.h>
+
+//----------------------------------------------------------------
+
+static int ClampRow(int row, int count)
+{
+    if (row < 0) return 0;
+    if (row >= count) return count - 1;
+
+    return row;
+}
+
+// Row at the top of a page above or below the focused one
+static int GetListViewPageRow(const ListView* view, int row, float viewHeight, int direction)
+{
+    const float y = GetListViewRowTop(view, row) + direction*viewHeight;
+    const int target = GetListViewRowAt(view, y);
+
+    // A row taller than the view still moves the focus by one
+    return (target == row) ? ClampRow(row + direction, view->count) : target;
+}
+
+//----------------------------------------------------------------
+
+ListView LoadListView(int count, float rowHeight)
+{
+    ListView view = { 0 };
+
+    view.count = (count > 0) ? count : 0;
+    view.rowHeight = (rowHeight >= 1.0f) ? rowHeight : 1.0f;
+    view.focused = -1;
+
+    return view;
+}
+
+ListView LoadListViewHeights(const float* heights, int count)
+{
+    ListView view = LoadListView(0, 1.0f);
+
+    view.offsets = (float*)RL_CALLOC(1, sizeof(float));
+    if (view.offsets == NULL) return view;
+
+    if (!AppendListViewRows(&view, heights, count))
+    {
+        UnloadListView(view);
+        return LoadListView(0, 1.0f);
+    }
+
+    return view;
+}
+
+void UnloadListView(ListView view)
+{
+    RL_FREE(view.offsets);
+    RL_FREE(view.bands);
+}
+
+bool AppendListViewRows(ListView* view, const float* heights, int count)
+{
+    if (view->offsets == NULL) return false;
+    if (count <= 0) return true;
+
+    const int total = view->count + count;
+
+    if (total + 1 > view->capacity)
+    {
+        int capacity = (view->capacity > 0) ? view->capacity : 64;
+        while (capacity < total + 1) capacity *= 2;
+
+        float* offsets = (float*)RL_REALLOC(view->offsets, capacity*sizeof(float));
+        if (offsets == NULL) return false;
+
+        view->offsets = offsets;
+        view->capacity = capacity;
+    }
+
+    float top = view->offsets[view->count];
+    float shortest = (view->count > 0) ? view->bandHeight : heights[0];
+
+    for (int i = 0; i < count; i++)
+    {
+        const float height = (heights[i] >= 1.0f) ? heights[i] : 1.0f;
+
+        view->offsets[view->count + i] = top;
+        top += height;
+
+        if (height < shortest) shortest = height;
+    }
+
+    view->offsets[total] = top;
+
+    int band = view->bandCount;
+
+    // A shorter row would fall between two band tops, the bands start over
+    if ((view->count == 0) || (shortest < view->bandHeight))
+    {
+        // Bands as tall as the shortest row, widened when the rows differ so much that there would be over two per row
+        view->bandHeight = (shortest >= 1.0f) ? shortest : 1.0f;
+        if (top/view->bandHeight > 2.0f*total) view->bandHeight = top/(2.0f*total);
+
+        band = 0;
+    }
+
+    const int bandCount = (int)(top/view->bandHeight) + 1;
+
+    if (bandCount > view->bandCapacity)
+    {
+        int capacity = (view->bandCapacity > 0) ? view->bandCapacity : 64;
+        while (capacity < bandCount) capacity *= 2;
+
+        int* bands = (int*)RL_REALLOC(view->bands, capacity*sizeof(int));
+        if (bands == NULL) return false;
+
+        view->bands = bands;
+        view->bandCapacity = capacity;
+    }
+
+    for (int row = (band > 0) ? view->bands[band - 1] : 0; band < bandCount; band++)
+    {
+        const float y = band*view->bandHeight;
+        while ((row < total - 1) && (view->offsets[row + 1] <= y)) row++;
+
+        view->bands[band] = row;
+    }
+
+    view->count = total;
+    view->bandCount = bandCount;
+    view->rowHeight = view->bandHeight;
+
+    return true;
+}
+
+void SetListViewCount(ListView* view, int count)
+{
+    if (view->offsets != NULL) return;
+
+    view->count = (count > 0) ? count : 0;
+
+    if (view->focused >= view->count) view->focused = view->count - 1;
+    view->first = view->last = 0;
+    view->firstTop = 0.0f;
+}
+
+float GetListViewContentHeight(const ListView* view)
+{
+    return (view->offsets != NULL) ? view->offsets[view->count] : view->count*view->rowHeight;
+}
+
+float GetListViewRowTop(const ListView* view, int row)
+{
+    return (view->offsets != NULL) ? view->offsets[row] : row*view->rowHeight;
+}
+
+float GetListViewRowHeight(const ListView* view, int row)
+{
+    return (view->offsets != NULL) ? view->offsets[row + 1] - view->offsets[row] : view->rowHeight;
+}
+
+int GetListViewRowAt(const ListView* view, float y)
+{
+    if (view->count == 0) return -1;
+    if (y <= 0.0f) return 0;
+
+    if (view->offsets == NULL) return ClampRow((int)(y/view->rowHeight), view->count);
+
+    const int band = (int)(y/view->bandHeight);
+    if (band >= view->bandCount) return view->count - 1;
+
+    int row = view->bands[band];
+    while ((row < view->count - 1) && (view->offsets[row + 1] <= y)) row++;
+
+    return row;
+}
+
+void ScrollListView(ListView* view, float scroll, float viewHeight)
+{
+    const float maxScroll = GetListViewContentHeight(view) - viewHeight;
+
+    if (scroll > maxScroll) scroll = maxScroll;
+    if (scroll < 0.0f) scroll = 0.0f;
+
+    view->scroll = scroll;
+}
+
+void ScrollListViewToRow(ListView* view, int row, float viewHeight)
+{
+    if ((row < 0) || (row >= view->count)) return;
+
+    const float top = GetListViewRowTop(view, row);
+    const float bottom = top + GetListViewRowHeight(view, row);
+
+    if (top < view->scroll) ScrollListView(view, top, viewHeight);
+    else if (bottom > view->scroll + viewHeight) ScrollListView(view, bottom - viewHeight, viewHeight);
+}
+
+int UpdateListView(ListView* view, float viewHeight, ListViewInput input)
+{
+    int activated = -1;
+
+    if (input.wheel != 0.0f) ScrollListView(view, view->scroll - input.wheel*LIST_VIEW_WHEEL_ROWS*view->rowHeight, viewHeight);
+
+    if ((view->count > 0) && (input.move != LIST_VIEW_MOVE_NONE))
+    {
+        // The first key press focuses the top visible row
+        int row = view->focused;
+
+        if (row < 0) row = GetListViewRowAt(view, view->scroll);
+        else
+        {
+            switch (input.move)
+            {
+                case LIST_VIEW_MOVE_UP: row = ClampRow(row - 1, view->count); break;
+                case LIST_VIEW_MOVE_DOWN: row = ClampRow(row + 1, view->count); break;
+                case LIST_VIEW_MOVE_PAGE_UP: row = GetListViewPageRow(view, row, viewHeight, -1); break;
+                case LIST_VIEW_MOVE_PAGE_DOWN: row = GetListViewPageRow(view, row, viewHeight, 1); break;
+                case LIST_VIEW_MOVE_HOME: row = 0; break;
+                case LIST_VIEW_MOVE_END: row = view->count - 1; break;
+                default: break;
+            }
+        }
+
+        view->focused = row;
+        ScrollListViewToRow(view, row, viewHeight);
+    }
+
+    if (input.activate && (view->focused >= 0) && (view->focused < view->count)) activated = view->focused;
+
+    // A shrunk list or a grown view can leave the scroll past the end
+    ScrollListView(view, view->scroll, viewHeight);
+
+    if (view->count == 0)
+    {
+        view->first = view->last = 0;
+        view->firstTop = 0.0f;
+
+        return activated;
+    }
+
+    view->first = GetListViewRowAt(view, view->scroll);
+    view->last = GetListViewRowAt(view, view->scroll + viewHeight) + 1;
+    view->firstTop = GetListViewRowTop(view, view->first) - view->scroll;
+
+    return activated;
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************************
+*
+*   listview - Virtualized list of rows with variable heights
+*
+*   Only the rows inside the view are visited, a frame costs the same for ten rows or a million.
+*   Rows share one height, or each has its own and the view keeps the top of every row. The
+*   content is cut into bands about as tall as the shortest row, each band stores the row at its
+*   top, so finding the row at a scroll offset is one division and a step or two forward.
+*
+*   Rows can be appended while the list is shown, the bands grow from where they ended unless a
+*   row shorter than the band height arrives and they are rebuilt.
+*
+*   UpdateListView() applies the wheel and keyboard navigation and computes the visible rows,
+*   drawing is left to the caller (gui_list_view.h draws with raygui).
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef LISTVIEW_H
+#define LISTVIEW_H
+
+#include "raylib.h"
+
+#define LIST_VIEW_WHEEL_ROWS    3       // Rows of the shortest height scrolled per wheel step
+
+typedef enum
+{
+    LIST_VIEW_MOVE_NONE = 0,
+    LIST_VIEW_MOVE_UP,
+    LIST_VIEW_MOVE_DOWN,
+    LIST_VIEW_MOVE_PAGE_UP,
+    LIST_VIEW_MOVE_PAGE_DOWN,
+    LIST_VIEW_MOVE_HOME,
+    LIST_VIEW_MOVE_END
+} ListViewMove;
+
+typedef struct
+{
+    float wheel;                // Wheel steps, positive scrolls up
+    ListViewMove move;          // Focus movement
+    bool activate;              // Enter on the focused row
+} ListViewInput;
+
+typedef struct
+{
+    int count;
+    float rowHeight;            // Height of every row without offsets, the shortest one with them
+    float* offsets;             // Top of each row and the content height at [count], NULL when rows share one height
+    int capacity;               // Rows the offsets have room for
+    int* bands;                 // Row at the top of each band
+    int bandCount;
+    int bandCapacity;
+    float bandHeight;
+
+    float scroll;               // Content pixels above the view
+    int focused;                // Keyboard focus, -1 for none
+
+    // Visible rows of the last update, last is exclusive
+    int first;
+    int last;
+    float firstTop;             // Top of the first visible row relative to the view, zero or negative
+
+    bool isDraggingThumb;
+    float thumbGrab;            // Mouse offset into the scrollbar thumb while dragging
+} ListView;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ListView LoadListView(int count, float rowHeight);
+// Every row has its own height, returns a view without rows when the offsets cannot be allocated
+ListView LoadListViewHeights(const float* heights, int count);
+void UnloadListView(ListView view);
+
+// Rows with their own heights only, for lists that fill in over several frames
+bool AppendListViewRows(ListView* view, const float* heights, int count);
+
+// Rows sharing one height only, the scroll and focus are clamped to the new count
+void SetListViewCount(ListView* view, int count);
+
+float GetListViewContentHeight(const ListView* view);
+float GetListViewRowTop(const ListView* view, int row);
+float GetListViewRowHeight(const ListView* view, int row);
+// Row covering a content offset, -1 for an empty list
+int GetListViewRowAt(const ListView* view, float y);
+
+void ScrollListView(ListView* view, float scroll, float viewHeight);
+// Scrolls as little as needed to show the whole row
+void ScrollListViewToRow(ListView* view, int row, float viewHeight);
+
+// Returns the row activated with enter, -1 otherwise
+int UpdateListView(ListView* view, float viewHeight, ListViewInput input);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LISTVIEW_H
@@ -0,0 +1,292 @@
+/*******************************************************************************************
+*
+*   loadreport - Time, bytes and throughput of each stage of a model load
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "loadreport.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct
+{
+    const char* prefix;                     // Start of the format string raylib logs
+    LoadStage stage;                        // Stage the message ends
+} LoadMarker;
+
+static const LoadMarker loadMarkers[] = {
+    { "MODEL: [%s] Model basic data", LOAD_STAGE_JSON },
+    { "TEXTURE: [ID %i] Texture loaded successfully", LOAD_STAGE_IMAGES },
+    { "VAO: [ID %i] Mesh uploaded successfully", LOAD_STAGE_GPU_UPLOAD },
+    { "VBO: Mesh uploaded successfully", LOAD_STAGE_GPU_UPLOAD },
+};
+
+static const char* stageNames[LOAD_STAGE_COUNT] = { "file i/o", "json", "images", "meshes", "gpu upload", "animations", "viewer" };
+static const char* stageKeys[LOAD_STAGE_COUNT] = { "file_io", "json", "images", "meshes", "gpu_upload", "animations", "viewer" };
+
+static const Color stageColors[LOAD_STAGE_COUNT] = {
+    { 253, 249, 0, 255 },       // file i/o
+    { 255, 161, 0, 255 },       // json
+    { 200, 122, 255, 255 },     // images
+    { 0, 228, 48, 255 },        // meshes
+    { 102, 191, 255, 255 },     // gpu upload
+    { 255, 109, 194, 255 },     // animations
+    { 130, 130, 130, 255 },     // viewer
+};
+
+// raylib callbacks take no user pointer
+static LoadReport* activeReport = NULL;
+
+//----------------------------------------------------------------
+
+static bool StartsWith(const char* text, const char* prefix)
+{
+    return strncmp(text, prefix, strlen(prefix)) == 0;
+}
+
+// Same output as raylib's own logger, which is bypassed while a callback is set
+static void LoadReportLog(int logLevel, const char* text, va_list args)
+{
+    LoadReport* report = activeReport;
+
+    for (int i = 0; (report != NULL) && (i < (int)(sizeof(loadMarkers)/sizeof(loadMarkers[0]))); i++)
+    {
+        if (!StartsWith(text, loadMarkers[i].prefix)) continue;
+
+        if (loadMarkers[i].stage == LOAD_STAGE_IMAGES) report->textureCount++;
+
+        if (loadMarkers[i].stage == LOAD_STAGE_GPU_UPLOAD)
+        {
+            // Until the first upload the meshes were being decoded
+            MarkLoadStage(report, (report->meshUploads == 0) ? LOAD_STAGE_MESHES : LOAD_STAGE_GPU_UPLOAD);
+            report->meshUploads++;
+        }
+        else MarkLoadStage(report, loadMarkers[i].stage);
+
+        break;
+    }
+
+    switch (logLevel)
+    {
+        case LOG_TRACE: printf("TRACE: "); break;
+        case LOG_DEBUG: printf("DEBUG: "); break;
+        case LOG_INFO: printf("INFO: "); break;
+        case LOG_WARNING: printf("WARNING: "); break;
+        case LOG_ERROR: printf("ERROR: "); break;
+        case LOG_FATAL: printf("FATAL: "); break;
+        default: break;
+    }
+
+    vprintf(text, args);
+    printf("\n");
+    fflush(stdout);
+
+    if (logLevel == LOG_FATAL) exit(EXIT_FAILURE);
+}
+
+static unsigned char* LoadReportFileData(const char* fileName, int* dataSize)
+{
+    const double start = GetTime();
+    unsigned char* data = NULL;
+
+    *dataSize = 0;
+
+    FILE* file = fopen(fileName, "rb");
+
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        const long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        // Freed by raylib with RL_FREE(), so not counted by memtrack
+        if (size > 0) data = (unsigned char*)RL_MALLOC(size);
+
+        if ((data != NULL) && (fread(data, 1, size, file) == (size_t)size)) *dataSize = (int)size;
+        else
+        {
+            RL_FREE(data);
+            data = NULL;
+        }
+
+        fclose(file);
+    }
+
+    LoadReport* report = activeReport;
+
+    if (report != NULL)
+    {
+        report->times[LOAD_STAGE_FILE_IO] += GetTime() - start;
+        report->bytes[LOAD_STAGE_FILE_IO] += *dataSize;
+        report->fileReads++;
+
+        // The first read is the model file, a .glb has the JSON chunk length in its header
+        if ((report->fileReads == 1) && (data != NULL))
+        {
+            const bool isGlb = (*dataSize >= 20) && (memcmp(data, "glTF", 4) == 0);
+            report->bytes[LOAD_STAGE_JSON] = isGlb ? (data[12] | (data[13] << 8) | (data[14] << 16) | ((long long)data[15] << 24)) : *dataSize;
+        }
+    }
+
+    if (data != NULL) TraceLog(LOG_INFO, "FILEIO: [%s] File loaded successfully", fileName);
+    else TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to read file", fileName);
+
+    return data;
+}
+
+// File names and exporter strings may hold quotes and, on Windows, backslashes
+static void WriteJsonString(FILE* file, const char* text)
+{
+    fputc('"', file);
+
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\')) fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+
+    fputc('"', file);
+}
+
+//----------------------------------------------------------------
+
+void BeginLoadReport(LoadReport* report, const char* fileName)
+{
+    *report = (LoadReport){ 0 };
+    snprintf(report->fileName, sizeof(report->fileName), "%s", fileName);
+
+    report->startTime = GetTime();
+    report->lastMark = report->startTime;
+
+    activeReport = report;
+    SetLoadFileDataCallback(LoadReportFileData);
+    SetTraceLogCallback(LoadReportLog);
+}
+
+// Charges the time since the last mark, file reads left out, to stage
+void MarkLoadStage(LoadReport* report, LoadStage stage)
+{
+    const double now = GetTime();
+    const double ioTime = report->times[LOAD_STAGE_FILE_IO];
+
+    if (stage != LOAD_STAGE_FILE_IO) report->times[stage] += (now - report->lastMark) - (ioTime - report->ioTimeAtMark);
+
+    report->lastMark = now;
+    report->ioTimeAtMark = ioTime;
+}
+
+void EndLoadReport(LoadReport* report)
+{
+    SetTraceLogCallback(NULL);
+    SetLoadFileDataCallback(NULL);
+    activeReport = NULL;
+
+    report->totalTime = GetTime() - report->startTime;
+
+    TraceLog(LOG_INFO, "LOAD: [%s] %.2f ms, %d file reads, %d textures, %d mesh uploads", report->fileName, report->totalTime*1000.0, report->fileReads, report->textureCount, report->meshUploads);
+
+    for (int i = 0; i < LOAD_STAGE_COUNT; i++)
+    {
+        const double rate = (report->times[i] > 0.0) ? report->bytes[i]/(1024.0*1024.0)/report->times[i] : 0.0;
+        TraceLog(LOG_INFO, "LOAD:     %-10s %10.2f ms %10.1f KB %10.1f MB/s", stageNames[i], report->times[i]*1000.0, report->bytes[i]/1024.0, rate);
+    }
+}
+
+bool AppendLoadReport(const LoadReport* report, const char* logFileName)
+{
+    FILE* file = fopen(logFileName, "a");
+
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "LOAD: [%s] Failed to open for appending", logFileName);
+        return false;
+    }
+
+    fprintf(file, "{\"time\":%lld,\"raylib\":\"%s\",\"file\":", (long long)time(NULL), RAYLIB_VERSION);
+    WriteJsonString(file, report->fileName);
+    fprintf(file, ",\"generator\":");
+    WriteJsonString(file, report->generator);
+
+    fprintf(file, ",\"total_ms\":%.3f,\"file_reads\":%d,\"textures\":%d,\"mesh_uploads\":%d,\"stages\":{",
+        report->totalTime*1000.0, report->fileReads, report->textureCount, report->meshUploads);
+
+    for (int i = 0; i < LOAD_STAGE_COUNT; i++)
+    {
+        const double rate = (report->times[i] > 0.0) ? report->bytes[i]/(1024.0*1024.0)/report->times[i] : 0.0;
+        fprintf(file, "%s\"%s\":{\"ms\":%.3f,\"bytes\":%lld,\"mb_per_s\":%.1f}", (i > 0) ? "," : "", stageKeys[i], report->times[i]*1000.0, report->bytes[i], rate);
+    }
+
+    fprintf(file, "}}\n");
+
+    return fclose(file) == 0;
+}
+
+const char* GetLoadStageName(LoadStage stage)
+{
+    return ((stage >= 0) && (stage < LOAD_STAGE_COUNT)) ? stageNames[stage] : "";
+}
+
+//----------------------------------------------------------------
+
+void DrawLoadReport(const LoadReport* report, Rectangle bounds)
+{
+    DrawRectangleRec(bounds, Fade(BLACK, 0.75f));
+
+    const int left = (int)bounds.x + 8;
+    const int top = (int)bounds.y + 4;
+
+    DrawText(TextFormat("%s, %.1f ms", GetFileName(report->fileName), report->totalTime*1000.0), left, top, 10, RAYWHITE);
+    if (report->generator[0] != '\0') DrawText(report->generator, left, top + 12, 10, LIGHTGRAY);
+
+    // One bar of the whole load, each stage in its share
+    const float barWidth = bounds.width - 16;
+    float x = (float)left;
+
+    for (int i = 0; (i < LOAD_STAGE_COUNT) && (report->totalTime > 0.0); i++)
+    {
+        const float width = barWidth*(float)(report->times[i]/report->totalTime);
+        DrawRectangleRec((Rectangle){ x, (float)top + 26, width, 8 }, stageColors[i]);
+        x += width;
+    }
+
+    const char* headers[4] = { "ms", "%", "KB", "MB/s" };
+    for (int i = 0; i < 4; i++) DrawText(headers[i], left + 90 + 70*i, top + 40, 10, RAYWHITE);
+
+    for (int i = 0; i < LOAD_STAGE_COUNT; i++)
+    {
+        const int y = top + 54 + i*12;
+        const double share = (report->totalTime > 0.0) ? 100.0*report->times[i]/report->totalTime : 0.0;
+
+        DrawRectangle(left, y + 2, 6, 6, stageColors[i]);
+        DrawText(stageNames[i], left + 10, y, 10, LIGHTGRAY);
+        DrawText(TextFormat("%.1f", report->times[i]*1000.0), left + 90, y, 10, LIGHTGRAY);
+        DrawText(TextFormat("%.0f", share), left + 160, y, 10, LIGHTGRAY);
+
+        if (report->bytes[i] > 0)
+        {
+            DrawText(TextFormat("%.1f", report->bytes[i]/1024.0), left + 230, y, 10, LIGHTGRAY);
+            if (report->times[i] > 0.0) DrawText(TextFormat("%.1f", report->bytes[i]/(1024.0*1024.0)/report->times[i]), left + 300, y, 10, LIGHTGRAY);
+        }
+    }
+}
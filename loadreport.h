@@ -0,0 +1,89 @@
+/*******************************************************************************************
+*
+*   loadreport - Time, bytes and throughput of each stage of a model load
+*
+*   LoadModel() parses, decodes and uploads in one call. BeginLoadReport() installs raylib's file
+*   and log callbacks until EndLoadReport(): file reads are timed as they happen, and the messages
+*   raylib logs as it goes mark the stage boundaries inside the call. JSON parsing ends with the
+*   "Model basic data" message, each texture with its "TEXTURE" message and each mesh upload with
+*   its "VAO"/"VBO" one. The decoding of the first mesh upload is charged to mesh decoding.
+*
+*   Stages outside raylib are closed with MarkLoadStage(), which charges the time since the last
+*   mark minus the file reads in between. Nothing is marked when raylib logs below LOG_INFO, the
+*   time then stays with the stage marked next.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef LOADREPORT_H
+#define LOADREPORT_H
+
+#include "raylib.h"
+
+typedef enum
+{
+    LOAD_STAGE_FILE_IO = 0,                 // Every LoadFileData(), the animations read the file again
+    LOAD_STAGE_JSON,
+    LOAD_STAGE_IMAGES,                      // Buffer loading, image decoding and texture upload
+    LOAD_STAGE_MESHES,                      // Accessors decoded into mesh arrays, skins
+    LOAD_STAGE_GPU_UPLOAD,                  // Vertex and index buffers
+    LOAD_STAGE_ANIMATIONS,                  // LoadModelAnimations(), clip poses baked per frame
+    LOAD_STAGE_VIEWER,                      // Quantization, scene graph, instances, edges, occluders and names
+    LOAD_STAGE_COUNT
+} LoadStage;
+
+typedef struct
+{
+    char fileName[256];
+    char generator[48];                     // asset.generator of a .glb, empty when unknown
+
+    double times[LOAD_STAGE_COUNT];         // Seconds
+    long long bytes[LOAD_STAGE_COUNT];      // Bytes each stage read, decoded or uploaded, 0 when not measured
+    double totalTime;
+
+    int fileReads;
+    int textureCount;
+    int meshUploads;
+
+    // Marks in progress
+    double startTime;
+    double lastMark;
+    double ioTimeAtMark;
+} LoadReport;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only one report is recorded at a time, the callbacks reach it through a static
+void BeginLoadReport(LoadReport* report, const char* fileName);
+void MarkLoadStage(LoadReport* report, LoadStage stage);
+void EndLoadReport(LoadReport* report);
+
+// Appends the report as one JSON line
+bool AppendLoadReport(const LoadReport* report, const char* logFileName);
+
+const char* GetLoadStageName(LoadStage stage);
+void DrawLoadReport(const LoadReport* report, Rectangle bounds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOADREPORT_H
@@ -31,325 +31,69 @@
 #include "main.h"
 
 //----------------------------------------------------------------
-Matrix MatrixMultiply(Matrix a, Matrix b)
-{
-    Matrix result = { 0 };
-
-    result.m0 = a.m0*b.m0 + a.m4*b.m1 + a.m8*b.m2 + a.m12*b.m3;
-    result.m1 = a.m1*b.m0 + a.m5*b.m1 + a.m9*b.m2 + a.m13*b.m3;
-    result.m2 = a.m2*b.m0 + a.m6*b.m1 + a.m10*b.m2 + a.m14*b.m3;
-    result.m3 = a.m3*b.m0 + a.m7*b.m1 + a.m11*b.m2 + a.m15*b.m3;
-
-    result.m4 = a.m0*b.m4 + a.m4*b.m5 + a.m8*b.m6 + a.m12*b.m7;
-    result.m5 = a.m1*b.m4 + a.m5*b.m5 + a.m9*b.m6 + a.m13*b.m7;
-    result.m6 = a.m2*b.m4 + a.m6*b.m5 + a.m10*b.m6 + a.m14*b.m7;
-    result.m7 = a.m3*b.m4 + a.m7*b.m5 + a.m11*b.m6 + a.m15*b.m7;
-
-    result.m8 = a.m0*b.m8 + a.m4*b.m9 + a.m8*b.m10 + a.m12*b.m11;
-    result.m9 = a.m1*b.m8 + a.m5*b.m9 + a.m9*b.m10 + a.m13*b.m11;
-    result.m10 = a.m2*b.m8 + a.m6*b.m9 + a.m10*b.m10 + a.m14*b.m11;
-    result.m11 = a.m3*b.m8 + a.m7*b.m9 + a.m11*b.m10 + a.m15*b.m11;
-
-    result.m12 = a.m0*b.m12 + a.m4*b.m13 + a.m8*b.m14 + a.m12*b.m15;
-    result.m13 = a.m1*b.m12 + a.m5*b.m13 + a.m9*b.m14 + a.m13*b.m15;
-    result.m14 = a.m2*b.m12 + a.m6*b.m13 + a.m10*b.m14 + a.m14*b.m15;
-    result.m15 = a.m3*b.m12 + a.m7*b.m13 + a.m11*b.m14 + a.m15*b.m15;
-
-    return result;
-}
-
-Matrix MatrixTranslateV(Vector3 v)
-{
-    return (Matrix){ 1.0f, 0.0f, 0.0f, v.x,
-                      0.0f, 1.0f, 0.0f, v.y,
-                      0.0f, 0.0f, 1.0f, v.z,
-                      0.0f, 0.0f, 0.0f, 1.0f };
-}
-
-Matrix MatrixScaleV(Vector3 v)
-{
-    return (Matrix){ v.x, 0.0f, 0.0f, 0.0f,
-                      0.0f, v.y, 0.0f, 0.0f,
-                      0.0f, 0.0f, v.z, 0.0f,
-                      0.0f, 0.0f, 0.0f, 1.0f };
-}
-
-Matrix MatrixRotateXYZ(Vector3 angle)
-{
-    Matrix result = { 0 };
-
-    float cosz = cosf(-angle.z);
-    float sinz = sinf(-angle.z);
-    float cosy = cosf(-angle.y);
-    float siny = sinf(-angle.y);
-    float cosx = cosf(-angle.x);
-    float sinx = sinf(-angle.x);
-
-    result.m0 = cosz*cosy;
-    result.m1 = (cosz*siny*sinx) - (sinz*cosx);
-    result.m2 = (cosz*siny*cosx) + (sinz*sinx);
-    result.m3 = 0.0f;
-
-    result.m4 = sinz*cosy;
-    result.m5 = (sinz*siny*sinx) + (cosz*cosx);
-    result.m6 = (sinz*siny*cosx) - (cosz*sinx);
-    result.m7 = 0.0f;
-
-    result.m8 = -siny;
-    result.m9 = cosy*sinx;
-    result.m10 = cosy*cosx;
-    result.m11 = 0.0f;
-
-    result.m12 = 0.0f;
-    result.m13 = 0.0f;
-    result.m14 = 0.0f;
-    result.m15 = 1.0f;
-
-    return result;
-}
-
-Matrix QuaternionToMatrix(Quaternion q) 
-{
-    Matrix result = { 0 };
-
-    // Normalize the quaternion
-    float norm = sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
-    if (norm > 0.0f) 
-    {
-        q.x /= norm;
-        q.y /= norm;
-        q.z /= norm;
-        q.w /= norm;
-    }
-
-    // Pre-calculate repeated values
-    float xx = q.x*q.x;
-    float yy = q.y*q.y;
-    float zz = q.z*q.z;
-    float xy = q.x*q.y;
-    float xz = q.x*q.z;
-    float yz = q.y*q.z;
-    float wx = q.w*q.x;
-    float wy = q.w*q.y;
-    float wz = q.w*q.z;
-
-    // Set matrix elements
-    result.m0 = 1.0f - 2.0f*(yy + zz);
-    result.m1 = 2.0f*(xy - wz);
-    result.m2 = 2.0f*(xz + wy);
-    result.m3 = 0.0f;
-
-    result.m4 = 2.0f*(xy + wz);
-    result.m5 = 1.0f - 2.0f*(xx + zz);
-    result.m6 = 2.0f*(yz - wx);
-    result.m7 = 0.0f;
-
-    result.m8  = 2.0f*(xz - wy);
-    result.m9  = 2.0f*(yz + wx);
-    result.m10 = 1.0f - 2.0f*(xx + yy);
-    result.m11 = 0.0f;
-
-    result.m12 = 0.0f;
-    result.m13 = 0.0f;
-    result.m14 = 0.0f;
-    result.m15 = 1.0f;
-
-    return result;
-}
 
-Matrix MatrixRotateV(Vector3 v)
+Camera CreateCamera()
 {
-    v.x *= DEG2RAD;
-    v.y *= DEG2RAD;
-    v.z *= DEG2RAD;
+    Camera camera;
+    camera.position    = (Vector3){ 20.0f, 20.0f, 20.0f };  
+    camera.target      = (Vector3){ 3.0f, 3.0f, 3.0f };     
+    camera.up          = (Vector3){ 0.0f, 1.0f, 0.0f };     
+    camera.fovy        = 45.0f;                             
+    camera.projection  = CAMERA_PERSPECTIVE;
 
-    return MatrixRotateXYZ(v);
+    return camera;   
 }
 
 //----------------------------------------------------------------
 
-//----------------------------------------------------------------
-
-Quaternion QuaternionMultiply(Quaternion a, Quaternion b) 
+// visible holds the occlusion result (one flag per instance, or per mesh without instances), NULL draws everything
+// transform is the cached root world of the scene graph
+void DrawModelPro(Model model, QuantModel quant, InstanceScene* instances, bool isInstanced, const bool* visible, Matrix transform)
 {
-    Quaternion result;
-
-    result.x = a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y;
-    result.y = a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x;
-    result.z = a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w;
-    result.w = a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z;
+    model.transform = transform;
 
-    return result;
-}
-
-Quaternion QuaternionInvert(Quaternion q) 
-{
-    Quaternion result;
-    
-    // Calculate the magnitude squared of the quaternion
-    float normSquared = q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w;
-
-    if (normSquared > 0.0f) 
-    {
-        // Inverse of a quaternion q = (conjugate(q)) / (norm(q)^2)
-        float invNorm = 1.0f / normSquared;
-        result.x = -q.x*invNorm;
-        result.y = -q.y*invNorm;
-        result.z = -q.z*invNorm;
-        result.w = q.w*invNorm;
-    } 
-    else 
+    if (instances->batchCount > 0)
     {
-        // Return identity quaternion if the input quaternion is zero (non-invertible)
-        result.x = 0.0f;
-        result.y = 0.0f;
-        result.z = 0.0f;
-        result.w = 1.0f;
+        DrawInstanceScene(instances, model, quant, model.transform, isInstanced, visible);
     }
-
-    return result;
-}
-
-Quaternion QuaternionFromEuler(Vector3 angle)
-{
-    // Calculate half angles
-    float halfPitch = angle.x*0.5f;
-    float halfYaw   = angle.y*0.5f;
-    float halfRoll  = angle.z*0.5f;
-
-    // Calculate sin and cos for each half angle
-    float sinPitch = sinf(halfPitch);
-    float cosPitch = cosf(halfPitch);
-    float sinYaw   = sinf(halfYaw);
-    float cosYaw   = cosf(halfYaw);
-    float sinRoll  = sinf(halfRoll);
-    float cosRoll  = cosf(halfRoll);
-
-    return (Quaternion) 
+    else if (visible != NULL)
     {
-        cosYaw*sinPitch*cosRoll + sinYaw*cosPitch*sinRoll,  
-        sinYaw*cosPitch*cosRoll - cosYaw*sinPitch*sinRoll, 
-        cosYaw*cosPitch*sinRoll - sinYaw*sinPitch*cosRoll, 
-        cosYaw*cosPitch*cosRoll + sinYaw*sinPitch*sinRoll   
-    };
-}
-
-//----------------------------------------------------------------
-
-//----------------------------------------------------------------
-
-Vector3 Vector3Zero() 
-{ 
-    return (Vector3){ 0.0f, 0.0f, 0.0f }; 
-}
-
-Vector3 Vector3One() 
-{ 
-    return (Vector3){ 1.0f, 1.0f, 1.0f }; 
-}
-
-Vector3 Vector3Add(Vector3 a, Vector3 b)
-{
-    return (Vector3){ a.x + b.x, a.y + b.y, a.z + b.z };
-}
-
-Vector3 Vector3Subtract(Vector3 a, Vector3 b)
-{
-    return (Vector3){ a.x - b.x, a.y - b.y, a.z - b.z };
-}
+        instances->drawCalls = 0;
 
-Vector3 Vector3Multiply(Vector3 a, Vector3 b)
-{
-    return (Vector3){ a.x*b.x, a.y*b.y, a.z*b.z };
-}
-
-Vector3 Vector3Scale(Vector3 v, float scalar)
-{
-    return (Vector3){ v.x*scalar, v.y*scalar, v.z*scalar };
-}
-
-float Vector3DotProduct(Vector3 a, Vector3 b)
-{
-    return (float){ a.x*b.x + a.y*b.y + a.z*b.z };
-}
-
-float Vector3Distance(Vector3 a, Vector3 b)
-{
-    float result = 0.0f;
-
-    float dx = b.x - a.x;
-    float dy = b.y - a.y;
-    float dz = b.z - a.z;
-    result = sqrtf(dx*dx + dy*dy + dz*dz);
-
-    return result;
-}
-
-Vector3 Vector3RotateByQuaternion(Vector3 v, Quaternion q)
-{
-    // Quaternion-vector multiplication: v' = q * v * q⁻¹
-    Quaternion qConjugate = (Quaternion){ -q.x, -q.y, -q.z, q.w };
+        for (int i = 0; i < model.meshCount; i++)
+        {
+            if (!visible[i]) continue;
 
-    // Convert vector to quaternion form (v.x, v.y, v.z, 0)
-    Quaternion vQuat = (Quaternion){ v.x, v.y, v.z, 0.0f };
+            Matrix transform = (i < quant.meshCount) ? GetQuantMeshMatrix(quant.meshes[i], model.transform) : model.transform;
 
-    // Calculate q * v
-    Quaternion qv = (Quaternion)
+            DrawMesh(model.meshes[i], model.materials[model.meshMaterial[i]], transform);
+            instances->drawCalls++;
+        }
+    }
+    else if (quant.meshCount > 0)
     {
-        q.w*vQuat.x + q.y*vQuat.z - q.z*vQuat.y,
-        q.w*vQuat.y + q.z*vQuat.x - q.x*vQuat.z,
-        q.w*vQuat.z + q.x*vQuat.y - q.y*vQuat.x,
-        -q.x*vQuat.x - q.y*vQuat.y - q.z*vQuat.z
-    };
-
-    // Calculate (q * v) * q⁻¹
-    Quaternion resultQuat = (Quaternion)
+        DrawQuantModel(model, quant);
+        instances->drawCalls = model.meshCount;
+    }
+    else
     {
-        qv.w*qConjugate.x + qv.x*qConjugate.w + qv.y*qConjugate.z - qv.z*qConjugate.y,
-        qv.w*qConjugate.y - qv.x*qConjugate.z + qv.y*qConjugate.w + qv.z*qConjugate.x,
-        qv.w*qConjugate.z + qv.x*qConjugate.y - qv.y*qConjugate.x + qv.z*qConjugate.w,
-        qv.w*qConjugate.w - qv.x*qConjugate.x - qv.y*qConjugate.y - qv.z*qConjugate.z
-    };
-
-    return (Vector3){ resultQuat.x, resultQuat.y, resultQuat.z };
+        DrawModel(model, Vector3Zero(), 1.0f, WHITE);
+        instances->drawCalls = model.meshCount;
+    }
 }
 
-Vector3 Vector3Transform(Vector3 v, Matrix mat)
+void DrawModelWiresPro(Model model, QuantModel quant, InstanceScene* instances, bool isInstanced, EdgeModel* edges, float creaseAngle, Matrix transform)
 {
-    return (Vector3)
+    // Unique edge buffers draw every edge once, line mode draws shared edges twice
+    if ((edges != NULL) && (edges->meshCount > 0))
     {
-        v.x*mat.m0 + v.y*mat.m4 + v.z*mat.m8 + mat.m12,
-        v.x*mat.m1 + v.y*mat.m5 + v.z*mat.m9 + mat.m13,
-        v.x*mat.m2 + v.y*mat.m6 + v.z*mat.m10 + mat.m14
-    };
-}
-
-//----------------------------------------------------------------
-
-Camera CreateCamera()
-{
-    Camera camera;
-    camera.position    = (Vector3){ 20.0f, 20.0f, 20.0f };  
-    camera.target      = (Vector3){ 3.0f, 3.0f, 3.0f };     
-    camera.up          = (Vector3){ 0.0f, 1.0f, 0.0f };     
-    camera.fovy        = 45.0f;                             
-    camera.projection  = CAMERA_PERSPECTIVE;
-
-    return camera;   
-}
-
-//----------------------------------------------------------------
-
-void DrawModelPro(Model model, Vector3 pos, Vector3 rot, Vector3 scl)
-{
-    model.transform = MatrixMultiply(MatrixTranslateV(pos), MatrixMultiply(MatrixRotateV(rot), MatrixScaleV(scl)));
-    DrawModel(model, Vector3Zero(), 1.0f, WHITE);
-}
+        DrawEdgeModel(edges, model, quant, instances, transform, creaseAngle, DARKGRAY);
+        return;
+    }
 
-void DrawModelWiresPro(Model model, Vector3 pos, Vector3 rot, Vector3 scl)
-{
-    model.transform = MatrixMultiply(MatrixTranslateV(pos), MatrixMultiply(MatrixRotateV(rot), MatrixScaleV(scl)));
-    DrawModelWires(model, Vector3Zero(), 1.0f, WHITE);
+    rlEnableWireMode();
+    DrawModelPro(model, quant, instances, isInstanced, NULL, transform);
+    rlDisableWireMode();
 }
 
 void DrawTransform(Vector3 pos, Vector3 rot, Vector3 scl)
@@ -377,16 +121,23 @@ void DrawTransform(Vector3 pos, Vector3 rot, Vector3 scl)
     );
 }
 
-void DrawModelBones(Model model, ModelAnimation* anims, unsigned animIndex, unsigned animCurrentFrame, Vector3 pos, Vector3 rot, Vector3 scl, bool isDrawCircles, bool isDrawCubes, bool isDrawAnimTransform, BoneColor colors)
+void DrawModelBones(FrameArena* frame, Model model, ModelAnimation* anims, unsigned animIndex, unsigned animCurrentFrame, Matrix transform, Vector3 rot, Vector3 scl, bool isDrawCircles, bool isDrawCubes, bool isDrawAnimTransform, BoneColor colors, int selectedBone)
 {
-    Matrix rotMatrix = MatrixRotateV(rot);
+    if (model.boneCount <= 0) return;
 
-    for (unsigned i = 0; i < model.boneCount-1; i++)
+    // Bone positions of the current frame in world space, transformed in one batch
+    Vector3* positions = (Vector3*)FrameAlloc(frame, model.boneCount*sizeof(Vector3));
+
+    for (int i = 0; i < model.boneCount; i++)
     {
-        // Get the current bone translation and apply scaling
-        Vector3 translation = anims[animIndex].framePoses[animCurrentFrame][i].translation;
-        Vector3 finalTranslation = Vector3Transform(Vector3Multiply(translation, scl), rotMatrix);
-        finalTranslation = Vector3Add(finalTranslation, pos); // Final transformed position
+        positions[i] = anims[animIndex].framePoses[animCurrentFrame][i].translation;
+    }
+
+    Vector3TransformBatch(positions, positions, model.boneCount, &transform);
+
+    for (int i = 0; i < model.boneCount - 1; i++)
+    {
+        Vector3 finalTranslation = positions[i];
 
         if (isDrawCubes)
         {
@@ -407,15 +158,16 @@ void DrawModelBones(Model model, ModelAnimation* anims, unsigned animIndex, unsi
         int parentIndex = anims[animIndex].bones[i].parent;
         if (parentIndex >= 0)
         {
-            // Get the parent's translation and apply transformations
-            Vector3 parentTranslation = anims[animIndex].framePoses[animCurrentFrame][parentIndex].translation;
-            Vector3 parentFinalTranslation = Vector3Transform(Vector3Multiply(parentTranslation, scl), rotMatrix);
-            parentFinalTranslation = Vector3Add(parentFinalTranslation, pos); // Final transformed position for parent
-
             // Draw a line between the bone and its parent
-            DrawLine3D(finalTranslation, parentFinalTranslation, colors.baseLineColor);
+            DrawLine3D(finalTranslation, positions[parentIndex], colors.baseLineColor);
         }
     }
+
+    // The bone of the node in the inspector, drawn whether cubes are on or not
+    if ((selectedBone >= 0) && (selectedBone < model.boneCount))
+    {
+        DrawCubeWiresV(positions[selectedBone], Vector3Scale(scl, 0.15f), YELLOW);
+    }
 }
 
 void DrawGizmo(Vector3* modelPos, Vector3* posX, Vector3* posY, Vector3* posZ, float size, bool colors[3], bool isGizmoMode)
@@ -451,112 +203,96 @@ bool IsMousePressed()
     return IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || IsMouseButtonPressed(MOUSE_RIGHT_BUTTON);
 }
 
-bool GuiDropdownPro(Rectangle rec, char** v, unsigned* start, unsigned* end, bool* isDragging, unsigned* index, ScrollbarColor* color)
+// Interns the clip names and returns the ';' separated dropdown options, allocated in the table arena
+char* LoadAnimationNames(NameTable* table, const ModelAnimation* anims, int count, NameArray* names, NameIndex* clipIndex)
 {
-    const unsigned max = vector_size(v);
-
-    // Adjust start and end based on scroll input (mouse wheel)
-    if (GetMouseWheelMove() < 0.0f && *end < max)
+    int* clipNames = (int*)ArenaAlloc(table->arena, count*sizeof(int));
+    size_t totalLength = 0;
+    for (int i = 0; i < count; i++)
     {
-        *start += 1;
-        *end += 1;
-    }
-    if (GetMouseWheelMove() > 0.0f && *start > 0)
-    {
-        *start -= 1;
-        *end -= 1;
+        totalLength += strlen(anims[i].name) + 1; // Name and its separator, the last one becomes the null terminator
     }
 
-    Rectangle editModeRec = { rec.x, rec.y + rec.height, rec.width + 11, rec.height*5 };
+    char* options = (char*)ArenaAlloc(table->arena, totalLength);
+    size_t length = 0;
+
+    assert((options != NULL) && (clipNames != NULL));
 
-    // Draw scrollbar if the number of items exceeds the visible range
-    if (max > 5)
+    for (int i = 0; i < count; i++)
     {
-        // Scrollbar background
-        Rectangle scrollbarRec = { rec.x + rec.width + 1, rec.y + rec.height, 10, rec.height*5 };
-        DrawRectangleRec(scrollbarRec, color->backgroundColor);
+        clipNames[i] = InternName(table, anims[i].name);
+
+        const char* name = GetNameString(table, clipNames[i]);
+        NameArrayPush(names, name);
 
-        // Calculate the height and position of the scroll thumb
-        float thumbHeight = (5.0f/max)*scrollbarRec.height;
-        float thumbY = scrollbarRec.y + (*start/(float)(max - 5))*(scrollbarRec.height - thumbHeight);
+        const size_t nameLength = strlen(name);
+        memcpy(options + length, name, nameLength);
+        length += nameLength;
+        options[length++] = (i < count - 1) ? ';' : '\0';
 
-        Vector2 mousePos = GetMousePosition();
+        TraceLog(LOG_INFO, "Animation %d: %s", i, name);
+    }
 
-        Rectangle thumbRec = { scrollbarRec.x, thumbY, scrollbarRec.width, thumbHeight };
-        bool isHovering = CheckCollisionPointRec(mousePos, thumbRec);
+    *clipIndex = BuildNameIndex(table, table->arena, clipNames, count);
 
-        if (isHovering && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) 
-        {
-            color->isDragging = true;
-        }
-        else if (color->isDragging && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) 
-        {
-            color->isDragging = false;
-        }
+    return options;
+}
 
-        if (isHovering && color->isDragging) 
-        {
-            color->currentThumbColor = color->draggedColor;
-        }
-        else if (isHovering) 
-        {
-            color->currentThumbColor = color->hoverColor;
-        }
-        else if (!isHovering && !color->isDragging)
-        {
-            color->currentThumbColor = color->idleColor;
-        }
-        
-        DrawRectangleRec(thumbRec, color->currentThumbColor);
+// Warns about the bytes the model categories hold over the usage before the model was loaded
+MemorySizes CheckModelMemory(MemoryUsage before)
+{
+    const MemorySizes leaks = FindMemoryLeaks(before, GetMemoryUsage());
 
-        float thumbOffsetY = 0.0f;
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        if (leaks.bytes[i] > 0) TraceLog(LOG_WARNING, "MEMORY: Model unload left %.1f KB of %s allocated", leaks.bytes[i]/1024.0f, GetMemoryCategoryName((MemoryCategory)i));
+    }
 
-        // Start dragging if mouse button is pressed within the thumb
-        if (CheckCollisionPointRec(mousePos, thumbRec) && IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
-        {
-            *isDragging = true;
-            thumbOffsetY = mousePos.y - thumbRec.y; // Calculate offset
-        }
+    return leaks;
+}
 
-        // Update thumb position while dragging
-        if (*isDragging)
-        {
-            if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
-            {
-                *isDragging = false;
-            }
-            
-            float newThumbY = mousePos.y - thumbOffsetY;
+// Interns the bone names of the model, bones by name
+NameIndex LoadBoneNames(NameTable* table, Model model)
+{
+    int* boneNames = (int*)ArenaAlloc(table->arena, ((model.boneCount > 0) ? model.boneCount : 1)*sizeof(int));
+    if (boneNames == NULL) return (NameIndex){ 0 };
 
-            // Clamp the thumb's position within the scrollbar
-            newThumbY = fmax(scrollbarRec.y, fmin(newThumbY, scrollbarRec.y + scrollbarRec.height - thumbHeight));
+    for (int i = 0; i < model.boneCount; i++)
+    {
+        boneNames[i] = InternName(table, model.bones[i].name);
+    }
 
-            // Update the scroll start based on the new thumb position
-            float scrollRatio = (newThumbY - scrollbarRec.y)/(scrollbarRec.height - thumbHeight);
-            *start = round(scrollRatio*(max - 5));
-            *end = *start + 5;
-        }
+    return BuildNameIndex(table, table->arena, boneNames, model.boneCount);
+}
 
-        // Draw dropdown items
-        for (unsigned i = 0, j = *start; i < max && j < *end; i++, j++)
-        {
-            Rectangle itemRec = { rec.x, rec.y + rec.height*i + rec.height, rec.width, rec.height };
+// Row of the clip list, rows map to clips through the search results
+void DrawClipRow(Rectangle bounds, int row, int state, void* userData)
+{
+    const ClipListRows* rows = (const ClipListRows*)userData;
+    const int clip = (rows->order != NULL) ? rows->order[row] : row;
 
-            if (GuiButton(itemRec, v[j]))
-            {
-                *index = j;
+    GuiListViewText(bounds, rows->names[clip], (clip == rows->activeClip) ? STATE_PRESSED : state);
+}
 
-                return false;
-            }
+// Clip list under the dropdown header, returns false once a clip is picked or the mouse is pressed outside
+bool GuiClipList(Rectangle rec, ListView* view, const ClipListRows* rows, unsigned* index)
+{
+    Rectangle listRec = { rec.x, rec.y + rec.height, rec.width + GuiGetStyle(LISTVIEW, SCROLLBAR_WIDTH), rec.height*5 };
 
-            if (IsMousePressed() && !CheckCollisionPointRec(mousePos, editModeRec))
-            {
-                return false;
-            }
-        }
+    const int row = GuiListViewVirtual(listRec, view, -1, true, DrawClipRow, (void*)rows);
 
-        // Debug rec
-        //DrawRectangleRec(editModeRec, RED);
+    if (row >= 0)
+    {
+        *index = (rows->order != NULL) ? rows->order[row] : row;
+
+        return false;
+    }
+
+    // The header stays interactive, it holds the search box
+    Vector2 mousePos = GetMousePosition();
+    if (IsMousePressed() && !CheckCollisionPointRec(mousePos, listRec) && !CheckCollisionPointRec(mousePos, rec))
+    {
+        return false;
     }
 
     return true;
@@ -585,28 +321,92 @@ BoneColor InitBoneColor(Color circleColor, Color cubeColor, Color baseLineColor)
     return colors;
 }
 
-ScrollbarColor InitScrollbarColor(Color backgroundColor, Color idleColor, Color hoverColor, Color draggedColor)
+// Process CPU time in seconds, negative when the platform does not provide it
+double GetProcessCpuTime()
 {
-    ScrollbarColor colors = { 0 };
-    colors.idleColor         = idleColor;
-    colors.hoverColor        = hoverColor;
-    colors.draggedColor      = draggedColor;
-    colors.backgroundColor   = backgroundColor;
-    colors.currentThumbColor = idleColor;
-    colors.isDragging        = false;
+#if !defined(_WIN32)
+    struct rusage usage = { 0 };
+    getrusage(RUSAGE_SELF, &usage);
 
-    return colors;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)/1000000.0;
+#else
+    return -1.0;
+#endif
+}
+
+IdleStats InitIdleStats()
+{
+    IdleStats stats = { 0 };
+    stats.windowStart = GetTime();
+    stats.cpuStart    = GetProcessCpuTime();
+    stats.cpuUsage    = -1.0f;
+
+    return stats;
+}
+
+void UpdateIdleStats(IdleStats* stats)
+{
+    stats->wakeups++;
+
+    const double now = GetTime();
+    const double elapsed = now - stats->windowStart;
+
+    if (elapsed >= 1.0)
+    {
+        const double cpuNow = GetProcessCpuTime();
+
+        stats->wakeupsPerSecond = stats->wakeups/elapsed;
+        stats->cpuUsage = (cpuNow >= 0.0) ? (float)(100.0*(cpuNow - stats->cpuStart)/elapsed) : -1.0f;
+
+        stats->windowStart = now;
+        stats->cpuStart = cpuNow;
+        stats->wakeups = 0;
+    }
 }
 
 //----------------------------------------------------------------
 
-int main()
+int main(int argc, char** argv)
 {
+    /* Command line */
+
+    // --trace file.json records from the start and writes at exit, F4 starts and stops a capture
+    const char* traceFileName = "trace.json";
+
+    // --bench file.glb [--clip N] [--frames N] [--loads N] prints JSON timings and exits without a window
+    HeadlessBench headless = { NULL, 0, 1000, 10 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+        {
+            traceFileName = argv[++i];
+            StartTracing();
+        }
+        else if ((strcmp(argv[i], "--bench") == 0) && (i + 1 < argc)) headless.fileName = argv[++i];
+        else if ((strcmp(argv[i], "--clip") == 0) && (i + 1 < argc)) headless.clip = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) headless.frames = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--loads") == 0) && (i + 1 < argc)) headless.loads = atoi(argv[++i]);
+    }
+
+    SetTraceThreadName("main");
+
+    if (headless.fileName != NULL)
+    {
+        const int result = RunHeadlessBench(headless);
+
+        if (IsTracing()) StopTracing(traceFileName);
+        UnloadTracing();
+
+        return result;
+    }
+
     /* Window */
     
     SetConfigFlags(FLAG_MSAA_4X_HINT);
     InitWindow(screenWidth, screenHeight, "GLTF Viewer");
     SetTargetFPS(60);
+    TraceLog(LOG_INFO, "MATH: Batch kernels use %s", GetMathSimdName(GetMathSimdLevel()));
     SetExitKey(0);
 
     /* Model */
@@ -622,6 +422,56 @@ int main()
     Vector3 modelRot = Vector3Zero();
     Vector3 modelScl = Vector3One();
 
+    // Compact vertex storage, applied when the next model is loaded
+    QuantModel quantModel = { 0 };
+    bool isCompactVertices = false;
+
+    // Load-lifetime data of the current model, released in one call on unload
+    Arena modelArena = { 0 };
+
+    // Node, bone and clip names of the current model, interned once
+    NameTable modelNames = { 0 };
+    NameIndex nodeNameIndex = { 0 };
+    NameIndex boneNameIndex = { 0 };
+    NameIndex clipNameIndex = { 0 };
+    double modelLoadTime = 0.0;
+    double modelUnloadTime = 0.0;
+
+    // Memory of the current model: usage before it was loaded and what raylib allocated for it,
+    // F5 shows the breakdown
+    MemoryUsage modelMemoryBase = { 0 };
+    MemorySizes modelMemory = { 0 };
+    MemorySizes modelLeaks = { 0 };
+    bool isMemoryPanel = false;
+
+    // Stage timings of the last load, shown after every load until F6 hides them
+    LoadReport loadReport = { 0 };
+    bool isLoadReportPanel = false;
+
+    // glTF node hierarchy, the root carries modelPos/modelRot/modelScl
+    SceneGraph sceneGraph = { 0 };
+    int instanceUpdates = 0;
+
+    // Node inspector, rotations are edited as an euler offset from the rotation at selection
+    int selectedNode = 0;
+    int inspectedNode = -1;
+    int selectedBone = NAME_NONE;       // Bone of the selected node by name, highlighted in the bone view
+    Quaternion nodeRotationBase = { 0.0f, 0.0f, 0.0f, 1.0f };
+    Vector3 nodeRotationOffset = { 0.0f, 0.0f, 0.0f };
+
+    // Mesh references from the glTF node graph, drawn as instance batches
+    InstanceScene instanceScene = { 0 };
+    bool isInstancing = true;
+
+    // Deduplicated wireframe edges, edges flatter than the crease angle are skipped
+    EdgeModel edgeModel = { 0 };
+    bool isUniqueEdges = true;
+    float creaseAngle = 0.0f;
+
+    // CPU occlusion culling, drawn with the result computed for the previous frame
+    OcclusionCuller occlusionCuller = { 0 };
+    bool isOcclusionCulling = true;
+
     /* Camera */
     
     Camera camera = CreateCamera();
@@ -650,24 +500,24 @@ int main()
     bool targetFPSDropdownEditMode = false;
 
     //----------------------------------------------------------------
-    char** animName = (char**)vector_create();
-    char** animNameSlice = (char**)vector_create();
+    NameArray animName = { 0 };
 
     /*.....................................*/
-    char* animNameOptions = " ";
+    const char* animNameOptions = " ";
     int animNameActiveOption = 0;   
     bool animNameDropdownEditMode = false;
 
     /*.....................................*/
-    unsigned animDropdownStart = 0;
-    unsigned animDropdownEnd = 5;
-    bool animDropdownIsDragging = false;
+    ListView animList = LoadListView(0, 20.0f);
+
+    // Clip search of the long clip list, typing refines the matches of the shorter query
+    SearchIndex clipSearch = { 0 };
+    char clipQuery[SEARCH_MAX_QUERY] = { 0 };
 
     bool isPlayAnimation = true;
     float currentFrame = 0.0f;
 
     /*.....................................*/
-    ScrollbarColor animScrollbarColor = InitScrollbarColor(LIGHTGRAY, DARKGRAY, CBLUE, DBLUE);
     BoneColor animBoneColor = InitBoneColor(LIME, GREEN, BLUE);
     
     /*.....................................*/
@@ -702,23 +552,46 @@ int main()
 
     bool loadFromKey = false; 
 
+    //----------------------------------------------------------------
+    // On-demand rendering: EndDrawing() sleeps until input arrives
+    bool isOnDemandRendering = true;
+    bool isEventWaiting = false;
+    int redrawFrames = 0;
+
+    IdleStats idleStats = InitIdleStats();
+
+    // Per-frame temporaries, reset before BeginDrawing()
+    FrameArena frameArena = InitFrameArena(FRAME_ARENA_DEFAULT_SIZE);
+
+    // Main loop phase timings, F3 shows the timeline
+    FrameProfiler profiler = InitFrameProfiler();
+    bool isProfilerOverlay = false;
+
     while (!WindowShouldClose())
     {
+        BeginProfilerFrame(&profiler);
+
         /* Update functions */
 
         //----------------------------------------------------------------
                             /* Camera */
         //----------------------------------------------------------------
 
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_CAMERA);
+
         if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT))
         {
             UpdateCamera(&camera, CAMERA_FREE);
         }
 
+        EndProfilerPhase(&profiler);
+
         //----------------------------------------------------------------
                             /* Gizmo */
         //----------------------------------------------------------------
 
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_GIZMO);
+
         if (!IsMouseButtonDown(MOUSE_BUTTON_LEFT))
         {
             for (unsigned i = 0; i < 3; i++)
@@ -915,111 +788,25 @@ int main()
         lastX = currentX; // Update lastX to current position
         lastY = currentY; // Update lastY to current position
 
+        EndProfilerPhase(&profiler);
+
         //----------------------------------------------------------------
                             /* Load model button */
         //----------------------------------------------------------------
 
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_LOAD);
+
         LoadRobot(&loadFromKey);
 
+        const char* fileToLoad = NULL;
+
         if (fileDialogState.SelectFilePressed)
         {
             // Load model file (if supported extension)
             if (IsFileExtension(fileDialogState.fileNameText, ".glb") || IsFileExtension(fileDialogState.fileNameText, ".gltf"))
             {
                 strcpy(fileNameToLoad, TextFormat("%s" PATH_SEPERATOR "%s", fileDialogState.dirPathText, fileDialogState.fileNameText));
-                
-                if (model != NULL)
-                {
-                    if (animsCount > 0)
-                    {
-                        UnloadModelAnimations(modelAnimation, animsCount);
-                        MemFree(animNameOptions);
-                        vector_free(animName);
-                    }
-                    
-                    UnloadModel(*model);
-                    MemFree(model);
-
-                    currentFrame = 0.0f;
-                    animNameOptions = " ";
-                    animNameActiveOption = 0; 
-                    animsCount = 0;
-                }
-
-                animName = (char**)vector_create();
-                model = (Model*)MemAlloc(sizeof(Model));
-                *model = LoadModel(fileNameToLoad);
-                modelAnimation = LoadModelAnimations(fileNameToLoad, &animsCount);
-
-                if (animsCount > 0)
-                {
-                    if (vector_size(animName) < 8)
-                    {
-                        for (unsigned i = 0; i < animsCount; i++)
-                        {
-                            char* name = strdup(modelAnimation[i].name); // Duplicate the string
-                            vector_add(&animName, name); // Add the duplicated name to the vector
-                            
-                            TraceLog(LOG_INFO, "Animation %d: %s", i, name);
-                        }
-
-                        // Calculate the size of the new string
-                        size_t totalLength = 0;
-                        for (unsigned i = 0; i < animsCount; i++)
-                        {
-                            totalLength += strlen(animName[i]);
-                        }
-                        totalLength += animsCount - 1; // For the semicolons
-                        totalLength += 1; // For the null terminator
-
-                        // Allocate memory for the new concatenated string
-                        animNameOptions = (char*)MemAlloc(totalLength*sizeof(char));
-                        
-                        assert(animNameOptions != NULL);
-
-                        strcpy(animNameOptions, animName[0]); // Copy the first name
-
-                        // Concatenate the rest of the names
-                        for (unsigned i = 1; i < animsCount; i++)
-                        {
-                            strcat(animNameOptions, ";");
-                            strcat(animNameOptions, animName[i]);
-                        }
-                    }
-                    else
-                    {
-                        for (unsigned i = 0; i < animsCount; i++)
-                        {
-                            char* name = strdup(modelAnimation[i].name); // Duplicate the string
-                            vector_add(&animNameSlice, name); // Add the duplicated name to the vector
-                            
-                            TraceLog(LOG_INFO, "Animation %d: %s", i, name);
-                        }
-
-                        // Calculate the size of the new string
-                        size_t totalLength = 0;
-                        for (unsigned i = 0; i < animsCount; i++)
-                        {
-                            totalLength += strlen(animNameSlice[i]);
-                        }
-                        totalLength += animsCount - 1; // For the semicolons
-                        totalLength += 1; // For the null terminator
-
-                        // Allocate memory for the new concatenated string
-                        animNameOptions = (char*)MemAlloc(totalLength*sizeof(char));
-                        
-                        assert(animNameOptions != NULL);
-
-                        strcpy(animNameOptions, animNameSlice[0]); // Copy the first name
-
-                        // Concatenate the rest of the names
-                        for (unsigned i = 1; i < animsCount; i++)
-                        {
-                            strcat(animNameOptions, ";");
-                            strcat(animNameOptions, animNameSlice[i]);
-                        }
-                    }
-                }
+                fileToLoad = fileNameToLoad;
             }
             else
             {
@@ -1031,108 +818,242 @@ int main()
 
         if (loadFromKey)
         {
+            fileToLoad = "./robot.glb";
+            loadFromKey = false;
+        }
+
+        if (fileToLoad != NULL)
+        {
+            // Reloading keeps the node and clip with the same names selected
+            char selectedNodeName[128] = "";
+            char selectedClipName[128] = "";
+
             if (model != NULL)
             {
+                const double unloadStart = GetTime();
+
+                if (selectedNode > SCENE_ROOT) snprintf(selectedNodeName, sizeof(selectedNodeName), "%s", sceneGraph.names[selectedNode]);
+                if (animIndex < (unsigned)NameArrayCount(&animName)) snprintf(selectedClipName, sizeof(selectedClipName), "%s", *NameArrayAt(&animName, animIndex));
+
                 if (animsCount > 0)
                 {
                     UnloadModelAnimations(modelAnimation, animsCount);
-                    MemFree(animNameOptions);
-                    vector_free(animName);
                 }
-                
+
+                NameArrayFree(&animName);
+
+                UnloadSearchIndex(clipSearch);
+                clipSearch = (SearchIndex){ 0 };
+
+                UnloadQuantModel(quantModel);
+                quantModel = (QuantModel){ 0 };
+
+                UnloadInstanceScene(instanceScene);
+                instanceScene = (InstanceScene){ 0 };
+
+                UnloadEdgeModel(edgeModel);
+                edgeModel = (EdgeModel){ 0 };
+
+                UnloadOcclusionCuller(occlusionCuller);
+                occlusionCuller = (OcclusionCuller){ 0 };
+
                 UnloadModel(*model);
                 MemFree(model);
 
+                // Scene graph, instance batches and clip names go in one call
+                UnloadArena(modelArena);
+                modelArena = (Arena){ 0 };
+                sceneGraph = (SceneGraph){ 0 };
+                modelNames = (NameTable){ 0 };
+                nodeNameIndex = boneNameIndex = clipNameIndex = (NameIndex){ 0 };
+
+                SubtractMemorySizes(modelMemory);
+                modelMemory = (MemorySizes){ 0 };
+                modelLeaks = CheckModelMemory(modelMemoryBase);
+
                 currentFrame = 0.0f;
                 animNameOptions = " ";
                 animNameActiveOption = 0; 
                 animsCount = 0;
+
+                modelUnloadTime = GetTime() - unloadStart;
             }
 
-            animName = (char**)vector_create();
+            const double loadStart = GetTime();
+            modelMemoryBase = GetMemoryUsage();
+
+            BeginLoadReport(&loadReport, fileToLoad);
+
+            modelArena = InitArena(ARENA_DEFAULT_BLOCK_SIZE);
+            modelNames = InitNameTable(&modelArena, 0);
+
+            animName = NameArrayInit(GetArenaAllocator(&modelArena));
             model = (Model*)MemAlloc(sizeof(Model));
-            *model = LoadModel("./robot.glb");
-            modelAnimation = LoadModelAnimations("./robot.glb", &animsCount);
 
-            if (vector_size(animName) < 8)
+            // Parsing, buffer and image decoding and the GPU upload all happen in raylib
+            TraceBegin("load model");
+            *model = LoadModel(fileToLoad);
+            TraceEnd();
+
+            // Time after the last mesh upload is the rest of the upload and the default materials
+            MarkLoadStage(&loadReport, LOAD_STAGE_GPU_UPLOAD);
+
+            const MemorySizes loadedMemory = MeasureModelMemory(*model, NULL, 0);
+            loadReport.bytes[LOAD_STAGE_IMAGES] = loadedMemory.bytes[MEMORY_TEXTURES_GPU];
+            loadReport.bytes[LOAD_STAGE_MESHES] = loadedMemory.bytes[MEMORY_VERTICES] + loadedMemory.bytes[MEMORY_INDICES];
+            loadReport.bytes[LOAD_STAGE_GPU_UPLOAD] = loadReport.bytes[LOAD_STAGE_MESHES];
+
+            if (isCompactVertices)
             {
-                for (unsigned i = 0; i < animsCount; i++)
-                {
-                    char* name = strdup(modelAnimation[i].name); // Duplicate the string
-                    vector_add(&animName, name); // Add the duplicated name to the vector
-                    
-                    TraceLog(LOG_INFO, "Animation %d: %s", i, name);
-                }
+                TraceBegin("quantize vertices");
+                quantModel = QuantizeModel(model);
+                TraceEnd();
+            }
 
-                // Calculate the size of the new string
-                size_t totalLength = 0;
-                for (unsigned i = 0; i < animsCount; i++)
-                {
-                    totalLength += strlen(animName[i]);
-                }
-                totalLength += animsCount - 1; // For the semicolons
-                totalLength += 1; // For the null terminator
+            TraceBegin("load scene graph");
+            sceneGraph = LoadSceneGraph(fileToLoad, &modelArena, &modelNames);
+            nodeNameIndex = BuildNameIndex(&modelNames, &modelArena, sceneGraph.nameIds, sceneGraph.nodeCount);
+            boneNameIndex = LoadBoneNames(&modelNames, *model);
+            TraceEnd();
 
-                // Allocate memory for the new concatenated string
-                animNameOptions = (char*)MemAlloc(totalLength*sizeof(char));
-                
-                assert(animNameOptions != NULL);
+            const int namedNode = FindNameIndex(&modelNames, nodeNameIndex, selectedNodeName);
+            selectedNode = (namedNode > SCENE_ROOT) ? namedNode : ((sceneGraph.nodeCount > 1) ? 1 : SCENE_ROOT);
+            inspectedNode = -1;
+            selectedBone = NAME_NONE;
 
-                strcpy(animNameOptions, animName[0]); // Copy the first name
+            TraceBegin("load instances");
+            instanceScene = LoadInstanceScene(fileToLoad, *model, &modelArena);
+            TraceEnd();
 
-                // Concatenate the rest of the names
-                for (unsigned i = 1; i < animsCount; i++)
-                {
-                    strcat(animNameOptions, ";");
-                    strcat(animNameOptions, animName[i]);
-                }
-            }
-            else
-            {
-                for (unsigned i = 0; i < animsCount; i++)
-                {
-                    char* name = strdup(modelAnimation[i].name); // Duplicate the string
-                    vector_add(&animNameSlice, name); // Add the duplicated name to the vector
-                    
-                    TraceLog(LOG_INFO, "Animation %d: %s", i, name);
-                }
+            TraceBegin("load edges");
+            edgeModel = LoadEdgeModel(*model, quantModel);
+            TraceEnd();
 
-                // Calculate the size of the new string
-                size_t totalLength = 0;
-                for (unsigned i = 0; i < animsCount; i++)
-                {
-                    totalLength += strlen(animNameSlice[i]);
-                }
-                totalLength += animsCount - 1; // For the semicolons
-                totalLength += 1; // For the null terminator
+            TraceBegin("load occluders");
+            occlusionCuller = LoadOcclusionCuller(*model, quantModel, &instanceScene);
+            TraceEnd();
 
-                // Allocate memory for the new concatenated string
-                animNameOptions = (char*)MemAlloc(totalLength*sizeof(char));
-                
-                assert(animNameOptions != NULL);
+            redrawFrames = 2;
 
-                strcpy(animNameOptions, animNameSlice[0]); // Copy the first name
+            MarkLoadStage(&loadReport, LOAD_STAGE_VIEWER);
 
-                // Concatenate the rest of the names
-                for (unsigned i = 1; i < animsCount; i++)
-                {
-                    strcat(animNameOptions, ";");
-                    strcat(animNameOptions, animNameSlice[i]);
-                }
+            TraceBegin("load animations");
+            modelAnimation = LoadModelAnimations(fileToLoad, &animsCount);
+            TraceEnd();
+
+            MarkLoadStage(&loadReport, LOAD_STAGE_ANIMATIONS);
+            loadReport.bytes[LOAD_STAGE_ANIMATIONS] = MeasureModelMemory((Model){ 0 }, modelAnimation, animsCount).bytes[MEMORY_ANIMATION];
+
+            if (animsCount > 0)
+            {
+                TraceBegin("clip names");
+                animNameOptions = LoadAnimationNames(&modelNames, modelAnimation, animsCount, &animName, &clipNameIndex);
+                clipSearch = LoadSearchIndex(NameArrayData(&animName), animsCount);
+                TraceEnd();
             }
 
-            loadFromKey = false;
+            SetListViewCount(&animList, animsCount);
+            animList.scroll = 0.0f;
+
+            clipQuery[0] = '\0';
+
+            const int namedClip = FindNameIndex(&modelNames, clipNameIndex, selectedClipName);
+            animIndex = (namedClip != NAME_NONE) ? namedClip : 0;
+            animNameActiveOption = (int)animIndex;
+
+            MarkLoadStage(&loadReport, LOAD_STAGE_VIEWER);
+            EndLoadReport(&loadReport);
+
+            modelLoadTime = GetTime() - loadStart;
+
+            // Read after the report ended, the header and JSON reads are not part of the load
+            GlbStats glbStats = { 0 };
+            if (ReadGlbStats(fileToLoad, &glbStats)) snprintf(loadReport.generator, sizeof(loadReport.generator), "%s", glbStats.generator);
+
+            AppendLoadReport(&loadReport, LOAD_REPORT_FILE);
+            isLoadReportPanel = true;
+
+            // Names are interned in the arena, they move from the scene to their own category
+            const long long nameBytes = (long long)(modelNames.stringBytes + modelNames.capacity*(sizeof(char*) + sizeof(unsigned int)) + modelNames.slotCount*sizeof(int));
+
+            modelMemory = MeasureModelMemory(*model, modelAnimation, animsCount);
+            modelMemory.bytes[MEMORY_NAMES] += nameBytes;
+            modelMemory.bytes[MEMORY_SCENE] -= nameBytes;
+            AddMemorySizes(modelMemory);
+
+            TraceLog(
+                LOG_INFO, 
+                "ARENA: [%s] %d allocations, %.1f KB in %d blocks (%.1f KB reserved), load: %.2f ms", 
+                fileToLoad, 
+                modelArena.allocationCount, 
+                modelArena.allocatedBytes/1024.0f, 
+                modelArena.blockCount, 
+                modelArena.reservedBytes/1024.0f, 
+                modelLoadTime*1000.0
+            );
+
+            TraceLog(
+                LOG_INFO, 
+                "NAMES: [%s] %d names, %d distinct (%d nodes, %d bones with a name lookup), %.1f KB, %.1f KB shared", 
+                fileToLoad, 
+                modelNames.internCount, 
+                modelNames.count, 
+                sceneGraph.nodeCount, 
+                model->boneCount, 
+                modelNames.stringBytes/1024.0f, 
+                modelNames.sharedBytes/1024.0f
+            );
         }
 
+        EndProfilerPhase(&profiler);
+
         //----------------------------------------------------------------
                             /* Model */
         //----------------------------------------------------------------
 
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_SCENE);
+
         // 0 = 1.0f, 1 = 2.0f, 2 = 3.0f
         maxScl = (float)maxSclActiveOption + 1.0f;
 
+        // Only the edited nodes and the root are recomputed, unchanged frames cost a comparison
+        if (model != NULL)
+        {
+            SetSceneRootTransform(&sceneGraph, modelPos, modelRot, modelScl);
+            UpdateSceneGraph(&sceneGraph);
+
+            instanceUpdates = UpdateInstanceTransforms(&instanceScene, &sceneGraph);
+            if (instanceUpdates > 0) SetOcclusionItemTransforms(&occlusionCuller, &instanceScene);
+        }
+
+        const Matrix modelTransform = (model != NULL) ? sceneGraph.worlds[SCENE_ROOT] : MatrixIdentity();
+
+        // Hand this frame's view to the occlusion worker, keep drawing until its result catches up
+        bool isOcclusionActive = (model != NULL) && isOcclusionCulling && !isDrawWires;
+
+        if (isOcclusionActive)
+        {
+            float aspect = (float)GetScreenWidth()/(float)GetScreenHeight();
+
+            if (UpdateOcclusionCuller(&occlusionCuller, camera, aspect, modelTransform) && (redrawFrames == 0))
+            {
+                redrawFrames = 1;
+            }
+        }
+
+        // The listing, thumbnails and stats finish on worker threads, keep drawing until they are in
+        if (fileDialogState.windowActive && (fileDialogState.dirScan.isScanning || IsThumbnailSetBusy(fileDialogState.thumbnails) || IsGlbIndexBusy(fileDialogState.glbIndex)) && (redrawFrames == 0))
+        {
+            redrawFrames = 1;
+        }
+
+        EndProfilerPhase(&profiler);
+
         /* Draw functions */
 
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_DRAW_3D);
+
+        ResetFrameArena(&frameArena);
         BeginDrawing();
 
         BeginMode3D(camera);
@@ -1141,6 +1062,12 @@ int main()
 
         float gizmoSize = gizmoRad*10.0f - 1.0f;
         DrawGizmo(&modelPos, &gizmoX, &gizmoY, &gizmoZ, gizmoSize, gizmoXYZColors, isGizmoMod);
+
+        // The gizmo moves the model while drawing, the root catches up next frame
+        if (isGizmoMod && (redrawFrames == 0))
+        {
+            redrawFrames = 1;
+        }
         
         if (model != NULL)
         {
@@ -1148,36 +1075,146 @@ int main()
             {
                 if (isAnimDrawMainWires)
                 {
-                    DrawModelWiresPro(*model, modelPos, modelRot, modelScl);
+                    TraceBegin("draw wires");
+                    DrawModelWiresPro(
+                        *model, 
+                        quantModel, 
+                        &instanceScene, 
+                        isInstancing, 
+                        isUniqueEdges ? &edgeModel : NULL, 
+                        creaseAngle, 
+                        modelTransform
+                    );
+                    TraceEnd();
                 }
 
                 if (animsCount > 0)
                 {
+                    TraceBegin("draw bones");
                     DrawModelBones(
+                        &frameArena, 
                         *model, 
                         modelAnimation, 
                         animIndex, 
                         animCurrentFrame, 
-                        modelPos, 
+                        modelTransform, 
                         modelRot, 
                         modelScl,
                         isAnimDrawCircles,
                         isAnimDrawCubes, 
                         isDrawAnimTransform,
-                        animBoneColor
+                        animBoneColor,
+                        selectedBone
                     );
+                    TraceEnd();
                 }
             }
             else
             {
-                DrawModelPro(*model, modelPos, modelRot, modelScl);
+                TraceBegin("draw model");
+                DrawModelPro(
+                    *model, 
+                    quantModel, 
+                    &instanceScene, 
+                    isInstancing, 
+                    isOcclusionActive ? occlusionCuller.visible : NULL, 
+                    modelTransform
+                );
+                TraceEnd();
+
+                TraceCounter("draw calls", instanceScene.drawCalls);
             }
         }
 
         EndMode3D();
 
+        EndProfilerPhase(&profiler);
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_GUI);
+
         DrawFPS(0, 0);
 
+        if (quantModel.compactBytes > 0)
+        {
+            DrawText(FrameTextFormat(&frameArena, "Vertex memory: %.1f KB (float %.1f KB)", quantModel.compactBytes/1024.0f, quantModel.floatBytes/1024.0f), 20, 60, 10, GRAY);
+        }
+
+        if (model != NULL)
+        {
+            DrawText(FrameTextFormat(&frameArena, "Draw calls: %d, instances: %d, frame: %.2f ms", instanceScene.drawCalls, instanceScene.instanceCount, GetFrameTime()*1000.0f), 20, 72, 10, GRAY);
+        }
+
+        if (model != NULL)
+        {
+            DrawText(
+                FrameTextFormat(
+                    &frameArena, 
+                    "Model arena: %d allocations, %.1f/%.1f KB in %d blocks, load: %.1f ms, unload: %.2f ms", 
+                    modelArena.allocationCount, 
+                    modelArena.allocatedBytes/1024.0f, 
+                    modelArena.reservedBytes/1024.0f, 
+                    modelArena.blockCount, 
+                    modelLoadTime*1000.0, 
+                    modelUnloadTime*1000.0
+                ), 
+                20, 
+                screenHeight - 36, 
+                10, 
+                GRAY
+            );
+        }
+
+        if (isDrawWires && isUniqueEdges && (edgeModel.edgeCount > 0))
+        {
+            DrawText(FrameTextFormat(&frameArena, "Edges: %d/%d (triangle edges %d), build: %.2f ms", edgeModel.drawnEdges, edgeModel.edgeCount, edgeModel.triangleEdgeCount, edgeModel.buildTime*1000.0), 20, 96, 10, GRAY);
+        }
+
+        if (isOcclusionActive)
+        {
+            OcclusionStats stats = occlusionCuller.stats;
+
+            DrawText(
+                FrameTextFormat(
+                    &frameArena, 
+                    "Occlusion: %d/%d rejected (%d outside), %d occluders, raster: %.2f ms, test: %.2f ms (%s)", 
+                    stats.occludedCount + stats.outsideCount, 
+                    occlusionCuller.itemCount, 
+                    stats.outsideCount, 
+                    occlusionCuller.occluderCount, 
+                    stats.rasterTime*1000.0, 
+                    stats.testTime*1000.0, 
+                    stats.simd
+                ), 
+                20, 
+                96, 
+                10, 
+                GRAY
+            );
+        }
+
+        DrawText(
+            FrameTextFormat(
+                &frameArena, 
+                "Frame arena: %.1f KB, peak: %.1f KB of %.1f KB, heap fallbacks: %d", 
+                frameArena.lastFrameBytes/1024.0f, 
+                frameArena.highWaterBytes/1024.0f, 
+                frameArena.capacities[frameArena.current]/1024.0f, 
+                frameArena.overflowCount
+            ), 
+            20, 
+            screenHeight - 24, 
+            10, 
+            GRAY
+        );
+
+        if (idleStats.cpuUsage >= 0.0f)
+        {
+            DrawText(FrameTextFormat(&frameArena, "CPU: %.1f%%, wakeups: %.0f/s", idleStats.cpuUsage, idleStats.wakeupsPerSecond), 20, 84, 10, GRAY);
+        }
+        else
+        {
+            DrawText(FrameTextFormat(&frameArena, "Wakeups: %.0f/s", idleStats.wakeupsPerSecond), 20, 84, 10, GRAY);
+        }
+
         /* Transform */
 
         const int uiTranformsLeft = screenWidth - 200;
@@ -1187,7 +1224,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 50 + 20*0, 100, 15 }, 
             "PosX", 
-            TextFormat("%3.2f", modelPos.x), 
+            FrameTextFormat(&frameArena, "%3.2f", modelPos.x), 
             &modelPos.x, 
             -50.0f, 
             50.0f
@@ -1195,7 +1232,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 50 + 20*1, 100, 15 }, 
             "PosY", 
-            TextFormat("%3.2f", modelPos.y), 
+            FrameTextFormat(&frameArena, "%3.2f", modelPos.y), 
             &modelPos.y, 
             -50.0f, 
             50.0f
@@ -1203,7 +1240,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 50 + 20*2, 100, 15 }, 
             "PosZ", 
-            TextFormat("%3.2f", modelPos.z), 
+            FrameTextFormat(&frameArena, "%3.2f", modelPos.z), 
             &modelPos.z, 
             -50.0f, 
             50.0f
@@ -1213,7 +1250,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 70 + 20*3, 100, 15 }, 
             "RotX", 
-            TextFormat("%3.2f", modelRot.x), 
+            FrameTextFormat(&frameArena, "%3.2f", modelRot.x), 
             &modelRot.x, 
             -360.0f, 
             360.0f
@@ -1221,7 +1258,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 70 + 20*4, 100, 15 }, 
             "RotY", 
-            TextFormat("%3.2f", modelRot.y), 
+            FrameTextFormat(&frameArena, "%3.2f", modelRot.y), 
             &modelRot.y, 
             -360.0f, 
             360.0f
@@ -1229,7 +1266,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 70 + 20*5, 100, 15 }, 
             "RotZ", 
-            TextFormat("%3.2f", modelRot.z), 
+            FrameTextFormat(&frameArena, "%3.2f", modelRot.z), 
             &modelRot.z, 
             -360.0f, 
             360.0f
@@ -1239,7 +1276,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 90 + 20*6, 100, 15 }, 
             "SclX", 
-            TextFormat("%3.2f", modelScl.x), 
+            FrameTextFormat(&frameArena, "%3.2f", modelScl.x), 
             &modelScl.x, 
             0.01f, 
             maxScl
@@ -1247,7 +1284,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 90 + 20*7, 100, 15 }, 
             "SclY", 
-            TextFormat("%3.2f", modelScl.y), 
+            FrameTextFormat(&frameArena, "%3.2f", modelScl.y), 
             &modelScl.y, 
             0.01f, 
             maxScl
@@ -1255,7 +1292,7 @@ int main()
         GuiSliderBar(
             (Rectangle){ uiTranformsLeft + 40, 90 + 20*8, 100, 15 }, 
             "SclZ", 
-            TextFormat("%3.2f", modelScl.z), 
+            FrameTextFormat(&frameArena, "%3.2f", modelScl.z), 
             &modelScl.z, 
             0.01f, 
             maxScl
@@ -1276,7 +1313,7 @@ int main()
         /* Settings */
 
         const int uiSettingsLeft = screenWidth - 200;
-        GuiGroupBox((Rectangle){ uiSettingsLeft, 350, 180, 220 }, "Settings");
+        GuiGroupBox((Rectangle){ uiSettingsLeft, 350, 180, 295 }, "Settings");
 
         GuiDrawText("Max Scale:", (Rectangle){ uiSettingsLeft + 10, 360, 100, 20 }, 0, GRAY);
 
@@ -1363,7 +1400,7 @@ int main()
         {
             GuiDrawText("Current Animation:", (Rectangle){ uiSettingsLeft + 10, 410 + 50, 100, 20 }, 0, GRAY);
 
-            if (vector_size(animName) < 8)
+            if (NameArrayCount(&animName) < 8)
             {
                 // Draw the dropdown box
                 GuiDropdownBox(
@@ -1410,30 +1447,39 @@ int main()
                 // Check if dropdown box is in edit mode (expanded)
                 if (animNameDropdownEditMode)
                 {
-                    bool editMode = GuiDropdownPro(
+                    // The header becomes a search box while the list is open
+                    GuiTextBox((Rectangle){ uiSettingsLeft + 40, 480, 100, 20 }, clipQuery, SEARCH_MAX_QUERY, true);
+
+                    // New results scroll back to the top and focus the best match for enter
+                    if (UpdateSearch(&clipSearch, clipQuery))
+                    {
+                        SetListViewCount(&animList, (clipSearch.results != NULL) ? clipSearch.resultCount : animsCount);
+                        animList.scroll = 0.0f;
+                        animList.focused = (animList.count > 0) ? 0 : -1;
+                    }
+
+                    const ClipListRows clipRows = { NameArrayData(&animName), clipSearch.results, (int)animIndex };
+
+                    bool editMode = GuiClipList(
                         (Rectangle){ uiSettingsLeft + 40, 480, 100, 20 }, 
-                        animName, 
-                        &animDropdownStart, 
-                        &animDropdownEnd, 
-                        &animDropdownIsDragging,
-                        &animIndex,
-                        &animScrollbarColor 
+                        &animList, 
+                        &clipRows, 
+                        &animIndex
+                    );
+
+                    GuiDrawText(
+                        FrameTextFormat(&frameArena, "%d/%d clips, %.2f ms", animList.count, animsCount, clipSearch.updateTime*1000.0), 
+                        (Rectangle){ uiSettingsLeft + 40, 480 + 20*6, 150, 20 }, 
+                        0, 
+                        GRAY
                     );
 
                     // If mouse is pressed and not in drag mode, set edit mode to false
                     if (!editMode)
                     {
-                        animNameOptions = animName[animIndex];
+                        animNameOptions = *NameArrayAt(&animName, animIndex);
                         animNameDropdownEditMode = false;
                     }
-
-                    // Draw the static dropdown box
-                    GuiDropdownBox(
-                        (Rectangle){ uiSettingsLeft + 40, 480, 100, 20 }, 
-                        animNameOptions, 
-                        &animNameActiveOption, 
-                        false
-                    );
                 }
                 else
                 {
@@ -1463,6 +1509,184 @@ int main()
                 "Draw Wires",
                 &isDrawWires
             );
+
+            GuiCheckBox(
+                (Rectangle){ uiSettingsLeft + 10, 545, 15, 15 }, 
+                "Compact Vertices",
+                &isCompactVertices
+            );
+
+            GuiCheckBox(
+                (Rectangle){ uiSettingsLeft + 10, 570, 15, 15 }, 
+                "Hardware Instancing",
+                &isInstancing
+            );
+
+            GuiCheckBox(
+                (Rectangle){ uiSettingsLeft + 10, 595, 15, 15 }, 
+                "On-Demand Rendering",
+                &isOnDemandRendering
+            );
+
+            GuiCheckBox(
+                (Rectangle){ uiSettingsLeft + 10, 620, 15, 15 }, 
+                "Occlusion Culling",
+                &isOcclusionCulling
+            );
+        }
+
+        /* Node inspector */
+
+        //----------------------------------------------------------------
+        if ((model != NULL) && (sceneGraph.nodeCount > 1))
+        {
+            const int nodeInspectorLeft = 20;
+            GuiGroupBox((Rectangle){ nodeInspectorLeft, 290, 200, 300 }, "Node");
+
+            if (GuiButton((Rectangle){ nodeInspectorLeft + 5, 300, 20, 20 }, "<"))
+            {
+                selectedNode = (selectedNode > 1) ? selectedNode - 1 : sceneGraph.nodeCount - 1;
+            }
+
+            if (GuiButton((Rectangle){ nodeInspectorLeft + 175, 300, 20, 20 }, ">"))
+            {
+                selectedNode = (selectedNode < sceneGraph.nodeCount - 1) ? selectedNode + 1 : 1;
+            }
+
+            if ((selectedNode <= SCENE_ROOT) || (selectedNode >= sceneGraph.nodeCount)) selectedNode = 1;
+
+            GuiDrawText(sceneGraph.names[selectedNode], (Rectangle){ nodeInspectorLeft + 30, 300, 140, 20 }, TEXT_ALIGN_CENTER, GRAY);
+            GuiDrawText(
+                (selectedBone != NAME_NONE) ? 
+                    FrameTextFormat(&frameArena, "Parent: %s, children: %d, bone: %d", sceneGraph.names[sceneGraph.parents[selectedNode]], sceneGraph.subtreeEnds[selectedNode] - selectedNode - 1, selectedBone) : 
+                    FrameTextFormat(&frameArena, "Parent: %s, children: %d", sceneGraph.names[sceneGraph.parents[selectedNode]], sceneGraph.subtreeEnds[selectedNode] - selectedNode - 1), 
+                (Rectangle){ nodeInspectorLeft + 5, 322, 190, 20 }, 
+                0, 
+                GRAY
+            );
+
+            // A new selection starts from its current rotation
+            if (inspectedNode != selectedNode)
+            {
+                inspectedNode = selectedNode;
+                selectedBone = FindNameIndex(&modelNames, boneNameIndex, sceneGraph.names[selectedNode]);
+                nodeRotationBase = sceneGraph.rotations[selectedNode];
+                nodeRotationOffset = Vector3Zero();
+            }
+
+            Vector3 nodeTranslation = sceneGraph.translations[selectedNode];
+            Vector3 nodeScale = sceneGraph.scales[selectedNode];
+            const Vector3 restTranslation = sceneGraph.restTranslations[selectedNode];
+
+            //----------------------------------------------------------------
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 345 + 20*0, 100, 15 }, 
+                "PosX", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeTranslation.x), 
+                &nodeTranslation.x, 
+                restTranslation.x - 5.0f, 
+                restTranslation.x + 5.0f
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 345 + 20*1, 100, 15 }, 
+                "PosY", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeTranslation.y), 
+                &nodeTranslation.y, 
+                restTranslation.y - 5.0f, 
+                restTranslation.y + 5.0f
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 345 + 20*2, 100, 15 }, 
+                "PosZ", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeTranslation.z), 
+                &nodeTranslation.z, 
+                restTranslation.z - 5.0f, 
+                restTranslation.z + 5.0f
+            );
+
+            //----------------------------------------------------------------
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 365 + 20*3, 100, 15 }, 
+                "RotX", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeRotationOffset.x), 
+                &nodeRotationOffset.x, 
+                -180.0f, 
+                180.0f
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 365 + 20*4, 100, 15 }, 
+                "RotY", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeRotationOffset.y), 
+                &nodeRotationOffset.y, 
+                -180.0f, 
+                180.0f
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 365 + 20*5, 100, 15 }, 
+                "RotZ", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeRotationOffset.z), 
+                &nodeRotationOffset.z, 
+                -180.0f, 
+                180.0f
+            );
+
+            //----------------------------------------------------------------
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 385 + 20*6, 100, 15 }, 
+                "SclX", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeScale.x), 
+                &nodeScale.x, 
+                0.01f, 
+                maxScl
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 385 + 20*7, 100, 15 }, 
+                "SclY", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeScale.y), 
+                &nodeScale.y, 
+                0.01f, 
+                maxScl
+            );
+            GuiSliderBar(
+                (Rectangle){ nodeInspectorLeft + 40, 385 + 20*8, 100, 15 }, 
+                "SclZ", 
+                FrameTextFormat(&frameArena, "%3.2f", nodeScale.z), 
+                &nodeScale.z, 
+                0.01f, 
+                maxScl
+            );
+
+            const Quaternion nodeRotation = (Vector3DotProduct(nodeRotationOffset, nodeRotationOffset) > 0.0f) ? 
+                QuaternionMultiply(nodeRotationBase, QuaternionFromEuler(Vector3Scale(nodeRotationOffset, DEG2RAD))) : 
+                nodeRotationBase;
+
+            // Applied next frame, the graph only marks the node when a value differs
+            SetSceneNodeTransform(&sceneGraph, selectedNode, nodeTranslation, nodeRotation, nodeScale);
+
+            if (GuiButton((Rectangle){ nodeInspectorLeft + 5, 545, 80, 20 }, "Reset Node"))
+            {
+                ResetSceneNode(&sceneGraph, selectedNode);
+                nodeRotationBase = sceneGraph.restRotations[selectedNode];
+                nodeRotationOffset = Vector3Zero();
+            }
+
+            if (sceneGraph.dirtyCount > 0)
+            {
+                redrawFrames = 1;
+            }
+
+            GuiDrawText(
+                FrameTextFormat(&frameArena, "Nodes: %d, recomputed: %d (locals %d)", sceneGraph.nodeCount - 1, sceneGraph.changedCount, sceneGraph.localCount), 
+                (Rectangle){ nodeInspectorLeft + 5, 567, 190, 10 }, 
+                0, 
+                GRAY
+            );
+            GuiDrawText(
+                FrameTextFormat(&frameArena, "Instances: %d, update: %.3f ms", instanceUpdates, sceneGraph.updateTime*1000.0), 
+                (Rectangle){ nodeInspectorLeft + 5, 578, 190, 10 }, 
+                0, 
+                GRAY
+            );
         }
 
         /* Bone view settings */
@@ -1471,7 +1695,7 @@ int main()
         if (isDrawWires)
         {
             const int bonesViewSettingsLeft = 20;
-            GuiGroupBox((Rectangle){ bonesViewSettingsLeft, 100, 120, 125 }, "Bone View Settings");
+            GuiGroupBox((Rectangle){ bonesViewSettingsLeft, 100, 120, 175 }, "Bone View Settings");
 
             GuiCheckBox(
                 (Rectangle){ bonesViewSettingsLeft + 4, 110, 15, 15 }, 
@@ -1502,6 +1726,21 @@ int main()
                 isAnimColorUpdate = !isAnimColorUpdate;
             }
 
+            GuiCheckBox(
+                (Rectangle){ bonesViewSettingsLeft + 4, 230, 15, 15 }, 
+                "Unique Edges",
+                &isUniqueEdges
+            );
+
+            GuiSliderBar(
+                (Rectangle){ bonesViewSettingsLeft + 40, 252, 50, 15 }, 
+                "Crease", 
+                FrameTextFormat(&frameArena, "%3.0f", creaseAngle), 
+                &creaseAngle, 
+                0.0f, 
+                180.0f
+            );
+
             if (isAnimColorUpdate)
             {
                 const int bonesColorUpdateLeft = 150;
@@ -1573,12 +1812,19 @@ int main()
             {
                 const ModelAnimation anim = modelAnimation[animIndex];
 
+                // Nested in the GUI phase, charged to the animation only
+                BeginProfilerPhase(&profiler, PROFILER_PHASE_ANIMATION);
+
                 if (isPlayAnimation)
                 {
                     if (anim.frameCount > 0)
                     {
                         animCurrentFrame = (animCurrentFrame + 1) % anim.frameCount;
+
+                        // CPU skinning of every animated mesh and its vertex buffer upload
+                        TraceBegin("skinning");
                         UpdateModelAnimation(*model, anim, animCurrentFrame);
+                        TraceEnd();
                     }
                     else
                     {
@@ -1590,8 +1836,13 @@ int main()
                 else
                 {
                     animCurrentFrame = (unsigned)currentFrame;
+
+                    TraceBegin("skinning");
                     UpdateModelAnimation(*model, anim, animCurrentFrame);
+                    TraceEnd();
                 }
+
+                EndProfilerPhase(&profiler);
                 
                 //----------------------------------------------------------------
                 if (!maxSclDropdownEditMode && !targetFPSDropdownEditMode && !animNameDropdownEditMode)
@@ -1599,7 +1850,7 @@ int main()
                     GuiSliderBar(
                         (Rectangle){ 50, screenHeight - 80, 900, 35 }, 
                         "Frame:", 
-                        TextFormat("%3.2f", currentFrame), 
+                        FrameTextFormat(&frameArena, "%3.2f", currentFrame), 
                         &currentFrame, 
                         0, 
                         anim.frameCount
@@ -1645,7 +1896,80 @@ int main()
             }
         }
 
+        //----------------------------------------------------------------
+        if (IsKeyPressed(KEY_F3))
+        {
+            isProfilerOverlay = !isProfilerOverlay;
+        }
+
+        // Shows the frames up to the last one, this frame is still being measured
+        if (isProfilerOverlay)
+        {
+            DrawFrameProfiler(&profiler, (Rectangle){ 180, 140, 690, 150 });
+        }
+
+        if (IsKeyPressed(KEY_F4))
+        {
+            if (IsTracing()) StopTracing(traceFileName);
+            else StartTracing();
+        }
+
+        if (IsTracing())
+        {
+            DrawText(FrameTextFormat(&frameArena, "Tracing, F4 writes %s", traceFileName), 170, 30, 10, RED);
+        }
+
+        if (IsKeyPressed(KEY_F5))
+        {
+            isMemoryPanel = !isMemoryPanel;
+        }
+
+        if (isMemoryPanel)
+        {
+            DrawMemoryPanel((model != NULL) ? &modelMemoryBase : NULL, &modelLeaks, (Rectangle){ 180, 300, 370, 160 });
+        }
+
+        if (IsKeyPressed(KEY_F6))
+        {
+            isLoadReportPanel = !isLoadReportPanel;
+        }
+
+        if (isLoadReportPanel && (loadReport.totalTime > 0.0))
+        {
+            DrawLoadReport(&loadReport, (Rectangle){ 570, 300, 390, 150 });
+        }
+
+        //----------------------------------------------------------------
+        // Keep polling while something changes on its own, otherwise wait for input in EndDrawing()
+        bool isAnimating = (model != NULL) && (animsCount > 0) && isPlayAnimation;
+        bool isContinuous = !isOnDemandRendering || isAnimating || (redrawFrames > 0);
+
+        if (isContinuous && isEventWaiting)
+        {
+            DisableEventWaiting();
+            isEventWaiting = false;
+        }
+        else if (!isContinuous && !isEventWaiting)
+        {
+            EnableEventWaiting();
+            isEventWaiting = true;
+        }
+
+        if (redrawFrames > 0)
+        {
+            redrawFrames--;
+        }
+
+        UpdateIdleStats(&idleStats);
+
+        EndProfilerPhase(&profiler);
+
+        BeginProfilerPhase(&profiler, PROFILER_PHASE_SWAP);
         EndDrawing();
+        EndProfilerPhase(&profiler);
+
+        // A frame that slept waiting for input says nothing about the frame cost
+        EndProfilerFrame(&profiler, isEventWaiting);
     }
 
     //----------------------------------------------------------------
@@ -1654,14 +1978,35 @@ int main()
         if (animsCount > 0)
         {
             UnloadModelAnimations(modelAnimation, animsCount);
-            MemFree(animNameOptions);
-            vector_free(animName);
         }
 
+        UnloadQuantModel(quantModel);
+        UnloadInstanceScene(instanceScene);
+        UnloadEdgeModel(edgeModel);
+        UnloadOcclusionCuller(occlusionCuller);
+
         UnloadModel(*model);
         MemFree(model);
+
+        UnloadArena(modelArena);
+
+        SubtractMemorySizes(modelMemory);
+        CheckModelMemory(modelMemoryBase);
     }
 
+    NameArrayFree(&animName);
+    UnloadSearchIndex(clipSearch);
+    UnloadListView(animList);
+    UnloadFrameArena(frameArena);
+    UnloadFrameProfiler(profiler);
+    UnloadGuiWindowFileDialog(&fileDialogState);
+
+    // Every worker is joined by now
+    if (IsTracing()) StopTracing(traceFileName);
+    UnloadTracing();
+
+    LogMemoryReport();
+
     CloseWindow();
 
     return 0;
@@ -30,29 +30,50 @@
 
 #include "raylib.h"
 #include "assert.h"
-#include "vec.h"
+#include "containers.h"
+#include "vmath.h"
+#include "quant.h"
+#include "scene.h"
+#include "search.h"
+#include "instancing.h"
+#include "edges.h"
+#include "occlusion.h"
+#include "profiler.h"
+#include "trace.h"
+#include "memtrack.h"
+#include "loadreport.h"
+#include "headless.h"
+#include "rlgl.h"
 
 #define RAYGUI_IMPLEMENTATION
 #include "raygui-4.0/src/raygui.h"
 
 #undef RAYGUI_IMPLEMENTATION // Avoid including raygui implementation again
+#define GUI_LIST_VIEW_IMPLEMENTATION
+#include "gui_list_view.h"
+
+#undef GUI_LIST_VIEW_IMPLEMENTATION
 #define GUI_WINDOW_FILE_DIALOG_IMPLEMENTATION
 #include "gui_window_file_dialog.h"
 
+#if !defined(_WIN32)
+#include <sys/resource.h>   // Required for: getrusage()
+#endif
+
 #define debug true
 
+#define LOAD_REPORT_FILE    "load_times.jsonl"     // One line appended per model load
+
 const int screenWidth = 1080;
 const int screenHeight = 720;
 
-typedef struct 
+// Rows of the clip list, order holds the clip of each row while a search filters it
+typedef struct
 {
-    Color idleColor;
-    Color hoverColor;
-    Color draggedColor;
-    Color currentThumbColor;
-    Color backgroundColor;
-    bool isDragging;
-} ScrollbarColor;
+    const char** names;
+    const int* order;           // NULL lists every clip
+    int activeClip;
+} ClipListRows;
 
 typedef struct
 {
@@ -61,5 +82,17 @@ typedef struct
     Color baseLineColor;
 } BoneColor;
 
+// Clip names for the dropdowns, interned in the model name table
+DEFINE_ARRAY(NameArray, const char*, 8)
+
+typedef struct
+{
+    double windowStart;         // Wall time the current one second window started
+    double cpuStart;            // Process CPU time at window start
+    int wakeups;                // Main loop iterations in the current window
+    float wakeupsPerSecond;     // Result of the last completed window
+    float cpuUsage;             // Percent of one core, negative when unavailable
+} IdleStats;
+
 #define CBLUE CLITERAL(Color){ 11, 174, 219, 255 }
 #define DBLUE CLITERAL(Color){ 20, 146, 181, 255 }
\ No newline at end of file
@@ -0,0 +1,304 @@
+/*******************************************************************************************
+*
+*   memtrack - Allocation accounting by category, with peaks and a leak check per model
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "memtrack.h"
+#include "rlgl.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #include <malloc.h>                 // Required for: _msize()
+    #define GetBlockSize(ptr) _msize(ptr)
+#elif defined(__APPLE__)
+    #include <malloc/malloc.h>          // Required for: malloc_size()
+    #define GetBlockSize(ptr) malloc_size(ptr)
+#else
+    #include <malloc.h>                 // Required for: malloc_usable_size()
+    #define GetBlockSize(ptr) malloc_usable_size(ptr)
+#endif
+
+#define MEMORY_MATERIAL_MAPS    12          // raylib MAX_MATERIAL_MAPS, maps of every material
+
+static const char* categoryNames[MEMORY_CATEGORY_COUNT] = { "other", "vertices", "indices", "textures cpu", "textures gpu", "animation", "names", "scene", "ui" };
+
+// Categories a model's load and unload must bring back to where they were
+static const bool isModelCategory[MEMORY_CATEGORY_COUNT] = { false, true, true, false, false, true, true, true, false };
+
+static long long categoryBytes[MEMORY_CATEGORY_COUNT] = { 0 };
+static long long categoryPeaks[MEMORY_CATEGORY_COUNT] = { 0 };
+static int categoryBlocks[MEMORY_CATEGORY_COUNT] = { 0 };
+static long long totalBytes = 0;
+static long long totalPeak = 0;
+
+//----------------------------------------------------------------
+
+static void RaisePeak(long long* peak, long long value)
+{
+    long long current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+
+    while ((value > current) && !__atomic_compare_exchange_n(peak, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) { }
+}
+
+static void CountBytes(MemoryCategory category, long long bytes, int blocks)
+{
+    const long long current = __atomic_add_fetch(&categoryBytes[category], bytes, __ATOMIC_RELAXED);
+    const long long total = __atomic_add_fetch(&totalBytes, bytes, __ATOMIC_RELAXED);
+
+    if (blocks != 0) __atomic_add_fetch(&categoryBlocks[category], blocks, __ATOMIC_RELAXED);
+
+    if (bytes > 0)
+    {
+        RaisePeak(&categoryPeaks[category], current);
+        RaisePeak(&totalPeak, total);
+    }
+}
+
+void* MemTrackAlloc(MemoryCategory category, size_t size)
+{
+    void* ptr = malloc(size);
+    if (ptr != NULL) CountBytes(category, (long long)GetBlockSize(ptr), 1);
+
+    return ptr;
+}
+
+void* MemTrackCalloc(MemoryCategory category, size_t count, size_t size)
+{
+    void* ptr = calloc(count, size);
+    if (ptr != NULL) CountBytes(category, (long long)GetBlockSize(ptr), 1);
+
+    return ptr;
+}
+
+void* MemTrackRealloc(MemoryCategory category, void* ptr, size_t size)
+{
+    const long long oldSize = (ptr != NULL) ? (long long)GetBlockSize(ptr) : 0;
+    void* result = realloc(ptr, size);
+
+    // A failed realloc() keeps the old block
+    if (result != NULL) CountBytes(category, (long long)GetBlockSize(result) - oldSize, (ptr == NULL) ? 1 : 0);
+    else if (size == 0) CountBytes(category, -oldSize, -1);
+
+    return result;
+}
+
+void MemTrackFree(MemoryCategory category, void* ptr)
+{
+    if (ptr == NULL) return;
+
+    CountBytes(category, -(long long)GetBlockSize(ptr), -1);
+    free(ptr);
+}
+
+//----------------------------------------------------------------
+
+void AddMemoryUsage(MemoryCategory category, long long bytes)
+{
+    CountBytes(category, bytes, 0);
+}
+
+void AddMemorySizes(MemorySizes sizes)
+{
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        if (sizes.bytes[i] != 0) CountBytes((MemoryCategory)i, sizes.bytes[i], 0);
+    }
+}
+
+void SubtractMemorySizes(MemorySizes sizes)
+{
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        if (sizes.bytes[i] != 0) CountBytes((MemoryCategory)i, -sizes.bytes[i], 0);
+    }
+}
+
+MemoryUsage GetMemoryUsage(void)
+{
+    MemoryUsage usage = { 0 };
+
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        usage.bytes[i] = __atomic_load_n(&categoryBytes[i], __ATOMIC_RELAXED);
+        usage.peakBytes[i] = __atomic_load_n(&categoryPeaks[i], __ATOMIC_RELAXED);
+        usage.blockCount[i] = __atomic_load_n(&categoryBlocks[i], __ATOMIC_RELAXED);
+    }
+
+    usage.totalBytes = __atomic_load_n(&totalBytes, __ATOMIC_RELAXED);
+    usage.peakTotalBytes = __atomic_load_n(&totalPeak, __ATOMIC_RELAXED);
+
+    return usage;
+}
+
+const char* GetMemoryCategoryName(MemoryCategory category)
+{
+    return ((category >= 0) && (category < MEMORY_CATEGORY_COUNT)) ? categoryNames[category] : "";
+}
+
+//----------------------------------------------------------------
+
+static long long GetTextureBytes(Texture2D texture)
+{
+    long long bytes = 0;
+
+    for (int level = 0; level < ((texture.mipmaps > 0) ? texture.mipmaps : 1); level++)
+    {
+        const int width = (texture.width >> level > 0) ? texture.width >> level : 1;
+        const int height = (texture.height >> level > 0) ? texture.height >> level : 1;
+        bytes += GetPixelDataSize(width, height, texture.format);
+    }
+
+    return bytes;
+}
+
+MemorySizes MeasureModelMemory(Model model, const ModelAnimation* animations, int animationCount)
+{
+    MemorySizes sizes = { 0 };
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        const Mesh* mesh = &model.meshes[i];
+        const long long n = mesh->vertexCount;
+
+        // Arrays another module freed, quantized copies say, are NULL and are not counted here
+        long long floats = 0;
+        if (mesh->vertices != NULL) floats += 3;
+        if (mesh->texcoords != NULL) floats += 2;
+        if (mesh->texcoords2 != NULL) floats += 2;
+        if (mesh->normals != NULL) floats += 3;
+        if (mesh->tangents != NULL) floats += 4;
+        if (mesh->animVertices != NULL) floats += 3;
+        if (mesh->animNormals != NULL) floats += 3;
+        if (mesh->boneWeights != NULL) floats += 4;
+
+        long long bytes = n*floats*(long long)sizeof(float);
+        if (mesh->colors != NULL) bytes += n*4;
+        if (mesh->boneIds != NULL) bytes += n*4;
+
+        sizes.bytes[MEMORY_VERTICES] += bytes;
+
+        if (mesh->indices != NULL) sizes.bytes[MEMORY_INDICES] += (long long)mesh->triangleCount*3*sizeof(unsigned short);
+    }
+
+    // Materials may share a texture, each id is counted once. The default texture belongs to raylib
+    const int mapCount = model.materialCount*MEMORY_MATERIAL_MAPS;
+    unsigned int* ids = (unsigned int*)malloc(((mapCount > 0) ? mapCount : 1)*sizeof(unsigned int));
+    int idCount = 0;
+
+    for (int i = 0; (i < model.materialCount) && (model.materials[i].maps != NULL); i++)
+    {
+        for (int map = 0; map < MEMORY_MATERIAL_MAPS; map++)
+        {
+            const Texture2D texture = model.materials[i].maps[map].texture;
+            if ((texture.id == 0) || (texture.id == rlGetTextureIdDefault())) continue;
+
+            bool isCounted = false;
+            for (int k = 0; (k < idCount) && !isCounted; k++) isCounted = (ids[k] == texture.id);
+            if (isCounted) continue;
+
+            ids[idCount++] = texture.id;
+            sizes.bytes[MEMORY_TEXTURES_GPU] += GetTextureBytes(texture);
+        }
+    }
+
+    free(ids);
+
+    sizes.bytes[MEMORY_ANIMATION] += (long long)model.boneCount*(sizeof(BoneInfo) + sizeof(Transform));
+
+    for (int i = 0; i < animationCount; i++)
+    {
+        const ModelAnimation* animation = &animations[i];
+
+        sizes.bytes[MEMORY_ANIMATION] += (long long)animation->boneCount*sizeof(BoneInfo);
+        sizes.bytes[MEMORY_ANIMATION] += (long long)animation->frameCount*(sizeof(Transform*) + animation->boneCount*sizeof(Transform));
+    }
+
+    return sizes;
+}
+
+MemorySizes FindMemoryLeaks(MemoryUsage before, MemoryUsage after)
+{
+    MemorySizes leaks = { 0 };
+
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        if (isModelCategory[i] && (after.bytes[i] > before.bytes[i])) leaks.bytes[i] = after.bytes[i] - before.bytes[i];
+    }
+
+    return leaks;
+}
+
+//----------------------------------------------------------------
+
+static const char* FormatBytes(long long bytes)
+{
+    if ((bytes >= 1024*1024) || (bytes <= -1024*1024)) return TextFormat("%.1f MB", bytes/(1024.0*1024.0));
+
+    return TextFormat("%.1f KB", bytes/1024.0);
+}
+
+void DrawMemoryPanel(const MemoryUsage* modelBase, const MemorySizes* leaks, Rectangle bounds)
+{
+    const MemoryUsage usage = GetMemoryUsage();
+
+    DrawRectangleRec(bounds, Fade(BLACK, 0.75f));
+
+    const int left = (int)bounds.x + 8;
+    const int top = (int)bounds.y + 4;
+    const char* headers[4] = { "current", "peak", "blocks", "model" };
+
+    DrawText("memory", left, top, 10, RAYWHITE);
+    for (int i = 0; i < 4; i++) DrawText(headers[i], left + 80 + 70*i, top, 10, RAYWHITE);
+
+    for (int i = 0; i <= MEMORY_CATEGORY_COUNT; i++)
+    {
+        const int y = top + 14 + i*12;
+        const bool isTotal = (i == MEMORY_CATEGORY_COUNT);
+        const bool isLeaking = !isTotal && (leaks != NULL) && (leaks->bytes[i] > 0);
+        const Color color = isLeaking ? RED : (isTotal ? YELLOW : LIGHTGRAY);
+
+        DrawText(isTotal ? "total" : categoryNames[i], left, y, 10, color);
+        DrawText(FormatBytes(isTotal ? usage.totalBytes : usage.bytes[i]), left + 80, y, 10, color);
+        DrawText(FormatBytes(isTotal ? usage.peakTotalBytes : usage.peakBytes[i]), left + 150, y, 10, color);
+        if (!isTotal) DrawText(TextFormat("%d", usage.blockCount[i]), left + 220, y, 10, color);
+        if (!isTotal && (modelBase != NULL) && isModelCategory[i]) DrawText(FormatBytes(usage.bytes[i] - modelBase->bytes[i]), left + 290, y, 10, color);
+    }
+
+    long long leakBytes = 0;
+    for (int i = 0; (leaks != NULL) && (i < MEMORY_CATEGORY_COUNT); i++) leakBytes += leaks->bytes[i];
+
+    const int y = top + 14 + (MEMORY_CATEGORY_COUNT + 1)*12 + 4;
+    if (leakBytes > 0) DrawText(TextFormat("Last unload left %s behind", FormatBytes(leakBytes)), left, y, 10, RED);
+    else DrawText("Last unload released everything", left, y, 10, LIGHTGRAY);
+}
+
+void LogMemoryReport(void)
+{
+    const MemoryUsage usage = GetMemoryUsage();
+
+    TraceLog(LOG_INFO, "MEMORY: Peak %.1f KB, %.1f KB still allocated", usage.peakTotalBytes/1024.0f, usage.totalBytes/1024.0f);
+
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++)
+    {
+        TraceLog(LOG_INFO, "MEMORY:     %-12s peak %10.1f KB, current %10.1f KB in %d blocks", categoryNames[i], usage.peakBytes[i]/1024.0f, usage.bytes[i]/1024.0f, usage.blockCount[i]);
+    }
+}
@@ -0,0 +1,118 @@
+/*******************************************************************************************
+*
+*   memtrack - Allocation accounting by category, with peaks and a leak check per model
+*
+*   Tracked allocations go through MemTrackAlloc()/MemTrackFree() with a category. No header is
+*   put in front of a block, the size comes from the C library (malloc_usable_size()), so a block
+*   allocated by raylib and freed here, or the other way round, only skews the counters.
+*
+*   A file routes its RL_MALLOC/RL_CALLOC/RL_REALLOC/RL_FREE by defining MEMORY_TRACK_CATEGORY
+*   before including this header. Memory raylib allocates for a model (meshes, textures, poses)
+*   is measured once loaded with MeasureModelMemory() and added with AddMemorySizes().
+*
+*   Counters are atomic, allocations from the worker threads are counted as they happen.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include "raylib.h"
+
+#include <stddef.h>
+
+typedef enum
+{
+    MEMORY_OTHER = 0,                       // Untagged, loader scratch buffers and tracing
+    MEMORY_VERTICES,
+    MEMORY_INDICES,                         // Triangle and edge indices
+    MEMORY_TEXTURES_CPU,                    // Decoded pixels waiting for upload
+    MEMORY_TEXTURES_GPU,                    // Estimate from size, format and mipmaps
+    MEMORY_ANIMATION,                       // Bones, bind pose and clip poses
+    MEMORY_NAMES,
+    MEMORY_SCENE,                           // Model arena, instance batches and occluders
+    MEMORY_UI,                              // File dialog, listings, thumbnails and overlays
+    MEMORY_CATEGORY_COUNT
+} MemoryCategory;
+
+typedef struct
+{
+    long long bytes[MEMORY_CATEGORY_COUNT];
+} MemorySizes;
+
+typedef struct
+{
+    long long bytes[MEMORY_CATEGORY_COUNT];
+    long long peakBytes[MEMORY_CATEGORY_COUNT];
+    int blockCount[MEMORY_CATEGORY_COUNT];  // Live tracked blocks, measured memory has none
+    long long totalBytes;
+    long long peakTotalBytes;
+} MemoryUsage;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* MemTrackAlloc(MemoryCategory category, size_t size);
+void* MemTrackCalloc(MemoryCategory category, size_t count, size_t size);
+void* MemTrackRealloc(MemoryCategory category, void* ptr, size_t size);
+void MemTrackFree(MemoryCategory category, void* ptr);
+
+// Memory allocated elsewhere, bytes is negative when it is released
+void AddMemoryUsage(MemoryCategory category, long long bytes);
+void AddMemorySizes(MemorySizes sizes);
+void SubtractMemorySizes(MemorySizes sizes);
+
+MemoryUsage GetMemoryUsage(void);
+const char* GetMemoryCategoryName(MemoryCategory category);
+
+// raylib-owned bytes of a loaded model: mesh arrays, texture estimates, bones and poses
+MemorySizes MeasureModelMemory(Model model, const ModelAnimation* animations, int animationCount);
+
+// Bytes the model categories hold over the usage before the model was loaded. UI, textures
+// and untagged memory change with the file dialog and are not checked
+MemorySizes FindMemoryLeaks(MemoryUsage before, MemoryUsage after);
+
+// Current and peak of every category. The model column is the growth of the model categories
+// since modelBase, the usage before the model was loaded. modelBase and leaks may be NULL
+void DrawMemoryPanel(const MemoryUsage* modelBase, const MemorySizes* leaks, Rectangle bounds);
+void LogMemoryReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMTRACK_H
+
+// Outside the include guard, a file may include the header before it picks a category
+#if defined(MEMORY_TRACK_CATEGORY) && !defined(MEMORY_TRACK_ROUTED)
+#define MEMORY_TRACK_ROUTED
+
+#undef RL_MALLOC
+#undef RL_CALLOC
+#undef RL_REALLOC
+#undef RL_FREE
+
+#define RL_MALLOC(size)             MemTrackAlloc(MEMORY_TRACK_CATEGORY, size)
+#define RL_CALLOC(count, size)      MemTrackCalloc(MEMORY_TRACK_CATEGORY, count, size)
+#define RL_REALLOC(ptr, size)       MemTrackRealloc(MEMORY_TRACK_CATEGORY, ptr, size)
+#define RL_FREE(ptr)                MemTrackFree(MEMORY_TRACK_CATEGORY, ptr)
+
+#endif
@@ -0,0 +1,198 @@
+/*******************************************************************************************
+*
+*   names - Interned name table with a hash index
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "names.h"
+
+#include <string.h>
+
+#define NAME_TABLE_MIN_CAPACITY     64
+
+//----------------------------------------------------------------
+
+// FNV-1a, names are short and mostly ASCII
+static unsigned int HashName(const char* name)
+{
+    unsigned int hash = 2166136261u;
+
+    for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// Slot holding the name, or the empty slot it would go in
+static int FindNameSlot(const NameTable* table, const char* name, unsigned int hash)
+{
+    const int mask = table->slotCount - 1;
+    int slot = (int)(hash & (unsigned int)mask);
+
+    while (table->slots[slot] != 0)
+    {
+        const int id = table->slots[slot] - 1;
+        if ((table->hashes[id] == hash) && (strcmp(table->strings[id], name) == 0)) break;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static bool GrowNameTable(NameTable* table)
+{
+    const int capacity = table->capacity*2;
+    const char** strings = (const char**)ArenaRealloc(table->arena, (void*)table->strings, table->capacity*sizeof(char*), capacity*sizeof(char*));
+    unsigned int* hashes = (unsigned int*)ArenaRealloc(table->arena, table->hashes, table->capacity*sizeof(unsigned int), capacity*sizeof(unsigned int));
+    int* slots = (int*)ArenaAlloc(table->arena, 2*capacity*sizeof(int));
+
+    if ((strings == NULL) || (hashes == NULL) || (slots == NULL)) return false;
+
+    table->strings = strings;
+    table->hashes = hashes;
+    table->capacity = capacity;
+
+    // The old slots stay in the arena, sizing the table at init avoids this
+    table->slots = slots;
+    table->slotCount = 2*capacity;
+
+    const int mask = table->slotCount - 1;
+
+    for (int id = 0; id < table->count; id++)
+    {
+        int slot = (int)(table->hashes[id] & (unsigned int)mask);
+        while (table->slots[slot] != 0) slot = (slot + 1) & mask;
+
+        table->slots[slot] = id + 1;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------
+
+NameTable InitNameTable(Arena* arena, int capacity)
+{
+    NameTable table = { 0 };
+
+    // Power of two so the slot count is one too
+    int size = NAME_TABLE_MIN_CAPACITY;
+    while (size < capacity) size *= 2;
+
+    table.arena = arena;
+    table.capacity = size;
+    table.strings = (const char**)ArenaAlloc(arena, size*sizeof(char*));
+    table.hashes = (unsigned int*)ArenaAlloc(arena, size*sizeof(unsigned int));
+    table.slotCount = 2*size;
+    table.slots = (int*)ArenaAlloc(arena, table.slotCount*sizeof(int));
+
+    if ((table.strings == NULL) || (table.hashes == NULL) || (table.slots == NULL))
+    {
+        TraceLog(LOG_WARNING, "NAMES: Failed to allocate a table of %d names", size);
+        table.capacity = 0;
+        table.slotCount = 0;
+    }
+
+    return table;
+}
+
+int InternName(NameTable* table, const char* name)
+{
+    if ((name == NULL) || (table->slotCount == 0)) return NAME_NONE;
+
+    const unsigned int hash = HashName(name);
+    int slot = FindNameSlot(table, name, hash);
+
+    table->internCount++;
+
+    if (table->slots[slot] != 0)
+    {
+        table->sharedBytes += strlen(name) + 1;
+        return table->slots[slot] - 1;
+    }
+
+    if (table->count == table->capacity)
+    {
+        if (!GrowNameTable(table))
+        {
+            TraceLog(LOG_WARNING, "NAMES: Failed to grow the table past %d names", table->count);
+            return NAME_NONE;
+        }
+
+        // Growing rehashed every name, the empty slot moved
+        slot = FindNameSlot(table, name, hash);
+    }
+
+    const char* string = ArenaStrdup(table->arena, name);
+    if (string == NULL) return NAME_NONE;
+
+    const int id = table->count++;
+
+    table->strings[id] = string;
+    table->hashes[id] = hash;
+    table->slots[slot] = id + 1;
+    table->stringBytes += strlen(name) + 1;
+
+    return id;
+}
+
+int FindName(const NameTable* table, const char* name)
+{
+    if ((name == NULL) || (table->slotCount == 0)) return NAME_NONE;
+
+    const int slot = FindNameSlot(table, name, HashName(name));
+
+    return table->slots[slot] - 1;
+}
+
+const char* GetNameString(const NameTable* table, int id)
+{
+    return ((id >= 0) && (id < table->count)) ? table->strings[id] : "";
+}
+
+NameIndex BuildNameIndex(const NameTable* table, Arena* arena, const int* itemNames, int itemCount)
+{
+    NameIndex index = { 0 };
+
+    index.items = (int*)ArenaAlloc(arena, ((table->count > 0) ? table->count : 1)*sizeof(int));
+    if (index.items == NULL) return index;
+
+    index.count = table->count;
+    for (int id = 0; id < index.count; id++) index.items[id] = NAME_NONE;
+
+    for (int i = itemCount - 1; i >= 0; i--)
+    {
+        const int id = itemNames[i];
+        if ((id >= 0) && (id < index.count)) index.items[id] = i;
+    }
+
+    return index;
+}
+
+int FindNameIndex(const NameTable* table, NameIndex index, const char* name)
+{
+    const int id = FindName(table, name);
+
+    return ((id >= 0) && (id < index.count)) ? index.items[id] : NAME_NONE;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   names - Interned name table with a hash index
+*
+*   Every distinct string is stored once and gets a dense integer id. Lookups hash the name
+*   once and probe an open addressing table, comparing strings only on a hash match. A
+*   NameIndex maps ids to items of one kind (nodes, bones, clips), so finding an item by name
+*   is one table lookup and one array read. Strings and arrays come from the arena the table
+*   was initialized with and are released with it.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef NAMES_H
+#define NAMES_H
+
+#include "raylib.h"
+#include "arena.h"
+
+#define NAME_NONE   -1
+
+typedef struct
+{
+    int count;                  // Distinct names, ids are 0..count-1
+    int capacity;
+    const char** strings;       // By id
+    unsigned int* hashes;       // By id
+
+    int* slots;                 // Id + 1 of the name hashed there, 0 when empty
+    int slotCount;              // Power of two, at most half full
+
+    Arena* arena;
+
+    int internCount;            // InternName() calls, repeated names included
+    size_t stringBytes;         // Bytes of the distinct strings
+    size_t sharedBytes;         // Bytes repeated names would have taken as copies
+} NameTable;
+
+typedef struct
+{
+    int* items;                 // Item of each id, NAME_NONE when no item has the name
+    int count;                  // Ids covered, later names are not indexed
+} NameIndex;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// capacity is the number of distinct names expected, the table grows past it
+NameTable InitNameTable(Arena* arena, int capacity);
+
+// Id of the name, added when new
+int InternName(NameTable* table, const char* name);
+
+// NAME_NONE when the name was never interned
+int FindName(const NameTable* table, const char* name);
+const char* GetNameString(const NameTable* table, int id);
+
+// itemNames holds the id of each item, the first item wins when a name repeats
+NameIndex BuildNameIndex(const NameTable* table, Arena* arena, const int* itemNames, int itemCount);
+
+// NAME_NONE when no item has the name
+int FindNameIndex(const NameTable* table, NameIndex index, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NAMES_H
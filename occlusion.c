@@ -0,0 +1,899 @@
+/*******************************************************************************************
+*
+*   occlusion - Software rasterized occlusion culling on a worker thread
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "occlusion.h"
+#include "vmath.h"
+#include "trace.h"
+#include "rlgl.h"               // Required for: RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR
+
+#define MEMORY_TRACK_CATEGORY MEMORY_SCENE
+#include "memtrack.h"
+
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define OCCLUSION_SSE
+    #include <immintrin.h>
+#endif
+
+#if defined(OCCLUSION_SSE) && (defined(__GNUC__) || defined(__clang__))
+    #define OCCLUSION_AVX       // Compiled with a target attribute, picked at runtime
+#endif
+
+#define OCCLUSION_SPAN_ALIGN    8
+
+typedef struct
+{
+    float x;
+    float y;
+    float z;
+    float w;
+} ClipVertex;
+
+typedef struct
+{
+    int item;
+    int meshIndex;
+} Occluder;
+
+typedef struct
+{
+    float score;
+    int item;
+} OccluderCandidate;
+
+typedef enum
+{
+    ITEM_VISIBLE = 0,
+    ITEM_OCCLUDED,
+    ITEM_OUTSIDE
+} ItemResult;
+
+// Rasterizes count pixels (multiple of 8) of one row, e holds the edge functions of the first pixel
+typedef void (*RasterSpanFunc)(float* row, int count, const float* e, const float* de, float z, float dz, float zMax);
+
+struct OcclusionWorker
+{
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    bool isRunning;
+    bool isJobPending;
+    bool isBusy;                // Job submitted and not finished, the back result belongs to the worker
+    bool isResultReady;
+
+    Matrix jobViewProjection;
+    Matrix jobTransform;
+    int jobItemsVersion;
+    Matrix resultViewProjection;
+    Matrix resultTransform;
+    int resultItemsVersion;
+
+    bool hasFront;
+    Matrix frontViewProjection;
+    Matrix frontTransform;
+    int frontItemsVersion;
+
+    // Item transforms set while a job runs, copied into items before the next job
+    Matrix* pendingTransforms;
+    int itemsVersion;
+    int appliedItemsVersion;
+
+    bool* backVisible;
+    OcclusionStats backStats;
+
+    float* depth;
+
+    OcclusionItem* items;       // Owned by the culler, written by the main thread only while the worker is idle
+    int itemCount;
+
+    Occluder occluders[OCCLUSION_MAX_OCCLUDERS];
+    int occluderCount;
+
+    int meshCount;
+    int* meshTriangleCounts;
+    Vector3** meshTriangles;    // Three mesh space vertices per triangle, occluder meshes only
+
+    RasterSpanFunc rasterSpan;
+    const char* simd;
+};
+
+//----------------------------------------------------------------
+
+static ClipVertex TransformClip(Matrix m, Vector3 v)
+{
+    return (ClipVertex)
+    {
+        m.m0*v.x + m.m4*v.y + m.m8*v.z  + m.m12,
+        m.m1*v.x + m.m5*v.y + m.m9*v.z  + m.m13,
+        m.m2*v.x + m.m6*v.y + m.m10*v.z + m.m14,
+        m.m3*v.x + m.m7*v.y + m.m11*v.z + m.m15
+    };
+}
+
+// Same projection BeginMode3D() sets up
+static Matrix GetCameraProjection(Camera camera, float aspect)
+{
+    const float nearPlane = (float)RL_CULL_DISTANCE_NEAR;
+    const float farPlane = (float)RL_CULL_DISTANCE_FAR;
+
+    Matrix result = { 0 };
+
+    if (camera.projection == CAMERA_PERSPECTIVE)
+    {
+        const float top = nearPlane*tanf(camera.fovy*0.5f*DEG2RAD);
+        const float right = top*aspect;
+
+        result.m0 = nearPlane/right;
+        result.m5 = nearPlane/top;
+        result.m10 = -(farPlane + nearPlane)/(farPlane - nearPlane);
+        result.m11 = -1.0f;
+        result.m14 = -2.0f*farPlane*nearPlane/(farPlane - nearPlane);
+    }
+    else
+    {
+        const float top = camera.fovy/2.0f;
+        const float right = top*aspect;
+
+        result.m0 = 1.0f/right;
+        result.m5 = 1.0f/top;
+        result.m10 = -2.0f/(farPlane - nearPlane);
+        result.m14 = -(farPlane + nearPlane)/(farPlane - nearPlane);
+        result.m15 = 1.0f;
+    }
+
+    return result;
+}
+
+static bool IsSameView(Matrix viewProjectionA, Matrix transformA, Matrix viewProjectionB, Matrix transformB)
+{
+    return (memcmp(&viewProjectionA, &viewProjectionB, sizeof(Matrix)) == 0) && (memcmp(&transformA, &transformB, sizeof(Matrix)) == 0);
+}
+
+static Vector3 GetOcclusionVertex(Mesh mesh, const QuantMesh* quant, int index)
+{
+    if (mesh.vertices != NULL) return (Vector3){ mesh.vertices[index*3], mesh.vertices[index*3 + 1], mesh.vertices[index*3 + 2] };
+
+    return GetQuantMeshVertex(*quant, index);
+}
+
+//----------------------------------------------------------------
+// Row rasterizers
+
+static void RasterSpanScalar(float* row, int count, const float* e, const float* de, float z, float dz, float zMax)
+{
+    for (int x = 0; x < count; x++)
+    {
+        const float ex = (float)x;
+
+        if ((e[0] + de[0]*ex >= 0.0f) && (e[1] + de[1]*ex >= 0.0f) && (e[2] + de[2]*ex >= 0.0f))
+        {
+            const float depth = fminf(z + dz*ex, zMax);
+            if (depth < row[x]) row[x] = depth;
+        }
+    }
+}
+
+#if defined(OCCLUSION_SSE)
+static void RasterSpanSse(float* row, int count, const float* e, const float* de, float z, float dz, float zMax)
+{
+    const __m128 ramp = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 vzMax = _mm_set1_ps(zMax);
+
+    __m128 e0 = _mm_add_ps(_mm_set1_ps(e[0]), _mm_mul_ps(ramp, _mm_set1_ps(de[0])));
+    __m128 e1 = _mm_add_ps(_mm_set1_ps(e[1]), _mm_mul_ps(ramp, _mm_set1_ps(de[1])));
+    __m128 e2 = _mm_add_ps(_mm_set1_ps(e[2]), _mm_mul_ps(ramp, _mm_set1_ps(de[2])));
+    __m128 vz = _mm_add_ps(_mm_set1_ps(z), _mm_mul_ps(ramp, _mm_set1_ps(dz)));
+
+    const __m128 step0 = _mm_set1_ps(4.0f*de[0]);
+    const __m128 step1 = _mm_set1_ps(4.0f*de[1]);
+    const __m128 step2 = _mm_set1_ps(4.0f*de[2]);
+    const __m128 stepZ = _mm_set1_ps(4.0f*dz);
+
+    for (int x = 0; x < count; x += 4)
+    {
+        const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+        if (_mm_movemask_ps(inside) != 0)
+        {
+            const __m128 depth = _mm_loadu_ps(row + x);
+            const __m128 nearest = _mm_min_ps(depth, _mm_min_ps(vz, vzMax));
+
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, depth)));
+        }
+
+        e0 = _mm_add_ps(e0, step0);
+        e1 = _mm_add_ps(e1, step1);
+        e2 = _mm_add_ps(e2, step2);
+        vz = _mm_add_ps(vz, stepZ);
+    }
+}
+#endif
+
+#if defined(OCCLUSION_AVX)
+__attribute__((target("avx")))
+static void RasterSpanAvx(float* row, int count, const float* e, const float* de, float z, float dz, float zMax)
+{
+    const __m256 ramp = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 vzMax = _mm256_set1_ps(zMax);
+
+    __m256 e0 = _mm256_add_ps(_mm256_set1_ps(e[0]), _mm256_mul_ps(ramp, _mm256_set1_ps(de[0])));
+    __m256 e1 = _mm256_add_ps(_mm256_set1_ps(e[1]), _mm256_mul_ps(ramp, _mm256_set1_ps(de[1])));
+    __m256 e2 = _mm256_add_ps(_mm256_set1_ps(e[2]), _mm256_mul_ps(ramp, _mm256_set1_ps(de[2])));
+    __m256 vz = _mm256_add_ps(_mm256_set1_ps(z), _mm256_mul_ps(ramp, _mm256_set1_ps(dz)));
+
+    const __m256 step0 = _mm256_set1_ps(8.0f*de[0]);
+    const __m256 step1 = _mm256_set1_ps(8.0f*de[1]);
+    const __m256 step2 = _mm256_set1_ps(8.0f*de[2]);
+    const __m256 stepZ = _mm256_set1_ps(8.0f*dz);
+
+    for (int x = 0; x < count; x += 8)
+    {
+        const __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)), _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+
+        if (_mm256_movemask_ps(inside) != 0)
+        {
+            const __m256 depth = _mm256_loadu_ps(row + x);
+            const __m256 nearest = _mm256_min_ps(depth, _mm256_min_ps(vz, vzMax));
+
+            _mm256_storeu_ps(row + x, _mm256_blendv_ps(depth, nearest, inside));
+        }
+
+        e0 = _mm256_add_ps(e0, step0);
+        e1 = _mm256_add_ps(e1, step1);
+        e2 = _mm256_add_ps(e2, step2);
+        vz = _mm256_add_ps(vz, stepZ);
+    }
+}
+#endif
+
+//----------------------------------------------------------------
+// Occluder rasterization
+
+// v holds screen space x, y and depth in [0..1]
+static void RasterizeTriangle(struct OcclusionWorker* worker, Vector3 v0, Vector3 v1, Vector3 v2)
+{
+    float area = (v1.x - v0.x)*(v2.y - v0.y) - (v2.x - v0.x)*(v1.y - v0.y);
+
+    if (fabsf(area) < 1e-6f) return;
+
+    if (area < 0.0f)
+    {
+        Vector3 tmp = v1; v1 = v2; v2 = tmp;
+        area = -area;
+    }
+
+    int minX = (int)floorf(fminf(v0.x, fminf(v1.x, v2.x)));
+    int maxX = (int)ceilf(fmaxf(v0.x, fmaxf(v1.x, v2.x)));
+    int minY = (int)floorf(fminf(v0.y, fminf(v1.y, v2.y)));
+    int maxY = (int)ceilf(fmaxf(v0.y, fmaxf(v1.y, v2.y)));
+
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > OCCLUSION_DEPTH_WIDTH - 1) maxX = OCCLUSION_DEPTH_WIDTH - 1;
+    if (maxY > OCCLUSION_DEPTH_HEIGHT - 1) maxY = OCCLUSION_DEPTH_HEIGHT - 1;
+
+    if ((minX > maxX) || (minY > maxY)) return;
+
+    // Edge functions a*x + b*y + c, positive inside, sampled at pixel centers. Shared edges
+    // pass on both sides so meshes stay watertight
+    const Vector3 verts[3] = { v0, v1, v2 };
+    float a[3] = { 0 };
+    float b[3] = { 0 };
+    float c[3] = { 0 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        const Vector3 p = verts[i];
+        const Vector3 q = verts[(i + 1)%3];
+
+        a[i] = p.y - q.y;
+        b[i] = q.x - p.x;
+        c[i] = -(a[i]*p.x + b[i]*p.y);
+    }
+
+    // Depth plane, biased to the farthest depth inside the pixel
+    const float dzdx = ((v1.z - v0.z)*(v2.y - v0.y) - (v2.z - v0.z)*(v1.y - v0.y))/area;
+    const float dzdy = ((v2.z - v0.z)*(v1.x - v0.x) - (v1.z - v0.z)*(v2.x - v0.x))/area;
+    const float zBias = 0.5f*(fabsf(dzdx) + fabsf(dzdy));
+    const float zMax = fmaxf(v0.z, fmaxf(v1.z, v2.z));
+
+    // Spans start and end on lane boundaries, the width is a multiple of the lane count
+    const int startX = minX & ~(OCCLUSION_SPAN_ALIGN - 1);
+    const int count = ((maxX + OCCLUSION_SPAN_ALIGN) & ~(OCCLUSION_SPAN_ALIGN - 1)) - startX;
+
+    const float px = (float)startX + 0.5f;
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        const float py = (float)y + 0.5f;
+
+        const float e[3] = {
+            a[0]*px + b[0]*py + c[0],
+            a[1]*px + b[1]*py + c[1],
+            a[2]*px + b[2]*py + c[2]
+        };
+
+        const float z = v0.z + dzdx*(px - v0.x) + dzdy*(py - v0.y) + zBias;
+
+        worker->rasterSpan(&worker->depth[y*OCCLUSION_DEPTH_WIDTH + startX], count, e, a, z, dzdx, zMax);
+    }
+}
+
+static Vector3 ClipToScreen(ClipVertex v)
+{
+    return (Vector3)
+    {
+        (v.x/v.w*0.5f + 0.5f)*OCCLUSION_DEPTH_WIDTH,
+        (v.y/v.w*0.5f + 0.5f)*OCCLUSION_DEPTH_HEIGHT,
+        v.z/v.w*0.5f + 0.5f
+    };
+}
+
+// Clips against the near plane (z >= -w) and rasterizes the remaining polygon as a fan
+static int RasterizeClipTriangle(struct OcclusionWorker* worker, const ClipVertex* triangle)
+{
+    ClipVertex polygon[4] = { 0 };
+    int count = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const ClipVertex p = triangle[i];
+        const ClipVertex q = triangle[(i + 1)%3];
+        const float dp = p.z + p.w;
+        const float dq = q.z + q.w;
+
+        if (dp >= 0.0f) polygon[count++] = p;
+
+        if ((dp >= 0.0f) != (dq >= 0.0f))
+        {
+            const float t = dp/(dp - dq);
+
+            polygon[count++] = (ClipVertex){
+                p.x + (q.x - p.x)*t,
+                p.y + (q.y - p.y)*t,
+                p.z + (q.z - p.z)*t,
+                p.w + (q.w - p.w)*t
+            };
+        }
+    }
+
+    if (count < 3) return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (polygon[i].w <= 0.0f) return 0;
+    }
+
+    const Vector3 first = ClipToScreen(polygon[0]);
+
+    for (int i = 1; i < count - 1; i++)
+    {
+        RasterizeTriangle(worker, first, ClipToScreen(polygon[i]), ClipToScreen(polygon[i + 1]));
+    }
+
+    return count - 2;
+}
+
+//----------------------------------------------------------------
+// Bounds test
+
+static ItemResult TestItemBounds(const float* depth, Matrix matrix, BoundingBox bounds)
+{
+    float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX;
+    int behindCount = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        const Vector3 corner = {
+            (i & 1) ? bounds.max.x : bounds.min.x,
+            (i & 2) ? bounds.max.y : bounds.min.y,
+            (i & 4) ? bounds.max.z : bounds.min.z
+        };
+
+        const ClipVertex v = TransformClip(matrix, corner);
+
+        if ((v.z < -v.w) || (v.w <= 0.0f))
+        {
+            behindCount++;
+            continue;
+        }
+
+        minX = fminf(minX, v.x/v.w); maxX = fmaxf(maxX, v.x/v.w);
+        minY = fminf(minY, v.y/v.w); maxY = fmaxf(maxY, v.y/v.w);
+        minZ = fminf(minZ, v.z/v.w);
+    }
+
+    if (behindCount == 8) return ITEM_OUTSIDE;
+    if (behindCount > 0) return ITEM_VISIBLE;       // Crosses the near plane
+
+    if ((maxX < -1.0f) || (minX > 1.0f) || (maxY < -1.0f) || (minY > 1.0f) || (minZ > 1.0f)) return ITEM_OUTSIDE;
+
+    int x0 = (int)floorf((minX*0.5f + 0.5f)*OCCLUSION_DEPTH_WIDTH);
+    int x1 = (int)floorf((maxX*0.5f + 0.5f)*OCCLUSION_DEPTH_WIDTH);
+    int y0 = (int)floorf((minY*0.5f + 0.5f)*OCCLUSION_DEPTH_HEIGHT);
+    int y1 = (int)floorf((maxY*0.5f + 0.5f)*OCCLUSION_DEPTH_HEIGHT);
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > OCCLUSION_DEPTH_WIDTH - 1) x1 = OCCLUSION_DEPTH_WIDTH - 1;
+    if (y1 > OCCLUSION_DEPTH_HEIGHT - 1) y1 = OCCLUSION_DEPTH_HEIGHT - 1;
+
+    const float nearest = minZ*0.5f + 0.5f;
+
+    for (int y = y0; y <= y1; y++)
+    {
+        const float* row = &depth[y*OCCLUSION_DEPTH_WIDTH];
+
+        for (int x = x0; x <= x1; x++)
+        {
+            if (row[x] >= nearest) return ITEM_VISIBLE;
+        }
+    }
+
+    return ITEM_OCCLUDED;
+}
+
+//----------------------------------------------------------------
+// Worker
+
+static OcclusionStats RunOcclusionJob(struct OcclusionWorker* worker, Matrix viewProjection, Matrix transform, bool* visible)
+{
+    OcclusionStats stats = { 0 };
+    stats.simd = worker->simd;
+
+    const Matrix world = MatrixMultiply(viewProjection, transform);
+
+    double startTime = GetTime();
+    TraceBegin("occlusion raster");
+
+    for (int i = 0; i < OCCLUSION_DEPTH_WIDTH*OCCLUSION_DEPTH_HEIGHT; i++) worker->depth[i] = 1.0f;
+
+    for (int i = 0; i < worker->occluderCount; i++)
+    {
+        const Occluder occluder = worker->occluders[i];
+        const Matrix matrix = MatrixMultiply(world, worker->items[occluder.item].transform);
+        const Vector3* vertices = worker->meshTriangles[occluder.meshIndex];
+
+        for (int t = 0; t < worker->meshTriangleCounts[occluder.meshIndex]; t++)
+        {
+            const ClipVertex triangle[3] = {
+                TransformClip(matrix, vertices[t*3]),
+                TransformClip(matrix, vertices[t*3 + 1]),
+                TransformClip(matrix, vertices[t*3 + 2])
+            };
+
+            stats.occluderTriangles += RasterizeClipTriangle(worker, triangle);
+        }
+    }
+
+    stats.rasterTime = GetTime() - startTime;
+    startTime = GetTime();
+
+    TraceEnd();
+    TraceBegin("occlusion test");
+
+    for (int i = 0; i < worker->itemCount; i++)
+    {
+        const OcclusionItem* item = &worker->items[i];
+
+        if (item->isDynamic)
+        {
+            visible[i] = true;
+            continue;
+        }
+
+        const ItemResult result = TestItemBounds(worker->depth, MatrixMultiply(world, item->transform), item->bounds);
+
+        visible[i] = (result == ITEM_VISIBLE);
+        stats.testedCount++;
+
+        if (result == ITEM_OCCLUDED) stats.occludedCount++;
+        else if (result == ITEM_OUTSIDE) stats.outsideCount++;
+    }
+
+    stats.testTime = GetTime() - startTime;
+
+    TraceEnd();
+    TraceCounter("occluded items", stats.occludedCount + stats.outsideCount);
+
+    return stats;
+}
+
+static void* OcclusionWorkerMain(void* arg)
+{
+    struct OcclusionWorker* worker = (struct OcclusionWorker*)arg;
+
+    SetTraceThreadName("occlusion");
+
+    pthread_mutex_lock(&worker->mutex);
+
+    while (true)
+    {
+        while (worker->isRunning && !worker->isJobPending) pthread_cond_wait(&worker->cond, &worker->mutex);
+
+        if (!worker->isRunning) break;
+
+        worker->isJobPending = false;
+
+        const Matrix viewProjection = worker->jobViewProjection;
+        const Matrix transform = worker->jobTransform;
+        const int itemsVersion = worker->jobItemsVersion;
+        bool* visible = worker->backVisible;
+
+        pthread_mutex_unlock(&worker->mutex);
+
+        const OcclusionStats stats = RunOcclusionJob(worker, viewProjection, transform, visible);
+
+        pthread_mutex_lock(&worker->mutex);
+
+        worker->backStats = stats;
+        worker->resultViewProjection = viewProjection;
+        worker->resultTransform = transform;
+        worker->resultItemsVersion = itemsVersion;
+        worker->isResultReady = true;
+        worker->isBusy = false;
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+
+//----------------------------------------------------------------
+// Load
+
+static int CompareOccluderCandidate(const void* a, const void* b)
+{
+    const float scoreA = ((const OccluderCandidate*)a)->score;
+    const float scoreB = ((const OccluderCandidate*)b)->score;
+
+    return (scoreA < scoreB) - (scoreA > scoreB);
+}
+
+// Surface area of the model space bounds, large walls and floors first
+static float GetOccluderScore(const OcclusionItem* item)
+{
+    Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for (int i = 0; i < 8; i++)
+    {
+        const Vector3 corner = {
+            (i & 1) ? item->bounds.max.x : item->bounds.min.x,
+            (i & 2) ? item->bounds.max.y : item->bounds.min.y,
+            (i & 4) ? item->bounds.max.z : item->bounds.min.z
+        };
+
+        const ClipVertex v = TransformClip(item->transform, corner);
+
+        min = (Vector3){ fminf(min.x, v.x), fminf(min.y, v.y), fminf(min.z, v.z) };
+        max = (Vector3){ fmaxf(max.x, v.x), fmaxf(max.y, v.y), fmaxf(max.z, v.z) };
+    }
+
+    const Vector3 size = { max.x - min.x, max.y - min.y, max.z - min.z };
+
+    return 2.0f*(size.x*size.y + size.y*size.z + size.z*size.x);
+}
+
+static void SelectOccluders(OcclusionCuller* culler, Model model, QuantModel quant, const int* materials)
+{
+    struct OcclusionWorker* worker = culler->worker;
+
+    OccluderCandidate* candidates = (OccluderCandidate*)RL_MALLOC(culler->itemCount*sizeof(OccluderCandidate));
+    int candidateCount = 0;
+
+    for (int i = 0; i < culler->itemCount; i++)
+    {
+        const OcclusionItem* item = &culler->items[i];
+        const Mesh mesh = model.meshes[item->meshIndex];
+
+        if (item->isDynamic) continue;
+
+        // Translucent materials don't hide anything
+        if (model.materials[materials[i]].maps[MATERIAL_MAP_DIFFUSE].color.a < 255) continue;
+
+        const int triangleCount = (mesh.indices != NULL) ? mesh.triangleCount : mesh.vertexCount/3;
+        if ((triangleCount == 0) || (triangleCount > OCCLUSION_MAX_OCCLUDER_TRIANGLES)) continue;
+
+        candidates[candidateCount++] = (OccluderCandidate){ GetOccluderScore(item), i };
+    }
+
+    qsort(candidates, candidateCount, sizeof(OccluderCandidate), CompareOccluderCandidate);
+
+    int triangleBudget = OCCLUSION_MAX_OCCLUDER_TRIANGLES;
+
+    for (int i = 0; (i < candidateCount) && (worker->occluderCount < OCCLUSION_MAX_OCCLUDERS); i++)
+    {
+        const int meshIndex = culler->items[candidates[i].item].meshIndex;
+        const Mesh mesh = model.meshes[meshIndex];
+        const QuantMesh* quantMesh = ((meshIndex < quant.meshCount) && quant.meshes[meshIndex].isQuantized) ? &quant.meshes[meshIndex] : NULL;
+
+        const int triangleCount = (mesh.indices != NULL) ? mesh.triangleCount : mesh.vertexCount/3;
+        if (triangleCount > triangleBudget) continue;
+
+        triangleBudget -= triangleCount;
+
+        // Instances of a mesh share its triangles
+        if (worker->meshTriangles[meshIndex] == NULL)
+        {
+            Vector3* vertices = (Vector3*)RL_MALLOC(triangleCount*3*sizeof(Vector3));
+
+            for (int v = 0; v < triangleCount*3; v++)
+            {
+                const int index = (mesh.indices != NULL) ? mesh.indices[v] : v;
+                vertices[v] = GetOcclusionVertex(mesh, quantMesh, index);
+            }
+
+            worker->meshTriangles[meshIndex] = vertices;
+            worker->meshTriangleCounts[meshIndex] = triangleCount;
+        }
+
+        worker->occluders[worker->occluderCount++] = (Occluder){ candidates[i].item, meshIndex };
+    }
+
+    culler->occluderCount = worker->occluderCount;
+
+    RL_FREE(candidates);
+}
+
+OcclusionCuller LoadOcclusionCuller(Model model, QuantModel quant, const InstanceScene* instances)
+{
+    OcclusionCuller culler = { 0 };
+
+    // Mesh space bounds, skinned meshes move outside of them
+    BoundingBox* meshBounds = (BoundingBox*)RL_CALLOC(model.meshCount, sizeof(BoundingBox));
+    bool* isMeshDynamic = (bool*)RL_CALLOC(model.meshCount, sizeof(bool));
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        const Mesh mesh = model.meshes[i];
+        const QuantMesh* quantMesh = ((i < quant.meshCount) && quant.meshes[i].isQuantized) ? &quant.meshes[i] : NULL;
+
+        if ((mesh.boneIds != NULL) || (mesh.animVertices != NULL) || ((mesh.vertices == NULL) && (quantMesh == NULL)) || (mesh.vertexCount == 0))
+        {
+            isMeshDynamic[i] = true;
+            continue;
+        }
+
+        BoundingBox bounds = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+        for (int v = 0; v < mesh.vertexCount; v++)
+        {
+            const Vector3 p = GetOcclusionVertex(mesh, quantMesh, v);
+
+            bounds.min = (Vector3){ fminf(bounds.min.x, p.x), fminf(bounds.min.y, p.y), fminf(bounds.min.z, p.z) };
+            bounds.max = (Vector3){ fmaxf(bounds.max.x, p.x), fmaxf(bounds.max.y, p.y), fmaxf(bounds.max.z, p.z) };
+        }
+
+        meshBounds[i] = bounds;
+    }
+
+    // One item per mesh reference, in the order DrawInstanceScene() walks them
+    const Matrix identity = { 1.0f, 0.0f, 0.0f, 0.0f,
+                              0.0f, 1.0f, 0.0f, 0.0f,
+                              0.0f, 0.0f, 1.0f, 0.0f,
+                              0.0f, 0.0f, 0.0f, 1.0f };
+
+    int* materials = NULL;
+
+    if ((instances != NULL) && (instances->batchCount > 0))
+    {
+        culler.itemCount = instances->instanceCount;
+        culler.items = (OcclusionItem*)RL_CALLOC(culler.itemCount, sizeof(OcclusionItem));
+        materials = (int*)RL_MALLOC(culler.itemCount*sizeof(int));
+
+        int item = 0;
+
+        for (int i = 0; i < instances->batchCount; i++)
+        {
+            const InstanceBatch* batch = &instances->batches[i];
+
+            for (int k = 0; k < batch->instanceCount; k++, item++)
+            {
+                culler.items[item] = (OcclusionItem){ batch->meshIndex, batch->transforms[k], meshBounds[batch->meshIndex], isMeshDynamic[batch->meshIndex] };
+                materials[item] = batch->materialIndex;
+            }
+        }
+    }
+    else
+    {
+        culler.itemCount = model.meshCount;
+        culler.items = (OcclusionItem*)RL_CALLOC(culler.itemCount, sizeof(OcclusionItem));
+        materials = (int*)RL_MALLOC(culler.itemCount*sizeof(int));
+
+        for (int i = 0; i < model.meshCount; i++)
+        {
+            culler.items[i] = (OcclusionItem){ i, identity, meshBounds[i], isMeshDynamic[i] };
+            materials[i] = model.meshMaterial[i];
+        }
+    }
+
+    RL_FREE(isMeshDynamic);
+    RL_FREE(meshBounds);
+
+    // Nothing is hidden until the first result arrives
+    culler.visible = (bool*)RL_MALLOC(culler.itemCount*sizeof(bool));
+    for (int i = 0; i < culler.itemCount; i++) culler.visible[i] = true;
+
+    struct OcclusionWorker* worker = (struct OcclusionWorker*)RL_CALLOC(1, sizeof(struct OcclusionWorker));
+    culler.worker = worker;
+
+    worker->items = culler.items;
+    worker->itemCount = culler.itemCount;
+    worker->backVisible = (bool*)RL_CALLOC(culler.itemCount, sizeof(bool));
+    worker->depth = (float*)RL_MALLOC(OCCLUSION_DEPTH_WIDTH*OCCLUSION_DEPTH_HEIGHT*sizeof(float));
+    worker->meshCount = model.meshCount;
+    worker->meshTriangleCounts = (int*)RL_CALLOC(model.meshCount, sizeof(int));
+    worker->meshTriangles = (Vector3**)RL_CALLOC(model.meshCount, sizeof(Vector3*));
+
+    worker->rasterSpan = RasterSpanScalar;
+    worker->simd = "scalar";
+
+#if defined(OCCLUSION_SSE)
+    worker->rasterSpan = RasterSpanSse;
+    worker->simd = "SSE2";
+#endif
+#if defined(OCCLUSION_AVX)
+    if (__builtin_cpu_supports("avx"))
+    {
+        worker->rasterSpan = RasterSpanAvx;
+        worker->simd = "AVX";
+    }
+#endif
+
+    culler.stats.simd = worker->simd;
+
+    SelectOccluders(&culler, model, quant, materials);
+    RL_FREE(materials);
+
+    worker->isRunning = true;
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+
+    if (pthread_create(&worker->thread, NULL, OcclusionWorkerMain, worker) != 0)
+    {
+        TraceLog(LOG_WARNING, "OCCLUSION: Failed to start worker thread, culling disabled");
+        worker->isRunning = false;
+    }
+
+    int occluderTriangles = 0;
+    for (int i = 0; i < worker->occluderCount; i++) occluderTriangles += worker->meshTriangleCounts[worker->occluders[i].meshIndex];
+
+    TraceLog(LOG_INFO, "OCCLUSION: %d items, %d occluders (%d triangles), %s rasterizer", culler.itemCount, culler.occluderCount, occluderTriangles, worker->simd);
+
+    return culler;
+}
+
+void UnloadOcclusionCuller(OcclusionCuller culler)
+{
+    struct OcclusionWorker* worker = culler.worker;
+
+    if (worker == NULL) return;
+
+    pthread_mutex_lock(&worker->mutex);
+    const bool wasRunning = worker->isRunning;
+    worker->isRunning = false;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+
+    if (wasRunning) pthread_join(worker->thread, NULL);
+
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->mutex);
+
+    for (int i = 0; i < worker->meshCount; i++) RL_FREE(worker->meshTriangles[i]);
+
+    RL_FREE(worker->meshTriangles);
+    RL_FREE(worker->meshTriangleCounts);
+    RL_FREE(worker->depth);
+    RL_FREE(worker->backVisible);
+    RL_FREE(worker->pendingTransforms);
+    RL_FREE(worker);
+
+    RL_FREE(culler.visible);
+    RL_FREE(culler.items);
+}
+
+//----------------------------------------------------------------
+
+bool UpdateOcclusionCuller(OcclusionCuller* culler, Camera camera, float aspect, Matrix transform)
+{
+    struct OcclusionWorker* worker = culler->worker;
+
+    if ((worker == NULL) || !worker->isRunning) return false;
+
+    const Matrix viewProjection = MatrixMultiply(GetCameraProjection(camera, aspect), GetCameraMatrix(camera));
+
+    pthread_mutex_lock(&worker->mutex);
+
+    // The worker is idle once its result is ready, swap it in for this frame
+    if (worker->isResultReady)
+    {
+        bool* visible = culler->visible;
+        culler->visible = worker->backVisible;
+        worker->backVisible = visible;
+
+        culler->stats = worker->backStats;
+        worker->frontViewProjection = worker->resultViewProjection;
+        worker->frontTransform = worker->resultTransform;
+        worker->frontItemsVersion = worker->resultItemsVersion;
+        worker->hasFront = true;
+        worker->isResultReady = false;
+    }
+
+    const bool isStale = !worker->hasFront || (worker->frontItemsVersion != worker->itemsVersion) ||
+                         !IsSameView(worker->frontViewProjection, worker->frontTransform, viewProjection, transform);
+
+    // A still view needs no new job, a busy worker gets the latest view next frame
+    if (isStale && !worker->isBusy)
+    {
+        // The worker is idle, the items are ours until the job is signaled
+        if (worker->appliedItemsVersion != worker->itemsVersion)
+        {
+            for (int i = 0; i < culler->itemCount; i++) culler->items[i].transform = worker->pendingTransforms[i];
+            worker->appliedItemsVersion = worker->itemsVersion;
+        }
+
+        worker->jobViewProjection = viewProjection;
+        worker->jobTransform = transform;
+        worker->jobItemsVersion = worker->itemsVersion;
+        worker->isJobPending = true;
+        worker->isBusy = true;
+        pthread_cond_signal(&worker->cond);
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return isStale;
+}
+
+void SetOcclusionItemTransforms(OcclusionCuller* culler, const InstanceScene* instances)
+{
+    struct OcclusionWorker* worker = culler->worker;
+
+    // Items without batches are model meshes, their transform is fixed
+    if ((worker == NULL) || (instances->batchCount == 0) || (instances->instanceCount != culler->itemCount)) return;
+
+    if (worker->pendingTransforms == NULL) worker->pendingTransforms = (Matrix*)RL_MALLOC(culler->itemCount*sizeof(Matrix));
+
+    int item = 0;
+
+    for (int i = 0; i < instances->batchCount; i++)
+    {
+        const InstanceBatch* batch = &instances->batches[i];
+
+        for (int k = 0; k < batch->instanceCount; k++) worker->pendingTransforms[item++] = batch->transforms[k];
+    }
+
+    // Only the main thread touches the pending copy and the version, no lock needed
+    worker->itemsVersion++;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************************
+*
+*   occlusion - Software rasterized occlusion culling on a worker thread
+*
+*   A few large meshes are picked as occluders at load time. Every frame a worker thread
+*   rasterizes them into a low resolution depth buffer (SSE, or AVX when the CPU has it) and
+*   tests the screen space bounds of every mesh reference against it. The main thread submits
+*   the camera of the current frame and draws with the result of the previous one, so the
+*   rasterizer runs while the GPU work of the frame is submitted.
+*
+*   Occluder depth is biased to the farthest depth inside each covered pixel, a mesh is only
+*   rejected when every pixel under its bounds is closer than it.
+*   Skinned meshes change bounds with the animation and are never rejected.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include "raylib.h"
+#include "quant.h"
+#include "instancing.h"
+
+#define OCCLUSION_DEPTH_WIDTH               256     // Multiple of 8 (AVX lanes)
+#define OCCLUSION_DEPTH_HEIGHT              128
+#define OCCLUSION_MAX_OCCLUDERS             64
+#define OCCLUSION_MAX_OCCLUDER_TRIANGLES    8192    // Budget over all occluders
+
+typedef struct
+{
+    int meshIndex;
+    Matrix transform;           // Model space transform, instance transform or identity
+    BoundingBox bounds;         // Mesh space bounds
+    bool isDynamic;             // Skinned, never rejected
+} OcclusionItem;
+
+typedef struct
+{
+    int testedCount;
+    int occludedCount;          // Rejected by the depth buffer
+    int outsideCount;           // Rejected by the view frustum
+    int occluderTriangles;      // Triangles rasterized after near plane clipping
+    double rasterTime;          // Seconds spent rasterizing occluders
+    double testTime;            // Seconds spent testing bounds
+    const char* simd;           // Rasterizer path in use
+} OcclusionStats;
+
+typedef struct
+{
+    int itemCount;
+    OcclusionItem* items;       // Instances in batch order, or model meshes without batches
+    int occluderCount;
+
+    bool* visible;              // Result the frame is drawn with, one flag per item
+    OcclusionStats stats;       // Stats of that result
+
+    struct OcclusionWorker* worker;
+} OcclusionCuller;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OcclusionCuller LoadOcclusionCuller(Model model, QuantModel quant, const InstanceScene* instances);
+void UnloadOcclusionCuller(OcclusionCuller culler);
+
+// Picks up the finished result and submits the camera of this frame,
+// returns true while the result in use was computed for an older view
+bool UpdateOcclusionCuller(OcclusionCuller* culler, Camera camera, float aspect, Matrix transform);
+
+// Takes the instance transforms after they changed, the next job culls with them
+void SetOcclusionItemTransforms(OcclusionCuller* culler, const InstanceScene* instances);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OCCLUSION_H
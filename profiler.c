@@ -0,0 +1,283 @@
+/*******************************************************************************************
+*
+*   profiler - Frame phase timers and an on-screen timeline of the last frames
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "profiler.h"
+#include "trace.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_TIMELINE_SCALE 0.0333f     // Seconds of the full timeline height, two 60 fps frames
+
+static const char* phaseNames[PROFILER_PHASE_COUNT] = { "camera", "gizmo", "load", "scene", "animation", "draw 3d", "gui", "swap", "other" };
+
+static const Color phaseColors[PROFILER_PHASE_COUNT] = {
+    { 102, 191, 255, 255 },     // camera
+    { 255, 161, 0, 255 },       // gizmo
+    { 230, 41, 55, 255 },       // load
+    { 0, 228, 48, 255 },        // scene
+    { 200, 122, 255, 255 },     // animation
+    { 0, 121, 241, 255 },       // draw 3d
+    { 253, 249, 0, 255 },       // gui
+    { 80, 80, 80, 255 },        // swap
+    { 130, 130, 130, 255 }      // other
+};
+
+//----------------------------------------------------------------
+
+static int CompareFloat(const void* a, const void* b)
+{
+    const float fa = *(const float*)a;
+    const float fb = *(const float*)b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+//----------------------------------------------------------------
+
+FrameProfiler InitFrameProfiler(void)
+{
+    FrameProfiler profiler = { 0 };
+    profiler.frames = (ProfilerFrame*)RL_CALLOC(PROFILER_FRAME_COUNT, sizeof(ProfilerFrame));
+    profiler.frameStart = GetTime();
+
+    return profiler;
+}
+
+void UnloadFrameProfiler(FrameProfiler profiler)
+{
+    RL_FREE(profiler.frames);
+}
+
+void BeginProfilerFrame(FrameProfiler* profiler)
+{
+    profiler->frameStart = GetTime();
+    profiler->depth = 0;
+    profiler->overflowDepth = 0;
+    memset(profiler->phaseTimes, 0, sizeof(profiler->phaseTimes));
+}
+
+void EndProfilerFrame(FrameProfiler* profiler, bool isIdle)
+{
+    // A phase left open is closed here rather than leaking into the next frame
+    while (profiler->depth > 0) EndProfilerPhase(profiler);
+
+    ProfilerFrame frame = { 0 };
+    frame.frameTime = (float)(GetTime() - profiler->frameStart);
+    frame.isIdle = isIdle;
+
+    TraceCounter("frame time us", (long long)(frame.frameTime*1000000.0f));
+
+    float measured = 0.0f;
+
+    for (int i = 0; i < PROFILER_PHASE_OTHER; i++)
+    {
+        frame.phaseTimes[i] = profiler->phaseTimes[i];
+        measured += profiler->phaseTimes[i];
+    }
+
+    frame.phaseTimes[PROFILER_PHASE_OTHER] = (frame.frameTime > measured) ? frame.frameTime - measured : 0.0f;
+
+    // Only this thread writes, the slot is filled before the count that exposes it
+    const unsigned int count = profiler->frameCount;
+    profiler->frames[count%PROFILER_FRAME_COUNT] = frame;
+    __atomic_store_n(&profiler->frameCount, count + 1, __ATOMIC_RELEASE);
+}
+
+void BeginProfilerPhase(FrameProfiler* profiler, ProfilerPhase phase)
+{
+    // Too deep to time, counted so the matching end does not pop an enclosing phase
+    if (profiler->depth == PROFILER_MAX_DEPTH)
+    {
+        profiler->overflowDepth++;
+        return;
+    }
+
+    profiler->stack[profiler->depth] = phase;
+    profiler->stackStarts[profiler->depth] = GetTime();
+    profiler->depth++;
+
+    TraceBegin(phaseNames[phase]);
+}
+
+void EndProfilerPhase(FrameProfiler* profiler)
+{
+    if (profiler->overflowDepth > 0)
+    {
+        profiler->overflowDepth--;
+        return;
+    }
+
+    if (profiler->depth == 0) return;
+
+    profiler->depth--;
+    TraceEnd();
+
+    const float elapsed = (float)(GetTime() - profiler->stackStarts[profiler->depth]);
+    profiler->phaseTimes[profiler->stack[profiler->depth]] += elapsed;
+
+    // The enclosing phase is charged its own time only
+    if (profiler->depth > 0) profiler->phaseTimes[profiler->stack[profiler->depth - 1]] -= elapsed;
+}
+
+int ReadProfilerFrames(const FrameProfiler* profiler, ProfilerFrame* frames, int maxCount)
+{
+    const unsigned int frameCount = __atomic_load_n(&profiler->frameCount, __ATOMIC_ACQUIRE);
+
+    // One slot short of the ring, the oldest one is the next the writer fills
+    int count = (frameCount < PROFILER_FRAME_COUNT - 1) ? (int)frameCount : PROFILER_FRAME_COUNT - 1;
+    if (count > maxCount) count = maxCount;
+
+    for (int i = 0; i < count; i++) frames[i] = profiler->frames[(frameCount - count + i)%PROFILER_FRAME_COUNT];
+
+    // Frames written during the copy may have reused the oldest slots, those copies are dropped
+    const unsigned int lapped = __atomic_load_n(&profiler->frameCount, __ATOMIC_ACQUIRE) - frameCount;
+
+    if (lapped > 0)
+    {
+        const int dropped = ((int)lapped < count) ? (int)lapped : count;
+        memmove(frames, frames + dropped, (count - dropped)*sizeof(ProfilerFrame));
+        count -= dropped;
+    }
+
+    return count;
+}
+
+ProfilerStats GetProfilerStats(const ProfilerFrame* frames, int count)
+{
+    ProfilerStats stats = { 0 };
+    float times[PROFILER_FRAME_COUNT] = { 0 };
+
+    if (count > PROFILER_FRAME_COUNT) count = PROFILER_FRAME_COUNT;
+
+    for (int phase = 0; phase <= PROFILER_PHASE_COUNT; phase++)
+    {
+        int n = 0;
+        float sum = 0.0f;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (frames[i].isIdle) continue;
+
+            times[n] = 1000.0f*((phase < PROFILER_PHASE_COUNT) ? frames[i].phaseTimes[phase] : frames[i].frameTime);
+            sum += times[n++];
+        }
+
+        if (n == 0) break;
+
+        qsort(times, n, sizeof(float), CompareFloat);
+
+        stats.minTimes[phase] = times[0];
+        stats.avgTimes[phase] = sum/n;
+        stats.p99Times[phase] = times[(99*n + 99)/100 - 1];     // Nearest rank
+
+        if (phase == PROFILER_PHASE_COUNT)
+        {
+            stats.frameCount = n;
+            stats.medianFrameTime = times[n/2];
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!frames[i].isIdle && (1000.0f*frames[i].frameTime > PROFILER_SPIKE_FACTOR*stats.medianFrameTime)) stats.spikeCount++;
+    }
+
+    return stats;
+}
+
+const char* GetProfilerPhaseName(ProfilerPhase phase)
+{
+    return ((phase >= 0) && (phase < PROFILER_PHASE_COUNT)) ? phaseNames[phase] : "frame";
+}
+
+void DrawFrameProfiler(const FrameProfiler* profiler, Rectangle bounds)
+{
+    ProfilerFrame frames[PROFILER_FRAME_COUNT];
+    const int count = ReadProfilerFrames(profiler, frames, PROFILER_FRAME_COUNT);
+    const ProfilerStats stats = GetProfilerStats(frames, count);
+
+    DrawRectangleRec(bounds, Fade(BLACK, 0.75f));
+
+    // Timeline, newest frame on the right, one bar per frame
+    const float barWidth = 2.0f;
+    const float timelineHeight = bounds.height - 28;
+    const float timelineLeft = bounds.x + 8;
+    const float timelineBottom = bounds.y + 20 + timelineHeight;
+
+    DrawText(TextFormat("Frames: %d, median %.2f ms, %d spikes", stats.frameCount, stats.medianFrameTime, stats.spikeCount), (int)timelineLeft, (int)bounds.y + 4, 10, RAYWHITE);
+
+    // 60 fps and 30 fps lines
+    for (int i = 1; i <= 2; i++)
+    {
+        const float y = timelineBottom - timelineHeight*(i*0.01667f)/PROFILER_TIMELINE_SCALE;
+        DrawLine((int)timelineLeft, (int)y, (int)(timelineLeft + PROFILER_FRAME_COUNT*barWidth), (int)y, Fade(RAYWHITE, 0.3f));
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const ProfilerFrame* frame = &frames[i];
+        const float x = timelineLeft + (PROFILER_FRAME_COUNT - count + i)*barWidth;
+        float y = timelineBottom;
+
+        for (int phase = 0; (phase < PROFILER_PHASE_COUNT) && (y > timelineBottom - timelineHeight); phase++)
+        {
+            float height = timelineHeight*frame->phaseTimes[phase]/PROFILER_TIMELINE_SCALE;
+            if (y - height < timelineBottom - timelineHeight) height = y - (timelineBottom - timelineHeight);
+            if (height <= 0.0f) continue;
+
+            y -= height;
+            DrawRectangleRec((Rectangle){ x, y, barWidth, height }, frame->isIdle ? Fade(phaseColors[phase], 0.25f) : phaseColors[phase]);
+        }
+
+        if (!frame->isIdle && (1000.0f*frame->frameTime > PROFILER_SPIKE_FACTOR*stats.medianFrameTime))
+        {
+            // Counter-clockwise, pointing down at the bar
+            const float top = timelineBottom - timelineHeight;
+            DrawTriangle((Vector2){ x + 1, top + 1 }, (Vector2){ x + 5, top - 5 }, (Vector2){ x - 3, top - 5 }, RED);
+        }
+    }
+
+    // Table right of the timeline
+    const int tableLeft = (int)(timelineLeft + PROFILER_FRAME_COUNT*barWidth + 12);
+    const int tableTop = (int)bounds.y + 4;
+
+    const char* headers[3] = { "min", "avg", "p99" };
+    for (int i = 0; i < 3; i++) DrawText(headers[i], tableLeft + 62 + 38*i, tableTop, 10, RAYWHITE);
+
+    DrawText("ms", tableLeft + 12, tableTop, 10, RAYWHITE);
+
+    for (int phase = 0; phase <= PROFILER_PHASE_COUNT; phase++)
+    {
+        const int y = tableTop + 14 + phase*12;
+        const float values[3] = { stats.minTimes[phase], stats.avgTimes[phase], stats.p99Times[phase] };
+
+        if (phase < PROFILER_PHASE_COUNT) DrawRectangle(tableLeft, y + 1, 8, 8, phaseColors[phase]);
+
+        DrawText(GetProfilerPhaseName((ProfilerPhase)phase), tableLeft + 12, y, 10, RAYWHITE);
+        for (int i = 0; i < 3; i++) DrawText(TextFormat("%.2f", values[i]), tableLeft + 62 + 38*i, y, 10, RAYWHITE);
+    }
+}
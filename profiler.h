@@ -0,0 +1,115 @@
+/*******************************************************************************************
+*
+*   profiler - Frame phase timers and an on-screen timeline of the last frames
+*
+*   The main loop brackets its phases with BeginProfilerPhase()/EndProfilerPhase(). Phases
+*   may nest, a phase is charged its own time only, so the phases of a frame stack up to the
+*   frame time. Time outside every phase is kept as PROFILER_PHASE_OTHER.
+*
+*   Finished frames go to a ring written by the main thread only. The frame count is published
+*   with a release store and ReadProfilerFrames() copies with an acquire load, a reader on
+*   another thread needs no lock. The count is loaded again after the copy and the frames the
+*   writer may have reused meanwhile are dropped.
+*
+*   Frames that slept in EndDrawing() waiting for input are marked idle, they are drawn but
+*   kept out of the statistics and the spike test.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "raylib.h"
+
+#define PROFILER_FRAME_COUNT    240         // Four seconds at 60 fps
+#define PROFILER_MAX_DEPTH      8
+#define PROFILER_SPIKE_FACTOR   2.0f        // A frame this many times the median frame time is a spike
+
+typedef enum
+{
+    PROFILER_PHASE_CAMERA = 0,
+    PROFILER_PHASE_GIZMO,
+    PROFILER_PHASE_LOAD,
+    PROFILER_PHASE_SCENE,                   // Scene graph, instances and occlusion submit
+    PROFILER_PHASE_ANIMATION,
+    PROFILER_PHASE_DRAW_3D,
+    PROFILER_PHASE_GUI,
+    PROFILER_PHASE_SWAP,                    // EndDrawing(): buffer swap, input and the frame limiter wait
+    PROFILER_PHASE_OTHER,                   // Frame time outside every phase
+    PROFILER_PHASE_COUNT
+} ProfilerPhase;
+
+typedef struct
+{
+    float phaseTimes[PROFILER_PHASE_COUNT]; // Seconds, each phase without the phases nested in it
+    float frameTime;
+    bool isIdle;
+} ProfilerFrame;
+
+typedef struct
+{
+    float minTimes[PROFILER_PHASE_COUNT + 1];   // Milliseconds, the last entry is the whole frame
+    float avgTimes[PROFILER_PHASE_COUNT + 1];
+    float p99Times[PROFILER_PHASE_COUNT + 1];
+    float medianFrameTime;
+    int frameCount;                         // Frames measured, idle ones left out
+    int spikeCount;
+} ProfilerStats;
+
+typedef struct
+{
+    ProfilerFrame* frames;                  // Ring of PROFILER_FRAME_COUNT
+    unsigned int frameCount;                // Frames written, published with a release store
+
+    // Frame being measured
+    double frameStart;
+    float phaseTimes[PROFILER_PHASE_COUNT];
+    ProfilerPhase stack[PROFILER_MAX_DEPTH];
+    double stackStarts[PROFILER_MAX_DEPTH];
+    int depth;
+    int overflowDepth;                      // Phases begun past PROFILER_MAX_DEPTH, their ends are skipped
+} FrameProfiler;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+FrameProfiler InitFrameProfiler(void);
+void UnloadFrameProfiler(FrameProfiler profiler);
+
+void BeginProfilerFrame(FrameProfiler* profiler);
+void EndProfilerFrame(FrameProfiler* profiler, bool isIdle);    // After EndDrawing()
+
+void BeginProfilerPhase(FrameProfiler* profiler, ProfilerPhase phase);
+void EndProfilerPhase(FrameProfiler* profiler);                 // Ends the phase begun last
+
+// Copies up to maxCount of the last frames, oldest first. Safe from any thread
+int ReadProfilerFrames(const FrameProfiler* profiler, ProfilerFrame* frames, int maxCount);
+ProfilerStats GetProfilerStats(const ProfilerFrame* frames, int count);
+const char* GetProfilerPhaseName(ProfilerPhase phase);
+
+// Stacked frame timeline with spike markers and a min/avg/p99 table
+void DrawFrameProfiler(const FrameProfiler* profiler, Rectangle bounds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
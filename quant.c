@@ -0,0 +1,393 @@
+/*******************************************************************************************
+*
+*   quant - Compact vertex storage for loaded models
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "quant.h"
+#include "rlgl.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_VERTICES
+#include "memtrack.h"
+
+#include <math.h>
+#include <string.h>
+
+// Vertex attribute types not exposed by rlgl (passed straight to glVertexAttribPointer)
+#define QUANT_GL_SHORT         0x1402
+#define QUANT_GL_HALF_FLOAT    0x140B
+
+//----------------------------------------------------------------
+
+static short FloatToSnorm16(float value)
+{
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+
+    return (short)lrintf(value*32767.0f);
+}
+
+static float Snorm16ToFloat(short value)
+{
+    float result = (float)value/32767.0f;
+
+    return (result < -1.0f) ? -1.0f : result;
+}
+
+static float SignNotZero(float value)
+{
+    return (value >= 0.0f) ? 1.0f : -1.0f;
+}
+
+static void OctEncode(Vector3 n, short* out)
+{
+    float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+
+    if (l1 <= 0.0f)
+    {
+        // Degenerate normal, decodes to +Z
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    float x = n.x/l1;
+    float y = n.y/l1;
+
+    // Fold the lower hemisphere over the diagonals
+    if (n.z < 0.0f)
+    {
+        float ox = x;
+        x = (1.0f - fabsf(y))*SignNotZero(ox);
+        y = (1.0f - fabsf(ox))*SignNotZero(y);
+    }
+
+    out[0] = FloatToSnorm16(x);
+    out[1] = FloatToSnorm16(y);
+}
+
+static Vector3 OctDecode(short qx, short qy)
+{
+    Vector3 n = { Snorm16ToFloat(qx), Snorm16ToFloat(qy), 0.0f };
+    n.z = 1.0f - fabsf(n.x) - fabsf(n.y);
+
+    if (n.z < 0.0f)
+    {
+        float ox = n.x;
+        n.x = (1.0f - fabsf(n.y))*SignNotZero(ox);
+        n.y = (1.0f - fabsf(ox))*SignNotZero(n.y);
+    }
+
+    float length = sqrtf(n.x*n.x + n.y*n.y + n.z*n.z);
+    if (length > 0.0f)
+    {
+        n.x /= length;
+        n.y /= length;
+        n.z /= length;
+    }
+
+    return n;
+}
+
+unsigned short FloatToHalf(float value)
+{
+    unsigned int bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000;
+    unsigned int rawExponent = (bits >> 23) & 0xff;
+    unsigned int mantissa = bits & 0x7fffff;
+    int exponent = (int)rawExponent - 127 + 15;
+
+    // Inf and NaN
+    if (rawExponent == 0xff) return (unsigned short)(sign | 0x7c00 | ((mantissa != 0) ? 0x200 : 0));
+
+    // Overflow saturates to infinity
+    if (exponent >= 31) return (unsigned short)(sign | 0x7c00);
+
+    // Subnormal half (or zero)
+    if (exponent <= 0)
+    {
+        if (exponent < -10) return (unsigned short)sign;
+
+        mantissa |= 0x800000;
+
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        unsigned int remainder = mantissa & ((1u << shift) - 1);
+        unsigned int halfway = 1u << (shift - 1);
+
+        // Round to nearest even
+        if ((remainder > halfway) || ((remainder == halfway) && (half & 1))) half++;
+
+        return (unsigned short)(sign | half);
+    }
+
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    unsigned int remainder = mantissa & 0x1fff;
+
+    // Round to nearest even, a carry correctly bumps the exponent
+    if ((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1))) half++;
+
+    return (unsigned short)half;
+}
+
+float HalfToFloat(unsigned short value)
+{
+    unsigned int sign = ((unsigned int)value & 0x8000) << 16;
+    unsigned int exponent = (value >> 10) & 0x1f;
+    unsigned int mantissa = value & 0x3ff;
+    unsigned int bits = 0;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0) bits = sign;
+        else
+        {
+            // Normalize the subnormal half
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0)
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    }
+    else if (exponent == 31) bits = sign | 0x7f800000 | (mantissa << 13);
+    else bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float result = 0.0f;
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+//----------------------------------------------------------------
+
+// Replace the float position, texcoord and normal buffers of the mesh VAO with the compact ones
+static void UploadQuantMesh(Mesh* mesh, QuantMesh* quant)
+{
+    const int vertexCount = mesh->vertexCount;
+
+    rlEnableVertexArray(mesh->vaoId);
+
+    rlUnloadVertexBuffer(mesh->vboId[0]);
+    mesh->vboId[0] = rlLoadVertexBuffer(quant->positions, vertexCount*4*sizeof(short), false);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, QUANT_GL_SHORT, true, 4*sizeof(short), 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+
+    if ((quant->texcoords != NULL) && (mesh->vboId[1] != 0))
+    {
+        rlUnloadVertexBuffer(mesh->vboId[1]);
+        mesh->vboId[1] = rlLoadVertexBuffer(quant->texcoords, vertexCount*2*sizeof(unsigned short), false);
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, QUANT_GL_HALF_FLOAT, false, 0, 0);
+        rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+    }
+
+    // NOTE: The default shader does not read normals, a lighting shader must decode the octahedral pair
+    if ((quant->normals != NULL) && (mesh->vboId[2] != 0))
+    {
+        rlUnloadVertexBuffer(mesh->vboId[2]);
+        mesh->vboId[2] = rlLoadVertexBuffer(quant->normals, vertexCount*2*sizeof(short), false);
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 2, QUANT_GL_SHORT, true, 0, 0);
+        rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL);
+    }
+
+    rlDisableVertexArray();
+
+    quant->isGpuCompact = true;
+}
+
+QuantModel QuantizeModel(Model* model)
+{
+    QuantModel quant = { 0 };
+
+    quant.meshCount = model->meshCount;
+    quant.meshes = (QuantMesh*)RL_CALLOC(model->meshCount, sizeof(QuantMesh));
+
+    int quantizedCount = 0;
+
+    for (int i = 0; i < model->meshCount; i++)
+    {
+        Mesh* mesh = &model->meshes[i];
+        QuantMesh* q = &quant.meshes[i];
+
+        q->vertexCount = mesh->vertexCount;
+
+        // Skinned meshes are re-uploaded as floats by UpdateModelAnimation()
+        if ((mesh->vertices == NULL) || (mesh->boneIds != NULL) || (mesh->animVertices != NULL)) continue;
+
+        const int vertexCount = mesh->vertexCount;
+
+        // Bounds define the dequantization transform
+        Vector3 min = { mesh->vertices[0], mesh->vertices[1], mesh->vertices[2] };
+        Vector3 max = min;
+
+        for (int v = 1; v < vertexCount; v++)
+        {
+            const float* p = &mesh->vertices[v*3];
+
+            min.x = fminf(min.x, p[0]); max.x = fmaxf(max.x, p[0]);
+            min.y = fminf(min.y, p[1]); max.y = fmaxf(max.y, p[1]);
+            min.z = fminf(min.z, p[2]); max.z = fmaxf(max.z, p[2]);
+        }
+
+        q->offset = (Vector3){ (min.x + max.x)*0.5f, (min.y + max.y)*0.5f, (min.z + max.z)*0.5f };
+        q->scale  = (Vector3){ (max.x - min.x)*0.5f, (max.y - min.y)*0.5f, (max.z - min.z)*0.5f };
+
+        // Flat axis, any scale maps back to the offset
+        if (q->scale.x <= 0.0f) q->scale.x = 1.0f;
+        if (q->scale.y <= 0.0f) q->scale.y = 1.0f;
+        if (q->scale.z <= 0.0f) q->scale.z = 1.0f;
+
+        q->positions = (short*)RL_MALLOC(vertexCount*4*sizeof(short));
+
+        for (int v = 0; v < vertexCount; v++)
+        {
+            const float* p = &mesh->vertices[v*3];
+
+            q->positions[v*4 + 0] = FloatToSnorm16((p[0] - q->offset.x)/q->scale.x);
+            q->positions[v*4 + 1] = FloatToSnorm16((p[1] - q->offset.y)/q->scale.y);
+            q->positions[v*4 + 2] = FloatToSnorm16((p[2] - q->offset.z)/q->scale.z);
+            q->positions[v*4 + 3] = 0;
+        }
+
+        size_t floatStride = 3*sizeof(float);
+        size_t compactStride = 4*sizeof(short);
+
+        if (mesh->normals != NULL)
+        {
+            q->normals = (short*)RL_MALLOC(vertexCount*2*sizeof(short));
+
+            for (int v = 0; v < vertexCount; v++)
+            {
+                const float* n = &mesh->normals[v*3];
+                OctEncode((Vector3){ n[0], n[1], n[2] }, &q->normals[v*2]);
+            }
+
+            floatStride += 3*sizeof(float);
+            compactStride += 2*sizeof(short);
+        }
+
+        if (mesh->texcoords != NULL)
+        {
+            q->texcoords = (unsigned short*)RL_MALLOC(vertexCount*2*sizeof(unsigned short));
+
+            for (int v = 0; v < vertexCount*2; v++)
+            {
+                q->texcoords[v] = FloatToHalf(mesh->texcoords[v]);
+            }
+
+            floatStride += 2*sizeof(float);
+            compactStride += 2*sizeof(unsigned short);
+        }
+
+        q->isQuantized = true;
+        quantizedCount++;
+
+        quant.floatBytes += floatStride*vertexCount;
+        quant.compactBytes += compactStride*vertexCount;
+
+        // Without a VAO DrawMesh() rebinds the buffers as floats, keep the GPU copy as it is
+        if (mesh->vaoId > 0) UploadQuantMesh(mesh, q);
+
+        // CPU copies now live in the compact arrays only, the float ones were allocated by raylib
+        MemFree(mesh->vertices);
+        MemFree(mesh->normals);
+        MemFree(mesh->texcoords);
+        mesh->vertices = NULL;
+        mesh->normals = NULL;
+        mesh->texcoords = NULL;
+    }
+
+    // Same bytes are saved on the CPU side and, for meshes with a VAO, on the GPU side
+    TraceLog(LOG_INFO, "QUANT: %d/%d meshes quantized, vertex data %.1f KB float -> %.1f KB compact (%.1f%%)",
+        quantizedCount, model->meshCount, quant.floatBytes/1024.0f, quant.compactBytes/1024.0f,
+        (quant.floatBytes > 0) ? 100.0f*quant.compactBytes/quant.floatBytes : 100.0f);
+
+    return quant;
+}
+
+void UnloadQuantModel(QuantModel quant)
+{
+    for (int i = 0; i < quant.meshCount; i++)
+    {
+        RL_FREE(quant.meshes[i].positions);
+        RL_FREE(quant.meshes[i].normals);
+        RL_FREE(quant.meshes[i].texcoords);
+    }
+
+    RL_FREE(quant.meshes);
+}
+
+//----------------------------------------------------------------
+
+// Returns transform*dequantization, the matrix to draw a compact GPU mesh with
+Matrix GetQuantMeshMatrix(QuantMesh mesh, Matrix transform)
+{
+    if (!mesh.isGpuCompact) return transform;
+
+    Matrix result = transform;
+    const Vector3 s = mesh.scale;
+    const Vector3 o = mesh.offset;
+
+    result.m0 = transform.m0*s.x; result.m4 = transform.m4*s.y; result.m8  = transform.m8*s.z;
+    result.m1 = transform.m1*s.x; result.m5 = transform.m5*s.y; result.m9  = transform.m9*s.z;
+    result.m2 = transform.m2*s.x; result.m6 = transform.m6*s.y; result.m10 = transform.m10*s.z;
+    result.m3 = transform.m3*s.x; result.m7 = transform.m7*s.y; result.m11 = transform.m11*s.z;
+
+    result.m12 = transform.m0*o.x + transform.m4*o.y + transform.m8*o.z + transform.m12;
+    result.m13 = transform.m1*o.x + transform.m5*o.y + transform.m9*o.z + transform.m13;
+    result.m14 = transform.m2*o.x + transform.m6*o.y + transform.m10*o.z + transform.m14;
+    result.m15 = transform.m3*o.x + transform.m7*o.y + transform.m11*o.z + transform.m15;
+
+    return result;
+}
+
+Vector3 GetQuantMeshVertex(QuantMesh mesh, int index)
+{
+    const short* q = &mesh.positions[index*4];
+
+    return (Vector3)
+    {
+        mesh.offset.x + mesh.scale.x*Snorm16ToFloat(q[0]),
+        mesh.offset.y + mesh.scale.y*Snorm16ToFloat(q[1]),
+        mesh.offset.z + mesh.scale.z*Snorm16ToFloat(q[2])
+    };
+}
+
+Vector3 GetQuantMeshNormal(QuantMesh mesh, int index)
+{
+    if (mesh.normals == NULL) return (Vector3){ 0.0f, 0.0f, 1.0f };
+
+    return OctDecode(mesh.normals[index*2], mesh.normals[index*2 + 1]);
+}
+
+void DrawQuantModel(Model model, QuantModel quant)
+{
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        Matrix transform = (i < quant.meshCount) ? GetQuantMeshMatrix(quant.meshes[i], model.transform) : model.transform;
+
+        DrawMesh(model.meshes[i], model.materials[model.meshMaterial[i]], transform);
+    }
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************************
+*
+*   quant - Compact vertex storage for loaded models
+*
+*   Static meshes are converted after LoadModel() to a 16 bytes per vertex layout:
+*       - positions: 16-bit normalized integers (xyz + pad) with a per-mesh dequantization transform
+*       - normals:   octahedral encoding, two 16-bit normalized integers
+*       - texcoords: half floats
+*
+*   The compact arrays replace the float copies kept by raylib on the CPU side and, when the
+*   mesh has a vertex array object, the GPU buffers too. Skinned meshes stay in float format
+*   because UpdateModelAnimation() reads and re-uploads float vertex data.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef QUANT_H
+#define QUANT_H
+
+#include "raylib.h"
+
+#include <stddef.h>
+
+typedef struct
+{
+    int vertexCount;
+
+    short* positions;           // xyzw snorm16, w unused (keeps 8 byte stride)
+    short* normals;             // Octahedral xy snorm16
+    unsigned short* texcoords;  // uv half float
+
+    Vector3 offset;             // Dequantization: position = offset + scale*q
+    Vector3 scale;
+
+    bool isQuantized;           // False for meshes kept in float format (skinned)
+    bool isGpuCompact;          // GPU buffers use the compact layout
+} QuantMesh;
+
+typedef struct
+{
+    int meshCount;
+    QuantMesh* meshes;
+
+    size_t floatBytes;          // Vertex bytes of the quantized meshes in float format
+    size_t compactBytes;        // Same vertices in the compact format
+} QuantModel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+QuantModel QuantizeModel(Model* model);
+void UnloadQuantModel(QuantModel quant);
+
+Matrix GetQuantMeshMatrix(QuantMesh mesh, Matrix transform);
+Vector3 GetQuantMeshVertex(QuantMesh mesh, int index);
+Vector3 GetQuantMeshNormal(QuantMesh mesh, int index);
+
+void DrawQuantModel(Model model, QuantModel quant);
+
+unsigned short FloatToHalf(float value);
+float HalfToFloat(unsigned short value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUANT_H
@@ -0,0 +1,348 @@
+/*******************************************************************************************
+*
+*   scene - glTF node hierarchy with cached transforms and dirty flag propagation
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "scene.h"
+#include "vmath.h"
+#include "glb.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------
+
+static const Matrix matrixIdentity = { 1.0f, 0.0f, 0.0f, 0.0f,
+                                       0.0f, 1.0f, 0.0f, 0.0f,
+                                       0.0f, 0.0f, 1.0f, 0.0f,
+                                       0.0f, 0.0f, 0.0f, 1.0f };
+
+//----------------------------------------------------------------
+
+
+static float Vector3Length(Vector3 v)
+{
+    return sqrtf(v.x*v.x + v.y*v.y + v.z*v.z);
+}
+
+// Splits a column major glTF matrix into translation, rotation and scale (no shear)
+static void DecomposeNodeMatrix(const float* f, Vector3* translation, Quaternion* rotation, Vector3* scale)
+{
+    Vector3 c0 = { f[0], f[1], f[2] };
+    Vector3 c1 = { f[4], f[5], f[6] };
+    Vector3 c2 = { f[8], f[9], f[10] };
+
+    *translation = (Vector3){ f[12], f[13], f[14] };
+    *scale = (Vector3){ Vector3Length(c0), Vector3Length(c1), Vector3Length(c2) };
+    *rotation = (Quaternion){ 0.0f, 0.0f, 0.0f, 1.0f };
+
+    if ((scale->x == 0.0f) || (scale->y == 0.0f) || (scale->z == 0.0f)) return;
+
+    // A mirrored basis keeps the flip in the scale, the rotation must stay proper
+    const float det = c0.x*(c1.y*c2.z - c1.z*c2.y) - c0.y*(c1.x*c2.z - c1.z*c2.x) + c0.z*(c1.x*c2.y - c1.y*c2.x);
+    if (det < 0.0f) scale->x = -scale->x;
+
+    Matrix basis = matrixIdentity;
+    basis.m0 = c0.x/scale->x; basis.m1 = c0.y/scale->x; basis.m2  = c0.z/scale->x;
+    basis.m4 = c1.x/scale->y; basis.m5 = c1.y/scale->y; basis.m6  = c1.z/scale->y;
+    basis.m8 = c2.x/scale->z; basis.m9 = c2.y/scale->z; basis.m10 = c2.z/scale->z;
+
+    *rotation = QuaternionFromMatrix(basis);
+}
+
+// Appends a node and its children in depth-first order
+static void AddSceneNode(SceneGraph* graph, NameTable* names, const cgltf_data* data, const cgltf_node* node, int parent)
+{
+    const int index = graph->nodeCount++;
+    const int gltfNode = (int)(node - data->nodes);
+
+    graph->parents[index] = parent;
+    graph->gltfNodes[index] = gltfNode;
+    graph->gltfToNode[gltfNode] = index;
+    graph->nameIds[index] = InternName(names, (node->name != NULL) ? node->name : TextFormat("Node %d", gltfNode));
+    graph->names[index] = GetNameString(names, graph->nameIds[index]);
+
+    Vector3 translation = { 0.0f, 0.0f, 0.0f };
+    Quaternion rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    Vector3 scale = { 1.0f, 1.0f, 1.0f };
+
+    if (node->has_matrix)
+    {
+        DecomposeNodeMatrix(node->matrix, &translation, &rotation, &scale);
+    }
+    else
+    {
+        if (node->has_translation) translation = (Vector3){ node->translation[0], node->translation[1], node->translation[2] };
+        if (node->has_rotation) rotation = (Quaternion){ node->rotation[0], node->rotation[1], node->rotation[2], node->rotation[3] };
+        if (node->has_scale) scale = (Vector3){ node->scale[0], node->scale[1], node->scale[2] };
+    }
+
+    graph->translations[index] = graph->restTranslations[index] = translation;
+    graph->rotations[index] = graph->restRotations[index] = rotation;
+    graph->scales[index] = graph->restScales[index] = scale;
+
+    for (cgltf_size i = 0; i < node->children_count; i++)
+    {
+        AddSceneNode(graph, names, data, node->children[i], index);
+    }
+
+    graph->subtreeEnds[index] = graph->nodeCount;
+}
+
+static void MarkSceneNodeDirty(SceneGraph* graph, int node)
+{
+    if (graph->isDirty[node]) return;
+
+    graph->isDirty[node] = true;
+    graph->dirtyNodes[graph->dirtyCount++] = node;
+}
+
+static int CompareNodeIndex(const void* a, const void* b)
+{
+    const int ia = *(const int*)a;
+    const int ib = *(const int*)b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+//----------------------------------------------------------------
+
+SceneGraph LoadSceneGraph(const char* fileName, Arena* arena, NameTable* names)
+{
+    SceneGraph graph = { 0 };
+
+    cgltf_data* data = NULL;
+
+    if (IsFileExtension(fileName, ".glb"))
+    {
+        // Node transforms are in the JSON chunk, the BIN chunk is not read
+        GlbFile glb = OpenGlbFile(fileName);
+        data = ParseGlbJson(&glb);
+        CloseGlbFile(&glb);
+    }
+    else
+    {
+        cgltf_options options = { cgltf_file_type_invalid };
+        if (cgltf_parse_file(&options, fileName, &data) != cgltf_result_success) data = NULL;
+    }
+
+    if (data == NULL) TraceLog(LOG_WARNING, "SCENE: [%s] Failed to parse node graph", fileName);
+
+    const int gltfNodeCount = (data != NULL) ? (int)data->nodes_count : 0;
+    const int capacity = gltfNodeCount + 1;
+
+    graph.parents = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+    graph.subtreeEnds = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+    graph.gltfNodes = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+    graph.nameIds = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+    graph.names = (const char**)ArenaAlloc(arena, capacity*sizeof(char*));
+    graph.gltfNodeCount = gltfNodeCount;
+    graph.gltfToNode = (int*)ArenaAlloc(arena, ((gltfNodeCount > 0) ? gltfNodeCount : 1)*sizeof(int));
+
+    graph.translations = (Vector3*)ArenaAlloc(arena, capacity*sizeof(Vector3));
+    graph.rotations = (Quaternion*)ArenaAlloc(arena, capacity*sizeof(Quaternion));
+    graph.scales = (Vector3*)ArenaAlloc(arena, capacity*sizeof(Vector3));
+    graph.restTranslations = (Vector3*)ArenaAlloc(arena, capacity*sizeof(Vector3));
+    graph.restRotations = (Quaternion*)ArenaAlloc(arena, capacity*sizeof(Quaternion));
+    graph.restScales = (Vector3*)ArenaAlloc(arena, capacity*sizeof(Vector3));
+
+    graph.locals = (Matrix*)ArenaAlloc(arena, capacity*sizeof(Matrix));
+    graph.worlds = (Matrix*)ArenaAlloc(arena, capacity*sizeof(Matrix));
+
+    graph.isDirty = (bool*)ArenaAlloc(arena, capacity*sizeof(bool));
+    graph.dirtyNodes = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+    graph.isChanged = (bool*)ArenaAlloc(arena, capacity*sizeof(bool));
+    graph.changedNodes = (int*)ArenaAlloc(arena, capacity*sizeof(int));
+
+    graph.scratchRotations = (Quaternion*)ArenaAlloc(arena, capacity*sizeof(Quaternion));
+    graph.scratchMatrices = (Matrix*)ArenaAlloc(arena, capacity*sizeof(Matrix));
+
+    for (int i = 0; i < gltfNodeCount; i++) graph.gltfToNode[i] = -1;
+
+    // Root node, carries the viewer transform
+    graph.nodeCount = 1;
+    graph.parents[SCENE_ROOT] = -1;
+    graph.gltfNodes[SCENE_ROOT] = -1;
+    graph.nameIds[SCENE_ROOT] = InternName(names, GetFileName(fileName));
+    graph.names[SCENE_ROOT] = GetNameString(names, graph.nameIds[SCENE_ROOT]);
+    graph.translations[SCENE_ROOT] = graph.restTranslations[SCENE_ROOT] = (Vector3){ 0.0f, 0.0f, 0.0f };
+    graph.rotations[SCENE_ROOT] = graph.restRotations[SCENE_ROOT] = (Quaternion){ 0.0f, 0.0f, 0.0f, 1.0f };
+    graph.scales[SCENE_ROOT] = graph.restScales[SCENE_ROOT] = (Vector3){ 1.0f, 1.0f, 1.0f };
+    graph.rootScale = (Vector3){ 1.0f, 1.0f, 1.0f };
+
+    if (data != NULL)
+    {
+        // Same roots as LoadInstanceScene()
+        if (data->scene != NULL)
+        {
+            for (cgltf_size i = 0; i < data->scene->nodes_count; i++) AddSceneNode(&graph, names, data, data->scene->nodes[i], SCENE_ROOT);
+        }
+        else
+        {
+            for (cgltf_size i = 0; i < data->nodes_count; i++)
+            {
+                if (data->nodes[i].parent == NULL) AddSceneNode(&graph, names, data, &data->nodes[i], SCENE_ROOT);
+            }
+        }
+
+        UnloadGlbData(data);
+    }
+
+    graph.subtreeEnds[SCENE_ROOT] = graph.nodeCount;
+
+    // First update builds every matrix
+    for (int i = 0; i < graph.nodeCount; i++) MarkSceneNodeDirty(&graph, i);
+    UpdateSceneGraph(&graph);
+
+    TraceLog(LOG_INFO, "SCENE: [%s] %d nodes in the hierarchy", fileName, graph.nodeCount - 1);
+
+    return graph;
+}
+
+//----------------------------------------------------------------
+
+void SetSceneRootTransform(SceneGraph* graph, Vector3 position, Vector3 rotation, Vector3 scale)
+{
+    if (graph->nodeCount == 0) return;
+
+    if ((memcmp(&position, &graph->rootPosition, sizeof(Vector3)) == 0) &&
+        (memcmp(&rotation, &graph->rootRotation, sizeof(Vector3)) == 0) &&
+        (memcmp(&scale, &graph->rootScale, sizeof(Vector3)) == 0)) return;
+
+    graph->rootPosition = position;
+    graph->rootRotation = rotation;
+    graph->rootScale = scale;
+
+    MarkSceneNodeDirty(graph, SCENE_ROOT);
+}
+
+void SetSceneNodeTransform(SceneGraph* graph, int node, Vector3 translation, Quaternion rotation, Vector3 scale)
+{
+    // The root is driven by SetSceneRootTransform()
+    if ((node <= SCENE_ROOT) || (node >= graph->nodeCount)) return;
+
+    if ((memcmp(&translation, &graph->translations[node], sizeof(Vector3)) == 0) &&
+        (memcmp(&rotation, &graph->rotations[node], sizeof(Quaternion)) == 0) &&
+        (memcmp(&scale, &graph->scales[node], sizeof(Vector3)) == 0)) return;
+
+    graph->translations[node] = translation;
+    graph->rotations[node] = rotation;
+    graph->scales[node] = scale;
+
+    MarkSceneNodeDirty(graph, node);
+}
+
+void ResetSceneNode(SceneGraph* graph, int node)
+{
+    if ((node <= SCENE_ROOT) || (node >= graph->nodeCount)) return;
+
+    SetSceneNodeTransform(graph, node, graph->restTranslations[node], graph->restRotations[node], graph->restScales[node]);
+}
+
+void UpdateSceneGraph(SceneGraph* graph)
+{
+    const double startTime = GetTime();
+
+    for (int i = 0; i < graph->changedCount; i++) graph->isChanged[graph->changedNodes[i]] = false;
+
+    graph->changedCount = 0;
+    graph->localCount = 0;
+
+    if (graph->dirtyCount == 0)
+    {
+        graph->updateTime = GetTime() - startTime;
+        return;
+    }
+
+    // Parents first, so a dirty node inside an already recomputed subtree can be skipped
+    qsort(graph->dirtyNodes, graph->dirtyCount, sizeof(int), CompareNodeIndex);
+
+    // Local matrices, rotations of every dirty node go through one batch call
+    int rotationCount = 0;
+    for (int i = 0; i < graph->dirtyCount; i++)
+    {
+        const int node = graph->dirtyNodes[i];
+        if (node != SCENE_ROOT) graph->scratchRotations[rotationCount++] = graph->rotations[node];
+    }
+
+    QuaternionToMatrixBatch(graph->scratchMatrices, graph->scratchRotations, rotationCount);
+
+    rotationCount = 0;
+    for (int i = 0; i < graph->dirtyCount; i++)
+    {
+        const int node = graph->dirtyNodes[i];
+
+        if (node == SCENE_ROOT)
+        {
+            graph->locals[node] = MatrixMultiply(MatrixTranslateV(graph->rootPosition), MatrixMultiply(MatrixRotateV(graph->rootRotation), MatrixScaleV(graph->rootScale)));
+        }
+        else
+        {
+            // Translation*rotation*scale, the scale multiplies the rotation columns
+            Matrix local = graph->scratchMatrices[rotationCount++];
+            const Vector3 s = graph->scales[node];
+            const Vector3 t = graph->translations[node];
+
+            local.m0 *= s.x; local.m1 *= s.x; local.m2  *= s.x;
+            local.m4 *= s.y; local.m5 *= s.y; local.m6  *= s.y;
+            local.m8 *= s.z; local.m9 *= s.z; local.m10 *= s.z;
+            local.m12 = t.x; local.m13 = t.y; local.m14 = t.z;
+
+            graph->locals[node] = local;
+        }
+
+        graph->localCount++;
+    }
+
+    // World matrices of each dirty subtree
+    int coveredEnd = 0;
+    for (int i = 0; i < graph->dirtyCount; i++)
+    {
+        const int node = graph->dirtyNodes[i];
+        graph->isDirty[node] = false;
+
+        if (node == SCENE_ROOT)
+        {
+            // glTF worlds are model space, the root does not propagate
+            graph->worlds[SCENE_ROOT] = graph->locals[SCENE_ROOT];
+            graph->isChanged[SCENE_ROOT] = true;
+            graph->changedNodes[graph->changedCount++] = SCENE_ROOT;
+            continue;
+        }
+
+        if (node < coveredEnd) continue;
+
+        coveredEnd = graph->subtreeEnds[node];
+
+        for (int k = node; k < coveredEnd; k++)
+        {
+            const int parent = graph->parents[k];
+
+            graph->worlds[k] = (parent == SCENE_ROOT) ? graph->locals[k] : MatrixMultiply(graph->worlds[parent], graph->locals[k]);
+            graph->isChanged[k] = true;
+            graph->changedNodes[graph->changedCount++] = k;
+        }
+    }
+
+    graph->dirtyCount = 0;
+    graph->updateTime = GetTime() - startTime;
+}
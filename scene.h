@@ -0,0 +1,107 @@
+/*******************************************************************************************
+*
+*   scene - glTF node hierarchy with cached transforms and dirty flag propagation
+*
+*   Nodes are stored in depth-first order as parallel arrays (local TRS, local matrix, world
+*   matrix), so a parent always comes before its children and the subtree of node i is the
+*   range [i, subtreeEnds[i]). Editing a node marks it dirty, UpdateSceneGraph() rebuilds the
+*   local matrices of the edited nodes and the world matrices of their subtrees only.
+*
+*   Node 0 is the root and holds the viewer transform (position, rotation in degrees, scale).
+*   glTF node worlds are model space and do not include it, the root is applied when drawing,
+*   so moving the model recomputes a single matrix.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "raylib.h"
+#include "arena.h"
+#include "names.h"
+
+#define SCENE_ROOT      0
+
+typedef struct
+{
+    int nodeCount;              // glTF nodes reachable from the scene, plus the root
+    int* parents;               // -1 for the root
+    int* subtreeEnds;           // One past the last node of the subtree
+    int* gltfNodes;             // glTF node index, -1 for the root
+    int* nameIds;               // Interned in the table given at load
+    const char** names;         // Strings of nameIds
+
+    int gltfNodeCount;
+    int* gltfToNode;            // Scene node of each glTF node, -1 when not in the scene
+
+    // Local transform, rotations of glTF nodes are quaternions
+    Vector3* translations;
+    Quaternion* rotations;
+    Vector3* scales;
+
+    // Transform as loaded, for resets
+    Vector3* restTranslations;
+    Quaternion* restRotations;
+    Vector3* restScales;
+
+    Matrix* locals;
+    Matrix* worlds;             // Model space for glTF nodes, the viewer transform for the root
+
+    Vector3 rootPosition;
+    Vector3 rootRotation;       // Degrees
+    Vector3 rootScale;
+
+    bool* isDirty;              // Local transform edited since the last update
+    int* dirtyNodes;
+    int dirtyCount;
+
+    bool* isChanged;            // World recomputed by the last update
+    int* changedNodes;
+    int changedCount;
+
+    int localCount;             // Local matrices rebuilt by the last update
+    double updateTime;          // Seconds spent in the last update
+
+    Quaternion* scratchRotations;
+    Matrix* scratchMatrices;
+} SceneGraph;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only the JSON is read, a file without nodes gives a graph with the root alone
+// Every array comes from the arena, the graph is released with it
+// Node names go in the name table, the file name is the name of the root
+SceneGraph LoadSceneGraph(const char* fileName, Arena* arena, NameTable* names);
+
+// Marks nodes dirty when their values differ from the stored ones
+void SetSceneRootTransform(SceneGraph* graph, Vector3 position, Vector3 rotation, Vector3 scale);
+void SetSceneNodeTransform(SceneGraph* graph, int node, Vector3 translation, Quaternion rotation, Vector3 scale);
+void ResetSceneNode(SceneGraph* graph, int node);
+
+// Rebuilds the edited locals and the worlds below them, fills changedNodes
+void UpdateSceneGraph(SceneGraph* graph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCENE_H
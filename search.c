@@ -0,0 +1,305 @@
+/*******************************************************************************************
+*
+*   search - Incremental fuzzy search over a list of names
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "search.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------
+
+static char FoldChar(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+}
+
+// Letters and digits get a bit each, other bytes share the rest
+static unsigned long long GetCharMask(char c)
+{
+    const unsigned char u = (unsigned char)c;
+
+    if ((u >= 'a') && (u <= 'z')) return 1ULL << (u - 'a');
+    if ((u >= '0') && (u <= '9')) return 1ULL << (26 + u - '0');
+
+    return 1ULL << (36 + u%28);
+}
+
+// Names are short, plain loops beat the call overhead of strchr() and strncmp()
+static int FindSearchChar(const char* name, int from, char c)
+{
+    for (int i = from; name[i] != '\0'; i++)
+    {
+        if (name[i] == c) return i;
+    }
+
+    return -1;
+}
+
+// Start of the first run of the prefix at or after from, -1 when there is none
+static int FindSearchRun(const char* name, int from, const char* prefix, int length)
+{
+    for (int i = FindSearchChar(name, from, prefix[0]); i >= 0; i = FindSearchChar(name, i + 1, prefix[0]))
+    {
+        int j = 1;
+        while ((j < length) && (name[i + j] == prefix[j])) j++;
+
+        if (j == length) return i;
+    }
+
+    return -1;
+}
+
+static bool ReserveSearchMatches(SearchIndex* index, int capacity)
+{
+    if (capacity <= index->capacity) return true;
+
+    int* ids = (int*)RL_REALLOC(index->ids, capacity*sizeof(int));
+    if (ids != NULL) index->ids = ids;
+    int* runStarts = (int*)RL_REALLOC(index->runStarts, capacity*sizeof(int));
+    if (runStarts != NULL) index->runStarts = runStarts;
+    int* subsequenceEnds = (int*)RL_REALLOC(index->subsequenceEnds, capacity*sizeof(int));
+    if (subsequenceEnds != NULL) index->subsequenceEnds = subsequenceEnds;
+
+    if ((ids == NULL) || (runStarts == NULL) || (subsequenceEnds == NULL)) return false;
+
+    index->capacity = capacity;
+
+    return true;
+}
+
+// Builds level + 1 from level by matching one more query character
+static bool ExtendSearch(SearchIndex* index, int level)
+{
+    const SearchLevel previous = index->levels[level];
+    const int start = previous.start + previous.count;
+
+    if (!ReserveSearchMatches(index, start + previous.count)) return false;
+
+    char prefix[SEARCH_MAX_QUERY];
+    memcpy(prefix, index->query, level + 1);
+    prefix[level + 1] = '\0';
+
+    const char c = prefix[level];
+    const unsigned long long mask = GetCharMask(c);
+
+    int* ids = index->ids;
+    int* runStarts = index->runStarts;
+    int* subsequenceEnds = index->subsequenceEnds;
+    int* scratch = index->scratch;
+
+    int runCount = 0;
+    int fallbackCount = 0;
+
+    // Run matches continue when the next character follows the run, otherwise the run is searched again further on
+    for (int i = previous.start; i < previous.start + previous.runCount; i++)
+    {
+        const int id = ids[i];
+        if ((index->masks[id] & mask) == 0) continue;
+
+        const char* name = index->folded + index->offsets[id];
+        const int next = FindSearchChar(name, subsequenceEnds[i], c);
+        if (next < 0) continue;
+
+        // The first character runs from the first occurrence the subsequence already found
+        int run = runStarts[i];
+        if (level == 0) run = next;
+        else if (name[run + level] != c) run = FindSearchRun(name, run + 1, prefix, level + 1);
+
+        if (run >= 0)
+        {
+            const int out = start + runCount++;
+            ids[out] = id;
+            runStarts[out] = run;
+            subsequenceEnds[out] = next + 1;
+        }
+        else
+        {
+            scratch[2*fallbackCount] = id;
+            scratch[2*fallbackCount + 1] = next + 1;
+            fallbackCount++;
+        }
+    }
+
+    // Subsequence matches follow the runs, the fallbacks are merged in after them
+    const int subsequenceStart = start + runCount;
+    int subsequenceCount = 0;
+
+    for (int i = previous.start + previous.runCount; i < previous.start + previous.count; i++)
+    {
+        const int id = ids[i];
+        if ((index->masks[id] & mask) == 0) continue;
+
+        const int next = FindSearchChar(index->folded + index->offsets[id], subsequenceEnds[i], c);
+        if (next < 0) continue;
+
+        const int out = subsequenceStart + subsequenceCount++;
+        ids[out] = id;
+        runStarts[out] = -1;
+        subsequenceEnds[out] = next + 1;
+    }
+
+    // From the back, both lists are in name order and the free room is at the end
+    const int count = subsequenceStart + subsequenceCount + fallbackCount;
+    int a = fallbackCount - 1;
+    int b = subsequenceStart + subsequenceCount - 1;
+
+    for (int out = count - 1; a >= 0; out--)
+    {
+        if ((b >= subsequenceStart) && (ids[b] > scratch[2*a]))
+        {
+            ids[out] = ids[b];
+            subsequenceEnds[out] = subsequenceEnds[b];
+            b--;
+        }
+        else
+        {
+            ids[out] = scratch[2*a];
+            subsequenceEnds[out] = scratch[2*a + 1];
+            a--;
+        }
+
+        runStarts[out] = -1;
+    }
+
+    index->levels[level + 1].start = start;
+    index->levels[level + 1].count = count - start;
+    index->levels[level + 1].runCount = runCount;
+
+    return true;
+}
+
+//----------------------------------------------------------------
+
+SearchIndex LoadSearchIndex(const char** names, int count)
+{
+    SearchIndex index = { 0 };
+
+    size_t totalLength = 0;
+    for (int i = 0; i < count; i++) totalLength += strlen(names[i]) + 1;
+
+    index.nameCount = count;
+    index.folded = (char*)RL_MALLOC(totalLength + 1);
+    index.offsets = (int*)RL_MALLOC((count + 1)*sizeof(int));
+    index.masks = (unsigned long long*)RL_MALLOC((count + 1)*sizeof(unsigned long long));
+    index.scratch = (int*)RL_MALLOC((2*count + 1)*sizeof(int));
+
+    if ((index.folded == NULL) || (index.offsets == NULL) || (index.masks == NULL) || (index.scratch == NULL) || !ReserveSearchMatches(&index, 2*count + 1))
+    {
+        TraceLog(LOG_WARNING, "SEARCH: Failed to allocate an index of %d names", count);
+        UnloadSearchIndex(index);
+        return (SearchIndex){ 0 };
+    }
+
+    size_t offset = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned long long mask = 0;
+
+        index.offsets[i] = (int)offset;
+
+        for (const char* c = names[i]; *c != '\0'; c++)
+        {
+            const char folded = FoldChar(*c);
+
+            index.folded[offset++] = folded;
+            mask |= GetCharMask(folded);
+        }
+
+        index.folded[offset++] = '\0';
+        index.masks[i] = mask;
+
+        // Level 0 is the empty query, every name matches at its start
+        index.ids[i] = i;
+        index.runStarts[i] = 0;
+        index.subsequenceEnds[i] = 0;
+    }
+
+    index.levels[0].count = count;
+    index.levels[0].runCount = count;
+
+    index.results = index.ids;
+    index.resultCount = count;
+    index.runCount = count;
+
+    return index;
+}
+
+void UnloadSearchIndex(SearchIndex index)
+{
+    RL_FREE(index.folded);
+    RL_FREE(index.offsets);
+    RL_FREE(index.masks);
+    RL_FREE(index.scratch);
+    RL_FREE(index.ids);
+    RL_FREE(index.runStarts);
+    RL_FREE(index.subsequenceEnds);
+}
+
+bool UpdateSearch(SearchIndex* index, const char* query)
+{
+    char folded[SEARCH_MAX_QUERY];
+    int length = 0;
+
+    while ((query[length] != '\0') && (length < SEARCH_MAX_QUERY - 1))
+    {
+        folded[length] = FoldChar(query[length]);
+        length++;
+    }
+
+    folded[length] = '\0';
+
+    if ((length == index->queryLength) && (memcmp(folded, index->query, length) == 0)) return false;
+    if (index->ids == NULL) return false;
+
+    const double startTime = GetTime();
+
+    // Levels up to the common prefix are still valid
+    int common = 0;
+    while ((common < length) && (common < index->queryLength) && (folded[common] == index->query[common])) common++;
+
+    memcpy(index->query, folded, length + 1);
+    index->queryLength = common;
+
+    for (int level = common; level < length; level++)
+    {
+        if (!ExtendSearch(index, level))
+        {
+            TraceLog(LOG_WARNING, "SEARCH: Failed to grow the match stack");
+            break;
+        }
+
+        index->queryLength = level + 1;
+    }
+
+    const SearchLevel top = index->levels[index->queryLength];
+
+    index->results = index->ids + top.start;
+    index->resultCount = top.count;
+    index->runCount = top.runCount;
+    index->updateTime = GetTime() - startTime;
+
+    return true;
+}
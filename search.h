@@ -0,0 +1,87 @@
+/*******************************************************************************************
+*
+*   search - Incremental fuzzy search over a list of names
+*
+*   A name matches when the query is a subsequence of it, ignoring case. Names that contain
+*   the query as one run come first, each group in list order. Every name has a 64 bit mask
+*   of the character classes it contains, a name missing one of the query characters is
+*   rejected by one AND before its text is read.
+*
+*   Results are kept as a stack with one level per query character, every level holds the
+*   matches of that prefix with the match positions. Typing a character filters the level
+*   below it and only moves each match forward from where it stopped, deleting one pops a
+*   level. Editing in the middle pops to the common prefix and refilters from there.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "raylib.h"
+
+#define SEARCH_MAX_QUERY    64
+
+typedef struct
+{
+    int start;                  // First match in the stack
+    int count;
+    int runCount;               // The first runCount matches contain the query as one run
+} SearchLevel;
+
+typedef struct
+{
+    int nameCount;
+    char* folded;               // Lowercase names, null terminated one after another
+    int* offsets;               // Start of each name in folded
+    unsigned long long* masks;  // Character classes of each name
+
+    char query[SEARCH_MAX_QUERY];   // Lowercase query the top level was built for
+    int queryLength;
+
+    // Match stack, level n holds the matches of the first n query characters
+    SearchLevel levels[SEARCH_MAX_QUERY + 1];
+    int* ids;
+    int* runStarts;             // Start of the first run of the query, -1 when there is none
+    int* subsequenceEnds;       // One past the last character of the leftmost subsequence
+    int capacity;
+
+    int* scratch;               // Matches that fell back to subsequence, merged in list order
+
+    const int* results;         // Names matching the query, valid until the next update
+    int resultCount;
+    int runCount;               // Results matching as one run, they come first
+    double updateTime;          // Seconds spent in the last update
+} SearchIndex;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SearchIndex LoadSearchIndex(const char** names, int count);
+void UnloadSearchIndex(SearchIndex index);
+
+// Returns true when the results changed, an unchanged query does no work
+bool UpdateSearch(SearchIndex* index, const char* query);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEARCH_H
@@ -0,0 +1,693 @@
+/*******************************************************************************************
+*
+*   thumbnails - Shaded .glb thumbnails rendered on worker threads
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "thumbnails.h"
+#include "glb.h"
+#include "trace.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_UI
+#include "memtrack.h"
+
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <direct.h>         // Required for: _mkdir()
+    #define MAKE_DIRECTORY(path) _mkdir(path)
+#else
+    #include <sys/stat.h>       // Required for: mkdir()
+    #include <unistd.h>         // Required for: sysconf()
+    #define MAKE_DIRECTORY(path) mkdir(path, 0755)
+#endif
+
+#define THUMBNAIL_RENDER_SIZE   (THUMBNAIL_SIZE*2)
+#define THUMBNAIL_CACHE_MAGIC   0x54424C47      // "GLBT"
+#define THUMBNAIL_CACHE_VERSION 1               // Bump when the rendering changes
+
+struct ThumbnailJobs
+{
+    pthread_t threads[THUMBNAIL_MAX_THREADS];
+    int threadCount;
+    pthread_mutex_t mutex;
+
+    bool isCancelled;           // Written under the lock, workers poll it with atomic loads while rendering
+
+    int count;
+    char** paths;               // Owned copies, NULL for entries that get no thumbnail
+    int nextJob;
+
+    unsigned char** pixels;     // Finished RGBA pixels waiting for upload, NULL when failed
+    bool* isCached;
+    int* finished;              // Indices in completion order
+    int finishedCount;
+    int uploadedCount;
+
+    char cacheDirectory[512];
+};
+
+typedef struct
+{
+    float* depth;
+    float* color;               // RGB
+    float* coverage;
+    Vector3 right;
+    Vector3 up;
+    Vector3 forward;
+    Vector3 center;
+    float scale;
+} ThumbnailTarget;
+
+//----------------------------------------------------------------
+
+static Vector3 Vec3Sub(Vector3 a, Vector3 b) { return (Vector3){ a.x - b.x, a.y - b.y, a.z - b.z }; }
+static Vector3 Vec3Cross(Vector3 a, Vector3 b) { return (Vector3){ a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x }; }
+static float Vec3Dot(Vector3 a, Vector3 b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+
+static Vector3 Vec3Normalize(Vector3 v)
+{
+    float length = sqrtf(Vec3Dot(v, v));
+    if (length > 0.0f) v = (Vector3){ v.x/length, v.y/length, v.z/length };
+
+    return v;
+}
+
+// Column major glTF matrix
+static Vector3 TransformPoint(const float* m, Vector3 v)
+{
+    return (Vector3){
+        m[0]*v.x + m[4]*v.y + m[8]*v.z + m[12],
+        m[1]*v.x + m[5]*v.y + m[9]*v.z + m[13],
+        m[2]*v.x + m[6]*v.y + m[10]*v.z + m[14]
+    };
+}
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i])*0x100000001b3ull;
+
+    return hash;
+}
+
+//----------------------------------------------------------------
+// Disk cache
+
+static void InitCacheDirectory(char* directory, size_t size)
+{
+    char base[400] = { 0 };
+
+#if defined(_WIN32)
+    const char* localAppData = getenv("LOCALAPPDATA");
+    if (localAppData != NULL) snprintf(base, sizeof(base), "%s", localAppData);
+#else
+    const char* cacheHome = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    if ((cacheHome != NULL) && (cacheHome[0] != '\0')) snprintf(base, sizeof(base), "%s", cacheHome);
+    else if (home != NULL)
+    {
+        snprintf(base, sizeof(base), "%s/.cache", home);
+        MAKE_DIRECTORY(base);
+    }
+#endif
+
+    if (base[0] == '\0')
+    {
+        snprintf(directory, size, ".thumbnails");
+        MAKE_DIRECTORY(directory);
+        return;
+    }
+
+    snprintf(directory, size, "%s/glb-viewer", base);
+    MAKE_DIRECTORY(directory);
+
+    snprintf(directory, size, "%s/glb-viewer/thumbnails", base);
+    MAKE_DIRECTORY(directory);
+}
+
+static unsigned char* LoadCachedThumbnail(const char* fileName)
+{
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+
+    unsigned int header[2] = { 0 };
+    unsigned char* pixels = NULL;
+
+    if ((fread(header, sizeof(header), 1, file) == 1) && (header[0] == THUMBNAIL_CACHE_MAGIC) && (header[1] == THUMBNAIL_SIZE))
+    {
+        pixels = (unsigned char*)MemTrackAlloc(MEMORY_TEXTURES_CPU, THUMBNAIL_SIZE*THUMBNAIL_SIZE*4);
+
+        if (fread(pixels, THUMBNAIL_SIZE*THUMBNAIL_SIZE*4, 1, file) != 1)
+        {
+            MemTrackFree(MEMORY_TEXTURES_CPU, pixels);
+            pixels = NULL;
+        }
+    }
+
+    fclose(file);
+
+    return pixels;
+}
+
+static void SaveCachedThumbnail(const char* fileName, const unsigned char* pixels)
+{
+    // Write aside and rename, a reader never sees a half written file
+    char tempName[600] = { 0 };
+    snprintf(tempName, sizeof(tempName), "%s.%p.tmp", fileName, (const void*)pixels);
+
+    FILE* file = fopen(tempName, "wb");
+    if (file == NULL) return;
+
+    const unsigned int header[2] = { THUMBNAIL_CACHE_MAGIC, THUMBNAIL_SIZE };
+
+    bool isWritten = (fwrite(header, sizeof(header), 1, file) == 1) && (fwrite(pixels, THUMBNAIL_SIZE*THUMBNAIL_SIZE*4, 1, file) == 1);
+    isWritten = (fclose(file) == 0) && isWritten;
+
+    if (!isWritten || (rename(tempName, fileName) != 0)) remove(tempName);
+}
+
+//----------------------------------------------------------------
+// Rasterizer
+
+static void RasterizeThumbnailTriangle(ThumbnailTarget* target, Vector3 p0, Vector3 p1, Vector3 p2, Vector3 albedo)
+{
+    // Flat shading, two sided so open meshes don't show holes
+    Vector3 normal = Vec3Normalize(Vec3Cross(Vec3Sub(p1, p0), Vec3Sub(p2, p0)));
+    if (Vec3Dot(normal, target->forward) > 0.0f) normal = (Vector3){ -normal.x, -normal.y, -normal.z };
+
+    const Vector3 light = { 0.4f, 0.8f, 0.45f };
+    const float intensity = 0.3f + 0.7f*fmaxf(0.0f, Vec3Dot(normal, Vec3Normalize(light)));
+    const Vector3 shade = { albedo.x*intensity, albedo.y*intensity, albedo.z*intensity };
+
+    // Orthographic projection, y down
+    const float half = THUMBNAIL_RENDER_SIZE*0.5f;
+    Vector3 s[3] = { 0 };
+    const Vector3 p[3] = { p0, p1, p2 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        const Vector3 d = Vec3Sub(p[i], target->center);
+
+        s[i] = (Vector3){
+            half + Vec3Dot(d, target->right)*target->scale,
+            half - Vec3Dot(d, target->up)*target->scale,
+            Vec3Dot(d, target->forward)
+        };
+    }
+
+    float area = (s[1].x - s[0].x)*(s[2].y - s[0].y) - (s[2].x - s[0].x)*(s[1].y - s[0].y);
+    if (fabsf(area) < 1e-8f) return;
+
+    if (area < 0.0f)
+    {
+        Vector3 tmp = s[1]; s[1] = s[2]; s[2] = tmp;
+        area = -area;
+    }
+
+    int minX = (int)floorf(fminf(s[0].x, fminf(s[1].x, s[2].x)));
+    int maxX = (int)ceilf(fmaxf(s[0].x, fmaxf(s[1].x, s[2].x)));
+    int minY = (int)floorf(fminf(s[0].y, fminf(s[1].y, s[2].y)));
+    int maxY = (int)ceilf(fmaxf(s[0].y, fmaxf(s[1].y, s[2].y)));
+
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > THUMBNAIL_RENDER_SIZE - 1) maxX = THUMBNAIL_RENDER_SIZE - 1;
+    if (maxY > THUMBNAIL_RENDER_SIZE - 1) maxY = THUMBNAIL_RENDER_SIZE - 1;
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            const float px = (float)x + 0.5f;
+            const float py = (float)y + 0.5f;
+
+            const float w0 = (s[2].x - s[1].x)*(py - s[1].y) - (s[2].y - s[1].y)*(px - s[1].x);
+            const float w1 = (s[0].x - s[2].x)*(py - s[2].y) - (s[0].y - s[2].y)*(px - s[2].x);
+            const float w2 = (s[1].x - s[0].x)*(py - s[0].y) - (s[1].y - s[0].y)*(px - s[0].x);
+
+            if ((w0 < 0.0f) || (w1 < 0.0f) || (w2 < 0.0f)) continue;
+
+            const float depth = (w0*s[0].z + w1*s[1].z + w2*s[2].z)/area;
+            const int index = y*THUMBNAIL_RENDER_SIZE + x;
+
+            if (depth < target->depth[index])
+            {
+                target->depth[index] = depth;
+                target->color[index*3] = shade.x;
+                target->color[index*3 + 1] = shade.y;
+                target->color[index*3 + 2] = shade.z;
+                target->coverage[index] = 1.0f;
+            }
+        }
+    }
+}
+
+// POSITION accessor of a triangle primitive, NULL for other primitives
+static const cgltf_accessor* GetPrimitivePositions(const cgltf_primitive* primitive)
+{
+    if (primitive->type != cgltf_primitive_type_triangles) return NULL;
+
+    for (cgltf_size i = 0; i < primitive->attributes_count; i++)
+    {
+        if ((primitive->attributes[i].type == cgltf_attribute_type_position) && (primitive->attributes[i].data->buffer_view != NULL)) return primitive->attributes[i].data;
+    }
+
+    return NULL;
+}
+
+// Reads the position and index buffer views, the only bytes of the BIN chunk a thumbnail needs
+static bool LoadPrimitiveBuffers(GlbFile* glb, const cgltf_primitive* primitive, const cgltf_accessor* positions)
+{
+    if (!LoadGlbBufferView(glb, positions->buffer_view)) return false;
+
+    if (primitive->indices != NULL)
+    {
+        if ((primitive->indices->buffer_view == NULL) || !LoadGlbBufferView(glb, primitive->indices->buffer_view)) return false;
+    }
+
+    return true;
+}
+
+static void DrawThumbnailPrimitive(ThumbnailTarget* target, const cgltf_primitive* primitive, const cgltf_accessor* positions, const float* world)
+{
+    Vector3 albedo = { 0.8f, 0.8f, 0.8f };
+
+    if ((primitive->material != NULL) && primitive->material->has_pbr_metallic_roughness)
+    {
+        const float* factor = primitive->material->pbr_metallic_roughness.base_color_factor;
+        albedo = (Vector3){ factor[0], factor[1], factor[2] };
+    }
+
+    const cgltf_size count = (primitive->indices != NULL) ? primitive->indices->count : positions->count;
+
+    for (cgltf_size t = 0; t + 2 < count; t += 3)
+    {
+        Vector3 v[3] = { 0 };
+
+        for (int k = 0; k < 3; k++)
+        {
+            const cgltf_size index = (primitive->indices != NULL) ? cgltf_accessor_read_index(primitive->indices, t + k) : t + k;
+
+            float p[3] = { 0 };
+            cgltf_accessor_read_float(positions, index, p, 3);
+
+            v[k] = TransformPoint(world, (Vector3){ p[0], p[1], p[2] });
+        }
+
+        RasterizeThumbnailTriangle(target, v[0], v[1], v[2], albedo);
+    }
+}
+
+// Renders the drawn meshes of a parsed file, NULL when nothing could be drawn
+static unsigned char* RenderThumbnail(GlbFile* glb, cgltf_data* data, const bool* isCancelled)
+{
+    const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    // Bounds from the POSITION min/max, no geometry needed to frame the camera
+    Vector3 boundsMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vector3 boundsMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    int drawnCount = 0;
+
+    for (cgltf_size i = 0; i < data->nodes_count; i++)
+    {
+        const cgltf_node* node = &data->nodes[i];
+        if (node->mesh == NULL) continue;
+
+        float world[16] = { 0 };
+        cgltf_node_transform_world(node, world);
+
+        for (cgltf_size p = 0; p < node->mesh->primitives_count; p++)
+        {
+            const cgltf_accessor* positions = GetPrimitivePositions(&node->mesh->primitives[p]);
+            if ((positions == NULL) || !positions->has_min || !positions->has_max) continue;
+
+            for (int c = 0; c < 8; c++)
+            {
+                const Vector3 corner = {
+                    (c & 1) ? positions->max[0] : positions->min[0],
+                    (c & 2) ? positions->max[1] : positions->min[1],
+                    (c & 4) ? positions->max[2] : positions->min[2]
+                };
+
+                const Vector3 v = TransformPoint((node->skin != NULL) ? identity : world, corner);
+
+                boundsMin = (Vector3){ fminf(boundsMin.x, v.x), fminf(boundsMin.y, v.y), fminf(boundsMin.z, v.z) };
+                boundsMax = (Vector3){ fmaxf(boundsMax.x, v.x), fmaxf(boundsMax.y, v.y), fmaxf(boundsMax.z, v.z) };
+            }
+
+            drawnCount++;
+        }
+    }
+
+    if (drawnCount == 0) return NULL;
+
+    ThumbnailTarget target = { 0 };
+    target.depth = (float*)RL_MALLOC(THUMBNAIL_RENDER_SIZE*THUMBNAIL_RENDER_SIZE*sizeof(float));
+    target.color = (float*)RL_CALLOC(THUMBNAIL_RENDER_SIZE*THUMBNAIL_RENDER_SIZE*3, sizeof(float));
+    target.coverage = (float*)RL_CALLOC(THUMBNAIL_RENDER_SIZE*THUMBNAIL_RENDER_SIZE, sizeof(float));
+
+    for (int i = 0; i < THUMBNAIL_RENDER_SIZE*THUMBNAIL_RENDER_SIZE; i++) target.depth[i] = FLT_MAX;
+
+    // Same diagonal view the viewer camera starts with
+    target.forward = Vec3Normalize((Vector3){ -1.0f, -1.0f, -1.0f });
+    target.right = Vec3Normalize(Vec3Cross(target.forward, (Vector3){ 0.0f, 1.0f, 0.0f }));
+    target.up = Vec3Cross(target.right, target.forward);
+    target.center = (Vector3){ (boundsMin.x + boundsMax.x)*0.5f, (boundsMin.y + boundsMax.y)*0.5f, (boundsMin.z + boundsMax.z)*0.5f };
+
+    const Vector3 extent = Vec3Sub(boundsMax, boundsMin);
+    const float radius = fmaxf(0.5f*sqrtf(Vec3Dot(extent, extent)), 1e-6f);
+    target.scale = THUMBNAIL_RENDER_SIZE/(2.0f*radius*1.05f);
+
+    for (cgltf_size i = 0; (i < data->nodes_count) && !__atomic_load_n(isCancelled, __ATOMIC_RELAXED); i++)
+    {
+        const cgltf_node* node = &data->nodes[i];
+        if (node->mesh == NULL) continue;
+
+        // Skinned vertices are already in model space (bind pose)
+        float world[16] = { 0 };
+        if (node->skin != NULL) memcpy(world, identity, sizeof(world));
+        else cgltf_node_transform_world(node, world);
+
+        for (cgltf_size p = 0; p < node->mesh->primitives_count; p++)
+        {
+            const cgltf_accessor* positions = GetPrimitivePositions(&node->mesh->primitives[p]);
+            if ((positions == NULL) || !LoadPrimitiveBuffers(glb, &node->mesh->primitives[p], positions)) continue;
+
+            DrawThumbnailPrimitive(&target, &node->mesh->primitives[p], positions, world);
+        }
+    }
+
+    // 2x2 box filter, alpha from coverage
+    unsigned char* pixels = (unsigned char*)MemTrackAlloc(MEMORY_TEXTURES_CPU, THUMBNAIL_SIZE*THUMBNAIL_SIZE*4);
+
+    for (int y = 0; y < THUMBNAIL_SIZE; y++)
+    {
+        for (int x = 0; x < THUMBNAIL_SIZE; x++)
+        {
+            float rgb[3] = { 0 };
+            float coverage = 0.0f;
+
+            for (int k = 0; k < 4; k++)
+            {
+                const int index = (y*2 + k/2)*THUMBNAIL_RENDER_SIZE + x*2 + k%2;
+
+                rgb[0] += target.color[index*3];
+                rgb[1] += target.color[index*3 + 1];
+                rgb[2] += target.color[index*3 + 2];
+                coverage += target.coverage[index];
+            }
+
+            unsigned char* out = &pixels[(y*THUMBNAIL_SIZE + x)*4];
+
+            for (int c = 0; c < 3; c++)
+            {
+                const float value = (coverage > 0.0f) ? rgb[c]/coverage : 0.0f;
+                out[c] = (unsigned char)(fminf(value, 1.0f)*255.0f + 0.5f);
+            }
+
+            out[3] = (unsigned char)(coverage*0.25f*255.0f + 0.5f);
+        }
+    }
+
+    RL_FREE(target.coverage);
+    RL_FREE(target.color);
+    RL_FREE(target.depth);
+
+    return pixels;
+}
+
+static unsigned char* LoadThumbnailPixels(const char* fileName, const char* cacheDirectory, const bool* isCancelled, bool* isCached)
+{
+    *isCached = false;
+
+    GlbFile glb = OpenGlbFile(fileName);
+    if (glb.file == NULL) return NULL;
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned int settings[3] = { THUMBNAIL_CACHE_VERSION, THUMBNAIL_SIZE, glb.binLength };
+
+    hash = HashBytes(hash, settings, sizeof(settings));
+    hash = HashBytes(hash, glb.json, glb.jsonLength);
+
+    char cacheName[600] = { 0 };
+    snprintf(cacheName, sizeof(cacheName), "%s/%016llx.thumb", cacheDirectory, (unsigned long long)hash);
+
+    unsigned char* pixels = LoadCachedThumbnail(cacheName);
+
+    if (pixels != NULL)
+    {
+        *isCached = true;
+    }
+    else
+    {
+        TraceBegin("parse json");
+        cgltf_data* data = ParseGlbJson(&glb);
+        TraceEnd();
+
+        if (data != NULL)
+        {
+            // Reads and decodes the position and index views, then rasterizes
+            TraceBegin("render thumbnail");
+            pixels = RenderThumbnail(&glb, data, isCancelled);
+            TraceEnd();
+
+            UnloadGlbData(data);
+        }
+
+        if ((pixels != NULL) && !__atomic_load_n(isCancelled, __ATOMIC_RELAXED)) SaveCachedThumbnail(cacheName, pixels);
+    }
+
+    CloseGlbFile(&glb);
+
+    return pixels;
+}
+
+//----------------------------------------------------------------
+// Workers
+
+static void* ThumbnailWorkerMain(void* arg)
+{
+    struct ThumbnailJobs* jobs = (struct ThumbnailJobs*)arg;
+
+    SetTraceThreadName("thumbnails");
+
+    while (true)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+
+        while ((jobs->nextJob < jobs->count) && (jobs->paths[jobs->nextJob] == NULL)) jobs->nextJob++;
+
+        const int job = jobs->nextJob;
+        const bool isDone = jobs->isCancelled || (job >= jobs->count);
+
+        if (!isDone) jobs->nextJob++;
+
+        pthread_mutex_unlock(&jobs->mutex);
+
+        if (isDone) break;
+
+        bool isCached = false;
+
+        TraceBegin("thumbnail");
+        unsigned char* pixels = LoadThumbnailPixels(jobs->paths[job], jobs->cacheDirectory, &jobs->isCancelled, &isCached);
+        TraceEnd();
+
+        pthread_mutex_lock(&jobs->mutex);
+
+        jobs->pixels[job] = pixels;
+        jobs->isCached[job] = isCached;
+        jobs->finished[jobs->finishedCount++] = job;
+
+        pthread_mutex_unlock(&jobs->mutex);
+    }
+
+    return NULL;
+}
+
+static int GetThumbnailThreadCount(void)
+{
+#if defined(_WIN32)
+    int count = 4;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;     // Leave a core to the main thread
+#endif
+
+    if (count < 1) count = 1;
+    if (count > THUMBNAIL_MAX_THREADS) count = THUMBNAIL_MAX_THREADS;
+
+    return count;
+}
+
+//----------------------------------------------------------------
+
+ThumbnailSet LoadThumbnailSet(FilePathList files, const DirectoryEntry* entries)
+{
+    ThumbnailSet set = { 0 };
+
+    set.count = files.count;
+    set.thumbnails = (Thumbnail*)RL_CALLOC((files.count > 0) ? files.count : 1, sizeof(Thumbnail));
+    set.startTime = GetTime();
+
+    struct ThumbnailJobs* jobs = (struct ThumbnailJobs*)RL_CALLOC(1, sizeof(struct ThumbnailJobs));
+    set.jobs = jobs;
+
+    jobs->count = files.count;
+    jobs->paths = (char**)RL_CALLOC(set.count + 1, sizeof(char*));
+    jobs->pixels = (unsigned char**)RL_CALLOC(set.count + 1, sizeof(unsigned char*));
+    jobs->isCached = (bool*)RL_CALLOC(set.count + 1, sizeof(bool));
+    jobs->finished = (int*)RL_CALLOC(set.count + 1, sizeof(int));
+
+    // Extensions are checked here, IsFileExtension() is not thread safe. The scan already knows the directories
+    for (int i = 0; i < set.count; i++)
+    {
+        if (entries[i].isDirectory || !IsFileExtension(files.paths[i], ".glb")) continue;
+
+        const size_t length = strlen(files.paths[i]);
+        jobs->paths[i] = (char*)RL_MALLOC(length + 1);
+        memcpy(jobs->paths[i], files.paths[i], length + 1);
+
+        set.thumbnails[i].state = THUMBNAIL_PENDING;
+        set.requestedCount++;
+    }
+
+    InitCacheDirectory(jobs->cacheDirectory, sizeof(jobs->cacheDirectory));
+    pthread_mutex_init(&jobs->mutex, NULL);
+
+    if (set.requestedCount > 0)
+    {
+        const int threadCount = (set.requestedCount < GetThumbnailThreadCount()) ? set.requestedCount : GetThumbnailThreadCount();
+
+        for (int i = 0; i < threadCount; i++)
+        {
+            if (pthread_create(&jobs->threads[jobs->threadCount], NULL, ThumbnailWorkerMain, jobs) == 0) jobs->threadCount++;
+        }
+
+        // Rendering every file here would stall the listing, the rows keep their icons instead
+        if (jobs->threadCount == 0)
+        {
+            TraceLog(LOG_WARNING, "THUMBNAILS: Failed to start worker threads");
+
+            for (int i = 0; i < set.count; i++)
+            {
+                if (set.thumbnails[i].state == THUMBNAIL_PENDING) set.thumbnails[i].state = THUMBNAIL_FAILED;
+            }
+
+            set.completedCount = set.requestedCount;
+        }
+    }
+
+    return set;
+}
+
+void UnloadThumbnailSet(ThumbnailSet set)
+{
+    struct ThumbnailJobs* jobs = set.jobs;
+
+    if (jobs != NULL)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+        __atomic_store_n(&jobs->isCancelled, true, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&jobs->mutex);
+
+        for (int i = 0; i < jobs->threadCount; i++) pthread_join(jobs->threads[i], NULL);
+
+        pthread_mutex_destroy(&jobs->mutex);
+
+        for (int i = 0; i < jobs->count; i++)
+        {
+            RL_FREE(jobs->paths[i]);
+            MemTrackFree(MEMORY_TEXTURES_CPU, jobs->pixels[i]);
+        }
+
+        RL_FREE(jobs->finished);
+        RL_FREE(jobs->isCached);
+        RL_FREE(jobs->pixels);
+        RL_FREE(jobs->paths);
+        RL_FREE(jobs);
+    }
+
+    for (int i = 0; i < set.count; i++)
+    {
+        if (set.thumbnails[i].state == THUMBNAIL_READY)
+        {
+            UnloadTexture(set.thumbnails[i].texture);
+            AddMemoryUsage(MEMORY_TEXTURES_GPU, -THUMBNAIL_SIZE*THUMBNAIL_SIZE*4);
+        }
+    }
+
+    RL_FREE(set.thumbnails);
+}
+
+void UpdateThumbnailSet(ThumbnailSet* set)
+{
+    struct ThumbnailJobs* jobs = set->jobs;
+
+    if ((jobs == NULL) || (set->completedCount == set->requestedCount)) return;
+
+    pthread_mutex_lock(&jobs->mutex);
+    const int finishedCount = jobs->finishedCount;
+    pthread_mutex_unlock(&jobs->mutex);
+
+    // Entries before finishedCount are final, no lock needed to read them
+    for (int uploads = 0; (jobs->uploadedCount < finishedCount) && (uploads < THUMBNAIL_UPLOADS_PER_FRAME); uploads++)
+    {
+        const int index = jobs->finished[jobs->uploadedCount++];
+        Thumbnail* thumbnail = &set->thumbnails[index];
+
+        if (jobs->pixels[index] != NULL)
+        {
+            Image image = { jobs->pixels[index], THUMBNAIL_SIZE, THUMBNAIL_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+            thumbnail->texture = LoadTextureFromImage(image);
+            SetTextureFilter(thumbnail->texture, TEXTURE_FILTER_BILINEAR);
+            thumbnail->state = THUMBNAIL_READY;
+
+            AddMemoryUsage(MEMORY_TEXTURES_GPU, THUMBNAIL_SIZE*THUMBNAIL_SIZE*4);
+
+            MemTrackFree(MEMORY_TEXTURES_CPU, jobs->pixels[index]);
+            jobs->pixels[index] = NULL;
+        }
+        else thumbnail->state = THUMBNAIL_FAILED;
+
+        if (jobs->isCached[index]) set->cachedCount++;
+        set->completedCount++;
+    }
+
+    const double elapsed = GetTime() - set->startTime;
+    if (elapsed > 0.0) set->thumbnailsPerSecond = (float)(set->completedCount/elapsed);
+
+    if (set->completedCount == set->requestedCount)
+    {
+        TraceLog(LOG_INFO, "THUMBNAILS: %d thumbnails in %.2f s (%.1f/s, %d cached)", set->completedCount, elapsed, set->thumbnailsPerSecond, set->cachedCount);
+    }
+}
+
+bool IsThumbnailSetBusy(ThumbnailSet set)
+{
+    return (set.jobs != NULL) && (set.completedCount < set.requestedCount);
+}
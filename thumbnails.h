@@ -0,0 +1,87 @@
+/*******************************************************************************************
+*
+*   thumbnails - Shaded .glb thumbnails rendered on worker threads
+*
+*   Every .glb of a directory listing is queued to a small thread pool. A worker reads the
+*   JSON chunk and only the POSITION/index buffer views of the drawn primitives (see glb.h),
+*   then rasterizes flat shaded triangles on the CPU, colored with the base color factor.
+*   Finished thumbnails are uploaded on the main thread in UpdateThumbnailSet().
+*
+*   Thumbnails are cached on disk, keyed by a hash of the JSON chunk and the BIN chunk length.
+*   POSITION accessors must carry min/max, so edited geometry changes the JSON as well.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef THUMBNAILS_H
+#define THUMBNAILS_H
+
+#include "raylib.h"
+#include "dirscan.h"
+
+#define THUMBNAIL_SIZE              48      // Stored size in pixels, rendered at 2x and downsampled
+#define THUMBNAIL_MAX_THREADS       8
+#define THUMBNAIL_UPLOADS_PER_FRAME 16
+
+typedef enum
+{
+    THUMBNAIL_NONE = 0,         // Not a .glb file
+    THUMBNAIL_PENDING,
+    THUMBNAIL_READY,
+    THUMBNAIL_FAILED
+} ThumbnailState;
+
+typedef struct
+{
+    ThumbnailState state;
+    Texture2D texture;
+} Thumbnail;
+
+typedef struct
+{
+    int count;
+    Thumbnail* thumbnails;      // One per listed path
+
+    int requestedCount;         // .glb files queued
+    int completedCount;         // Rendered, read from cache or failed
+    int cachedCount;            // Read from the disk cache
+
+    double startTime;
+    float thumbnailsPerSecond;  // Completed thumbnails over the time since the listing was loaded
+
+    struct ThumbnailJobs* jobs;
+} ThumbnailSet;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// entries are the scanned entries of files, in the same order
+ThumbnailSet LoadThumbnailSet(FilePathList files, const DirectoryEntry* entries);
+void UnloadThumbnailSet(ThumbnailSet set);
+
+// Uploads finished thumbnails, call once per frame from the main thread
+void UpdateThumbnailSet(ThumbnailSet* set);
+bool IsThumbnailSetBusy(ThumbnailSet set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THUMBNAILS_H
@@ -0,0 +1,391 @@
+/*******************************************************************************************
+*
+*   trace - Chrome trace-event capture from the main thread and the worker threads
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "trace.h"
+
+#define MEMORY_TRACK_CATEGORY MEMORY_OTHER
+#include "memtrack.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>        // Required for: QueryPerformanceCounter(), GetCurrentThreadId()
+    #include <process.h>        // Required for: _getpid()
+    #define GetProcessId()      _getpid()
+#else
+    #include <time.h>           // Required for: clock_gettime()
+    #include <unistd.h>         // Required for: getpid()
+    #define GetProcessId()      getpid()
+    #if defined(__linux__)
+        #include <sys/syscall.h>    // Required for: SYS_gettid
+    #endif
+#endif
+
+typedef struct
+{
+    long long time;             // Nanoseconds
+    const char* name;
+    long long value;            // Counters only
+    char phase;                 // 'B', 'E' or 'C'
+} TraceEvent;
+
+typedef enum
+{
+    TRACE_THREAD_ACTIVE = 0,    // Owned by a running thread
+    TRACE_THREAD_EXITED,        // Its thread is gone, the events wait for StopTracing()
+    TRACE_THREAD_FREE           // Written or out of date, a new thread can take it over
+} TraceThreadState;
+
+typedef struct TraceThread
+{
+    TraceEvent* chunks[TRACE_MAX_CHUNKS];
+    unsigned int count;         // Events written in this capture, published with a release store
+    unsigned int capture;       // Capture the count belongs to, the thread resets it when a new one starts
+    int droppedCount;
+    int state;
+
+    int threadId;
+    const char* name;
+
+    struct TraceThread* next;
+} TraceThread;
+
+static TraceThread* traceThreads = NULL;     // Pushed with a compare-and-swap, never removed until UnloadTracing()
+static __thread TraceThread* currentThread = NULL;
+static __thread const char* currentThreadName = NULL;      // Given to the buffer once the thread records
+static int isTracing = 0;
+static unsigned int traceCapture = 0;       // Incremented by StartTracing()
+
+static pthread_once_t exitKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t exitKey;               // Its destructor hands the buffer of an exiting thread back
+
+//----------------------------------------------------------------
+
+long long GetTraceTime(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (long long)(counter.QuadPart*(1000000000.0/frequency.QuadPart));
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (long long)now.tv_sec*1000000000 + now.tv_nsec;
+#endif
+}
+
+static int GetTraceThreadId(void)
+{
+#if defined(_WIN32)
+    return (int)GetCurrentThreadId();
+#elif defined(__linux__)
+    return (int)syscall(SYS_gettid);
+#else
+    static int nextId = 1;
+    return __atomic_fetch_add(&nextId, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static void ExitTraceThread(void* data)
+{
+    __atomic_store_n(&((TraceThread*)data)->state, TRACE_THREAD_EXITED, __ATOMIC_RELEASE);
+}
+
+static void InitExitKey(void)
+{
+    pthread_key_create(&exitKey, ExitTraceThread);
+}
+
+// Short lived workers reuse the buffers of the ones before them, the list only grows with the peak thread count
+static TraceThread* ClaimFreeTraceThread(void)
+{
+    for (TraceThread* thread = __atomic_load_n(&traceThreads, __ATOMIC_ACQUIRE); thread != NULL; thread = thread->next)
+    {
+        int expected = TRACE_THREAD_FREE;
+        if (__atomic_compare_exchange_n(&thread->state, &expected, TRACE_THREAD_ACTIVE, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return thread;
+    }
+
+    return NULL;
+}
+
+static TraceThread* GetTraceThread(void)
+{
+    if (currentThread != NULL) return currentThread;
+
+    pthread_once(&exitKeyOnce, InitExitKey);
+
+    TraceThread* thread = ClaimFreeTraceThread();
+
+    if (thread != NULL)
+    {
+        // The capture is never the current one, so the first event resets the count
+        thread->threadId = GetTraceThreadId();
+        __atomic_store_n(&thread->name, currentThreadName, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        thread = (TraceThread*)RL_CALLOC(1, sizeof(TraceThread));
+        if (thread == NULL) return NULL;
+
+        thread->threadId = GetTraceThreadId();
+        thread->name = currentThreadName;
+
+        // Lock-free push, StopTracing() may be walking the list meanwhile
+        thread->next = __atomic_load_n(&traceThreads, __ATOMIC_ACQUIRE);
+        while (!__atomic_compare_exchange_n(&traceThreads, &thread->next, thread, true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) { }
+    }
+
+    pthread_setspecific(exitKey, thread);
+    currentThread = thread;
+
+    return thread;
+}
+
+// Chunk k starts at event TRACE_FIRST_CHUNK_EVENTS*(2^k - 1)
+static int GetTraceChunk(unsigned int index, unsigned int* offset)
+{
+    const unsigned int slot = index/TRACE_FIRST_CHUNK_EVENTS + 1;
+    const int chunk = 31 - __builtin_clz(slot);
+
+    *offset = index - TRACE_FIRST_CHUNK_EVENTS*((1u << chunk) - 1);
+
+    return chunk;
+}
+
+static void AddTraceEvent(const char* name, char phase, long long value)
+{
+    if (!__atomic_load_n(&isTracing, __ATOMIC_RELAXED)) return;
+
+    TraceThread* thread = GetTraceThread();
+    if (thread == NULL) return;
+
+    // First event of a capture, the chunks of the last one are written over
+    const unsigned int capture = __atomic_load_n(&traceCapture, __ATOMIC_ACQUIRE);
+
+    if (thread->capture != capture)
+    {
+        __atomic_store_n(&thread->count, 0, __ATOMIC_RELAXED);
+        thread->droppedCount = 0;
+        __atomic_store_n(&thread->capture, capture, __ATOMIC_RELEASE);
+    }
+
+    const unsigned int index = thread->count;
+    unsigned int offset = 0;
+    const int chunk = GetTraceChunk(index, &offset);
+
+    if (chunk >= TRACE_MAX_CHUNKS)
+    {
+        thread->droppedCount++;
+        return;
+    }
+
+    // Only this thread writes the chunk pointers, they are published along with the count
+    if (thread->chunks[chunk] == NULL)
+    {
+        thread->chunks[chunk] = (TraceEvent*)RL_MALLOC(((size_t)TRACE_FIRST_CHUNK_EVENTS << chunk)*sizeof(TraceEvent));
+
+        if (thread->chunks[chunk] == NULL)
+        {
+            thread->droppedCount++;
+            return;
+        }
+    }
+
+    TraceEvent* event = &thread->chunks[chunk][offset];
+    event->time = GetTraceTime();
+    event->name = name;
+    event->value = value;
+    event->phase = phase;
+
+    __atomic_store_n(&thread->count, index + 1, __ATOMIC_RELEASE);
+}
+
+static void WriteTraceName(FILE* file, const char* name)
+{
+    fputc('"', file);
+
+    for (const char* c = name; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\')) fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+
+    fputc('"', file);
+}
+
+//----------------------------------------------------------------
+
+// The chunks of an exited thread are released, a thread taking the buffer over allocates them again
+static void FreeExitedTraceThread(TraceThread* thread)
+{
+    if (__atomic_load_n(&thread->state, __ATOMIC_ACQUIRE) != TRACE_THREAD_EXITED) return;
+
+    for (int i = 0; i < TRACE_MAX_CHUNKS; i++)
+    {
+        RL_FREE(thread->chunks[i]);
+        thread->chunks[i] = NULL;
+    }
+
+    __atomic_store_n(&thread->state, TRACE_THREAD_FREE, __ATOMIC_RELEASE);
+}
+
+//----------------------------------------------------------------
+
+void StartTracing(void)
+{
+    // Whatever was recorded before belongs to no capture, every thread resets its count on its next event
+    __atomic_add_fetch(&traceCapture, 1, __ATOMIC_RELEASE);
+
+    for (TraceThread* thread = __atomic_load_n(&traceThreads, __ATOMIC_ACQUIRE); thread != NULL; thread = thread->next) FreeExitedTraceThread(thread);
+
+    __atomic_store_n(&isTracing, 1, __ATOMIC_RELAXED);
+
+    TraceLog(LOG_INFO, "TRACE: Capture started");
+}
+
+bool StopTracing(const char* fileName)
+{
+    __atomic_store_n(&isTracing, 0, __ATOMIC_RELAXED);
+
+    FILE* file = fopen(fileName, "w");
+
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "TRACE: [%s] Failed to open for writing", fileName);
+        return false;
+    }
+
+    const unsigned int capture = __atomic_load_n(&traceCapture, __ATOMIC_ACQUIRE);
+    const int processId = (int)GetProcessId();
+    long long eventCount = 0;
+    int droppedCount = 0;
+    bool isFirst = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (TraceThread* thread = __atomic_load_n(&traceThreads, __ATOMIC_ACQUIRE); thread != NULL; thread = thread->next)
+    {
+        // Free buffers and threads that recorded nothing in this capture hold no events of it
+        if ((__atomic_load_n(&thread->state, __ATOMIC_ACQUIRE) == TRACE_THREAD_FREE) ||
+            (__atomic_load_n(&thread->capture, __ATOMIC_ACQUIRE) != capture)) continue;
+
+        // Events after this count are still being written, they are left out
+        const unsigned int count = __atomic_load_n(&thread->count, __ATOMIC_ACQUIRE);
+        const char* name = __atomic_load_n(&thread->name, __ATOMIC_ACQUIRE);
+
+        if (name != NULL)
+        {
+            fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", isFirst ? "" : ",\n", processId, thread->threadId);
+            WriteTraceName(file, name);
+            fprintf(file, "}}");
+            isFirst = false;
+        }
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            unsigned int offset = 0;
+            const TraceEvent* event = &thread->chunks[GetTraceChunk(i, &offset)][offset];
+
+            fprintf(file, "%s{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%lld.%03d", isFirst ? "" : ",\n", event->phase, processId, thread->threadId, event->time/1000, (int)(event->time%1000));
+            isFirst = false;
+
+            if (event->phase != 'E')
+            {
+                fprintf(file, ",\"name\":");
+                WriteTraceName(file, event->name);
+            }
+
+            if (event->phase == 'C') fprintf(file, ",\"args\":{\"value\":%lld}", event->value);
+
+            fputc('}', file);
+        }
+
+        eventCount += count;
+        droppedCount += thread->droppedCount;
+
+        FreeExitedTraceThread(thread);
+    }
+
+    fprintf(file, "\n]}\n");
+
+    const bool isWritten = (fclose(file) == 0);
+
+    if (isWritten) TraceLog(LOG_INFO, "TRACE: [%s] %lld events written, %d dropped", fileName, eventCount, droppedCount);
+    else TraceLog(LOG_WARNING, "TRACE: [%s] Failed to write", fileName);
+
+    return isWritten;
+}
+
+bool IsTracing(void)
+{
+    return __atomic_load_n(&isTracing, __ATOMIC_RELAXED) != 0;
+}
+
+void UnloadTracing(void)
+{
+    __atomic_store_n(&isTracing, 0, __ATOMIC_RELAXED);
+
+    TraceThread* thread = __atomic_exchange_n(&traceThreads, (TraceThread*)NULL, __ATOMIC_ACQ_REL);
+
+    while (thread != NULL)
+    {
+        TraceThread* next = thread->next;
+
+        for (int i = 0; i < TRACE_MAX_CHUNKS; i++) RL_FREE(thread->chunks[i]);
+        RL_FREE(thread);
+
+        thread = next;
+    }
+
+    // Only the calling thread can forget its own buffer, the workers are gone by now
+    if (currentThread != NULL) pthread_setspecific(exitKey, NULL);
+    currentThread = NULL;
+}
+
+void TraceBegin(const char* name)
+{
+    AddTraceEvent(name, 'B', 0);
+}
+
+void TraceEnd(void)
+{
+    AddTraceEvent(NULL, 'E', 0);
+}
+
+void TraceCounter(const char* name, long long value)
+{
+    AddTraceEvent(name, 'C', value);
+}
+
+void SetTraceThreadName(const char* name)
+{
+    // Threads that never record during a capture get no buffer
+    currentThreadName = name;
+    if (currentThread != NULL) __atomic_store_n(&currentThread->name, name, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************************
+*
+*   trace - Chrome trace-event capture from the main thread and the worker threads
+*
+*   Begin/end spans and counters are recorded while a capture runs, StopTracing() writes them
+*   as a Chrome trace-event JSON file that opens in Perfetto (ui.perfetto.dev) or chrome://tracing.
+*
+*   Every thread appends to a buffer of its own, found through a thread local pointer, so
+*   recording takes no lock. A buffer is registered on the first event of its thread with a
+*   compare-and-swap push, the writer publishes its event count with a release store and
+*   StopTracing() reads it with an acquire load. Buffers grow in chunks of doubling size and
+*   are written over by the next capture, events past TRACE_MAX_CHUNKS of a thread are dropped.
+*   The buffer of an exited thread is released once its events are written and a new thread
+*   takes it over, so short lived workers do not add up.
+*
+*   Timestamps are CLOCK_MONOTONIC and thread ids are the system ones, a capture lines up with
+*   a system trace of the same run. Event names are not copied, pass string literals.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "raylib.h"
+
+#define TRACE_FIRST_CHUNK_EVENTS    256     // Chunk k holds 256 << k events
+#define TRACE_MAX_CHUNKS            13      // About two million events per thread
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void StartTracing(void);
+bool StopTracing(const char* fileName);     // Writes the events recorded since StartTracing()
+bool IsTracing(void);
+
+// Frees the buffers of every thread, call after the worker threads are joined
+void UnloadTracing(void);
+
+void TraceBegin(const char* name);
+void TraceEnd(void);                        // Ends the span begun last on this thread
+void TraceCounter(const char* name, long long value);
+void SetTraceThreadName(const char* name);  // Shown as the track name
+
+long long GetTraceTime(void);               // Monotonic nanoseconds, needs no window
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "vec.h"
+#include "memtrack.h"
 #include <string.h>
 
 typedef struct
@@ -44,14 +45,14 @@ vector_header* vector_get_header(vector vec) { return &((vector_header*)vec)[-1]
 
 vector vector_create(void)
 {
-	vector_header* h = (vector_header*)malloc(sizeof(vector_header));
+	vector_header* h = (vector_header*)MemTrackAlloc(MEMORY_OTHER, sizeof(vector_header));
 	h->capacity = 0;
 	h->size = 0;
 
 	return &h->data;
 }
 
-void vector_free(vector vec) { free(vector_get_header(vec)); }
+void vector_free(vector vec) { MemTrackFree(MEMORY_OTHER, vector_get_header(vec)); }
 
 vec_size_t vector_size(vector vec) { return vector_get_header(vec)->size; }
 
@@ -60,7 +61,7 @@ vec_size_t vector_capacity(vector vec) { return vector_get_header(vec)->capacity
 vector_header* vector_realloc(vector_header* h, vec_type_t type_size)
 {
 	vec_size_t new_capacity = (h->capacity == 0) ? 1 : h->capacity * 2;
-	vector_header* new_h = (vector_header*)realloc(h, sizeof(vector_header) + new_capacity * type_size);
+	vector_header* new_h = (vector_header*)MemTrackRealloc(MEMORY_OTHER, h, sizeof(vector_header) + new_capacity * type_size);
 	new_h->capacity = new_capacity;
 
 	return new_h;
@@ -131,7 +132,7 @@ void _vector_reserve(vector* vec_addr, vec_type_t type_size, vec_size_t capacity
 		return;
 	}
 
-	h = (vector_header*)realloc(h, sizeof(vector_header) + capacity * type_size);
+	h = (vector_header*)MemTrackRealloc(MEMORY_OTHER, h, sizeof(vector_header) + capacity * type_size);
 	h->capacity = capacity;
 	*vec_addr = &h->data;
 }
@@ -140,7 +141,7 @@ vector _vector_copy(vector vec, vec_type_t type_size)
 {
 	vector_header* h = vector_get_header(vec);
 	size_t alloc_size = sizeof(vector_header) + h->size * type_size;
-	vector_header* copy_h = (vector_header*)malloc(alloc_size);
+	vector_header* copy_h = (vector_header*)MemTrackAlloc(MEMORY_OTHER, alloc_size);
 	memcpy(copy_h, h, alloc_size);
 	copy_h->capacity = copy_h->size;
 
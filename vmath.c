@@ -0,0 +1,969 @@
+/*******************************************************************************************
+*
+*   vmath - Vector, matrix and quaternion math with SIMD batch paths
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#include "vmath.h"
+
+#include <math.h>
+#include <pthread.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define VMATH_SSE
+    #include <immintrin.h>
+#endif
+
+#if defined(VMATH_SSE) && (defined(__GNUC__) || defined(__clang__))
+    #define VMATH_AVX2          // Compiled with a target attribute, picked at runtime
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define VMATH_NEON
+    #include <arm_neon.h>
+#endif
+
+// Kernels see matrices as 16 floats, four rows of four
+typedef void (*MultiplyFunc)(float* out, const float* a, int aStride, const float* b, int count);
+typedef void (*TransformFunc)(float* out, const float* in, int count, const float* m);
+typedef void (*QuaternionFunc)(float* out, const float* in, int count);
+
+typedef struct
+{
+    MathSimdLevel level;
+    MultiplyFunc multiply;
+    TransformFunc transform;
+    QuaternionFunc quaternion;
+} MathKernels;
+
+static MathKernels kernels = { MATH_SIMD_SCALAR };
+static pthread_once_t kernelsOnce = PTHREAD_ONCE_INIT;
+
+//----------------------------------------------------------------
+static Matrix MatrixMultiplyScalar(Matrix a, Matrix b)
+{
+    Matrix result = { 0 };
+
+    result.m0 = a.m0*b.m0 + a.m4*b.m1 + a.m8*b.m2 + a.m12*b.m3;
+    result.m1 = a.m1*b.m0 + a.m5*b.m1 + a.m9*b.m2 + a.m13*b.m3;
+    result.m2 = a.m2*b.m0 + a.m6*b.m1 + a.m10*b.m2 + a.m14*b.m3;
+    result.m3 = a.m3*b.m0 + a.m7*b.m1 + a.m11*b.m2 + a.m15*b.m3;
+
+    result.m4 = a.m0*b.m4 + a.m4*b.m5 + a.m8*b.m6 + a.m12*b.m7;
+    result.m5 = a.m1*b.m4 + a.m5*b.m5 + a.m9*b.m6 + a.m13*b.m7;
+    result.m6 = a.m2*b.m4 + a.m6*b.m5 + a.m10*b.m6 + a.m14*b.m7;
+    result.m7 = a.m3*b.m4 + a.m7*b.m5 + a.m11*b.m6 + a.m15*b.m7;
+
+    result.m8 = a.m0*b.m8 + a.m4*b.m9 + a.m8*b.m10 + a.m12*b.m11;
+    result.m9 = a.m1*b.m8 + a.m5*b.m9 + a.m9*b.m10 + a.m13*b.m11;
+    result.m10 = a.m2*b.m8 + a.m6*b.m9 + a.m10*b.m10 + a.m14*b.m11;
+    result.m11 = a.m3*b.m8 + a.m7*b.m9 + a.m11*b.m10 + a.m15*b.m11;
+
+    result.m12 = a.m0*b.m12 + a.m4*b.m13 + a.m8*b.m14 + a.m12*b.m15;
+    result.m13 = a.m1*b.m12 + a.m5*b.m13 + a.m9*b.m14 + a.m13*b.m15;
+    result.m14 = a.m2*b.m12 + a.m6*b.m13 + a.m10*b.m14 + a.m14*b.m15;
+    result.m15 = a.m3*b.m12 + a.m7*b.m13 + a.m11*b.m14 + a.m15*b.m15;
+
+    return result;
+}
+
+static void MultiplyScalar(float* out, const float* a, int aStride, const float* b, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        ((Matrix*)out)[i] = MatrixMultiplyScalar(((const Matrix*)a)[i*aStride], ((const Matrix*)b)[i]);
+    }
+}
+
+static void TransformScalar(float* out, const float* in, int count, const float* m)
+{
+    const Matrix mat = *(const Matrix*)m;
+
+    for (int i = 0; i < count; i++)
+    {
+        ((Vector3*)out)[i] = Vector3Transform(((const Vector3*)in)[i], mat);
+    }
+}
+
+static void QuaternionScalar(float* out, const float* in, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        ((Matrix*)out)[i] = QuaternionToMatrix(((const Quaternion*)in)[i]);
+    }
+}
+
+//----------------------------------------------------------------
+#if defined(VMATH_SSE)
+// Row i of a*b is the sum of a[i][k]*(row k of b), out may alias a or b
+static inline void MultiplySse4x4(float* out, const float* a, const float* b)
+{
+    const __m128 b0 = _mm_loadu_ps(b);
+    const __m128 b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8);
+    const __m128 b3 = _mm_loadu_ps(b + 12);
+
+    for (int i = 0; i < 16; i += 4)
+    {
+        const __m128 row = _mm_loadu_ps(a + i);
+
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), b3));
+
+        _mm_storeu_ps(out + i, r);
+    }
+}
+
+// Four points per step, every input is loaded before the block is stored
+static void TransformSse(float* out, const float* in, int count, const float* m)
+{
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4, in += 12, out += 12)
+    {
+        // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+        const __m128 v0 = _mm_loadu_ps(in);
+        const __m128 v1 = _mm_loadu_ps(in + 4);
+        const __m128 v2 = _mm_loadu_ps(in + 8);
+
+        const __m128 r0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v0, v0, 0x00)), _mm_mul_ps(c1, _mm_shuffle_ps(v0, v0, 0x55))),
+                                     _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v0, v0, 0xAA)), c3));
+        const __m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v0, v0, 0xFF)), _mm_mul_ps(c1, _mm_shuffle_ps(v1, v1, 0x00))),
+                                     _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v1, v1, 0x55)), c3));
+        const __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v1, v1, 0xAA)), _mm_mul_ps(c1, _mm_shuffle_ps(v1, v1, 0xFF))),
+                                     _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v2, v2, 0x00)), c3));
+        const __m128 r3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v2, v2, 0x55)), _mm_mul_ps(c1, _mm_shuffle_ps(v2, v2, 0xAA))),
+                                     _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v2, v2, 0xFF)), c3));
+
+        // Pack the xyz of the four results back to 12 floats
+        const __m128 t0 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(0, 0, 2, 2));
+        const __m128 t2 = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(0, 0, 2, 2));
+
+        _mm_storeu_ps(out, _mm_shuffle_ps(r0, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(out + 4, _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(1, 0, 2, 1)));
+        _mm_storeu_ps(out + 8, _mm_shuffle_ps(t2, r3, _MM_SHUFFLE(2, 1, 2, 0)));
+    }
+
+    TransformScalar(out, in, count - i, m);
+}
+
+// Four quaternions per step as x, y, z, w lanes, then transposed into rows
+static void QuaternionSse(float* out, const float* in, int count)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4, in += 16, out += 64)
+    {
+        __m128 x = _mm_loadu_ps(in);
+        __m128 y = _mm_loadu_ps(in + 4);
+        __m128 z = _mm_loadu_ps(in + 8);
+        __m128 w = _mm_loadu_ps(in + 12);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        // Normalize, zero quaternions stay zero and give identity
+        const __m128 norm = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+        const __m128 mask = _mm_cmpgt_ps(norm, zero);
+        const __m128 inv = _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(one, norm)), _mm_andnot_ps(mask, one));
+
+        x = _mm_mul_ps(x, inv);
+        y = _mm_mul_ps(y, inv);
+        z = _mm_mul_ps(z, inv);
+        w = _mm_mul_ps(w, inv);
+
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        // Rows of the four matrices as m0 m4 m8 m12 | m1 m5 m9 m13 | m2 m6 m10 m14
+        __m128 r00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        __m128 r01 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        __m128 r02 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        __m128 r03 = zero;
+
+        __m128 r10 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        __m128 r11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        __m128 r12 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        __m128 r13 = zero;
+
+        __m128 r20 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        __m128 r21 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        __m128 r22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+        __m128 r23 = zero;
+
+        _MM_TRANSPOSE4_PS(r00, r01, r02, r03);
+        _MM_TRANSPOSE4_PS(r10, r11, r12, r13);
+        _MM_TRANSPOSE4_PS(r20, r21, r22, r23);
+
+        const __m128 r3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+        _mm_storeu_ps(out,      r00); _mm_storeu_ps(out + 4,  r10); _mm_storeu_ps(out + 8,  r20); _mm_storeu_ps(out + 12, r3);
+        _mm_storeu_ps(out + 16, r01); _mm_storeu_ps(out + 20, r11); _mm_storeu_ps(out + 24, r21); _mm_storeu_ps(out + 28, r3);
+        _mm_storeu_ps(out + 32, r02); _mm_storeu_ps(out + 36, r12); _mm_storeu_ps(out + 40, r22); _mm_storeu_ps(out + 44, r3);
+        _mm_storeu_ps(out + 48, r03); _mm_storeu_ps(out + 52, r13); _mm_storeu_ps(out + 56, r23); _mm_storeu_ps(out + 60, r3);
+    }
+
+    QuaternionScalar(out, in, count - i);
+}
+#endif
+
+//----------------------------------------------------------------
+#if defined(VMATH_AVX2)
+#define VMATH_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+// Transposes the 4x4 block of each 128 bit half
+VMATH_AVX2_TARGET static inline void Transpose4x4Avx(__m256* r0, __m256* r1, __m256* r2, __m256* r3)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(*r0, *r1);
+    const __m256 t1 = _mm256_unpacklo_ps(*r2, *r3);
+    const __m256 t2 = _mm256_unpackhi_ps(*r0, *r1);
+    const __m256 t3 = _mm256_unpackhi_ps(*r2, *r3);
+
+    *r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    *r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    *r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    *r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// Two floats[4] in the low and high half
+VMATH_AVX2_TARGET static inline __m256 Load2x4Avx(const float* lo, const float* hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+VMATH_AVX2_TARGET static inline void Store2x4Avx(float* lo, float* hi, __m256 v)
+{
+    _mm_storeu_ps(lo, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(hi, _mm256_extractf128_ps(v, 1));
+}
+
+// Two rows per register, each half broadcasts its own row of a
+VMATH_AVX2_TARGET static void MultiplyAvx(float* out, const float* a, int aStride, const float* b, int count)
+{
+    for (int i = 0; i < count; i++, out += 16, a += 16*aStride, b += 16)
+    {
+        const __m256 b0 = _mm256_broadcast_ps((const __m128*)b);
+        const __m256 b1 = _mm256_broadcast_ps((const __m128*)(b + 4));
+        const __m256 b2 = _mm256_broadcast_ps((const __m128*)(b + 8));
+        const __m256 b3 = _mm256_broadcast_ps((const __m128*)(b + 12));
+
+        const __m256 a01 = _mm256_loadu_ps(a);
+        const __m256 a23 = _mm256_loadu_ps(a + 8);
+
+        __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+        __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1, r23);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2, r23);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3, r01);
+        r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3, r23);
+
+        _mm256_storeu_ps(out, r01);
+        _mm256_storeu_ps(out + 8, r23);
+    }
+}
+
+// Same steps as TransformSse(), points 0-3 in the low half and 4-7 in the high half
+VMATH_AVX2_TARGET static void TransformAvx(float* out, const float* in, int count, const float* m)
+{
+    __m128 m0 = _mm_loadu_ps(m);
+    __m128 m1 = _mm_loadu_ps(m + 4);
+    __m128 m2 = _mm_loadu_ps(m + 8);
+    __m128 m3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+
+    const __m256 c0 = _mm256_set_m128(m0, m0);
+    const __m256 c1 = _mm256_set_m128(m1, m1);
+    const __m256 c2 = _mm256_set_m128(m2, m2);
+    const __m256 c3 = _mm256_set_m128(m3, m3);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8, in += 24, out += 24)
+    {
+        const __m256 v0 = Load2x4Avx(in, in + 12);
+        const __m256 v1 = Load2x4Avx(in + 4, in + 16);
+        const __m256 v2 = Load2x4Avx(in + 8, in + 20);
+
+        const __m256 r0 = _mm256_fmadd_ps(c0, _mm256_shuffle_ps(v0, v0, 0x00), _mm256_fmadd_ps(c1, _mm256_shuffle_ps(v0, v0, 0x55), _mm256_fmadd_ps(c2, _mm256_shuffle_ps(v0, v0, 0xAA), c3)));
+        const __m256 r1 = _mm256_fmadd_ps(c0, _mm256_shuffle_ps(v0, v0, 0xFF), _mm256_fmadd_ps(c1, _mm256_shuffle_ps(v1, v1, 0x00), _mm256_fmadd_ps(c2, _mm256_shuffle_ps(v1, v1, 0x55), c3)));
+        const __m256 r2 = _mm256_fmadd_ps(c0, _mm256_shuffle_ps(v1, v1, 0xAA), _mm256_fmadd_ps(c1, _mm256_shuffle_ps(v1, v1, 0xFF), _mm256_fmadd_ps(c2, _mm256_shuffle_ps(v2, v2, 0x00), c3)));
+        const __m256 r3 = _mm256_fmadd_ps(c0, _mm256_shuffle_ps(v2, v2, 0x55), _mm256_fmadd_ps(c1, _mm256_shuffle_ps(v2, v2, 0xAA), _mm256_fmadd_ps(c2, _mm256_shuffle_ps(v2, v2, 0xFF), c3)));
+
+        const __m256 t0 = _mm256_shuffle_ps(r0, r1, _MM_SHUFFLE(0, 0, 2, 2));
+        const __m256 t2 = _mm256_shuffle_ps(r2, r3, _MM_SHUFFLE(0, 0, 2, 2));
+
+        Store2x4Avx(out, out + 12, _mm256_shuffle_ps(r0, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+        Store2x4Avx(out + 4, out + 16, _mm256_shuffle_ps(r1, r2, _MM_SHUFFLE(1, 0, 2, 1)));
+        Store2x4Avx(out + 8, out + 20, _mm256_shuffle_ps(t2, r3, _MM_SHUFFLE(2, 1, 2, 0)));
+    }
+
+    TransformScalar(out, in, count - i, m);
+}
+
+// Same steps as QuaternionSse(), quaternions 0-3 in the low half and 4-7 in the high half
+VMATH_AVX2_TARGET static void QuaternionAvx(float* out, const float* in, int count)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 r3 = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8, in += 32, out += 128)
+    {
+        __m256 x = Load2x4Avx(in, in + 16);
+        __m256 y = Load2x4Avx(in + 4, in + 20);
+        __m256 z = Load2x4Avx(in + 8, in + 24);
+        __m256 w = Load2x4Avx(in + 12, in + 28);
+        Transpose4x4Avx(&x, &y, &z, &w);
+
+        const __m256 norm = _mm256_sqrt_ps(_mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_fmadd_ps(z, z, _mm256_mul_ps(w, w)))));
+        const __m256 inv = _mm256_blendv_ps(one, _mm256_div_ps(one, norm), _mm256_cmp_ps(norm, zero, _CMP_GT_OQ));
+
+        x = _mm256_mul_ps(x, inv);
+        y = _mm256_mul_ps(y, inv);
+        z = _mm256_mul_ps(z, inv);
+        w = _mm256_mul_ps(w, inv);
+
+        const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        __m256 r00 = _mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one);
+        __m256 r01 = _mm256_mul_ps(two, _mm256_sub_ps(xy, wz));
+        __m256 r02 = _mm256_mul_ps(two, _mm256_add_ps(xz, wy));
+        __m256 r03 = zero;
+
+        __m256 r10 = _mm256_mul_ps(two, _mm256_add_ps(xy, wz));
+        __m256 r11 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one);
+        __m256 r12 = _mm256_mul_ps(two, _mm256_sub_ps(yz, wx));
+        __m256 r13 = zero;
+
+        __m256 r20 = _mm256_mul_ps(two, _mm256_sub_ps(xz, wy));
+        __m256 r21 = _mm256_mul_ps(two, _mm256_add_ps(yz, wx));
+        __m256 r22 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one);
+        __m256 r23 = zero;
+
+        Transpose4x4Avx(&r00, &r01, &r02, &r03);
+        Transpose4x4Avx(&r10, &r11, &r12, &r13);
+        Transpose4x4Avx(&r20, &r21, &r22, &r23);
+
+        const __m256 rows[4][3] = { { r00, r10, r20 }, { r01, r11, r21 }, { r02, r12, r22 }, { r03, r13, r23 } };
+
+        for (int k = 0; k < 4; k++)
+        {
+            for (int row = 0; row < 3; row++) Store2x4Avx(out + 16*k + 4*row, out + 64 + 16*k + 4*row, rows[k][row]);
+            Store2x4Avx(out + 16*k + 12, out + 64 + 16*k + 12, r3);
+        }
+    }
+
+    QuaternionSse(out, in, count - i);
+}
+#endif
+
+//----------------------------------------------------------------
+#if defined(VMATH_NEON)
+static inline void MultiplyNeon4x4(float* out, const float* a, const float* b)
+{
+    const float32x4_t b0 = vld1q_f32(b);
+    const float32x4_t b1 = vld1q_f32(b + 4);
+    const float32x4_t b2 = vld1q_f32(b + 8);
+    const float32x4_t b3 = vld1q_f32(b + 12);
+
+    float32x4_t rows[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        float32x4_t r = vmulq_n_f32(b0, a[4*i]);
+        r = vmlaq_n_f32(r, b1, a[4*i + 1]);
+        r = vmlaq_n_f32(r, b2, a[4*i + 2]);
+        rows[i] = vmlaq_n_f32(r, b3, a[4*i + 3]);
+    }
+
+    // Stored after all of a is read, out may alias a
+    for (int i = 0; i < 4; i++) vst1q_f32(out + 4*i, rows[i]);
+}
+
+static void MultiplyNeon(float* out, const float* a, int aStride, const float* b, int count)
+{
+    for (int i = 0; i < count; i++) MultiplyNeon4x4(out + 16*i, a + 16*i*aStride, b + 16*i);
+}
+
+// vld3/vst3 split and join the xyz of four points
+static void TransformNeon(float* out, const float* in, int count, const float* m)
+{
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4, in += 12, out += 12)
+    {
+        const float32x4x3_t v = vld3q_f32(in);
+        float32x4x3_t r;
+
+        for (int row = 0; row < 3; row++)
+        {
+            const float* mr = m + 4*row;
+
+            float32x4_t c = vdupq_n_f32(mr[3]);
+            c = vmlaq_n_f32(c, v.val[0], mr[0]);
+            c = vmlaq_n_f32(c, v.val[1], mr[1]);
+            r.val[row] = vmlaq_n_f32(c, v.val[2], mr[2]);
+        }
+
+        vst3q_f32(out, r);
+    }
+
+    TransformScalar(out, in, count - i, m);
+}
+
+static inline void Transpose4x4Neon(float32x4_t* r0, float32x4_t* r1, float32x4_t* r2, float32x4_t* r3)
+{
+    const float32x4x2_t t01 = vtrnq_f32(*r0, *r1);
+    const float32x4x2_t t23 = vtrnq_f32(*r2, *r3);
+
+    *r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    *r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    *r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    *r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+static void QuaternionNeon(float* out, const float* in, int count)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t r3 = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4, in += 16, out += 64)
+    {
+        const float32x4x4_t q = vld4q_f32(in);
+
+        // Scalar square root keeps ARMv7 working, vsqrtq_f32 is AArch64 only
+        float32x4_t normSquared = vmulq_f32(q.val[0], q.val[0]);
+        normSquared = vmlaq_f32(normSquared, q.val[1], q.val[1]);
+        normSquared = vmlaq_f32(normSquared, q.val[2], q.val[2]);
+        normSquared = vmlaq_f32(normSquared, q.val[3], q.val[3]);
+
+        float lengths[4];
+        vst1q_f32(lengths, normSquared);
+        for (int k = 0; k < 4; k++) lengths[k] = (lengths[k] > 0.0f) ? 1.0f/sqrtf(lengths[k]) : 1.0f;
+        const float32x4_t inv = vld1q_f32(lengths);
+
+        const float32x4_t x = vmulq_f32(q.val[0], inv);
+        const float32x4_t y = vmulq_f32(q.val[1], inv);
+        const float32x4_t z = vmulq_f32(q.val[2], inv);
+        const float32x4_t w = vmulq_f32(q.val[3], inv);
+
+        const float32x4_t xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+        const float32x4_t xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+        const float32x4_t wx = vmulq_f32(w, x), wy = vmulq_f32(w, y), wz = vmulq_f32(w, z);
+
+        float32x4_t r00 = vmlsq_n_f32(one, vaddq_f32(yy, zz), 2.0f);
+        float32x4_t r01 = vmulq_n_f32(vsubq_f32(xy, wz), 2.0f);
+        float32x4_t r02 = vmulq_n_f32(vaddq_f32(xz, wy), 2.0f);
+        float32x4_t r03 = zero;
+
+        float32x4_t r10 = vmulq_n_f32(vaddq_f32(xy, wz), 2.0f);
+        float32x4_t r11 = vmlsq_n_f32(one, vaddq_f32(xx, zz), 2.0f);
+        float32x4_t r12 = vmulq_n_f32(vsubq_f32(yz, wx), 2.0f);
+        float32x4_t r13 = zero;
+
+        float32x4_t r20 = vmulq_n_f32(vsubq_f32(xz, wy), 2.0f);
+        float32x4_t r21 = vmulq_n_f32(vaddq_f32(yz, wx), 2.0f);
+        float32x4_t r22 = vmlsq_n_f32(one, vaddq_f32(xx, yy), 2.0f);
+        float32x4_t r23 = zero;
+
+        Transpose4x4Neon(&r00, &r01, &r02, &r03);
+        Transpose4x4Neon(&r10, &r11, &r12, &r13);
+        Transpose4x4Neon(&r20, &r21, &r22, &r23);
+
+        vst1q_f32(out,      r00); vst1q_f32(out + 4,  r10); vst1q_f32(out + 8,  r20); vst1q_f32(out + 12, r3);
+        vst1q_f32(out + 16, r01); vst1q_f32(out + 20, r11); vst1q_f32(out + 24, r21); vst1q_f32(out + 28, r3);
+        vst1q_f32(out + 32, r02); vst1q_f32(out + 36, r12); vst1q_f32(out + 40, r22); vst1q_f32(out + 44, r3);
+        vst1q_f32(out + 48, r03); vst1q_f32(out + 52, r13); vst1q_f32(out + 56, r23); vst1q_f32(out + 60, r3);
+    }
+
+    QuaternionScalar(out, in, count - i);
+}
+#endif
+
+//----------------------------------------------------------------
+static bool IsMathSimdLevelSupported(MathSimdLevel level)
+{
+    switch (level)
+    {
+        case MATH_SIMD_SCALAR: return true;
+#if defined(VMATH_SSE)
+        case MATH_SIMD_SSE2: return true;
+#endif
+#if defined(VMATH_AVX2)
+        case MATH_SIMD_AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#if defined(VMATH_NEON)
+        case MATH_SIMD_NEON: return true;
+#endif
+        default: return false;
+    }
+}
+
+static MathKernels GetLevelKernels(MathSimdLevel level)
+{
+    MathKernels result = { MATH_SIMD_SCALAR, MultiplyScalar, TransformScalar, QuaternionScalar };
+
+    switch (level)
+    {
+#if defined(VMATH_SSE)
+        // A 4x4 multiply in SSE2 measured slower than the scalar loop the compiler vectorizes
+        case MATH_SIMD_SSE2: result = (MathKernels){ level, MultiplyScalar, TransformSse, QuaternionSse }; break;
+#endif
+#if defined(VMATH_AVX2)
+        case MATH_SIMD_AVX2: result = (MathKernels){ level, MultiplyAvx, TransformAvx, QuaternionAvx }; break;
+#endif
+#if defined(VMATH_NEON)
+        case MATH_SIMD_NEON: result = (MathKernels){ level, MultiplyNeon, TransformNeon, QuaternionNeon }; break;
+#endif
+        default: break;
+    }
+
+    return result;
+}
+
+static void InitMathKernels(void)
+{
+    MathSimdLevel best = MATH_SIMD_SCALAR;
+
+    for (int level = MATH_SIMD_SCALAR; level <= MATH_SIMD_NEON; level++)
+    {
+        if (IsMathSimdLevelSupported((MathSimdLevel)level)) best = (MathSimdLevel)level;
+    }
+
+    kernels = GetLevelKernels(best);
+}
+
+static const MathKernels* GetMathKernels(void)
+{
+    pthread_once(&kernelsOnce, InitMathKernels);
+
+    return &kernels;
+}
+
+//----------------------------------------------------------------
+Matrix MatrixIdentity(void)
+{
+    return (Matrix){ 1.0f, 0.0f, 0.0f, 0.0f,
+                     0.0f, 1.0f, 0.0f, 0.0f,
+                     0.0f, 0.0f, 1.0f, 0.0f,
+                     0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Matrix MatrixMultiply(Matrix a, Matrix b)
+{
+#if defined(VMATH_SSE)
+    Matrix result;
+    MultiplySse4x4((float*)&result, (const float*)&a, (const float*)&b);
+    return result;
+#elif defined(VMATH_NEON)
+    Matrix result;
+    MultiplyNeon4x4((float*)&result, (const float*)&a, (const float*)&b);
+    return result;
+#else
+    return MatrixMultiplyScalar(a, b);
+#endif
+}
+
+Matrix MatrixTranslateV(Vector3 v)
+{
+    return (Matrix){ 1.0f, 0.0f, 0.0f, v.x,
+                      0.0f, 1.0f, 0.0f, v.y,
+                      0.0f, 0.0f, 1.0f, v.z,
+                      0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Matrix MatrixScaleV(Vector3 v)
+{
+    return (Matrix){ v.x, 0.0f, 0.0f, 0.0f,
+                      0.0f, v.y, 0.0f, 0.0f,
+                      0.0f, 0.0f, v.z, 0.0f,
+                      0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Matrix MatrixRotateXYZ(Vector3 angle)
+{
+    Matrix result = { 0 };
+
+    float cosz = cosf(-angle.z);
+    float sinz = sinf(-angle.z);
+    float cosy = cosf(-angle.y);
+    float siny = sinf(-angle.y);
+    float cosx = cosf(-angle.x);
+    float sinx = sinf(-angle.x);
+
+    result.m0 = cosz*cosy;
+    result.m1 = (cosz*siny*sinx) - (sinz*cosx);
+    result.m2 = (cosz*siny*cosx) + (sinz*sinx);
+    result.m3 = 0.0f;
+
+    result.m4 = sinz*cosy;
+    result.m5 = (sinz*siny*sinx) + (cosz*cosx);
+    result.m6 = (sinz*siny*cosx) - (cosz*sinx);
+    result.m7 = 0.0f;
+
+    result.m8 = -siny;
+    result.m9 = cosy*sinx;
+    result.m10 = cosy*cosx;
+    result.m11 = 0.0f;
+
+    result.m12 = 0.0f;
+    result.m13 = 0.0f;
+    result.m14 = 0.0f;
+    result.m15 = 1.0f;
+
+    return result;
+}
+
+Matrix QuaternionToMatrix(Quaternion q)
+{
+    Matrix result = { 0 };
+
+    // Normalize the quaternion
+    float norm = sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+    if (norm > 0.0f)
+    {
+        q.x /= norm;
+        q.y /= norm;
+        q.z /= norm;
+        q.w /= norm;
+    }
+
+    // Pre-calculate repeated values
+    float xx = q.x*q.x;
+    float yy = q.y*q.y;
+    float zz = q.z*q.z;
+    float xy = q.x*q.y;
+    float xz = q.x*q.z;
+    float yz = q.y*q.z;
+    float wx = q.w*q.x;
+    float wy = q.w*q.y;
+    float wz = q.w*q.z;
+
+    // Set matrix elements
+    result.m0 = 1.0f - 2.0f*(yy + zz);
+    result.m1 = 2.0f*(xy + wz);
+    result.m2 = 2.0f*(xz - wy);
+    result.m3 = 0.0f;
+
+    result.m4 = 2.0f*(xy - wz);
+    result.m5 = 1.0f - 2.0f*(xx + zz);
+    result.m6 = 2.0f*(yz + wx);
+    result.m7 = 0.0f;
+
+    result.m8  = 2.0f*(xz + wy);
+    result.m9  = 2.0f*(yz - wx);
+    result.m10 = 1.0f - 2.0f*(xx + yy);
+    result.m11 = 0.0f;
+
+    result.m12 = 0.0f;
+    result.m13 = 0.0f;
+    result.m14 = 0.0f;
+    result.m15 = 1.0f;
+
+    return result;
+}
+
+Matrix MatrixRotateV(Vector3 v)
+{
+    v.x *= DEG2RAD;
+    v.y *= DEG2RAD;
+    v.z *= DEG2RAD;
+
+    return MatrixRotateXYZ(v);
+}
+
+// glTF matrices are column major float[16], Matrix fields are named row by row
+Matrix MatrixFromColumns(const float* f)
+{
+    return (Matrix){ f[0], f[4], f[8],  f[12],
+                     f[1], f[5], f[9],  f[13],
+                     f[2], f[6], f[10], f[14],
+                     f[3], f[7], f[11], f[15] };
+}
+
+//----------------------------------------------------------------
+
+Quaternion QuaternionMultiply(Quaternion a, Quaternion b)
+{
+    Quaternion result;
+
+    result.x = a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y;
+    result.y = a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x;
+    result.z = a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w;
+    result.w = a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z;
+
+    return result;
+}
+
+Quaternion QuaternionInvert(Quaternion q)
+{
+    Quaternion result;
+
+    // Calculate the magnitude squared of the quaternion
+    float normSquared = q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w;
+
+    if (normSquared > 0.0f)
+    {
+        // Inverse of a quaternion q = (conjugate(q)) / (norm(q)^2)
+        float invNorm = 1.0f / normSquared;
+        result.x = -q.x*invNorm;
+        result.y = -q.y*invNorm;
+        result.z = -q.z*invNorm;
+        result.w = q.w*invNorm;
+    }
+    else
+    {
+        // Return identity quaternion if the input quaternion is zero (non-invertible)
+        result.x = 0.0f;
+        result.y = 0.0f;
+        result.z = 0.0f;
+        result.w = 1.0f;
+    }
+
+    return result;
+}
+
+Quaternion QuaternionFromEuler(Vector3 angle)
+{
+    // Calculate half angles
+    float halfPitch = angle.x*0.5f;
+    float halfYaw   = angle.y*0.5f;
+    float halfRoll  = angle.z*0.5f;
+
+    // Calculate sin and cos for each half angle
+    float sinPitch = sinf(halfPitch);
+    float cosPitch = cosf(halfPitch);
+    float sinYaw   = sinf(halfYaw);
+    float cosYaw   = cosf(halfYaw);
+    float sinRoll  = sinf(halfRoll);
+    float cosRoll  = cosf(halfRoll);
+
+    return (Quaternion)
+    {
+        cosYaw*sinPitch*cosRoll + sinYaw*cosPitch*sinRoll,
+        sinYaw*cosPitch*cosRoll - cosYaw*sinPitch*sinRoll,
+        cosYaw*cosPitch*sinRoll - sinYaw*sinPitch*cosRoll,
+        cosYaw*cosPitch*cosRoll + sinYaw*sinPitch*sinRoll
+    };
+}
+
+// Rotation part of an orthonormal matrix, picks the largest diagonal term for precision
+Quaternion QuaternionFromMatrix(Matrix mat)
+{
+    Quaternion result;
+    float trace = mat.m0 + mat.m5 + mat.m10;
+
+    if (trace > 0.0f)
+    {
+        float s = sqrtf(trace + 1.0f)*2.0f;
+        result.w = 0.25f*s;
+        result.x = (mat.m6 - mat.m9)/s;
+        result.y = (mat.m8 - mat.m2)/s;
+        result.z = (mat.m1 - mat.m4)/s;
+    }
+    else if ((mat.m0 > mat.m5) && (mat.m0 > mat.m10))
+    {
+        float s = sqrtf(1.0f + mat.m0 - mat.m5 - mat.m10)*2.0f;
+        result.w = (mat.m6 - mat.m9)/s;
+        result.x = 0.25f*s;
+        result.y = (mat.m4 + mat.m1)/s;
+        result.z = (mat.m8 + mat.m2)/s;
+    }
+    else if (mat.m5 > mat.m10)
+    {
+        float s = sqrtf(1.0f + mat.m5 - mat.m0 - mat.m10)*2.0f;
+        result.w = (mat.m8 - mat.m2)/s;
+        result.x = (mat.m4 + mat.m1)/s;
+        result.y = 0.25f*s;
+        result.z = (mat.m9 + mat.m6)/s;
+    }
+    else
+    {
+        float s = sqrtf(1.0f + mat.m10 - mat.m0 - mat.m5)*2.0f;
+        result.w = (mat.m1 - mat.m4)/s;
+        result.x = (mat.m8 + mat.m2)/s;
+        result.y = (mat.m9 + mat.m6)/s;
+        result.z = 0.25f*s;
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------
+
+Vector3 Vector3Zero()
+{
+    return (Vector3){ 0.0f, 0.0f, 0.0f };
+}
+
+Vector3 Vector3One()
+{
+    return (Vector3){ 1.0f, 1.0f, 1.0f };
+}
+
+Vector3 Vector3Add(Vector3 a, Vector3 b)
+{
+    return (Vector3){ a.x + b.x, a.y + b.y, a.z + b.z };
+}
+
+Vector3 Vector3Subtract(Vector3 a, Vector3 b)
+{
+    return (Vector3){ a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+Vector3 Vector3Multiply(Vector3 a, Vector3 b)
+{
+    return (Vector3){ a.x*b.x, a.y*b.y, a.z*b.z };
+}
+
+Vector3 Vector3Scale(Vector3 v, float scalar)
+{
+    return (Vector3){ v.x*scalar, v.y*scalar, v.z*scalar };
+}
+
+float Vector3DotProduct(Vector3 a, Vector3 b)
+{
+    return (float){ a.x*b.x + a.y*b.y + a.z*b.z };
+}
+
+float Vector3Distance(Vector3 a, Vector3 b)
+{
+    float result = 0.0f;
+
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float dz = b.z - a.z;
+    result = sqrtf(dx*dx + dy*dy + dz*dz);
+
+    return result;
+}
+
+Vector3 Vector3RotateByQuaternion(Vector3 v, Quaternion q)
+{
+    // Quaternion-vector multiplication: v' = q * v * q⁻¹
+    Quaternion qConjugate = (Quaternion){ -q.x, -q.y, -q.z, q.w };
+
+    // Convert vector to quaternion form (v.x, v.y, v.z, 0)
+    Quaternion vQuat = (Quaternion){ v.x, v.y, v.z, 0.0f };
+
+    // Calculate q * v
+    Quaternion qv = (Quaternion)
+    {
+        q.w*vQuat.x + q.y*vQuat.z - q.z*vQuat.y,
+        q.w*vQuat.y + q.z*vQuat.x - q.x*vQuat.z,
+        q.w*vQuat.z + q.x*vQuat.y - q.y*vQuat.x,
+        -q.x*vQuat.x - q.y*vQuat.y - q.z*vQuat.z
+    };
+
+    // Calculate (q * v) * q⁻¹
+    Quaternion resultQuat = (Quaternion)
+    {
+        qv.w*qConjugate.x + qv.x*qConjugate.w + qv.y*qConjugate.z - qv.z*qConjugate.y,
+        qv.w*qConjugate.y - qv.x*qConjugate.z + qv.y*qConjugate.w + qv.z*qConjugate.x,
+        qv.w*qConjugate.z + qv.x*qConjugate.y - qv.y*qConjugate.x + qv.z*qConjugate.w,
+        qv.w*qConjugate.w - qv.x*qConjugate.x - qv.y*qConjugate.y - qv.z*qConjugate.z
+    };
+
+    return (Vector3){ resultQuat.x, resultQuat.y, resultQuat.z };
+}
+
+Vector3 Vector3Transform(Vector3 v, Matrix mat)
+{
+    return (Vector3)
+    {
+        v.x*mat.m0 + v.y*mat.m4 + v.z*mat.m8 + mat.m12,
+        v.x*mat.m1 + v.y*mat.m5 + v.z*mat.m9 + mat.m13,
+        v.x*mat.m2 + v.y*mat.m6 + v.z*mat.m10 + mat.m14
+    };
+}
+
+//----------------------------------------------------------------
+
+void MatrixMultiplyBatch(Matrix* out, const Matrix* a, const Matrix* b, int count)
+{
+    GetMathKernels()->multiply((float*)out, (const float*)a, 1, (const float*)b, count);
+}
+
+void MatrixMultiplyBatchLeft(Matrix* out, const Matrix* a, const Matrix* b, int count)
+{
+    // Copied, out may overlap a
+    const Matrix left = *a;
+
+    GetMathKernels()->multiply((float*)out, (const float*)&left, 0, (const float*)b, count);
+}
+
+void Vector3TransformBatch(Vector3* out, const Vector3* in, int count, const Matrix* mat)
+{
+    const Matrix m = *mat;
+
+    GetMathKernels()->transform((float*)out, (const float*)in, count, (const float*)&m);
+}
+
+void QuaternionToMatrixBatch(Matrix* out, const Quaternion* in, int count)
+{
+    GetMathKernels()->quaternion((float*)out, (const float*)in, count);
+}
+
+MathSimdLevel GetMathSimdLevel(void)
+{
+    return GetMathKernels()->level;
+}
+
+const char* GetMathSimdName(MathSimdLevel level)
+{
+    switch (level)
+    {
+        case MATH_SIMD_SSE2: return "SSE2";
+        case MATH_SIMD_AVX2: return "AVX2";
+        case MATH_SIMD_NEON: return "NEON";
+        default: return "scalar";
+    }
+}
+
+bool SetMathSimdLevel(MathSimdLevel level)
+{
+    if (!IsMathSimdLevelSupported(level)) return false;
+
+    GetMathKernels();
+    kernels = GetLevelKernels(level);
+
+    return true;
+}
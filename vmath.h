@@ -0,0 +1,102 @@
+/*******************************************************************************************
+*
+*   vmath - Vector, matrix and quaternion math with SIMD batch paths
+*
+*   The single value functions keep the raylib style signatures (values in, value out),
+*   MatrixMultiply() uses SSE2 or NEON when the target always has it.
+*
+*   The batch functions work on arrays and pick a kernel once at runtime: AVX2+FMA on x86
+*   when the CPU has it (compiled with target attributes, so the build flags do not change),
+*   SSE2 as the x86-64 baseline, NEON on ARM, scalar everywhere else.
+*   Every batch function accepts out == in.
+*
+*   Matrix follows raylib: m0, m4, m8, m12 is the first row, vectors are columns and
+*   MatrixMultiply(a, b) returns a*b, b is applied first.
+*
+*   Copyright (c) 2024 Wildan R Wijanarko
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef VMATH_H
+#define VMATH_H
+
+#include "raylib.h"
+
+typedef enum
+{
+    MATH_SIMD_SCALAR = 0,
+    MATH_SIMD_SSE2,
+    MATH_SIMD_AVX2,
+    MATH_SIMD_NEON
+} MathSimdLevel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------
+Matrix MatrixIdentity(void);
+Matrix MatrixMultiply(Matrix a, Matrix b);
+Matrix MatrixTranslateV(Vector3 v);
+Matrix MatrixScaleV(Vector3 v);
+Matrix MatrixRotateXYZ(Vector3 angle);
+Matrix MatrixRotateV(Vector3 v);                // Degrees
+Matrix MatrixFromColumns(const float* f);       // Column major float[16], as glTF stores them
+Matrix QuaternionToMatrix(Quaternion q);
+
+Quaternion QuaternionMultiply(Quaternion a, Quaternion b);
+Quaternion QuaternionInvert(Quaternion q);
+Quaternion QuaternionFromEuler(Vector3 angle);
+Quaternion QuaternionFromMatrix(Matrix mat);      // Rotation only, no scale
+
+Vector3 Vector3Zero();
+Vector3 Vector3One();
+Vector3 Vector3Add(Vector3 a, Vector3 b);
+Vector3 Vector3Subtract(Vector3 a, Vector3 b);
+Vector3 Vector3Multiply(Vector3 a, Vector3 b);
+Vector3 Vector3Scale(Vector3 v, float scalar);
+float Vector3DotProduct(Vector3 a, Vector3 b);
+float Vector3Distance(Vector3 a, Vector3 b);
+Vector3 Vector3RotateByQuaternion(Vector3 v, Quaternion q);
+Vector3 Vector3Transform(Vector3 v, Matrix mat);
+
+//----------------------------------------------------------------
+// out[i] = a[i]*b[i]
+void MatrixMultiplyBatch(Matrix* out, const Matrix* a, const Matrix* b, int count);
+
+// out[i] = a*b[i], one shared left hand matrix
+void MatrixMultiplyBatchLeft(Matrix* out, const Matrix* a, const Matrix* b, int count);
+
+// out[i] = mat*in[i] as a point
+void Vector3TransformBatch(Vector3* out, const Vector3* in, int count, const Matrix* mat);
+
+// Same result as QuaternionToMatrix() for every element, zero quaternions give identity
+void QuaternionToMatrixBatch(Matrix* out, const Quaternion* in, int count);
+
+// Best level the CPU supports unless forced below
+MathSimdLevel GetMathSimdLevel(void);
+const char* GetMathSimdName(MathSimdLevel level);
+
+// Forces the batch kernels of a level, returns false when the CPU or build does not have it
+bool SetMathSimdLevel(MathSimdLevel level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VMATH_H